@@ -9,10 +9,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #include "arvore.h"
 #include "../geometria/calculos/calculos.h"
 
+#define BALDES_INICIAIS 64
+
 /* ============================================================================
  * Estruturas Internas
  * ============================================================================ */
@@ -24,6 +27,7 @@ typedef struct no_arvore
     struct no_arvore *esquerda;
     struct no_arvore *direita;
     struct no_arvore *pai;
+    struct no_arvore *prox_indice;  /* Encadeamento no índice segmento -> nó */
 } NoArvore;
 
 /* Estrutura principal da árvore */
@@ -33,6 +37,10 @@ typedef struct arvore_internal
     Ponto origem;       /* Ponto de vista */
     double angulo;      /* Ângulo atual da varredura */
     int tamanho;
+    NoArvore **indice;  /* Tabela hash (por endereço do segmento) dos nós */
+    int num_baldes;
+    Arena arena;        /* Origem dos nós (NULL = malloc) */
+    NoArvore *livres;   /* Nós de arena já removidos, encadeados por 'direita' */
 } ArvoreInternal;
 
 /* ============================================================================
@@ -42,19 +50,151 @@ typedef struct arvore_internal
 /**
  * Cria um novo nó.
  */
-static NoArvore* criar_no(Segmento seg)
+static NoArvore* criar_no(ArvoreInternal *arv, Segmento seg)
 {
-    NoArvore *no = (NoArvore*)malloc(sizeof(NoArvore));
+    NoArvore *no;
+    if (arv->livres != NULL)
+    {
+        no = arv->livres;
+        arv->livres = no->direita;
+    }
+    else if (arv->arena != NULL)
+    {
+        no = (NoArvore*)arena_alocar(arv->arena, sizeof(NoArvore));
+    }
+    else
+    {
+        no = (NoArvore*)malloc(sizeof(NoArvore));
+    }
     if (no == NULL) return NULL;
     
     no->segmento = seg;
     no->esquerda = NULL;
     no->direita = NULL;
     no->pai = NULL;
+    no->prox_indice = NULL;
     
     return no;
 }
 
+/**
+ * Índice segmento -> nós, para localizar um segmento sem percorrer a árvore.
+ */
+static int balde_do_segmento(ArvoreInternal *arv, Segmento seg)
+{
+    uintptr_t h = (uintptr_t)seg;
+    h ^= h >> 17;
+    h *= 0x9E3779B1u;
+    return (int)(h % (uintptr_t)arv->num_baldes);
+}
+
+static void indice_inserir(ArvoreInternal *arv, NoArvore *no)
+{
+    if (arv->tamanho >= arv->num_baldes)
+    {
+        int novo_num = arv->num_baldes * 2;
+        NoArvore **novo = (NoArvore**)calloc(novo_num, sizeof(NoArvore*));
+        if (novo != NULL)
+        {
+            NoArvore **antigo = arv->indice;
+            int antigo_num = arv->num_baldes;
+            arv->indice = novo;
+            arv->num_baldes = novo_num;
+
+            for (int i = 0; i < antigo_num; i++)
+            {
+                NoArvore *atual = antigo[i];
+                while (atual != NULL)
+                {
+                    NoArvore *prox = atual->prox_indice;
+                    int b = balde_do_segmento(arv, atual->segmento);
+                    atual->prox_indice = arv->indice[b];
+                    arv->indice[b] = atual;
+                    atual = prox;
+                }
+            }
+            free(antigo);
+        }
+    }
+
+    int b = balde_do_segmento(arv, no->segmento);
+    no->prox_indice = arv->indice[b];
+    arv->indice[b] = no;
+}
+
+static void indice_remover(ArvoreInternal *arv, NoArvore *no)
+{
+    NoArvore **atual = &arv->indice[balde_do_segmento(arv, no->segmento)];
+    while (*atual != NULL)
+    {
+        if (*atual == no)
+        {
+            *atual = no->prox_indice;
+            return;
+        }
+        atual = &(*atual)->prox_indice;
+    }
+}
+
+static int profundidade(NoArvore *no)
+{
+    int d = 0;
+    while (no->pai != NULL)
+    {
+        no = no->pai;
+        d++;
+    }
+    return d;
+}
+
+/**
+ * Verifica se o nó a vem antes do nó b no percurso pré-ordem
+ * (raiz, esquerda, direita), que é a ordem de visita das buscas da árvore.
+ */
+static int precede_preordem(NoArvore *a, NoArvore *b)
+{
+    if (a == b) return 0;
+
+    int da = profundidade(a);
+    int db = profundidade(b);
+    NoArvore *pa = a;
+    NoArvore *pb = b;
+
+    while (da > db) { pa = pa->pai; da--; }
+    while (db > da) { pb = pb->pai; db--; }
+
+    if (pa == b) return 0;  /* b é ancestral de a */
+    if (pb == a) return 1;  /* a é ancestral de b */
+
+    while (pa->pai != pb->pai)
+    {
+        pa = pa->pai;
+        pb = pb->pai;
+    }
+    return pa == pa->pai->esquerda;
+}
+
+/**
+ * Encontra o nó do segmento que uma busca em pré-ordem encontraria primeiro
+ * (um mesmo segmento pode ter sido inserido mais de uma vez).
+ */
+static NoArvore* buscar_no(ArvoreInternal *arv, Segmento seg)
+{
+    NoArvore *escolhido = NULL;
+    NoArvore *atual = arv->indice[balde_do_segmento(arv, seg)];
+
+    while (atual != NULL)
+    {
+        if (atual->segmento == seg &&
+            (escolhido == NULL || precede_preordem(atual, escolhido)))
+        {
+            escolhido = atual;
+        }
+        atual = atual->prox_indice;
+    }
+    return escolhido;
+}
+
 /**
  * Compara dois segmentos pela distância no ângulo atual.
  * @return < 0 se seg1 mais perto, > 0 se seg2 mais perto
@@ -129,6 +269,22 @@ static void transplantar(ArvoreInternal *arv, NoArvore *u, NoArvore *v)
     }
 }
 
+/**
+ * Devolve um nó: para a lista livre (arena) ou para o sistema.
+ */
+static void liberar_no(ArvoreInternal *arv, NoArvore *no)
+{
+    if (arv->arena != NULL)
+    {
+        no->direita = arv->livres;
+        arv->livres = no;
+    }
+    else
+    {
+        free(no);
+    }
+}
+
 /**
  * Destroi recursivamente os nós da árvore.
  */
@@ -146,6 +302,11 @@ static void destruir_nos(NoArvore *no)
  * ============================================================================ */
 
 ArvoreSegmentos arvore_criar(Ponto origem)
+{
+    return arvore_criar_em(origem, NULL);
+}
+
+ArvoreSegmentos arvore_criar_em(Ponto origem, Arena arena)
 {
     if (origem == NULL) return NULL;
     
@@ -160,6 +321,16 @@ ArvoreSegmentos arvore_criar(Ponto origem)
     arv->origem = origem;
     arv->angulo = 0.0;
     arv->tamanho = 0;
+    arv->arena = arena;
+    arv->livres = NULL;
+    arv->num_baldes = BALDES_INICIAIS;
+    arv->indice = (NoArvore**)calloc(arv->num_baldes, sizeof(NoArvore*));
+    if (arv->indice == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar árvore de segmentos.\n");
+        free(arv);
+        return NULL;
+    }
     
     return (ArvoreSegmentos)arv;
 }
@@ -169,7 +340,9 @@ void arvore_destruir(ArvoreSegmentos arvore)
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
     if (arv == NULL) return;
     
-    destruir_nos(arv->raiz);
+    // Nós de arena voltam todos de uma vez, no reset dela
+    if (arv->arena == NULL) destruir_nos(arv->raiz);
+    free(arv->indice);
     free(arv);
 }
 
@@ -187,7 +360,7 @@ int arvore_inserir(ArvoreSegmentos arvore, Segmento seg)
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
     if (arv == NULL || seg == NULL) return 0;
     
-    NoArvore *novo = criar_no(seg);
+    NoArvore *novo = criar_no(arv, seg);
     if (novo == NULL) return 0;
     
     /* Inserção padrão da BST */
@@ -224,6 +397,7 @@ int arvore_inserir(ArvoreSegmentos arvore, Segmento seg)
         pai->direita = novo;
     }
     
+    indice_inserir(arv, novo);
     arv->tamanho++;
     return 1;
 }
@@ -233,29 +407,7 @@ int arvore_remover(ArvoreSegmentos arvore, Segmento seg)
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
     if (arv == NULL || seg == NULL) return 0;
     
-    /* Busca linear para encontrar o nó (por ponteiro do segmento) */
-    NoArvore *no = NULL;
-    NoArvore *stack[1000];
-    int stack_top = 0;
-    
-    if (arv->raiz != NULL)
-    {
-        stack[stack_top++] = arv->raiz;
-    }
-    
-    while (stack_top > 0)
-    {
-        NoArvore *atual = stack[--stack_top];
-        
-        if (atual->segmento == seg)
-        {
-            no = atual;
-            break;
-        }
-        
-        if (atual->direita != NULL) stack[stack_top++] = atual->direita;
-        if (atual->esquerda != NULL) stack[stack_top++] = atual->esquerda;
-    }
+    NoArvore *no = buscar_no(arv, seg);
     
     if (no == NULL) return 0;
     
@@ -284,7 +436,8 @@ int arvore_remover(ArvoreSegmentos arvore, Segmento seg)
         sucessor->esquerda->pai = sucessor;
     }
     
-    free(no);
+    indice_remover(arv, no);
+    liberar_no(arv, no);
     arv->tamanho--;
     return 1;
 }
@@ -329,34 +482,29 @@ Segmento arvore_obter_proximo(ArvoreSegmentos arvore, Segmento seg)
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
     if (arv == NULL || seg == NULL) return NULL;
     
-    /* Busca linear para encontrar o nó */
-    NoArvore *no = NULL;
-    NoArvore *stack[1000];
-    int stack_top = 0;
+    NoArvore *no = buscar_no(arv, seg);
     
-    if (arv->raiz != NULL)
-    {
-        stack[stack_top++] = arv->raiz;
-    }
+    if (no == NULL) return NULL;
     
-    while (stack_top > 0)
+    NoArvore *sucessor = encontrar_sucessor(no);
+    return sucessor ? sucessor->segmento : NULL;
+}
+
+Segmento arvore_primeiro_dentre(ArvoreSegmentos arvore, Segmento *candidatos, int n)
+{
+    ArvoreInternal *arv = (ArvoreInternal*)arvore;
+    if (arv == NULL || candidatos == NULL) return NULL;
+    
+    NoArvore *escolhido = NULL;
+    for (int i = 0; i < n; i++)
     {
-        NoArvore *atual = stack[--stack_top];
-        
-        if (atual->segmento == seg)
+        NoArvore *no = buscar_no(arv, candidatos[i]);
+        if (no != NULL && (escolhido == NULL || precede_preordem(no, escolhido)))
         {
-            no = atual;
-            break;
+            escolhido = no;
         }
-        
-        if (atual->direita != NULL) stack[stack_top++] = atual->direita;
-        if (atual->esquerda != NULL) stack[stack_top++] = atual->esquerda;
     }
-    
-    if (no == NULL) return NULL;
-    
-    NoArvore *sucessor = encontrar_sucessor(no);
-    return sucessor ? sucessor->segmento : NULL;
+    return escolhido ? escolhido->segmento : NULL;
 }
 
 int arvore_vazia(ArvoreSegmentos arvore)
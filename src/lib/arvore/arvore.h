@@ -27,6 +27,13 @@ typedef void* ArvoreSegmentos;
  */
 ArvoreSegmentos arvore_criar(Ponto origem);
 
+/**
+ * Como arvore_criar, mas os nós vêm da arena (NULL usa malloc). Nós
+ * removidos voltam a uma lista livre da própria árvore; a memória só é
+ * devolvida no reset da arena, que deve acontecer após arvore_destruir.
+ */
+ArvoreSegmentos arvore_criar_em(Ponto origem, Arena arena);
+
 /**
  * Destroi a árvore de segmentos.
  * @param arvore Árvore a ser destruída
@@ -83,6 +90,18 @@ Segmento arvore_obter_primeiro(ArvoreSegmentos arvore);
  */
 Segmento arvore_obter_proximo(ArvoreSegmentos arvore, Segmento seg);
 
+/**
+ * Dentre segmentos empatados na menor distância, obtém aquele que
+ * arvore_obter_primeiro() escolheria (o primeiro na ordem de visita da árvore).
+ * Permite reproduzir o resultado de arvore_obter_primeiro() quando as
+ * distâncias foram calculadas fora da árvore (ex.: varredura setorial).
+ * @param arvore Árvore de segmentos
+ * @param candidatos Segmentos empatados (todos presentes na árvore)
+ * @param n Quantidade de candidatos
+ * @return O candidato escolhido, ou NULL se nenhum estiver na árvore
+ */
+Segmento arvore_primeiro_dentre(ArvoreSegmentos arvore, Segmento *candidatos, int n);
+
 /**
  * Verifica se a árvore está vazia.
  * @param arvore Árvore de segmentos
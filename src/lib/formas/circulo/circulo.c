@@ -1,20 +1,12 @@
-
 #include "circulo.h"
-#include "../../utils/utils.h"
+#include "../registro.h"
 #include <stdlib.h>
 #include <string.h>
+
 /**
- * Internal Circle structure
+ * A circle is a RegistroForma tagged CIRCLE; see registro.h
  */
-struct Circulo
-{
-    int id;
-    double x;
-    double y;
-    double radius;
-    char *border_color;
-    char *fill_color;
-};
+#define C(circulo) ((RegistroForma *)(circulo))
 
 void *circulo_criar(int id, double x, double y, double raio,
                     const char *cor_borda, const char *cor_preenchimento)
@@ -24,100 +16,74 @@ void *circulo_criar(int id, double x, double y, double raio,
         return NULL;
     }
 
-    struct Circulo *circulo = malloc(sizeof(struct Circulo));
+    RegistroForma *circulo = registro_criar(CIRCLE, id, cor_borda, cor_preenchimento);
     if (!circulo)
     {
         return NULL;
     }
 
-    circulo->id = id;
-    circulo->x = x;
-    circulo->y = y;
-    circulo->radius = raio;
-
-    circulo->border_color = duplicate_string(cor_borda);
-    if (!circulo->border_color)
-    {
-        free(circulo);
-        return NULL;
-    }
-
-    circulo->fill_color = duplicate_string(cor_preenchimento);
-    if (!circulo->fill_color)
-    {
-        free(circulo->border_color);
-        free(circulo);
-        return NULL;
-    }
+    circulo->u.circulo.x = x;
+    circulo->u.circulo.y = y;
+    circulo->u.circulo.raio = raio;
 
     return circulo;
 }
 
 void circulo_destruir(void *circulo)
 {
-    if (!circulo)
-        return;
-
-    struct Circulo *c = (struct Circulo *)circulo;
-    free(c->border_color);
-    free(c->fill_color);
-    free(c);
+    registro_destruir(C(circulo));
 }
 
 int circulo_get_id(void *circulo)
 {
     if (!circulo)
         return -1;
-    return ((struct Circulo *)circulo)->id;
+    return C(circulo)->id;
 }
 
 double circulo_get_x(void *circulo)
 {
     if (!circulo)
         return 0.0;
-    return ((struct Circulo *)circulo)->x;
+    return C(circulo)->u.circulo.x;
 }
 
 double circulo_get_y(void *circulo)
 {
     if (!circulo)
         return 0.0;
-    return ((struct Circulo *)circulo)->y;
+    return C(circulo)->u.circulo.y;
 }
 
 double circulo_get_raio(void *circulo)
 {
     if (!circulo)
         return 0.0;
-    return ((struct Circulo *)circulo)->radius;
+    return C(circulo)->u.circulo.raio;
 }
 
 const char *circulo_get_cor_borda(void *circulo)
 {
     if (!circulo)
         return NULL;
-    return ((struct Circulo *)circulo)->border_color;
+    return interno_texto(C(circulo)->cor_borda);
 }
 
 const char *circulo_get_cor_preenchimento(void *circulo)
 {
     if (!circulo)
         return NULL;
-    return ((struct Circulo *)circulo)->fill_color;
+    return interno_texto(C(circulo)->cor_preenchimento);
 }
 
 void circulo_set_cor_borda(void *circulo, const char *cor)
 {
     if (!circulo || !cor) return;
-    struct Circulo *c = (struct Circulo *)circulo;
-    if (c->border_color) free(c->border_color);
-    c->border_color = duplicate_string(cor);
+    registro_set_cor(&C(circulo)->cor_borda, cor);
 }
 
 void circulo_set_cor_preenchimento(void *circulo, const char *cor)
 {
     if (!circulo || !cor) return;
-    struct Circulo *c = (struct Circulo *)circulo;
-    if (c->fill_color) free(c->fill_color);
-    c->fill_color = duplicate_string(cor);
-}
\ No newline at end of file
+    registro_set_cor(&C(circulo)->cor_preenchimento, cor);
+}
@@ -1,20 +1,12 @@
 #include "linha.h"
-#include "../../utils/utils.h"
+#include "../registro.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * Internal Line structure
+ * A line is a RegistroForma tagged LINE; its color is cor_borda
  */
-struct Line
-{
-    int id;
-    double x1;
-    double y1;
-    double x2;
-    double y2;
-    char *color;
-};
+#define L(line) ((RegistroForma *)(line))
 
 void *line_create(int id, double x1, double y1, double x2, double y2,
                   const char *color)
@@ -24,84 +16,69 @@ void *line_create(int id, double x1, double y1, double x2, double y2,
         return NULL;
     }
 
-    struct Line *line = malloc(sizeof(struct Line));
+    RegistroForma *line = registro_criar(LINE, id, color, NULL);
     if (!line)
     {
         return NULL;
     }
 
-    line->id = id;
-    line->x1 = x1;
-    line->y1 = y1;
-    line->x2 = x2;
-    line->y2 = y2;
-
-    line->color = duplicate_string(color);
-    if (!line->color)
-    {
-        free(line);
-        return NULL;
-    }
+    line->u.linha.x1 = x1;
+    line->u.linha.y1 = y1;
+    line->u.linha.x2 = x2;
+    line->u.linha.y2 = y2;
 
     return line;
 }
 
 void line_destroy(void *line)
 {
-    if (!line)
-        return;
-
-    struct Line *l = (struct Line *)line;
-    free(l->color);
-    free(l);
+    registro_destruir(L(line));
 }
 
 int line_get_id(void *line)
 {
     if (!line)
         return -1;
-    return ((struct Line *)line)->id;
+    return L(line)->id;
 }
 
 double line_get_x1(void *line)
 {
     if (!line)
         return 0.0;
-    return ((struct Line *)line)->x1;
+    return L(line)->u.linha.x1;
 }
 
 double line_get_y1(void *line)
 {
     if (!line)
         return 0.0;
-    return ((struct Line *)line)->y1;
+    return L(line)->u.linha.y1;
 }
 
 double line_get_x2(void *line)
 {
     if (!line)
         return 0.0;
-    return ((struct Line *)line)->x2;
+    return L(line)->u.linha.x2;
 }
 
 double line_get_y2(void *line)
 {
     if (!line)
         return 0.0;
-    return ((struct Line *)line)->y2;
+    return L(line)->u.linha.y2;
 }
 
 const char *line_get_color(void *line)
 {
     if (!line)
         return NULL;
-    return ((struct Line *)line)->color;
+    return interno_texto(L(line)->cor_borda);
 }
 
 void line_set_color(void *line, const char *color)
 {
     if (!line || !color) return;
-    struct Line *l = (struct Line *)line;
-    if (l->color) free(l->color);
-    l->color = duplicate_string(color);
-}
\ No newline at end of file
+    registro_set_cor(&L(line)->cor_borda, color);
+}
@@ -0,0 +1,101 @@
+#include "registro.h"
+#include <stdlib.h>
+#include <string.h>
+
+RegistroForma *registro_criar(TipoForma tipo, int id, const char *cor_borda,
+                              const char *cor_preenchimento)
+{
+    if (!cor_borda)
+    {
+        return NULL;
+    }
+
+    RegistroForma *r = calloc(1, sizeof(RegistroForma));
+    if (!r)
+    {
+        return NULL;
+    }
+
+    r->tipo = tipo;
+    r->id = id;
+    r->cor_borda = interno_registrar(cor_borda);
+    r->cor_preenchimento = interno_registrar(cor_preenchimento);
+
+    if (r->cor_borda == STRING_NENHUMA ||
+        (cor_preenchimento && r->cor_preenchimento == STRING_NENHUMA))
+    {
+        free(r);
+        return NULL;
+    }
+
+    return r;
+}
+
+void registro_liberar(RegistroForma *r)
+{
+    if (!r)
+        return;
+
+    if (r->tipo == TEXT)
+    {
+        free(r->u.texto.conteudo);
+        r->u.texto.conteudo = NULL;
+    }
+}
+
+void registro_destruir(RegistroForma *r)
+{
+    if (!r)
+        return;
+
+    registro_liberar(r);
+    free(r);
+}
+
+void registro_set_cor(IdString *campo, const char *cor)
+{
+    if (!campo || !cor)
+        return;
+
+    IdString id = interno_registrar(cor);
+    if (id != STRING_NENHUMA)
+        *campo = id;
+}
+
+void registro_caixa(const RegistroForma *r, double *x1, double *y1, double *x2, double *y2)
+{
+    double a = 0, b = 0, c = 0, d = 0;
+
+    switch (r->tipo)
+    {
+    case CIRCLE:
+        a = r->u.circulo.x - r->u.circulo.raio;
+        b = r->u.circulo.y - r->u.circulo.raio;
+        c = r->u.circulo.x + r->u.circulo.raio;
+        d = r->u.circulo.y + r->u.circulo.raio;
+        break;
+    case RECTANGLE:
+        a = r->u.retangulo.x;
+        b = r->u.retangulo.y;
+        c = a + r->u.retangulo.largura;
+        d = b + r->u.retangulo.altura;
+        break;
+    case LINE:
+        a = (r->u.linha.x1 < r->u.linha.x2) ? r->u.linha.x1 : r->u.linha.x2;
+        c = (r->u.linha.x1 > r->u.linha.x2) ? r->u.linha.x1 : r->u.linha.x2;
+        b = (r->u.linha.y1 < r->u.linha.y2) ? r->u.linha.y1 : r->u.linha.y2;
+        d = (r->u.linha.y1 > r->u.linha.y2) ? r->u.linha.y1 : r->u.linha.y2;
+        break;
+    case TEXT:
+        a = c = r->u.texto.x;
+        b = d = r->u.texto.y;
+        break;
+    default:
+        break;
+    }
+
+    *x1 = a;
+    *y1 = b;
+    *x2 = c;
+    *y2 = d;
+}
@@ -0,0 +1,61 @@
+/**
+ * Shape record - compact tagged union shared by all shape ADTs
+ *
+ * Circulo, Retangulo, Line and Text handles all point to a RegistroForma.
+ * Standalone shapes (x_create / x_criar) own a heap record; the Geo store
+ * keeps records by value and hands out pointers into its storage, so the
+ * per-shape getters stay thin views over the same layout.
+ *
+ * Internal header: only the shape modules and the shape store include it.
+ */
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include "formas.h"
+#include "../utils/interno/interno.h"
+
+typedef struct
+{
+    TipoForma tipo;
+    int id;
+    IdString cor_borda;         /* Linha: cor do traço */
+    IdString cor_preenchimento; /* STRING_NENHUMA em linhas */
+    union
+    {
+        struct { double x, y, raio; } circulo;
+        struct { double x, y, largura, altura; } retangulo;
+        struct { double x1, y1, x2, y2; } linha;
+        struct { double x, y; char *conteudo; char ancora; } texto;
+    } u;
+} RegistroForma;
+
+/**
+ * Allocates a record with its colours interned
+ * @param cor_preenchimento May be NULL (lines)
+ * @return New record or NULL on error
+ */
+RegistroForma *registro_criar(TipoForma tipo, int id, const char *cor_borda,
+                              const char *cor_preenchimento);
+
+/**
+ * Frees what the record owns (the text content), but not the record itself
+ * (used by stores that keep records by value)
+ */
+void registro_liberar(RegistroForma *r);
+
+/**
+ * Frees the record and everything it owns
+ */
+void registro_destruir(RegistroForma *r);
+
+/**
+ * Points one of the record's colour fields at the interned cor
+ */
+void registro_set_cor(IdString *campo, const char *cor);
+
+/**
+ * Axis-aligned bounding box of the record's geometry
+ */
+void registro_caixa(const RegistroForma *r, double *x1, double *y1, double *x2, double *y2);
+
+#endif // REGISTRO_H
@@ -1,21 +1,12 @@
 #include "retangulo.h"
-#include "../../utils/utils.h"
+#include "../registro.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * Internal Rectangle structure
+ * A rectangle is a RegistroForma tagged RECTANGLE; see registro.h
  */
-struct Retangulo
-{
-    int id;
-    double x;
-    double y;
-    double width;
-    double height;
-    char *border_color;
-    char *fill_color;
-};
+#define R(retangulo) ((RegistroForma *)(retangulo))
 
 void *retangulo_criar(int id, double x, double y, double largura, double altura,
                       const char *cor_borda, const char *cor_preenchimento)
@@ -25,108 +16,82 @@ void *retangulo_criar(int id, double x, double y, double largura, double altura,
         return NULL;
     }
 
-    struct Retangulo *retangulo = malloc(sizeof(struct Retangulo));
+    RegistroForma *retangulo = registro_criar(RECTANGLE, id, cor_borda, cor_preenchimento);
     if (!retangulo)
     {
         return NULL;
     }
 
-    retangulo->id = id;
-    retangulo->x = x;
-    retangulo->y = y;
-    retangulo->width = largura;
-    retangulo->height = altura;
-
-    retangulo->border_color = duplicate_string(cor_borda);
-    if (!retangulo->border_color)
-    {
-        free(retangulo);
-        return NULL;
-    }
-
-    retangulo->fill_color = duplicate_string(cor_preenchimento);
-    if (!retangulo->fill_color)
-    {
-        free(retangulo->border_color);
-        free(retangulo);
-        return NULL;
-    }
+    retangulo->u.retangulo.x = x;
+    retangulo->u.retangulo.y = y;
+    retangulo->u.retangulo.largura = largura;
+    retangulo->u.retangulo.altura = altura;
 
     return retangulo;
 }
 
 void retangulo_destruir(void *retangulo)
 {
-    if (!retangulo)
-        return;
-
-    struct Retangulo *r = (struct Retangulo *)retangulo;
-    free(r->border_color);
-    free(r->fill_color);
-    free(r);
+    registro_destruir(R(retangulo));
 }
 
 int retangulo_get_id(void *retangulo)
 {
     if (!retangulo)
         return -1;
-    return ((struct Retangulo *)retangulo)->id;
+    return R(retangulo)->id;
 }
 
 double retangulo_get_x(void *retangulo)
 {
     if (!retangulo)
         return 0.0;
-    return ((struct Retangulo *)retangulo)->x;
+    return R(retangulo)->u.retangulo.x;
 }
 
 double retangulo_get_y(void *retangulo)
 {
     if (!retangulo)
         return 0.0;
-    return ((struct Retangulo *)retangulo)->y;
+    return R(retangulo)->u.retangulo.y;
 }
 
 double retangulo_get_largura(void *retangulo)
 {
     if (!retangulo)
         return 0.0;
-    return ((struct Retangulo *)retangulo)->width;
+    return R(retangulo)->u.retangulo.largura;
 }
 
 double retangulo_get_altura(void *retangulo)
 {
     if (!retangulo)
         return 0.0;
-    return ((struct Retangulo *)retangulo)->height;
+    return R(retangulo)->u.retangulo.altura;
 }
 
 const char *retangulo_get_cor_borda(void *retangulo)
 {
     if (!retangulo)
         return NULL;
-    return ((struct Retangulo *)retangulo)->border_color;
+    return interno_texto(R(retangulo)->cor_borda);
 }
 
 const char *retangulo_get_cor_preenchimento(void *retangulo)
 {
     if (!retangulo)
         return NULL;
-    return ((struct Retangulo *)retangulo)->fill_color;
+    return interno_texto(R(retangulo)->cor_preenchimento);
 }
 
 void retangulo_set_cor_borda(void *retangulo, const char *cor)
 {
     if (!retangulo || !cor) return;
-    struct Retangulo *r = (struct Retangulo *)retangulo;
-    if (r->border_color) free(r->border_color);
-    r->border_color = duplicate_string(cor);
+    registro_set_cor(&R(retangulo)->cor_borda, cor);
 }
 
 void retangulo_set_cor_preenchimento(void *retangulo, const char *cor)
 {
     if (!retangulo || !cor) return;
-    struct Retangulo *r = (struct Retangulo *)retangulo;
-    if (r->fill_color) free(r->fill_color);
-    r->fill_color = duplicate_string(cor);
-}
\ No newline at end of file
+    registro_set_cor(&R(retangulo)->cor_preenchimento, cor);
+}
@@ -1,5 +1,5 @@
 #include "text_style.h"
-#include "../../utils/utils.h"
+#include "../../utils/interno/interno.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -8,7 +8,7 @@
  */
 struct TextStyle
 {
-    char *font_family;
+    IdString font_family;   /* Interned: styles share family strings */
     char font_weight;
     int font_size;
 };
@@ -30,8 +30,8 @@ void *text_style_create(const char *font_family, char font_weight,
     text_style->font_weight = font_weight;
     text_style->font_size = font_size;
 
-    text_style->font_family = duplicate_string(font_family);
-    if (!text_style->font_family)
+    text_style->font_family = interno_registrar(font_family);
+    if (text_style->font_family == STRING_NENHUMA)
     {
         free(text_style);
         return NULL;
@@ -46,7 +46,6 @@ void text_style_destroy(void *text_style)
         return;
 
     struct TextStyle *ts = (struct TextStyle *)text_style;
-    free(ts->font_family);
     free(ts);
 }
 
@@ -54,7 +53,7 @@ const char *text_style_get_font_family(void *text_style)
 {
     if (!text_style)
         return NULL;
-    return ((struct TextStyle *)text_style)->font_family;
+    return interno_texto(((struct TextStyle *)text_style)->font_family);
 }
 
 char text_style_get_font_weight(void *text_style)
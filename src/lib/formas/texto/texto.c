@@ -1,21 +1,13 @@
 #include "texto.h"
+#include "../registro.h"
 #include "../../utils/utils.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * Internal Text structure
+ * A text is a RegistroForma tagged TEXT; see registro.h
  */
-struct Text
-{
-    int id;
-    double x;
-    double y;
-    char *border_color;
-    char *fill_color;
-    char anchor;
-    char *text;
-};
+#define T(text) ((RegistroForma *)(text))
 
 void *text_create(int id, double x, double y, const char *border_color,
                   const char *fill_color, char anchor, const char *text)
@@ -25,38 +17,20 @@ void *text_create(int id, double x, double y, const char *border_color,
         return NULL;
     }
 
-    struct Text *t = malloc(sizeof(struct Text));
+    RegistroForma *t = registro_criar(TEXT, id, border_color, fill_color);
     if (!t)
     {
         return NULL;
     }
 
-    t->id = id;
-    t->x = x;
-    t->y = y;
-    t->anchor = anchor;
-
-    t->border_color = duplicate_string(border_color);
-    if (!t->border_color)
-    {
-        free(t);
-        return NULL;
-    }
-
-    t->fill_color = duplicate_string(fill_color);
-    if (!t->fill_color)
-    {
-        free(t->border_color);
-        free(t);
-        return NULL;
-    }
+    t->u.texto.x = x;
+    t->u.texto.y = y;
+    t->u.texto.ancora = anchor;
 
-    t->text = duplicate_string(text);
-    if (!t->text)
+    t->u.texto.conteudo = duplicate_string(text);
+    if (!t->u.texto.conteudo)
     {
-        free(t->border_color);
-        free(t->fill_color);
-        free(t);
+        registro_destruir(t);
         return NULL;
     }
 
@@ -65,87 +39,75 @@ void *text_create(int id, double x, double y, const char *border_color,
 
 void text_destroy(void *text)
 {
-    if (!text)
-        return;
-
-    struct Text *t = (struct Text *)text;
-    free(t->border_color);
-    free(t->fill_color);
-    free(t->text);
-    free(t);
+    registro_destruir(T(text));
 }
 
 int text_get_id(void *text)
 {
     if (!text)
         return -1;
-    return ((struct Text *)text)->id;
+    return T(text)->id;
 }
 
 double text_get_x(void *text)
 {
     if (!text)
         return 0.0;
-    return ((struct Text *)text)->x;
+    return T(text)->u.texto.x;
 }
 
 double text_get_y(void *text)
 {
     if (!text)
         return 0.0;
-    return ((struct Text *)text)->y;
+    return T(text)->u.texto.y;
 }
 
 const char *text_get_border_color(void *text)
 {
     if (!text)
         return NULL;
-    return ((struct Text *)text)->border_color;
+    return interno_texto(T(text)->cor_borda);
 }
 
 const char *text_get_fill_color(void *text)
 {
     if (!text)
         return NULL;
-    return ((struct Text *)text)->fill_color;
+    return interno_texto(T(text)->cor_preenchimento);
 }
 
 char text_get_anchor(void *text)
 {
     if (!text)
         return '\0';
-    return ((struct Text *)text)->anchor;
+    return T(text)->u.texto.ancora;
 }
 
 const char *text_get_text(void *text)
 {
     if (!text)
         return NULL;
-    return ((struct Text *)text)->text;
+    return T(text)->u.texto.conteudo;
 }
 
 int text_get_length(void *text)
 {
     if (!text)
         return -1;
-    struct Text *t = (struct Text *)text;
-    if (!t->text)
+    if (!T(text)->u.texto.conteudo)
         return 0;
-    return (int)strlen(t->text);
+    return (int)strlen(T(text)->u.texto.conteudo);
 }
 
 void text_set_border_color(void *text, const char *color)
 {
     if (!text || !color) return;
-    struct Text *t = (struct Text *)text;
-    if (t->border_color) free(t->border_color);
-    t->border_color = duplicate_string(color);
+    registro_set_cor(&T(text)->cor_borda, color);
 }
 
 void text_set_fill_color(void *text, const char *color)
 {
     if (!text || !color) return;
-    struct Text *t = (struct Text *)text;
-    if (t->fill_color) free(t->fill_color);
-    t->fill_color = duplicate_string(color);
-}
\ No newline at end of file
+    registro_set_cor(&T(text)->cor_preenchimento, color);
+}
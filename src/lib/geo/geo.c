@@ -4,38 +4,586 @@
 #include <string.h>
 #include <float.h>
 #include <math.h>
+#include <limits.h>
 #include "../formas/circulo/circulo.h"
 #include "../formas/retangulo/retangulo.h"
 #include "../formas/linha/linha.h"
 #include "../formas/texto/texto.h"
 #include "../formas/formas.h"
+#include "../formas/registro.h"
 #include "../utils/lista/lista.h"
+#include "../utils/vetor/vetor.h"
 #include "../geometria/ponto/ponto.h"
 #include "../geometria/segmento/segmento.h"
+#include "../geometria/calculos/calculos.h"
 
+/* Elemento da visão legada em lista (geo_get_formas) */
 typedef struct {
     TipoForma tipo;
     void *forma;
 } ElementoGeo;
 
+/* Entrada do índice por id. slot < 0 marca uma forma já removida. */
+typedef struct {
+    int id;
+    int slot;
+} EntradaId;
+
+// Inserções fora de ordem toleradas antes de reordenar o índice
+#define PENDENTES_MIN 64
+// Trechos ordenados que a cauda de pendentes pode ter (ver trechos_acomodar)
+#define MAX_TRECHOS 64
+// Compacta o slab quando mais de 1/4 das posições (e ao menos isto) são lápides
+#define LAPIDES_MIN 64
+// Formas que cobririam mais células que isto ficam fora da grade de baldes
+#define REGIAO_MAX_CELULAS 64
+// Lado máximo da grade de baldes, em células
+#define REGIAO_MAX_LADO 2048
+
+#define LAPIDE_TESTAR(mapa, i) (((mapa)[(i) >> 3] >> ((i) & 7)) & 1)
+#define LAPIDE_MARCAR(mapa, i) ((mapa)[(i) >> 3] |= (unsigned char)(1u << ((i) & 7)))
+
 struct Geo_st {
-    LinkedList formas;
+    /* Slab: formas na ordem de inserção; posições removidas ficam marcadas
+     * no mapa de lápides até a próxima compactação */
+    RegistroForma *slab;
+    unsigned char *lapides;
+    int num_slots, cap_slots;
+    int num_removidas;
+    /* Índice por id: [0, num_ordenadas) ordenado por (id, slot); o restante
+     * são inserções recentes, em trechos ordenados que começam em
+     * inicio_trecho[] (cauda_desordenada: os trechos se perderam por falta
+     * de memória e a cauda é lida por inteiro até a próxima normalização) */
+    EntradaId *indice;
+    int num_indice, cap_indice;
+    int num_ordenadas;
+    int num_lapides;
+    int inicio_trecho[MAX_TRECHOS];
+    int num_trechos;
+    int cauda_desordenada;
+    EntradaId *aux;
+    int cap_aux;
+    /* Índice por região: grade uniforme de baldes sobre as caixas das formas,
+     * montada na primeira consulta. Cada célula é uma lista encadeada de
+     * entradas (regiao_slot, regiao_prox); formas grandes ficam em
+     * regiao_grandes. Inserções entram nas células da sua caixa (presas à
+     * borda); remoções ficam até a remontagem, que ocorre na compactação do
+     * slab ou quando as entradas dobram */
+    int regiao_montada;
+    int regiao_cols, regiao_lins;
+    double regiao_x0, regiao_y0, regiao_tam;
+    int *regiao_cabeca;
+    int *regiao_slot, *regiao_prox;
+    int regiao_num, regiao_cap, regiao_num_montagem;
+    int *regiao_grandes;
+    int num_grandes, cap_grandes;
+    /* Visão em lista para geo_get_formas; refeita na próxima chamada depois
+     * de uma alteração (suja) */
+    LinkedList visao;
+    ElementoGeo *elementos_visao;
+    int visao_suja;
+    /* Muda a cada anteparo inserido ou removido (ver geo_versao_barreiras) */
+    unsigned long versao;
 };
 
 Geo geo_criar() {
-    struct Geo_st *g = malloc(sizeof(struct Geo_st));
-    if (g) {
-        g->formas = list_create();
+    return calloc(1, sizeof(struct Geo_st));
+}
+
+static int slot_vivo(struct Geo_st *g, int slot) {
+    return !LAPIDE_TESTAR(g->lapides, slot);
+}
+
+/* Mesmo critério de geo_obter_todas_barreiras: linhas com id >= 5000 */
+static int eh_anteparo(const RegistroForma *r) {
+    return r->tipo == LINE && r->id >= 5000;
+}
+
+/* Refaz a visão em lista; os ponteiros apontam para o slab, que pode mudar
+ * de endereço a cada inserção ou compactação. Sem memória, a lista antiga
+ * fica como estava e a visão continua suja. */
+static void sincronizar_visao(struct Geo_st *g) {
+    ElementoGeo *elementos = realloc(g->elementos_visao, (g->num_slots + 1) * sizeof(ElementoGeo));
+    if (elementos == NULL) return;
+    g->elementos_visao = elementos;
+    g->visao_suja = 0;
+    while (!list_is_empty(g->visao)) list_remove_front(g->visao);
+    for (int i = 0; i < g->num_slots; i++) {
+        if (!slot_vivo(g, i)) continue;
+        elementos[i].tipo = g->slab[i].tipo;
+        elementos[i].forma = &g->slab[i];
+        list_insert_back(g->visao, &elementos[i]);
+    }
+}
+
+/* ============================================================================
+ * Índice por Id
+ * ============================================================================ */
+
+static int comparar_entradas(const void *a, const void *b) {
+    const EntradaId *x = (const EntradaId *)a, *y = (const EntradaId *)b;
+    if (x->id != y->id) return (x->id > y->id) - (x->id < y->id);
+    return (x->slot > y->slot) - (x->slot < y->slot);
+}
+
+static int comparar_slot(const void *a, const void *b) {
+    const EntradaId *x = (const EntradaId *)a, *y = (const EntradaId *)b;
+    return (x->slot > y->slot) - (x->slot < y->slot);
+}
+
+/* Ordena as inserções pendentes, intercala com o prefixo ordenado e
+ * descarta as lápides. O(n) mais a ordenação das pendentes. */
+static void indice_normalizar(struct Geo_st *g) {
+    int pendentes = g->num_indice - g->num_ordenadas;
+    if (pendentes == 0 && g->num_lapides == 0) {
+        g->num_trechos = 0;
+        g->cauda_desordenada = 0;
+        return;
+    }
+
+    EntradaId *novo = malloc((g->num_indice + 1) * sizeof(EntradaId));
+    if (novo == NULL) return;
+
+    EntradaId *cauda = g->indice + g->num_ordenadas;
+    qsort(cauda, pendentes, sizeof(EntradaId), comparar_entradas);
+
+    int i = 0, j = 0, k = 0;
+    while (i < g->num_ordenadas || j < pendentes) {
+        EntradaId *e;
+        if (j >= pendentes || (i < g->num_ordenadas && comparar_entradas(&g->indice[i], &cauda[j]) <= 0)) {
+            e = &g->indice[i++];
+        } else {
+            e = &cauda[j++];
+        }
+        if (e->slot >= 0) novo[k++] = *e;
+    }
+
+    free(g->indice);
+    g->indice = novo;
+    g->num_indice = g->num_ordenadas = k;
+    g->cap_indice = g->num_indice + 1;
+    g->num_lapides = 0;
+    g->num_trechos = 0;
+    g->cauda_desordenada = 0;
+}
+
+/* Garante espaço para mais uma entrada; 0 se faltar memória */
+static int indice_reservar(struct Geo_st *g) {
+    if (g->num_indice < g->cap_indice) return 1;
+    int nova_cap = g->cap_indice ? 2 * g->cap_indice : 64;
+    EntradaId *novo = realloc(g->indice, nova_cap * sizeof(EntradaId));
+    if (novo == NULL) return 0;
+    g->indice = novo;
+    g->cap_indice = nova_cap;
+    return 1;
+}
+
+/* Intercala os dois últimos trechos pendentes; 0 se faltar memória */
+static int trechos_intercalar(struct Geo_st *g) {
+    int a = g->inicio_trecho[g->num_trechos - 2];
+    int b = g->inicio_trecho[g->num_trechos - 1];
+    int n = b - a;
+    if (n > g->cap_aux) {
+        int nova_cap = g->cap_aux ? g->cap_aux : 64;
+        while (nova_cap < n) nova_cap *= 2;
+        EntradaId *novo = realloc(g->aux, nova_cap * sizeof(EntradaId));
+        if (novo == NULL) return 0;
+        g->aux = novo;
+        g->cap_aux = nova_cap;
+    }
+    memcpy(g->aux, g->indice + a, n * sizeof(EntradaId));
+
+    int i = 0, j = b, k = a;
+    while (i < n && j < g->num_indice) {
+        if (comparar_entradas(&g->indice[j], &g->aux[i]) < 0) g->indice[k++] = g->indice[j++];
+        else g->indice[k++] = g->aux[i++];
+    }
+    while (i < n) g->indice[k++] = g->aux[i++];
+    g->num_trechos--;
+    return 1;
+}
+
+/* A última entrada do índice vira um trecho de tamanho 1; trechos vizinhos
+ * são intercalados enquanto o anterior não for maior (contador binário),
+ * então a cauda tem O(log n) trechos e cada entrada é copiada O(log n) vezes */
+static void trechos_acomodar(struct Geo_st *g) {
+    if (g->cauda_desordenada) return;
+    if (g->num_trechos == MAX_TRECHOS) {
+        g->cauda_desordenada = 1;
+        return;
+    }
+    g->inicio_trecho[g->num_trechos++] = g->num_indice - 1;
+    while (g->num_trechos >= 2) {
+        int ultimo = g->num_indice - g->inicio_trecho[g->num_trechos - 1];
+        int anterior = g->inicio_trecho[g->num_trechos - 1] - g->inicio_trecho[g->num_trechos - 2];
+        if (anterior > ultimo) break;
+        if (!trechos_intercalar(g)) {
+            g->cauda_desordenada = 1;
+            break;
+        }
+    }
+}
+
+/* Chamar só depois de indice_reservar() */
+static void indice_adicionar(struct Geo_st *g, int id, int slot) {
+    EntradaId *e = &g->indice[g->num_indice++];
+    e->id = id;
+    e->slot = slot;
+    trechos_acomodar(g);
+}
+
+/* Primeira posição de indice[ini, fim) (ordenado) com entrada >= (id, slot) */
+static int busca_limite_inferior(const EntradaId *v, int ini, int fim, int id, int slot) {
+    EntradaId chave = { id, slot };
+    while (ini < fim) {
+        int meio = ini + (fim - ini) / 2;
+        if (comparar_entradas(&v[meio], &chave) < 0) ini = meio + 1;
+        else fim = meio;
+    }
+    return ini;
+}
+
+/* Primeira posição do prefixo ordenado com entrada >= (id, slot) */
+static int indice_limite_inferior(struct Geo_st *g, int id, int slot) {
+    return busca_limite_inferior(g->indice, 0, g->num_ordenadas, id, slot);
+}
+
+/* Junta a achadas as entradas vivas de indice[ini, fim) (ordenado) com id
+ * em [id_ini, id_fim]; 0 se faltar memória */
+static int coletar_no_trecho(struct Geo_st *g, int ini, int fim, int id_ini, int id_fim, Vetor achadas) {
+    for (int i = busca_limite_inferior(g->indice, ini, fim, id_ini, INT_MIN);
+         i < fim && g->indice[i].id <= id_fim; i++) {
+        if (g->indice[i].slot < 0) continue;
+        if (vetor_inserir(achadas, &g->indice[i]) == NULL) return 0;
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * Índice por região
+ * ============================================================================ */
+
+/* Célula de v numa grade de n células a partir de origem; fora dela, presa à borda */
+static int regiao_coluna(double v, double origem, double tam, int n) {
+    double c = floor((v - origem) / tam);
+    if (!(c >= 0)) return 0;
+    if (c >= n) return n - 1;
+    return (int)c;
+}
+
+/* Põe o slot nas células da sua caixa; 0 se faltar memória */
+static int regiao_adicionar(struct Geo_st *g, int slot) {
+    RegistroForma *r = &g->slab[slot];
+    if (r->tipo == TEXT_STYLE) return 1;
+    double x1, y1, x2, y2;
+    registro_caixa(r, &x1, &y1, &x2, &y2);
+    int c1 = regiao_coluna(x1, g->regiao_x0, g->regiao_tam, g->regiao_cols);
+    int c2 = regiao_coluna(x2, g->regiao_x0, g->regiao_tam, g->regiao_cols);
+    int l1 = regiao_coluna(y1, g->regiao_y0, g->regiao_tam, g->regiao_lins);
+    int l2 = regiao_coluna(y2, g->regiao_y0, g->regiao_tam, g->regiao_lins);
+    long celulas = (long)(c2 - c1 + 1) * (l2 - l1 + 1);
+
+    if (celulas > REGIAO_MAX_CELULAS) {
+        if (g->num_grandes == g->cap_grandes) {
+            int nova_cap = g->cap_grandes ? 2 * g->cap_grandes : 16;
+            int *novo = realloc(g->regiao_grandes, nova_cap * sizeof(int));
+            if (novo == NULL) return 0;
+            g->regiao_grandes = novo;
+            g->cap_grandes = nova_cap;
+        }
+        g->regiao_grandes[g->num_grandes++] = slot;
+        return 1;
+    }
+
+    if (g->regiao_num + celulas > g->regiao_cap) {
+        int nova_cap = g->regiao_cap ? 2 * g->regiao_cap : 256;
+        while (nova_cap < g->regiao_num + celulas) nova_cap *= 2;
+        int *slots = realloc(g->regiao_slot, nova_cap * sizeof(int));
+        if (slots == NULL) return 0;
+        g->regiao_slot = slots;
+        int *prox = realloc(g->regiao_prox, nova_cap * sizeof(int));
+        if (prox == NULL) return 0;
+        g->regiao_prox = prox;
+        g->regiao_cap = nova_cap;
+    }
+    for (int l = l1; l <= l2; l++) {
+        for (int c = c1; c <= c2; c++) {
+            int e = g->regiao_num++;
+            int celula = l * g->regiao_cols + c;
+            g->regiao_slot[e] = slot;
+            g->regiao_prox[e] = g->regiao_cabeca[celula];
+            g->regiao_cabeca[celula] = e;
+        }
+    }
+    return 1;
+}
+
+/* Refaz a grade sobre a caixa das formas vivas, com cerca de uma forma por
+ * célula; 0 se faltar memória (a grade fica desmontada) */
+static int regiao_montar(struct Geo_st *g) {
+    g->regiao_montada = 0;
+    double mx = DBL_MAX, my = DBL_MAX, Mx = -DBL_MAX, My = -DBL_MAX;
+    int vivas = 0;
+    for (int i = 0; i < g->num_slots; i++) {
+        if (!slot_vivo(g, i) || g->slab[i].tipo == TEXT_STYLE) continue;
+        double x1, y1, x2, y2;
+        registro_caixa(&g->slab[i], &x1, &y1, &x2, &y2);
+        if (x1 < mx) mx = x1;
+        if (y1 < my) my = y1;
+        if (x2 > Mx) Mx = x2;
+        if (y2 > My) My = y2;
+        vivas++;
+    }
+    if (vivas == 0) {
+        mx = my = 0;
+        Mx = My = 1;
+        vivas = 1;
+    }
+
+    double w = Mx - mx, h = My - my;
+    double tam = sqrt(w * h / vivas);
+    if (!(tam > 0)) tam = ((w > h) ? w : h) / vivas;
+    if (!(tam > 0)) tam = 1;
+    if (w / tam > REGIAO_MAX_LADO) tam = w / REGIAO_MAX_LADO;
+    if (h / tam > REGIAO_MAX_LADO) tam = h / REGIAO_MAX_LADO;
+    int cols = (int)(w / tam) + 1;
+    int lins = (int)(h / tam) + 1;
+
+    int *cabeca = realloc(g->regiao_cabeca, (size_t)cols * lins * sizeof(int));
+    if (cabeca == NULL) return 0;
+    for (long i = 0; i < (long)cols * lins; i++) cabeca[i] = -1;
+    g->regiao_cabeca = cabeca;
+    g->regiao_cols = cols;
+    g->regiao_lins = lins;
+    g->regiao_x0 = mx;
+    g->regiao_y0 = my;
+    g->regiao_tam = tam;
+    g->regiao_num = 0;
+    g->num_grandes = 0;
+
+    for (int i = 0; i < g->num_slots; i++) {
+        if (slot_vivo(g, i) && !regiao_adicionar(g, i)) return 0;
+    }
+    g->regiao_num_montagem = g->regiao_num + g->num_grandes;
+    g->regiao_montada = 1;
+    return 1;
+}
+
+/* Junta a achadas o slot se a forma estiver viva e sua caixa tocar a região */
+static int regiao_testar(struct Geo_st *g, int slot, double x1, double y1, double x2, double y2,
+                         Vetor achadas) {
+    if (!slot_vivo(g, slot) || g->slab[slot].tipo == TEXT_STYLE) return 1;
+    double a, b, c, d;
+    registro_caixa(&g->slab[slot], &a, &b, &c, &d);
+    if (c < x1 || a > x2 || d < y1 || b > y2) return 1;
+    EntradaId e = { g->slab[slot].id, slot };
+    return vetor_inserir(achadas, &e) != NULL;
+}
+
+/* Entradas (id, slot) das formas cuja caixa toca [x1, x2] x [y1, y2], na
+ * ordem da cidade e sem repetição; NULL se faltar memória. Sem grade (falta
+ * de memória ao montar), percorre o slab. */
+static Vetor regiao_consultar(struct Geo_st *g, double x1, double y1, double x2, double y2) {
+    if (!g->regiao_montada || g->regiao_num + g->num_grandes > 2 * g->regiao_num_montagem + 256) {
+        regiao_montar(g);
+    }
+    Vetor achadas = vetor_criar(sizeof(EntradaId));
+    if (achadas == NULL) return NULL;
+
+    int ok = 1;
+    if (!g->regiao_montada) {
+        for (int i = 0; ok && i < g->num_slots; i++) ok = regiao_testar(g, i, x1, y1, x2, y2, achadas);
+    } else {
+        int c1 = regiao_coluna(x1, g->regiao_x0, g->regiao_tam, g->regiao_cols);
+        int c2 = regiao_coluna(x2, g->regiao_x0, g->regiao_tam, g->regiao_cols);
+        int l1 = regiao_coluna(y1, g->regiao_y0, g->regiao_tam, g->regiao_lins);
+        int l2 = regiao_coluna(y2, g->regiao_y0, g->regiao_tam, g->regiao_lins);
+        for (int l = l1; ok && l <= l2; l++) {
+            for (int c = c1; ok && c <= c2; c++) {
+                for (int e = g->regiao_cabeca[l * g->regiao_cols + c]; ok && e >= 0; e = g->regiao_prox[e]) {
+                    ok = regiao_testar(g, g->regiao_slot[e], x1, y1, x2, y2, achadas);
+                }
+            }
+        }
+        for (int i = 0; ok && i < g->num_grandes; i++) {
+            ok = regiao_testar(g, g->regiao_grandes[i], x1, y1, x2, y2, achadas);
+        }
+    }
+    if (!ok) {
+        vetor_destruir(achadas);
+        return NULL;
+    }
+
+    // Ordem da cidade; uma forma que cobre várias células aparece uma vez
+    vetor_ordenar(achadas, comparar_slot, ALG_QSORT, 0);
+    EntradaId *entradas = (EntradaId *)vetor_dados(achadas);
+    int n = vetor_tamanho(achadas), k = 0;
+    for (int i = 0; i < n; i++) {
+        if (k == 0 || entradas[i].slot != entradas[k - 1].slot) entradas[k++] = entradas[i];
+    }
+    vetor_truncar(achadas, k);
+    return achadas;
+}
+
+/* ============================================================================
+ * Slab
+ * ============================================================================ */
+
+/* Descarta as lápides do slab preservando a ordem e renumera o índice.
+ * O mapeamento de slots é crescente, então o índice continua ordenado. */
+static void compactar(struct Geo_st *g) {
+    int *novo_slot = malloc((g->num_slots + 1) * sizeof(int));
+    if (novo_slot == NULL) return;
+
+    int k = 0;
+    for (int i = 0; i < g->num_slots; i++) {
+        if (slot_vivo(g, i)) {
+            novo_slot[i] = k;
+            g->slab[k++] = g->slab[i];
+        } else {
+            novo_slot[i] = -1;
+        }
+    }
+    for (int i = 0; i < g->num_indice; i++) {
+        if (g->indice[i].slot >= 0) g->indice[i].slot = novo_slot[g->indice[i].slot];
+    }
+    free(novo_slot);
+
+    memset(g->lapides, 0, (g->cap_slots + 7) / 8);
+    g->num_slots = k;
+    g->num_removidas = 0;
+    // Os slots mudaram: a grade de baldes é refeita na próxima consulta
+    g->regiao_montada = 0;
+}
+
+/* Garante espaço no slab e no mapa de lápides para mais uma forma. A
+ * capacidade só muda quando os dois cresceram; 0 se faltar memória */
+static int slab_reservar(struct Geo_st *g) {
+    if (g->num_slots < g->cap_slots) return 1;
+    int nova_cap = g->cap_slots ? 2 * g->cap_slots : 64;
+    RegistroForma *novo = realloc(g->slab, nova_cap * sizeof(RegistroForma));
+    if (novo == NULL) return 0;
+    g->slab = novo;
+    unsigned char *mapa = realloc(g->lapides, (nova_cap + 7) / 8);
+    if (mapa == NULL) return 0;
+    memset(mapa + (g->cap_slots + 7) / 8, 0, (nova_cap + 7) / 8 - (g->cap_slots + 7) / 8);
+    g->lapides = mapa;
+    g->cap_slots = nova_cap;
+    return 1;
+}
+
+/* Move o registro para o fim do slab; o invólucro (alocado por
+ * circulo_criar etc.) é liberado, o conteúdo passa a ser da cidade.
+ * Sem memória, a forma é destruída e a cidade fica como estava. */
+static int inserir_forma(Geo geo, TipoForma tipo, void *objeto) {
+    struct Geo_st *g = (struct Geo_st *)geo;
+    RegistroForma *registro = (RegistroForma *)objeto;
+    if (registro == NULL) return 0;
+    // Etiqueta trocada pelo chamador: a forma é recusada
+    if (registro->tipo != tipo || !slab_reservar(g) || !indice_reservar(g)) {
+        registro_destruir(registro);
+        return 0;
+    }
+    int slot = g->num_slots++;
+    g->slab[slot] = *registro;
+    free(registro);
+    indice_adicionar(g, g->slab[slot].id, slot);
+    if (g->regiao_montada && !regiao_adicionar(g, slot)) g->regiao_montada = 0;
+    if (eh_anteparo(&g->slab[slot])) g->versao++;
+    g->visao_suja = 1;
+    return 1;
+}
+
+int geo_inserir_forma(Geo geo, TipoForma tipo, void *forma) {
+    if (geo == NULL || forma == NULL) return 0;
+    return inserir_forma(geo, tipo, forma);
+}
+
+void geo_para_cada(Geo geo, void (*fn)(TipoForma tipo, void *forma, void *contexto), void *contexto) {
+    struct Geo_st *g = (struct Geo_st *)geo;
+    if (g == NULL || fn == NULL) return;
+    for (int i = 0; i < g->num_slots; i++) {
+        if (slot_vivo(g, i)) fn(g->slab[i].tipo, &g->slab[i], contexto);
     }
-    return g;
 }
 
-static void inserir_forma(Geo geo, TipoForma tipo, void *objeto) {
+int geo_num_formas(Geo geo) {
     struct Geo_st *g = (struct Geo_st *)geo;
-    ElementoGeo *el = malloc(sizeof(ElementoGeo));
-    el->tipo = tipo;
-    el->forma = objeto;
-    list_insert_back(g->formas, el);
+    return g ? g->num_slots - g->num_removidas : 0;
+}
+
+unsigned long geo_versao_barreiras(Geo geo) {
+    struct Geo_st *g = (struct Geo_st *)geo;
+    return g ? g->versao : 0;
+}
+
+/* Converte entradas já na ordem da cidade em vetores paralelos de formas e
+ * tipos; destrói achadas e retorna a quantidade */
+static int exportar_achadas(struct Geo_st *g, Vetor achadas, void ***formas, TipoForma **tipos) {
+    int k = vetor_tamanho(achadas);
+    EntradaId *entradas = (EntradaId *)vetor_dados(achadas);
+
+    *formas = malloc((k + 1) * sizeof(void *));
+    *tipos = malloc((k + 1) * sizeof(TipoForma));
+    if (*formas == NULL || *tipos == NULL) {
+        free(*formas); free(*tipos);
+        *formas = NULL; *tipos = NULL;
+        vetor_destruir(achadas);
+        return 0;
+    }
+    for (int i = 0; i < k; i++) {
+        (*formas)[i] = &g->slab[entradas[i].slot];
+        (*tipos)[i] = g->slab[entradas[i].slot].tipo;
+    }
+    vetor_destruir(achadas);
+    return k;
+}
+
+int geo_formas_no_intervalo(Geo geo, int id_ini, int id_fim, void ***formas, TipoForma **tipos) {
+    struct Geo_st *g = (struct Geo_st *)geo;
+    *formas = NULL;
+    *tipos = NULL;
+    if (g == NULL || id_ini > id_fim) return 0;
+
+    // Reordena só quando as pendências ou lápides pesam (custo amortizado)
+    int pendentes = g->num_indice - g->num_ordenadas;
+    if (pendentes > PENDENTES_MIN + g->num_ordenadas / 16 || g->num_lapides > g->num_indice / 2) {
+        indice_normalizar(g);
+    }
+
+    Vetor achadas = vetor_criar(sizeof(EntradaId));
+    if (achadas == NULL) return 0;
+
+    // Busca binária no prefixo ordenado e em cada trecho pendente
+    int ok = coletar_no_trecho(g, 0, g->num_ordenadas, id_ini, id_fim, achadas);
+    if (!g->cauda_desordenada) {
+        for (int t = 0; ok && t < g->num_trechos; t++) {
+            int fim = t + 1 < g->num_trechos ? g->inicio_trecho[t + 1] : g->num_indice;
+            ok = coletar_no_trecho(g, g->inicio_trecho[t], fim, id_ini, id_fim, achadas);
+        }
+    } else {
+        for (int i = g->num_ordenadas; ok && i < g->num_indice; i++) {
+            EntradaId *e = &g->indice[i];
+            if (e->slot < 0 || e->id < id_ini || e->id > id_fim) continue;
+            if (vetor_inserir(achadas, e) == NULL) ok = 0;
+        }
+    }
+
+    // Ordem da cidade
+    vetor_ordenar(achadas, comparar_slot, ALG_QSORT, 0);
+    return exportar_achadas(g, achadas, formas, tipos);
+}
+
+int geo_formas_na_regiao(Geo geo, double x1, double y1, double x2, double y2,
+                         void ***formas, TipoForma **tipos) {
+    struct Geo_st *g = (struct Geo_st *)geo;
+    *formas = NULL;
+    *tipos = NULL;
+    if (g == NULL || x1 > x2 || y1 > y2) return 0;
+
+    Vetor achadas = regiao_consultar(g, x1, y1, x2, y2);
+    if (achadas == NULL) return 0;
+    return exportar_achadas(g, achadas, formas, tipos);
 }
 
 void geo_ler(Geo geo, const char *path) {
@@ -93,30 +641,30 @@ void geo_escrever_svg(Geo geo, FILE *svg) {
     if (!geo || !svg) return;
     struct Geo_st *g = (struct Geo_st *)geo;
 
-    int n = list_size(g->formas);
-    for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        
+    for (int i = 0; i < g->num_slots; i++) {
+        if (!slot_vivo(g, i)) continue;
+        RegistroForma *el = &g->slab[i];
+
         if (el->tipo == CIRCLE) {
-            void *c = el->forma;
+            void *c = el;
             fprintf(svg, "<circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\" stroke=\"%s\" fill=\"%s\" stroke-width=\"1\" fill-opacity=\"0.6\" stroke-opacity=\"0.6\" />\n",
                 circulo_get_x(c), circulo_get_y(c), circulo_get_raio(c), 
                 circulo_get_cor_borda(c), circulo_get_cor_preenchimento(c));
         }
         else if (el->tipo == RECTANGLE) {
-            void *r = el->forma;
+            void *r = el;
             fprintf(svg, "<rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\" stroke=\"%s\" fill=\"%s\" stroke-width=\"1\" fill-opacity=\"0.6\" stroke-opacity=\"0.6\" />\n",
                 retangulo_get_x(r), retangulo_get_y(r), 
                 retangulo_get_largura(r), retangulo_get_altura(r),
                 retangulo_get_cor_borda(r), retangulo_get_cor_preenchimento(r));
         }
         else if (el->tipo == LINE) {
-            void *l = el->forma;
+            void *l = el;
             fprintf(svg, "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke=\"%s\" stroke-width=\"1\" stroke-opacity=\"0.6\" />\n",
                 line_get_x1(l), line_get_y1(l), line_get_x2(l), line_get_y2(l), line_get_color(l));
         }
         else if (el->tipo == TEXT) {
-            void *t = el->forma;
+            void *t = el;
             char anchor = text_get_anchor(t);
             const char *svg_anchor = "start";
             if (anchor == 'm') svg_anchor = "middle";
@@ -130,29 +678,62 @@ void geo_escrever_svg(Geo geo, FILE *svg) {
 }
 
 LinkedList geo_get_formas(Geo geo) {
-    return ((struct Geo_st *)geo)->formas;
+    struct Geo_st *g = (struct Geo_st *)geo;
+    if (g->visao == NULL) {
+        g->visao = list_create();
+        if (g->visao == NULL) return NULL;
+        g->visao_suja = 1;
+    }
+    if (g->visao_suja) sincronizar_visao(g);
+    return g->visao;
+}
+
+LinkedList geo_obter_barreiras_proximas(Geo geo, double x, double y, double raio) {
+    struct Geo_st *g = (struct Geo_st *)geo;
+    if (raio <= 0) return geo_obter_todas_barreiras(geo);
+    LinkedList segmentos = list_create();
+
+    // Só as formas cuja caixa toca o quadrado do disco, pela grade de baldes
+    Vetor candidatas = regiao_consultar(g, x - raio, y - raio, x + raio, y + raio);
+    if (candidatas == NULL) return segmentos;
+    EntradaId *entradas = (EntradaId *)vetor_dados(candidatas);
+    int n = vetor_tamanho(candidatas);
+
+    for (int j = 0; j < n; j++) {
+        RegistroForma *el = &g->slab[entradas[j].slot];
+        // Mesmo critério de geo_obter_todas_barreiras; só cria as que alcançam o disco
+        if (!eh_anteparo(el)) continue;
+        double x1 = el->u.linha.x1, y1 = el->u.linha.y1;
+        double x2 = el->u.linha.x2, y2 = el->u.linha.y2;
+        if (distancia_ponto_segmento(x, y, x1, y1, x2, y2) > raio) continue;
+        list_insert_back(segmentos, criar_segmento_com_cor(NULL, el->id, el->id, x1, y1, x2, y2,
+                                                                  segmento_cor_barreira()));
+    }
+    vetor_destruir(candidatas);
+    return segmentos;
 }
 
 LinkedList geo_obter_todas_barreiras(Geo geo) {
     struct Geo_st *g = (struct Geo_st *)geo;
     LinkedList segmentos = list_create(); 
 
-    int n = list_size(g->formas);
-    for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        
+    for (int i = 0; i < g->num_slots; i++) {
+        if (!slot_vivo(g, i)) continue;
+        RegistroForma *el = &g->slab[i];
+
         // Only include lines that are anteparos (those created by command 'a')
         // Anteparos have IDs >= 5000 by convention (set in qry.c)
         if (el->tipo == LINE) {
-            int line_id = line_get_id(el->forma);
+            int line_id = el->id;
             if (line_id >= 5000) {  // Only anteparos
-                double x1 = line_get_x1(el->forma);
-                double y1 = line_get_y1(el->forma);
-                double x2 = line_get_x2(el->forma);
-                double y2 = line_get_y2(el->forma);
+                double x1 = el->u.linha.x1;
+                double y1 = el->u.linha.y1;
+                double x2 = el->u.linha.x2;
+                double y2 = el->u.linha.y2;
                 
                 // Correct usage with new API:
-                Segmento seg = criar_segmento(line_id, line_id, x1, y1, x2, y2, "black");
+                Segmento seg = criar_segmento_com_cor(NULL, line_id, line_id, x1, y1, x2, y2,
+                                                      segmento_cor_barreira());
                 list_insert_back(segmentos, seg);
             }
         }
@@ -172,7 +753,7 @@ LinkedList geo_gerar_biombo(Geo geo, Ponto centro_bomba) {
     double cx = get_ponto_x(centro_bomba);
     double cy = get_ponto_y(centro_bomba);
 
-    if (list_is_empty(g->formas)) {
+    if (g->num_slots == g->num_removidas) {
         min_x = cx; max_x = cx;
         min_y = cy; max_y = cy;
     } else {
@@ -194,10 +775,11 @@ LinkedList geo_gerar_biombo(Geo geo, Ponto centro_bomba) {
     min_x -= dx; min_y -= dy;
     max_x += dx; max_y += dy;
 
-    Segmento s1 = criar_segmento(-1, -1, min_x, min_y, max_x, min_y, "none");
-    Segmento s2 = criar_segmento(-1, -1, max_x, min_y, max_x, max_y, "none");
-    Segmento s3 = criar_segmento(-1, -1, max_x, max_y, min_x, max_y, "none");
-    Segmento s4 = criar_segmento(-1, -1, min_x, max_y, min_x, min_y, "none");
+    IdString borda = segmento_cor_borda();
+    Segmento s1 = criar_segmento_com_cor(NULL, -1, -1, min_x, min_y, max_x, min_y, borda);
+    Segmento s2 = criar_segmento_com_cor(NULL, -1, -1, max_x, min_y, max_x, max_y, borda);
+    Segmento s3 = criar_segmento_com_cor(NULL, -1, -1, max_x, max_y, min_x, max_y, borda);
+    Segmento s4 = criar_segmento_com_cor(NULL, -1, -1, min_x, max_y, min_x, min_y, borda);
 
     list_insert_back(biombo, s1);
     list_insert_back(biombo, s2);
@@ -207,11 +789,10 @@ LinkedList geo_gerar_biombo(Geo geo, Ponto centro_bomba) {
     return biombo;
 }
 
-LinkedList geo_gerar_biombo_com_limites(Geo geo, Ponto centro_bomba, 
-                                         double ext_min_x, double ext_min_y,
-                                         double ext_max_x, double ext_max_y) {
+void geo_limites_biombo(Geo geo, Ponto centro_bomba,
+                        double ext_min_x, double ext_min_y, double ext_max_x, double ext_max_y,
+                        double *min_x_out, double *min_y_out, double *max_x_out, double *max_y_out) {
     struct Geo_st *g = (struct Geo_st *)geo;
-    LinkedList biombo = list_create();
 
     double min_x = DBL_MAX, min_y = DBL_MAX;
     double max_x = -DBL_MAX, max_y = -DBL_MAX;
@@ -219,7 +800,7 @@ LinkedList geo_gerar_biombo_com_limites(Geo geo, Ponto centro_bomba,
     double cx = get_ponto_x(centro_bomba);
     double cy = get_ponto_y(centro_bomba);
 
-    if (list_is_empty(g->formas)) {
+    if (g->num_slots == g->num_removidas) {
         min_x = cx; max_x = cx;
         min_y = cy; max_y = cy;
     } else {
@@ -244,13 +825,23 @@ LinkedList geo_gerar_biombo_com_limites(Geo geo, Ponto centro_bomba,
     double dx = (largura > 0) ? largura * 0.10 : 50.0;
     double dy = (altura > 0) ? altura * 0.10 : 50.0;
 
-    min_x -= dx; min_y -= dy;
-    max_x += dx; max_y += dy;
+    *min_x_out = min_x - dx; *min_y_out = min_y - dy;
+    *max_x_out = max_x + dx; *max_y_out = max_y + dy;
+}
 
-    Segmento s1 = criar_segmento(-1, -1, min_x, min_y, max_x, min_y, "none");
-    Segmento s2 = criar_segmento(-1, -1, max_x, min_y, max_x, max_y, "none");
-    Segmento s3 = criar_segmento(-1, -1, max_x, max_y, min_x, max_y, "none");
-    Segmento s4 = criar_segmento(-1, -1, min_x, max_y, min_x, min_y, "none");
+LinkedList geo_gerar_biombo_com_limites(Geo geo, Ponto centro_bomba, 
+                                         double ext_min_x, double ext_min_y,
+                                         double ext_max_x, double ext_max_y) {
+    LinkedList biombo = list_create();
+    double min_x, min_y, max_x, max_y;
+    geo_limites_biombo(geo, centro_bomba, ext_min_x, ext_min_y, ext_max_x, ext_max_y,
+                       &min_x, &min_y, &max_x, &max_y);
+
+    IdString borda = segmento_cor_borda();
+    Segmento s1 = criar_segmento_com_cor(NULL, -1, -1, min_x, min_y, max_x, min_y, borda);
+    Segmento s2 = criar_segmento_com_cor(NULL, -1, -1, max_x, min_y, max_x, max_y, borda);
+    Segmento s3 = criar_segmento_com_cor(NULL, -1, -1, max_x, max_y, min_x, max_y, borda);
+    Segmento s4 = criar_segmento_com_cor(NULL, -1, -1, min_x, max_y, min_x, min_y, borda);
 
     list_insert_back(biombo, s1);
     list_insert_back(biombo, s2);
@@ -264,48 +855,19 @@ void geo_get_bounding_box(Geo geo, double *min_x, double *min_y, double *max_x,
     struct Geo_st *g = (struct Geo_st *)geo;
     double mx = DBL_MAX, my = DBL_MAX, Mx = -DBL_MAX, My = -DBL_MAX;
 
-    int n = list_size(g->formas);
-    if (n == 0) {
+    if (g->num_slots == g->num_removidas) {
         if (min_x) *min_x = 0; if (min_y) *min_y = 0;
         if (max_x) *max_x = 1000; if (max_y) *max_y = 1000;
         return;
     }
 
-    for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
-
-        if (el->tipo == CIRCLE) {
-            double x = circulo_get_x(el->forma);
-            double y = circulo_get_y(el->forma);
-            double r = circulo_get_raio(el->forma);
-            x1 = x - r; y1 = y - r;
-            x2 = x + r; y2 = y + r;
-        }
-        else if (el->tipo == RECTANGLE) {
-            x1 = retangulo_get_x(el->forma);
-            y1 = retangulo_get_y(el->forma);
-            x2 = x1 + retangulo_get_largura(el->forma);
-            y2 = y1 + retangulo_get_altura(el->forma);
-        }
-        else if (el->tipo == LINE) {
-            double lx1 = line_get_x1(el->forma);
-            double ly1 = line_get_y1(el->forma);
-            double lx2 = line_get_x2(el->forma);
-            double ly2 = line_get_y2(el->forma);
-            x1 = (lx1 < lx2) ? lx1 : lx2;
-            x2 = (lx1 > lx2) ? lx1 : lx2;
-            y1 = (ly1 < ly2) ? ly1 : ly2;
-            y2 = (ly1 > ly2) ? ly1 : ly2;
-        }
-        else if (el->tipo == TEXT) {
-            x1 = x2 = text_get_x(el->forma);
-            y1 = y2 = text_get_y(el->forma);
-        }
-        else {
-            continue;
-        }
+    // Geometria inline no slab: nenhuma indireção por forma
+    for (int i = 0; i < g->num_slots; i++) {
+        RegistroForma *el = &g->slab[i];
+        if (!slot_vivo(g, i) || el->tipo == TEXT_STYLE) continue;
 
+        double x1, y1, x2, y2;
+        registro_caixa(el, &x1, &y1, &x2, &y2);
         if (x1 < mx) mx = x1;
         if (y1 < my) my = y1;
         if (x2 > Mx) Mx = x2;
@@ -318,124 +880,167 @@ void geo_get_bounding_box(Geo geo, double *min_x, double *min_y, double *max_x,
     if (max_y) *max_y = My;
 }
 
-void geo_remover_forma(Geo geo, int id) {
+/* ============================================================================
+ * Operações em Lote
+ * ============================================================================ */
+
+static int comparar_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Ordena e normaliza o índice: cada id pedido vira um trecho contíguo,
+ * já na ordem da cidade. Retorna os ids ordenados (liberar com free). */
+static int *preparar_lote(struct Geo_st *g, const int *ids, int n) {
+    int *ordenados = malloc(n * sizeof(int));
+    if (ordenados == NULL) return NULL;
+    memcpy(ordenados, ids, n * sizeof(int));
+    qsort(ordenados, n, sizeof(int), comparar_int);
+    indice_normalizar(g);
+    return ordenados;
+}
+
+/* Slot da primeira forma viva com o id, ou -1 */
+static int primeiro_slot(struct Geo_st *g, int id) {
+    int pos = indice_limite_inferior(g, id, INT_MIN);
+    for (; pos < g->num_ordenadas && g->indice[pos].id == id; pos++) {
+        if (g->indice[pos].slot >= 0) return g->indice[pos].slot;
+    }
+    return -1;
+}
+
+void geo_remover_formas(Geo geo, const int *ids, int n) {
     struct Geo_st *g = (struct Geo_st *)geo;
-    int n = list_size(g->formas);
-    for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        int el_id = -1;
-        
-        if (el->tipo == CIRCLE) el_id = circulo_get_id(el->forma);
-        else if (el->tipo == RECTANGLE) el_id = retangulo_get_id(el->forma);
-        else if (el->tipo == LINE) el_id = line_get_id(el->forma);
-        else if (el->tipo == TEXT) el_id = text_get_id(el->forma);
-        
-        if (el_id == id) {
-            list_remove_at(g->formas, i);
-            
-            if (el->tipo == CIRCLE) circulo_destruir(el->forma);
-            else if (el->tipo == RECTANGLE) retangulo_destruir(el->forma);
-            else if (el->tipo == LINE) line_destroy(el->forma);
-            else if (el->tipo == TEXT) text_destroy(el->forma);
-            
-            free(el);
-            return;
+    if (g == NULL || ids == NULL || n <= 0) return;
+    int *ordenados = preparar_lote(g, ids, n);
+    if (ordenados == NULL) return;
+    int anteparos_removidos = 0;
+
+    // Cada repetição de um id consome a próxima ocorrência no trecho dele
+    for (int i = 0; i < n; ) {
+        int id = ordenados[i], restantes = 0;
+        while (i < n && ordenados[i] == id) { restantes++; i++; }
+
+        int pos = indice_limite_inferior(g, id, INT_MIN);
+        for (; restantes > 0 && pos < g->num_ordenadas && g->indice[pos].id == id; pos++) {
+            int slot = g->indice[pos].slot;
+            if (slot < 0) continue;
+            anteparos_removidos += eh_anteparo(&g->slab[slot]);
+            registro_liberar(&g->slab[slot]);
+            LAPIDE_MARCAR(g->lapides, slot);
+            g->indice[pos].slot = -1;
+            g->num_lapides++;
+            g->num_removidas++;
+            restantes--;
         }
     }
+    free(ordenados);
+    if (anteparos_removidos > 0) g->versao++;
+
+    if (g->num_removidas > LAPIDES_MIN && g->num_removidas > g->num_slots / 4) {
+        compactar(g);
+    }
+    g->visao_suja = 1;
 }
 
-void geo_alterar_cor(Geo geo, int id, const char *cor) {
+void geo_alterar_cores(Geo geo, const int *ids, int n, const char *cor) {
     struct Geo_st *g = (struct Geo_st *)geo;
-    int n = list_size(g->formas);
+    if (g == NULL || ids == NULL || n <= 0) return;
+    // Interna a cor uma vez; cada forma só recebe o identificador
+    IdString id_cor = interno_registrar(cor);
+    if (id_cor == STRING_NENHUMA) return;
+    int *ordenados = preparar_lote(g, ids, n);
+    if (ordenados == NULL) return;
+
     for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        int el_id = -1;
-        if (el->tipo == CIRCLE) el_id = circulo_get_id(el->forma);
-        else if (el->tipo == RECTANGLE) el_id = retangulo_get_id(el->forma);
-        else if (el->tipo == LINE) el_id = line_get_id(el->forma);
-        else if (el->tipo == TEXT) el_id = text_get_id(el->forma);
-
-        if (el_id == id) {
-            if (el->tipo == CIRCLE) {
-                circulo_set_cor_borda(el->forma, cor);
-                circulo_set_cor_preenchimento(el->forma, cor);
-            } else if (el->tipo == RECTANGLE) {
-                retangulo_set_cor_borda(el->forma, cor);
-                retangulo_set_cor_preenchimento(el->forma, cor);
-            } else if (el->tipo == LINE) {
-                line_set_color(el->forma, cor);
-            } else if (el->tipo == TEXT) {
-                text_set_border_color(el->forma, cor);
-                text_set_fill_color(el->forma, cor);
-            }
-            return;
-        }
+        if (i > 0 && ordenados[i] == ordenados[i - 1]) continue;
+        int slot = primeiro_slot(g, ordenados[i]);
+        if (slot < 0) continue;
+        // Linhas só têm a cor do traço
+        RegistroForma *el = &g->slab[slot];
+        el->cor_borda = id_cor;
+        if (el->tipo != LINE) el->cor_preenchimento = id_cor;
     }
+    free(ordenados);
 }
 
-void geo_clonar_forma(Geo geo, int id, double dx, double dy) {
+void geo_clonar_formas(Geo geo, const int *ids, int n, double dx, double dy) {
     struct Geo_st *g = (struct Geo_st *)geo;
-    int n = list_size(g->formas);
+    if (g == NULL || ids == NULL || n <= 0) return;
+
+    // Localiza antes de inserir: os clones entram no fim, após os originais
+    int *originais = malloc(n * sizeof(int));
+    if (originais == NULL) return;
+    indice_normalizar(g);
+    for (int i = 0; i < n; i++) originais[i] = primeiro_slot(g, ids[i]);
+
     for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        int el_id = -1;
-        if (el->tipo == CIRCLE) el_id = circulo_get_id(el->forma);
-        else if (el->tipo == RECTANGLE) el_id = retangulo_get_id(el->forma);
-        else if (el->tipo == LINE) el_id = line_get_id(el->forma);
-        else if (el->tipo == TEXT) el_id = text_get_id(el->forma);
-        
-        if (el_id == id) {
-            // O qry.c define o ID novo como id + 10000.
-            int new_id = id + 10000;
-
-            if (el->tipo == CIRCLE) {
-                void* c = el->forma;
-                void* novo = circulo_criar(new_id, circulo_get_x(c)+dx, circulo_get_y(c)+dy, 
-                                           circulo_get_raio(c), circulo_get_cor_borda(c), circulo_get_cor_preenchimento(c));
-                inserir_forma(geo, CIRCLE, novo);
-            } 
-            else if (el->tipo == RECTANGLE) {
-                void* r = el->forma;
-                void* novo = retangulo_criar(new_id, retangulo_get_x(r)+dx, retangulo_get_y(r)+dy, 
-                                             retangulo_get_largura(r), retangulo_get_altura(r),
-                                             retangulo_get_cor_borda(r), retangulo_get_cor_preenchimento(r));
-                inserir_forma(geo, RECTANGLE, novo);
-            }
-            else if (el->tipo == LINE) {
-                void* l = el->forma;
-                void* novo = line_create(new_id, line_get_x1(l)+dx, line_get_y1(l)+dy, 
-                                         line_get_x2(l)+dx, line_get_y2(l)+dy, 
-                                         line_get_color(l));
-                inserir_forma(geo, LINE, novo);
-            }
-            else if (el->tipo == TEXT) {
-                void* t = el->forma;
-                void* novo = text_create(new_id, text_get_x(t)+dx, text_get_y(t)+dy, 
-                                         text_get_border_color(t), text_get_fill_color(t),
-                                         text_get_anchor(t), text_get_text(t));
-                inserir_forma(geo, TEXT, novo);
-            }
-            return;
+        if (originais[i] < 0) continue;
+        // inserir_forma pode realocar o slab: relê o elemento a cada volta
+        RegistroForma *el = &g->slab[originais[i]];
+
+        // O qry.c define o ID novo como id + 10000.
+        int new_id = ids[i] + 10000;
+
+        if (el->tipo == CIRCLE) {
+            void* c = el;
+            void* novo = circulo_criar(new_id, circulo_get_x(c)+dx, circulo_get_y(c)+dy, 
+                                       circulo_get_raio(c), circulo_get_cor_borda(c), circulo_get_cor_preenchimento(c));
+            inserir_forma(geo, CIRCLE, novo);
+        } 
+        else if (el->tipo == RECTANGLE) {
+            void* r = el;
+            void* novo = retangulo_criar(new_id, retangulo_get_x(r)+dx, retangulo_get_y(r)+dy, 
+                                         retangulo_get_largura(r), retangulo_get_altura(r),
+                                         retangulo_get_cor_borda(r), retangulo_get_cor_preenchimento(r));
+            inserir_forma(geo, RECTANGLE, novo);
+        }
+        else if (el->tipo == LINE) {
+            void* l = el;
+            void* novo = line_create(new_id, line_get_x1(l)+dx, line_get_y1(l)+dy, 
+                                     line_get_x2(l)+dx, line_get_y2(l)+dy, 
+                                     line_get_color(l));
+            inserir_forma(geo, LINE, novo);
+        }
+        else if (el->tipo == TEXT) {
+            void* t = el;
+            void* novo = text_create(new_id, text_get_x(t)+dx, text_get_y(t)+dy, 
+                                     text_get_border_color(t), text_get_fill_color(t),
+                                     text_get_anchor(t), text_get_text(t));
+            inserir_forma(geo, TEXT, novo);
         }
     }
+    free(originais);
+}
+
+void geo_remover_forma(Geo geo, int id) {
+    geo_remover_formas(geo, &id, 1);
+}
+
+void geo_alterar_cor(Geo geo, int id, const char *cor) {
+    geo_alterar_cores(geo, &id, 1, cor);
+}
+
+void geo_clonar_forma(Geo geo, int id, double dx, double dy) {
+    geo_clonar_formas(geo, &id, 1, dx, dy);
 }
 
 void geo_destruir(Geo geo) {
     if (!geo) return;
     struct Geo_st *g = (struct Geo_st *)geo;
-    
-    int n = list_size(g->formas);
-    for (int i = 0; i < n; i++) {
-        ElementoGeo *el = (ElementoGeo *)list_get_at(g->formas, i);
-        
-        if (el->tipo == CIRCLE) circulo_destruir(el->forma);
-        else if (el->tipo == RECTANGLE) retangulo_destruir(el->forma);
-        else if (el->tipo == LINE) line_destroy(el->forma);
-        else if (el->tipo == TEXT) text_destroy(el->forma);
 
-        free(el);
+    for (int i = 0; i < g->num_slots; i++) {
+        if (slot_vivo(g, i)) registro_liberar(&g->slab[i]);
     }
-    
-    list_destroy(g->formas);
+    if (g->visao) list_destroy(g->visao);
+    free(g->elementos_visao);
+    free(g->slab);
+    free(g->lapides);
+    free(g->indice);
+    free(g->aux);
+    free(g->regiao_cabeca);
+    free(g->regiao_slot);
+    free(g->regiao_prox);
+    free(g->regiao_grandes);
     free(g);
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include "../geometria/ponto/ponto.h"
 #include "../geometria/segmento/segmento.h"
+#include "../formas/formas.h"
 
 typedef void* LinkedList;
 typedef void *Geo;
@@ -11,16 +12,70 @@ typedef void *Geo;
 Geo geo_criar();
 void geo_ler(Geo geo, const char *path);
 void geo_escrever_svg(Geo geo, FILE *svg);
+/* Visão legada em lista das formas (ElementoGeo*, na ordem da cidade). A
+ * lista é sempre a mesma, mas só é atualizada por esta chamada: depois de
+ * alterar a cidade, chame de novo (os ponteiros só valem até a próxima
+ * alteração). Prefira geo_para_cada. */
 LinkedList geo_get_formas(Geo geo);
 LinkedList geo_obter_todas_barreiras(Geo geo);
+/* Como geo_obter_todas_barreiras, mas só os anteparos a até raio de (x, y);
+ * raio <= 0 devolve todos. Evita criar segmentos que a consulta descartaria. */
+LinkedList geo_obter_barreiras_proximas(Geo geo, double x, double y, double raio);
 LinkedList geo_gerar_biombo(Geo geo, Ponto centro_bomba);
 LinkedList geo_gerar_biombo_com_limites(Geo geo, Ponto centro_bomba, 
                                          double ext_min_x, double ext_min_y,
                                          double ext_max_x, double ext_max_y);
+/* Retângulo do biombo de geo_gerar_biombo_com_limites, sem criar os
+ * segmentos (para quem trata as bordas à parte, como a triangulação) */
+void geo_limites_biombo(Geo geo, Ponto centro_bomba,
+                        double ext_min_x, double ext_min_y, double ext_max_x, double ext_max_y,
+                        double *min_x, double *min_y, double *max_x, double *max_y);
 void geo_get_bounding_box(Geo geo, double *min_x, double *min_y, double *max_x, double *max_y);
 void geo_destruir(Geo geo);
 void geo_remover_forma(Geo geo, int id);
 void geo_alterar_cor(Geo geo, int id, const char *cor);
 void geo_clonar_forma(Geo geo, int id, double dx, double dy);
 
+/* Versões em lote: uma única passada pela cidade para todos os ids.
+ * Equivalem a chamar a versão unitária para cada id, na ordem dada:
+ * - remover: cada repetição de um id remove mais uma ocorrência (a primeira restante);
+ * - alterar cor: afeta a primeira forma com cada id;
+ * - clonar: um clone por entrada de ids, inserido no fim, na ordem de ids
+ *   (os ids são procurados entre as formas que já existiam antes da chamada). */
+void geo_remover_formas(Geo geo, const int *ids, int n);
+void geo_alterar_cores(Geo geo, const int *ids, int n, const char *cor);
+void geo_clonar_formas(Geo geo, const int *ids, int n, double dx, double dy);
+
+/* Insere uma forma no fim da cidade. O registro é copiado para o armazém da
+ * cidade e o handle recebido é liberado: não use forma depois da chamada.
+ * Retorna 0 se tipo não for o da forma ou se faltar memória (a forma é
+ * destruída e a cidade não muda). */
+int geo_inserir_forma(Geo geo, TipoForma tipo, void *forma);
+
+/* Formas com id em [id_ini, id_fim], na ordem da cidade, via índice
+ * ordenado por id: O(log² n + k log k) em vez de percorrer a cidade.
+ * *formas e *tipos recebem vetores paralelos de k posições (liberar com free);
+ * as formas continuam pertencendo à cidade e os handles só valem até a
+ * próxima alteração dela. Retorna k. */
+int geo_formas_no_intervalo(Geo geo, int id_ini, int id_fim, void ***formas, TipoForma **tipos);
+
+/* Formas cuja caixa envolvente toca o retângulo [x1, x2] x [y1, y2], na
+ * ordem da cidade, via grade de baldes: o custo acompanha as formas perto
+ * da região, não o tamanho da cidade. Saída como em geo_formas_no_intervalo. */
+int geo_formas_na_regiao(Geo geo, double x1, double y1, double x2, double y2,
+                         void ***formas, TipoForma **tipos);
+
+/* Chama fn(tipo, forma, contexto) para cada forma, na ordem da cidade
+ * (percurso sequencial do slab). fn não deve alterar a cidade. */
+void geo_para_cada(Geo geo, void (*fn)(TipoForma tipo, void *forma, void *contexto), void *contexto);
+
+/* Número de formas presentes na cidade */
+int geo_num_formas(Geo geo);
+
+/* Versão das barreiras para quem guarda resultados derivados delas: muda a
+ * cada anteparo (linha com id >= 5000) inserido ou removido. As outras
+ * formas, as cores e a bounding box não a alteram; quem depende da bounding
+ * box (o biombo) deve guardá-la à parte. */
+unsigned long geo_versao_barreiras(Geo geo);
+
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "calculos.h"
 
@@ -88,23 +89,15 @@ Orientacao calcular_orientacao_coords(double x1, double y1,
  * Implementação das Funções de Interseção
  * ============================================================================ */
 
-int intersecao_raio_segmento(Ponto origem, Ponto direcao, Segmento seg, Ponto *resultado)
+/**
+ * Interseção do raio (ox, oy) + t * (dx, dy) com o segmento (sx1, sy1)-(sx2, sy2).
+ * Núcleo comum de todas as consultas de raio, para que devolvam o mesmo t.
+ * @return 1 se há interseção (t em *t_saida), 0 caso contrário
+ */
+static int raio_atinge_segmento(double ox, double oy, double dx, double dy,
+                                double sx1, double sy1, double sx2, double sy2,
+                                double *t_saida)
 {
-    if (origem == NULL || direcao == NULL || seg == NULL || resultado == NULL)
-    {
-        return 0;
-    }
-    
-    double ox = get_ponto_x(origem);
-    double oy = get_ponto_y(origem);
-    double dx = get_ponto_x(direcao) - ox;
-    double dy = get_ponto_y(direcao) - oy;
-    
-    double sx1 = get_segmento_x1(seg);
-    double sy1 = get_segmento_y1(seg);
-    double sx2 = get_segmento_x2(seg);
-    double sy2 = get_segmento_y2(seg);
-    
     /* Vetor do segmento */
     double segx = sx2 - sx1;
     double segy = sy2 - sy1;
@@ -126,6 +119,30 @@ int intersecao_raio_segmento(Ponto origem, Ponto direcao, Segmento seg, Ponto *r
     
     /* Interseção válida: t >= 0 (na direção do raio) e 0 <= u <= 1 (dentro do segmento) */
     if (t >= -GEO_EPSILON && u >= -GEO_EPSILON && u <= 1.0 + GEO_EPSILON)
+    {
+        *t_saida = t;
+        return 1;
+    }
+    
+    return 0;
+}
+
+int intersecao_raio_segmento(Ponto origem, Ponto direcao, Segmento seg, Ponto *resultado)
+{
+    if (origem == NULL || direcao == NULL || seg == NULL || resultado == NULL)
+    {
+        return 0;
+    }
+    
+    double ox = get_ponto_x(origem);
+    double oy = get_ponto_y(origem);
+    double dx = get_ponto_x(direcao) - ox;
+    double dy = get_ponto_y(direcao) - oy;
+    
+    double t;
+    if (raio_atinge_segmento(ox, oy, dx, dy,
+                             get_segmento_x1(seg), get_segmento_y1(seg),
+                             get_segmento_x2(seg), get_segmento_y2(seg), &t))
     {
         double ix = ox + t * dx;
         double iy = oy + t * dy;
@@ -140,32 +157,14 @@ double distancia_raio_segmento(Ponto origem, double angulo, Segmento seg)
 {
     if (origem == NULL || seg == NULL) return INFINITY;
     
-    double ox = get_ponto_x(origem);
-    double oy = get_ponto_y(origem);
-    
     /* Criar ponto de direção */
     double dx = cos(angulo);
     double dy = sin(angulo);
     
-    double sx1 = get_segmento_x1(seg);
-    double sy1 = get_segmento_y1(seg);
-    double sx2 = get_segmento_x2(seg);
-    double sy2 = get_segmento_y2(seg);
-    
-    double segx = sx2 - sx1;
-    double segy = sy2 - sy1;
-    
-    double denom = dx * segy - dy * segx;
-    
-    if (fabs(denom) < GEO_EPSILON)
-    {
-        return INFINITY;
-    }
-    
-    double t = ((sx1 - ox) * segy - (sy1 - oy) * segx) / denom;
-    double u = ((sx1 - ox) * dy - (sy1 - oy) * dx) / denom;
-    
-    if (t >= -GEO_EPSILON && u >= -GEO_EPSILON && u <= 1.0 + GEO_EPSILON)
+    double t;
+    if (raio_atinge_segmento(get_ponto_x(origem), get_ponto_y(origem), dx, dy,
+                             get_segmento_x1(seg), get_segmento_y1(seg),
+                             get_segmento_x2(seg), get_segmento_y2(seg), &t))
     {
         return t;
     }
@@ -203,6 +202,177 @@ int comparar_segmentos_raio(Ponto origem, double angulo, Segmento seg1, Segmento
     return (dist1 < dist2) ? -1 : 1;
 }
 
+double distancia_ponto_segmento(double px, double py,
+                                double x1, double y1, double x2, double y2)
+{
+    double dx = x2 - x1, dy = y2 - y1;
+    double comp2 = dx * dx + dy * dy;
+    double t = (comp2 > 0) ? ((px - x1) * dx + (py - y1) * dy) / comp2 : 0.0;
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    return hypot(x1 + t * dx - px, y1 + t * dy - py);
+}
+
+/* ============================================================================
+ * Kernel em Lote: um Raio contra Muitos Segmentos
+ * ============================================================================ */
+
+static NivelSimd g_nivel_simd = SIMD_AVX2;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CALCULOS_X86 1
+#include <immintrin.h>
+#endif
+
+/* Versão escalar: mesma sequência de operações das versões vetoriais */
+static void lote_escalar(double ox, double oy, double dx, double dy,
+                         const double *x1, const double *y1,
+                         const double *x2, const double *y2,
+                         int ini, int n, double *distancias)
+{
+    for (int i = ini; i < n; i++)
+    {
+        double t;
+        distancias[i] = raio_atinge_segmento(ox, oy, dx, dy, x1[i], y1[i], x2[i], y2[i], &t)
+                        ? t : INFINITY;
+    }
+}
+
+#ifdef CALCULOS_X86
+
+__attribute__((target("sse2")))
+static int lote_sse2(double ox, double oy, double dx, double dy,
+                     const double *x1, const double *y1,
+                     const double *x2, const double *y2,
+                     int n, double *distancias)
+{
+    const __m128d vox = _mm_set1_pd(ox), voy = _mm_set1_pd(oy);
+    const __m128d vdx = _mm_set1_pd(dx), vdy = _mm_set1_pd(dy);
+    const __m128d eps = _mm_set1_pd(GEO_EPSILON);
+    const __m128d neg_eps = _mm_set1_pd(-GEO_EPSILON);
+    const __m128d um_eps = _mm_set1_pd(1.0 + GEO_EPSILON);
+    const __m128d inf = _mm_set1_pd(INFINITY);
+    const __m128d sinal = _mm_set1_pd(-0.0);
+    
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d sx1 = _mm_loadu_pd(x1 + i), sy1 = _mm_loadu_pd(y1 + i);
+        __m128d segx = _mm_sub_pd(_mm_loadu_pd(x2 + i), sx1);
+        __m128d segy = _mm_sub_pd(_mm_loadu_pd(y2 + i), sy1);
+        __m128d denom = _mm_sub_pd(_mm_mul_pd(vdx, segy), _mm_mul_pd(vdy, segx));
+        __m128d ax = _mm_sub_pd(sx1, vox), ay = _mm_sub_pd(sy1, voy);
+        __m128d t = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(ax, segy), _mm_mul_pd(ay, segx)), denom);
+        __m128d u = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(ax, vdy), _mm_mul_pd(ay, vdx)), denom);
+        
+        /* Paralelo: |denom| < eps; comparações com NaN dão falso, como no escalar */
+        __m128d paralelo = _mm_cmplt_pd(_mm_andnot_pd(sinal, denom), eps);
+        __m128d ok = _mm_and_pd(_mm_cmpge_pd(t, neg_eps),
+                     _mm_and_pd(_mm_cmpge_pd(u, neg_eps), _mm_cmple_pd(u, um_eps)));
+        ok = _mm_andnot_pd(paralelo, ok);
+        _mm_storeu_pd(distancias + i, _mm_or_pd(_mm_and_pd(ok, t), _mm_andnot_pd(ok, inf)));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static int lote_avx2(double ox, double oy, double dx, double dy,
+                     const double *x1, const double *y1,
+                     const double *x2, const double *y2,
+                     int n, double *distancias)
+{
+    const __m256d vox = _mm256_set1_pd(ox), voy = _mm256_set1_pd(oy);
+    const __m256d vdx = _mm256_set1_pd(dx), vdy = _mm256_set1_pd(dy);
+    const __m256d eps = _mm256_set1_pd(GEO_EPSILON);
+    const __m256d neg_eps = _mm256_set1_pd(-GEO_EPSILON);
+    const __m256d um_eps = _mm256_set1_pd(1.0 + GEO_EPSILON);
+    const __m256d inf = _mm256_set1_pd(INFINITY);
+    const __m256d sinal = _mm256_set1_pd(-0.0);
+    
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d sx1 = _mm256_loadu_pd(x1 + i), sy1 = _mm256_loadu_pd(y1 + i);
+        __m256d segx = _mm256_sub_pd(_mm256_loadu_pd(x2 + i), sx1);
+        __m256d segy = _mm256_sub_pd(_mm256_loadu_pd(y2 + i), sy1);
+        __m256d denom = _mm256_sub_pd(_mm256_mul_pd(vdx, segy), _mm256_mul_pd(vdy, segx));
+        __m256d ax = _mm256_sub_pd(sx1, vox), ay = _mm256_sub_pd(sy1, voy);
+        __m256d t = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(ax, segy), _mm256_mul_pd(ay, segx)), denom);
+        __m256d u = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(ax, vdy), _mm256_mul_pd(ay, vdx)), denom);
+        
+        __m256d paralelo = _mm256_cmp_pd(_mm256_andnot_pd(sinal, denom), eps, _CMP_LT_OQ);
+        __m256d ok = _mm256_and_pd(_mm256_cmp_pd(t, neg_eps, _CMP_GE_OQ),
+                     _mm256_and_pd(_mm256_cmp_pd(u, neg_eps, _CMP_GE_OQ),
+                                   _mm256_cmp_pd(u, um_eps, _CMP_LE_OQ)));
+        ok = _mm256_andnot_pd(paralelo, ok);
+        _mm256_storeu_pd(distancias + i, _mm256_blendv_pd(inf, t, ok));
+    }
+    return i;
+}
+
+#endif /* CALCULOS_X86 */
+
+static NivelSimd nivel_suportado(void)
+{
+#ifdef CALCULOS_X86
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_ESCALAR;
+}
+
+NivelSimd calculos_set_nivel_simd(NivelSimd nivel)
+{
+#ifdef CALCULOS_X86
+    __builtin_cpu_init();
+#endif
+    NivelSimd suportado = nivel_suportado();
+    g_nivel_simd = (nivel < suportado) ? nivel : suportado;
+    return g_nivel_simd;
+}
+
+int distancias_raio_lote(double ox, double oy, double dx, double dy,
+                         const double *x1, const double *y1,
+                         const double *x2, const double *y2,
+                         int n, double *distancias)
+{
+    if (x1 == NULL || y1 == NULL || x2 == NULL || y2 == NULL || distancias == NULL || n <= 0)
+    {
+        return -1;
+    }
+    
+    /* Sem escrita em estado global: seguro para as threads da varredura */
+    NivelSimd nivel = g_nivel_simd;
+    NivelSimd suportado = nivel_suportado();
+    if (nivel > suportado) nivel = suportado;
+    
+    int feitos = 0;
+#ifdef CALCULOS_X86
+    if (nivel == SIMD_AVX2)
+    {
+        feitos = lote_avx2(ox, oy, dx, dy, x1, y1, x2, y2, n, distancias);
+    }
+    else if (nivel == SIMD_SSE2)
+    {
+        feitos = lote_sse2(ox, oy, dx, dy, x1, y1, x2, y2, n, distancias);
+    }
+#endif
+    lote_escalar(ox, oy, dx, dy, x1, y1, x2, y2, feitos, n, distancias);
+    
+    /* Primeiro mínimo estrito, como numa varredura linear */
+    int menor = -1;
+    double menor_dist = INFINITY;
+    for (int i = 0; i < n; i++)
+    {
+        if (distancias[i] < menor_dist)
+        {
+            menor_dist = distancias[i];
+            menor = i;
+        }
+    }
+    return menor;
+}
+
 /* ============================================================================
  * Implementação das Funções de Ponto no Polígono
  * ============================================================================ */
@@ -235,6 +405,66 @@ int ponto_no_poligono(double px, double py, double *vertices, int num_vertices)
     return dentro;
 }
 
+#ifdef CALCULOS_X86
+__attribute__((target("avx2")))
+static int pontos_no_poligono_avx2(const double *px, const double *py, int n,
+                                   const double *vertices, int num_vertices, unsigned char *mapa)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d x = _mm256_loadu_pd(px + i);
+        __m256d y = _mm256_loadu_pd(py + i);
+        __m256d dentro = _mm256_setzero_pd();
+        
+        for (int a = 0, b = num_vertices - 1; a < num_vertices; b = a++)
+        {
+            double xi = vertices[a * 2], yi = vertices[a * 2 + 1];
+            double xj = vertices[b * 2], yj = vertices[b * 2 + 1];
+            __m256d vyi = _mm256_set1_pd(yi);
+            
+            /* Mesmas operações, na mesma ordem, do teste escalar */
+            __m256d cruza = _mm256_xor_pd(_mm256_cmp_pd(vyi, y, _CMP_GT_OQ),
+                                          _mm256_cmp_pd(_mm256_set1_pd(yj), y, _CMP_GT_OQ));
+            __m256d lim = _mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(xj - xi),
+                                                                    _mm256_sub_pd(y, vyi)),
+                                                      _mm256_set1_pd(yj - yi)),
+                                        _mm256_set1_pd(xi));
+            __m256d antes = _mm256_cmp_pd(x, lim, _CMP_LT_OQ);
+            dentro = _mm256_xor_pd(dentro, _mm256_and_pd(cruza, antes));
+        }
+        
+        /* i é múltiplo de 4: os quatro bits caem no mesmo byte */
+        mapa[i >> 3] |= (unsigned char)(_mm256_movemask_pd(dentro) << (i & 7));
+    }
+    return i;
+}
+#endif
+
+void pontos_no_poligono(const double *px, const double *py, int n,
+                        const double *vertices, int num_vertices, unsigned char *mapa)
+{
+    if (px == NULL || py == NULL || mapa == NULL || n <= 0) return;
+    memset(mapa, 0, BITMAP_BYTES(n));
+    if (vertices == NULL || num_vertices < 3) return;
+    
+    int feitos = 0;
+#ifdef CALCULOS_X86
+    NivelSimd nivel = (g_nivel_simd < nivel_suportado()) ? g_nivel_simd : nivel_suportado();
+    if (nivel == SIMD_AVX2)
+    {
+        feitos = pontos_no_poligono_avx2(px, py, n, vertices, num_vertices, mapa);
+    }
+#endif
+    for (int i = feitos; i < n; i++)
+    {
+        if (ponto_no_poligono(px[i], py[i], (double*)vertices, num_vertices))
+        {
+            mapa[i >> 3] |= (unsigned char)(1u << (i & 7));
+        }
+    }
+}
+
 /* ============================================================================
  * Funções Auxiliares Estáticas para Colisão
  * ============================================================================ */
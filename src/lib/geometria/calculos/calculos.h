@@ -102,6 +102,51 @@ int ponto_na_frente(Ponto origem, Ponto ponto, Segmento seg);
  */
 double distancia_raio_segmento(Ponto origem, double angulo, Segmento seg);
 
+/**
+ * Distância euclidiana de (px, py) ao ponto mais próximo do segmento
+ * (x1, y1)-(x2, y2). Um segmento degenerado vale como ponto.
+ */
+double distancia_ponto_segmento(double px, double py,
+                                double x1, double y1, double x2, double y2);
+
+/* ============================================================================
+ * Kernel em Lote: um Raio contra Muitos Segmentos
+ * ============================================================================ */
+
+/* Conjunto de instruções usado por distancias_raio_lote() */
+typedef enum {
+    SIMD_ESCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2
+} NivelSimd;
+
+/**
+ * Escolhe o conjunto de instruções do kernel em lote. O pedido é limitado
+ * ao que a CPU suporta (detectado em tempo de execução); o padrão é o
+ * melhor disponível.
+ * 
+ * @param nivel Nível desejado
+ * @return Nível efetivamente em uso
+ */
+NivelSimd calculos_set_nivel_simd(NivelSimd nivel);
+
+/**
+ * Distância ao longo de um raio até cada segmento de um lote, com as
+ * coordenadas em estrutura de vetores (SoA). Cada distância é idêntica,
+ * bit a bit, à de distancia_raio_segmento() para a mesma direção.
+ * 
+ * @param ox, oy Origem do raio
+ * @param dx, dy Direção do raio (ex.: cos e sen do ângulo)
+ * @param x1, y1, x2, y2 Coordenadas dos extremos dos n segmentos
+ * @param n Número de segmentos
+ * @param distancias Saída: parâmetro t por segmento (INFINITY se não atingido)
+ * @return Posição do primeiro segmento de menor distância, ou -1 se nenhum
+ */
+int distancias_raio_lote(double ox, double oy, double dx, double dy,
+                         const double *x1, const double *y1,
+                         const double *x2, const double *y2,
+                         int n, double *distancias);
+
 /* ============================================================================
  * Funções de Comparação para Ordenação
  * ============================================================================ */
@@ -134,6 +179,25 @@ int comparar_segmentos_raio(Ponto origem, double angulo, Segmento seg1, Segmento
  */
 int ponto_no_poligono(double px, double py, double *vertices, int num_vertices);
 
+/* Acesso a mapas de bits (bit i no byte i / 8) */
+#define BITMAP_BYTES(n) (((n) + 7) / 8)
+#define BITMAP_TESTAR(mapa, i) (((mapa)[(i) >> 3] >> ((i) & 7)) & 1)
+
+/**
+ * Versão em lote de ponto_no_poligono(): testa n pontos contra o mesmo
+ * polígono, quatro pontos por vez com AVX2 (conforme o nível escolhido em
+ * calculos_set_nivel_simd()). O resultado de cada ponto é idêntico ao da
+ * versão escalar.
+ * 
+ * @param px, py Coordenadas dos n pontos
+ * @param n Número de pontos
+ * @param vertices Array de coordenadas do polígono [x0, y0, x1, y1, ...]
+ * @param num_vertices Número de vértices do polígono
+ * @param mapa Saída com BITMAP_BYTES(n) bytes: bit i ligado se o ponto i está dentro
+ */
+void pontos_no_poligono(const double *px, const double *py, int n,
+                        const double *vertices, int num_vertices, unsigned char *mapa);
+
 /**
  * Verifica se uma forma está pelo menos parcialmente dentro do polígono.
  * Para círculos: verifica se o centro está dentro.
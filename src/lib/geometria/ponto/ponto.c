@@ -45,6 +45,19 @@ Ponto criar_ponto(double x, double y)
     return (Ponto)p;
 }
 
+Ponto criar_ponto_em(Arena arena, double x, double y)
+{
+    if (arena == NULL) return criar_ponto(x, y);
+    
+    PontoInternal *p = (PontoInternal*)arena_alocar(arena, sizeof(PontoInternal));
+    if (p == NULL) return NULL;
+    
+    p->x = x;
+    p->y = y;
+    
+    return (Ponto)p;
+}
+
 Ponto clonar_ponto(Ponto ponto)
 {
     PontoInternal *p = (PontoInternal*)ponto;
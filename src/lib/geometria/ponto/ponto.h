@@ -7,6 +7,8 @@
 #ifndef PONTO_H
 #define PONTO_H
 
+#include "../../utils/arena/arena.h"
+
 /* Tipo opaco para Ponto */
 typedef void* Ponto;
 
@@ -22,6 +24,12 @@ typedef void* Ponto;
  */
 Ponto criar_ponto(double x, double y);
 
+/**
+ * Cria um ponto dentro de uma arena (NULL equivale a criar_ponto).
+ * Pontos de arena não devem ser passados a destruir_ponto.
+ */
+Ponto criar_ponto_em(Arena arena, double x, double y);
+
 /**
  * Clona um ponto.
  * @param p Ponto a ser clonado
@@ -3,12 +3,15 @@
  * Implementação do TAD Segmento
  */
 
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include "segmento.h"
 #include <string.h>
 #include "../ponto/ponto.h"
+#include "../../utils/interno/interno.h"
 
 /* ============================================================================
  * Estrutura Interna (Ponteiro Opaco)
@@ -20,16 +23,20 @@ typedef struct segmento_internal
     int id_original;  /* ID da forma original */
     Ponto p1;         /* Ponto inicial */
     Ponto p2;         /* Ponto final */
-    char cor[32];     /* Cor do segmento */
+    IdString cor;     /* Cor do segmento (internada) */
 } SegmentoInternal;
 
 /* ============================================================================
  * Implementação das Funções de Criação e Destruição
  * ============================================================================ */
 
-Segmento criar_segmento(int id, int id_original, double x1, double y1, double x2, double y2, const char *cor)
+/* Cria com a cor já internada: clonar e dividir não consultam a tabela */
+static Segmento criar_com_cor(Arena arena, int id, int id_original, double x1, double y1,
+                              double x2, double y2, IdString cor)
 {
-    SegmentoInternal *seg = (SegmentoInternal*)malloc(sizeof(SegmentoInternal));
+    SegmentoInternal *seg = (arena != NULL)
+        ? (SegmentoInternal*)arena_alocar(arena, sizeof(SegmentoInternal))
+        : (SegmentoInternal*)malloc(sizeof(SegmentoInternal));
     if (seg == NULL)
     {
         fprintf(stderr, "Erro: falha ao alocar segmento.\n");
@@ -38,30 +45,66 @@ Segmento criar_segmento(int id, int id_original, double x1, double y1, double x2
     
     seg->id = id;
     seg->id_original = id_original;
-    seg->p1 = criar_ponto(x1, y1);
-    seg->p2 = criar_ponto(x2, y2);
-    
-    if (cor != NULL)
-    {
-        strncpy(seg->cor, cor, 31);
-        seg->cor[31] = '\0';
-    }
-    else
-    {
-        strcpy(seg->cor, "black");
-    }
+    seg->p1 = criar_ponto_em(arena, x1, y1);
+    seg->p2 = criar_ponto_em(arena, x2, y2);
+    seg->cor = cor;
     
     if (seg->p1 == NULL || seg->p2 == NULL)
     {
-        destruir_ponto(seg->p1);
-        destruir_ponto(seg->p2);
-        free(seg);
+        // Na arena, o espaço volta no próximo reset
+        if (arena == NULL)
+        {
+            destruir_ponto(seg->p1);
+            destruir_ponto(seg->p2);
+            free(seg);
+        }
         return NULL;
     }
     
     return (Segmento)seg;
 }
 
+Segmento criar_segmento_com_cor(Arena arena, int id, int id_original, double x1, double y1,
+                                double x2, double y2, IdString cor)
+{
+    return criar_com_cor(arena, id, id_original, x1, y1, x2, y2, cor);
+}
+
+/* Cores fixas das barreiras e das bordas, internadas na primeira consulta */
+static pthread_once_t cores_fixas_once = PTHREAD_ONCE_INIT;
+static IdString cor_barreira = STRING_NENHUMA;
+static IdString cor_borda = STRING_NENHUMA;
+
+static void registrar_cores_fixas(void)
+{
+    cor_barreira = interno_registrar("black");
+    cor_borda = interno_registrar("none");
+}
+
+IdString segmento_cor_barreira(void)
+{
+    pthread_once(&cores_fixas_once, registrar_cores_fixas);
+    return cor_barreira;
+}
+
+IdString segmento_cor_borda(void)
+{
+    pthread_once(&cores_fixas_once, registrar_cores_fixas);
+    return cor_borda;
+}
+
+Segmento criar_segmento(int id, int id_original, double x1, double y1, double x2, double y2, const char *cor)
+{
+    return criar_segmento_em(NULL, id, id_original, x1, y1, x2, y2, cor);
+}
+
+Segmento criar_segmento_em(Arena arena, int id, int id_original, double x1, double y1,
+                           double x2, double y2, const char *cor)
+{
+    return criar_com_cor(arena, id, id_original, x1, y1, x2, y2,
+                         interno_registrar(cor != NULL ? cor : "black"));
+}
+
 Segmento criar_segmento_pontos(int id, int id_original, Ponto p1, Ponto p2, const char *cor)
 {
     if (p1 == NULL || p2 == NULL) return NULL;
@@ -73,14 +116,19 @@ Segmento criar_segmento_pontos(int id, int id_original, Ponto p1, Ponto p2, cons
 }
 
 Segmento clonar_segmento(Segmento segmento)
+{
+    return clonar_segmento_em(NULL, segmento);
+}
+
+Segmento clonar_segmento_em(Arena arena, Segmento segmento)
 {
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
     if (seg == NULL) return NULL;
     
-    return criar_segmento(seg->id, seg->id_original,
-                          get_ponto_x(seg->p1), get_ponto_y(seg->p1),
-                          get_ponto_x(seg->p2), get_ponto_y(seg->p2),
-                          seg->cor);
+    return criar_com_cor(arena, seg->id, seg->id_original,
+                         get_ponto_x(seg->p1), get_ponto_y(seg->p1),
+                         get_ponto_x(seg->p2), get_ponto_y(seg->p2),
+                         seg->cor);
 }
 
 void destruir_segmento(Segmento segmento)
@@ -112,7 +160,14 @@ int get_segmento_id_original(Segmento segmento)
 const char* get_segmento_cor(Segmento segmento)
 {
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? seg->cor : "none";
+    const char *cor = seg ? interno_texto(seg->cor) : NULL;
+    return cor ? cor : "none";
+}
+
+IdString get_segmento_cor_id(Segmento segmento)
+{
+    SegmentoInternal *seg = (SegmentoInternal*)segmento;
+    return seg ? seg->cor : STRING_NENHUMA;
 }
 
 Ponto get_segmento_p1(Segmento segmento)
@@ -172,16 +227,16 @@ int segmento_dividir(Segmento segmento, Ponto ponto, Segmento *seg1, Segmento *s
     }
     
     /* Primeiro segmento: p1 até ponto de divisão */
-    *seg1 = criar_segmento(seg->id, seg->id_original,
-                           get_ponto_x(seg->p1), get_ponto_y(seg->p1),
-                           get_ponto_x(ponto), get_ponto_y(ponto),
-                           seg->cor);
+    *seg1 = criar_com_cor(NULL, seg->id, seg->id_original,
+                          get_ponto_x(seg->p1), get_ponto_y(seg->p1),
+                          get_ponto_x(ponto), get_ponto_y(ponto),
+                          seg->cor);
     
     /* Segundo segmento: ponto de divisão até p2 */
-    *seg2 = criar_segmento(seg->id, seg->id_original,
-                           get_ponto_x(ponto), get_ponto_y(ponto),
-                           get_ponto_x(seg->p2), get_ponto_y(seg->p2),
-                           seg->cor);
+    *seg2 = criar_com_cor(NULL, seg->id, seg->id_original,
+                          get_ponto_x(ponto), get_ponto_y(ponto),
+                          get_ponto_x(seg->p2), get_ponto_y(seg->p2),
+                          seg->cor);
     
     return (*seg1 != NULL && *seg2 != NULL);
 }
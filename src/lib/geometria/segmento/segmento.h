@@ -8,6 +8,7 @@
 #define SEGMENTO_H
 
 #include "../ponto/ponto.h"
+#include "../../utils/interno/interno.h"
 
 /* Tipo opaco para Segmento */
 typedef void* Segmento;
@@ -53,6 +54,31 @@ Segmento criar_segmento_pontos(int id, int id_original, Ponto p1, Ponto p2, cons
  */
 Segmento clonar_segmento(Segmento seg);
 
+/**
+ * Versões que alocam o segmento (e seus pontos) numa arena; NULL equivale
+ * às versões comuns. Segmentos de arena não devem ser passados a
+ * destruir_segmento: são liberados pelo reset da arena.
+ */
+Segmento criar_segmento_em(Arena arena, int id, int id_original, double x1, double y1,
+                           double x2, double y2, const char *cor);
+Segmento clonar_segmento_em(Arena arena, Segmento seg);
+
+/**
+ * Versão com a cor já internada, para os caminhos quentes (barreiras e
+ * bordas montadas a cada consulta): não consulta a tabela de strings.
+ * @param arena Arena, ou NULL para malloc
+ * @param cor Cor internada (ver segmento_cor_barreira e segmento_cor_borda)
+ */
+Segmento criar_segmento_com_cor(Arena arena, int id, int id_original, double x1, double y1,
+                                double x2, double y2, IdString cor);
+
+/**
+ * Cores internadas uma única vez: "black" das barreiras extraídas das
+ * formas e "none" das bordas da cena.
+ */
+IdString segmento_cor_barreira(void);
+IdString segmento_cor_borda(void);
+
 /**
  * Destroi um segmento.
  * @param seg Segmento a ser destruído
@@ -78,6 +104,11 @@ int get_segmento_id_original(Segmento seg);
  */
 const char* get_segmento_cor(Segmento seg);
 
+/**
+ * Obtém a cor internada do segmento, para copiá-la sem passar pela tabela.
+ */
+IdString get_segmento_cor_id(Segmento seg);
+
 /**
  * Obtém o ponto inicial do segmento.
  * @note NÃO modifique nem destrua o ponto retornado!
@@ -5,31 +5,35 @@
 #include <string.h>
 #include "poligono.h"
 #include "../utils/lista/lista.h"
+#include "../utils/vetor/vetor.h"
 #include "../geometria/ponto/ponto.h"
 
 #define INITIAL_CAPACITY 16
 
 /* Definição concreta da struct baseada em Array Dinâmico */
 typedef struct poligono_st {
-    double *coords;     /* [x0, y0, x1, y1, ...] */
-    int num_vertices;
-    int capacity;       /* Capacidade atual do array em número de vértices */
+    Vetor vertices;     /* Pares (x, y) contíguos: [x0, y0, x1, y1, ...] */
     LinkedList lista_cache;  /* Cache para uso legado, invalidada ao alterar */
+    void *anexo;             /* Dado de quem gerou o polígono (poligono_anexar) */
+    void *(*reter)(void*);
+    void (*soltar)(void*);
 } PoligonoStruct;
 
 Poligono poligono_criar() {
     PoligonoStruct *p = (PoligonoStruct*)malloc(sizeof(PoligonoStruct));
     if (p == NULL) return NULL;
 
-    p->coords = (double*)malloc(2 * INITIAL_CAPACITY * sizeof(double));
-    if (p->coords == NULL) {
+    p->vertices = vetor_criar(2 * sizeof(double));
+    if (p->vertices == NULL || !vetor_reservar(p->vertices, INITIAL_CAPACITY)) {
+        vetor_destruir(p->vertices);
         free(p);
         return NULL;
     }
 
-    p->num_vertices = 0;
-    p->capacity = INITIAL_CAPACITY;
     p->lista_cache = NULL;
+    p->anexo = NULL;
+    p->reter = NULL;
+    p->soltar = NULL;
     
     return (Poligono)p;
 }
@@ -58,30 +62,51 @@ static void limpar_cache(PoligonoStruct *ps) {
 void poligono_destruir(Poligono p) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
     if (ps != NULL) {
-        if (ps->coords != NULL) {
-            free(ps->coords);
-        }
+        vetor_destruir(ps->vertices);
         limpar_cache(ps);
+        if (ps->anexo != NULL) ps->soltar(ps->anexo);
         free(ps);
     }
 }
 
-void poligono_inserir_vertice(Poligono p, double x, double y) {
+Poligono poligono_clonar(Poligono p) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
-    if (ps == NULL) return;
+    if (ps == NULL) return NULL;
 
-    if (ps->num_vertices >= ps->capacity) {
-        int new_capacity = ps->capacity * 2;
-        double *new_coords = (double*)realloc(ps->coords, 2 * new_capacity * sizeof(double));
-        if (new_coords == NULL) return; /* Falha na alocação */
-        
-        ps->coords = new_coords;
-        ps->capacity = new_capacity;
+    PoligonoStruct *copia = (PoligonoStruct*)poligono_criar();
+    if (copia == NULL) return NULL;
+    int n = vetor_tamanho(ps->vertices);
+    if (!vetor_reservar(copia->vertices, n)) {
+        poligono_destruir(copia);
+        return NULL;
     }
+    const double *v = (const double*)vetor_dados(ps->vertices);
+    for (int i = 0; i < n; i++) vetor_inserir(copia->vertices, &v[2 * i]);
+    if (ps->anexo != NULL) poligono_anexar(copia, ps->reter(ps->anexo), ps->reter, ps->soltar);
+    return (Poligono)copia;
+}
+
+void poligono_anexar(Poligono p, void *anexo, void *(*reter)(void*), void (*soltar)(void*)) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL) return;
+    if (ps->anexo != NULL) ps->soltar(ps->anexo);
+    if (anexo != NULL && (reter == NULL || soltar == NULL)) anexo = NULL;
+    ps->anexo = anexo;
+    ps->reter = reter;
+    ps->soltar = soltar;
+}
+
+void* poligono_anexo(Poligono p) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    return ps ? ps->anexo : NULL;
+}
+
+void poligono_inserir_vertice(Poligono p, double x, double y) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL) return;
 
-    ps->coords[2 * ps->num_vertices] = x;
-    ps->coords[2 * ps->num_vertices + 1] = y;
-    ps->num_vertices++;
+    double par[2] = { x, y };
+    if (vetor_inserir(ps->vertices, par) == NULL) return; /* Falha na alocação */
     
     limpar_cache(ps); /* Invalida cache legado */
 }
@@ -89,15 +114,16 @@ void poligono_inserir_vertice(Poligono p, double x, double y) {
 int poligono_qtd_vertices(Poligono p) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
     if (ps == NULL) return 0;
-    return ps->num_vertices;
+    return vetor_tamanho(ps->vertices);
 }
 
 Ponto poligono_get_vertice(Poligono p, int indice) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
-    if (ps == NULL || indice < 0 || indice >= ps->num_vertices) return NULL;
+    double *par = ps ? (double*)vetor_obter(ps->vertices, indice) : NULL;
+    if (par == NULL) return NULL;
 
     /* Retorna uma copia fresca */
-    return criar_ponto(ps->coords[2*indice], ps->coords[2*indice+1]);
+    return criar_ponto(par[0], par[1]);
 }
 
 double* poligono_get_vertices_ref(Poligono p, int *num_vertices) {
@@ -107,24 +133,25 @@ double* poligono_get_vertices_ref(Poligono p, int *num_vertices) {
         return NULL;
     }
     
-    if(num_vertices) *num_vertices = ps->num_vertices;
-    return ps->coords;
+    if(num_vertices) *num_vertices = vetor_tamanho(ps->vertices);
+    return (double*)vetor_dados(ps->vertices);
 }
 
 int poligono_obter_vertices_array(Poligono p, double **vertices_out) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
-    if (ps == NULL || vertices_out == NULL || ps->num_vertices == 0) {
+    int num = ps ? vetor_tamanho(ps->vertices) : 0;
+    if (ps == NULL || vertices_out == NULL || num == 0) {
         *vertices_out = NULL;
         return 0;
     }
 
-    double *arr = (double*)malloc(2 * ps->num_vertices * sizeof(double));
+    double *arr = (double*)malloc(2 * num * sizeof(double));
     if (arr == NULL) return 0;
 
-    memcpy(arr, ps->coords, 2 * ps->num_vertices * sizeof(double));
+    memcpy(arr, vetor_dados(ps->vertices), 2 * num * sizeof(double));
 
     *vertices_out = arr;
-    return ps->num_vertices;
+    return num;
 }
 
 LinkedList poligono_obter_lista(Poligono p) {
@@ -133,8 +160,9 @@ LinkedList poligono_obter_lista(Poligono p) {
     
     if (ps->lista_cache == NULL) {
         ps->lista_cache = list_create();
-        for (int i = 0; i < ps->num_vertices; i++) {
-            Ponto pt = criar_ponto(ps->coords[2*i], ps->coords[2*i+1]);
+        double *coords = (double*)vetor_dados(ps->vertices);
+        for (int i = 0; i < vetor_tamanho(ps->vertices); i++) {
+            Ponto pt = criar_ponto(coords[2*i], coords[2*i+1]);
             list_insert_back(ps->lista_cache, pt);
         }
     }
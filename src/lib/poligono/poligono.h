@@ -21,6 +21,31 @@ Poligono poligono_criar();
  */
 void poligono_destruir(Poligono p);
 
+/**
+ * Cria uma cópia independente do polígono (mesmos vértices, mesma ordem).
+ * @param p Polígono a copiar.
+ * @return Nova instância, ou NULL em caso de erro.
+ */
+Poligono poligono_clonar(Poligono p);
+
+/**
+ * Prende ao polígono um dado opaco de quem o gerou (ex.: a máscara do motor
+ * de visibilidade em grade). O polígono fica com a referência recebida:
+ * chama soltar(anexo) ao ser destruído ou ao receber outro anexo, e cada
+ * clone compartilha o anexo chamando reter(anexo).
+ * @param p Polígono.
+ * @param anexo Dado opaco (NULL só solta o anterior).
+ * @param reter Nova referência ao anexo; devolve o próprio anexo.
+ * @param soltar Desfaz uma referência.
+ */
+void poligono_anexar(Poligono p, void *anexo, void *(*reter)(void*), void (*soltar)(void*));
+
+/**
+ * @param p Polígono.
+ * @return Anexo preso por poligono_anexar(), ou NULL.
+ */
+void* poligono_anexo(Poligono p);
+
 /**
  * Insere um vértice no final da sequência do polígono.
  * @param p Polígono.
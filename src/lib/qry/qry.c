@@ -4,17 +4,28 @@
 #include <stdlib.h>
 #include <math.h>
 #include "../visibilidade/visibilidade.h"
+#include "../visibilidade/cache_visibilidade.h"
+#include "../visibilidade/triangulacao.h"
+#include "../visibilidade/aproximada.h"
 #include "../geo/geo.h"
 #include "../svg/svg.h"
 #include "../geometria/ponto/ponto.h"
 #include "../geometria/segmento/segmento.h"
+#include "../geometria/calculos/calculos.h"
 #include "../utils/lista/lista.h"
+#include "../utils/pool/pool.h"
+#include "../utils/sort/sort.h"
+#include "../utils/arena/arena.h"
 #include "../formas/circulo/circulo.h"
 #include "../formas/retangulo/retangulo.h"
 #include "../formas/linha/linha.h"
 #include "../formas/texto/texto.h"
 #include "../formas/formas.h"
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 typedef struct { TipoForma tipo; void *forma; } ElementoGeo;
 
 static int obter_id(void* forma, TipoForma tipo) {
@@ -33,75 +44,211 @@ static const char* obter_tipo_str(TipoForma tipo) {
     return "?";
 }
 
-static bool forma_foi_atingida(PoligonoVisibilidade pol, ElementoGeo* el) {
-    if (!pol) return false;
+// Máximo de pontos de amostra por forma (retângulo e círculo usam 5)
+#define AMOSTRAS_POR_FORMA 5
 
+/**
+ * Pontos de amostra de uma forma para o teste de atingimento:
+ * retângulo: 4 cantos + centro; círculo: centro + 4 extremos;
+ * texto: âncora; linha: 2 extremos (completados pelo teste de arestas).
+ */
+static int amostras_forma(ElementoGeo* el, double *xs, double *ys) {
     if (el->tipo == RECTANGLE) {
         double x = retangulo_get_x(el->forma);
         double y = retangulo_get_y(el->forma);
         double w = retangulo_get_largura(el->forma);
         double h = retangulo_get_altura(el->forma);
-        
-        Ponto p1 = criar_ponto(x, y);
-        Ponto p2 = criar_ponto(x + w, y);
-        Ponto p3 = criar_ponto(x + w, y + h);
-        Ponto p4 = criar_ponto(x, y + h);
-        
-        bool hit = false;
-        if (visibilidade_ponto_atingido(pol, p1)) hit = true;
-        if (!hit && visibilidade_ponto_atingido(pol, p2)) hit = true;
-        if (!hit && visibilidade_ponto_atingido(pol, p3)) hit = true;
-        if (!hit && visibilidade_ponto_atingido(pol, p4)) hit = true;
-        
-        destruir_ponto(p1); destruir_ponto(p2); destruir_ponto(p3); destruir_ponto(p4);
-        
-        if (hit) return true;
-
-        Ponto centro = criar_ponto(x + w/2, y + h/2);
-        if (visibilidade_ponto_atingido(pol, centro)) hit = true;
-        destruir_ponto(centro);
-        if (hit) return true;
-
+        xs[0] = x;         ys[0] = y;
+        xs[1] = x + w;     ys[1] = y;
+        xs[2] = x + w;     ys[2] = y + h;
+        xs[3] = x;         ys[3] = y + h;
+        xs[4] = x + w/2;   ys[4] = y + h/2;
+        return 5;
     } else if (el->tipo == LINE) {
-        Ponto p1 = criar_ponto(line_get_x1(el->forma), line_get_y1(el->forma));
-        Ponto p2 = criar_ponto(line_get_x2(el->forma), line_get_y2(el->forma));
-        bool hit = visibilidade_segmento_atingido(pol, p1, p2);
-        destruir_ponto(p1); destruir_ponto(p2);
-        if (hit) return true;
-
+        xs[0] = line_get_x1(el->forma); ys[0] = line_get_y1(el->forma);
+        xs[1] = line_get_x2(el->forma); ys[1] = line_get_y2(el->forma);
+        return 2;
     } else if (el->tipo == TEXT) {
-        double x = text_get_x(el->forma);
-        double y = text_get_y(el->forma);
-        Ponto p1 = criar_ponto(x, y);
-        bool hit = visibilidade_ponto_atingido(pol, p1);
-        destruir_ponto(p1);
-        if (hit) return true;
-
+        xs[0] = text_get_x(el->forma); ys[0] = text_get_y(el->forma);
+        return 1;
     } else if (el->tipo == CIRCLE) {
         double cx = circulo_get_x(el->forma);
         double cy = circulo_get_y(el->forma);
         double r = circulo_get_raio(el->forma);
-        
-        Ponto c = criar_ponto(cx, cy);
-        bool hit = visibilidade_ponto_atingido(pol, c);
-        destruir_ponto(c);
-        if (hit) return true;
-        
-        Ponto p1 = criar_ponto(cx + r, cy);
-        Ponto p2 = criar_ponto(cx - r, cy);
-        Ponto p3 = criar_ponto(cx, cy + r);
-        Ponto p4 = criar_ponto(cx, cy - r);
-        
-        if (visibilidade_ponto_atingido(pol, p1)) hit = true;
-        if (!hit && visibilidade_ponto_atingido(pol, p2)) hit = true;
-        if (!hit && visibilidade_ponto_atingido(pol, p3)) hit = true;
-        if (!hit && visibilidade_ponto_atingido(pol, p4)) hit = true;
-        
-        destruir_ponto(p1); destruir_ponto(p2); destruir_ponto(p3); destruir_ponto(p4);
-        if (hit) return true;
+        xs[0] = cx;     ys[0] = cy;
+        xs[1] = cx + r; ys[1] = cy;
+        xs[2] = cx - r; ys[2] = cy;
+        xs[3] = cx;     ys[3] = cy + r;
+        xs[4] = cx;     ys[4] = cy - r;
+        return 5;
     }
-    
-    return false;
+    return 0;
+}
+
+// Menor faixa de formas entregue a uma tarefa do pool
+#define FORMAS_POR_FAIXA 256
+
+static int g_num_threads = 1;
+
+void qry_set_num_threads(int num_threads) {
+    g_num_threads = (num_threads < 1) ? 1 : num_threads;
+}
+
+static bool g_triangulacao = false;
+
+void qry_set_triangulacao(bool ativa) {
+    g_triangulacao = ativa;
+}
+
+static int g_faixas_aproximada = 0;
+
+void qry_set_aproximada(int num_faixas) {
+    g_faixas_aproximada = (num_faixas < 3) ? 0 : num_faixas;
+}
+
+/* Teste de atingimento de uma faixa de formas (fase paralela, somente leitura) */
+typedef struct {
+    PoligonoVisibilidade pol;
+    ElementoGeo *elementos;     /* Cópia (tipo, forma) das formas, na ordem da cidade */
+    int n;
+    int tam_faixa;
+    unsigned char *atingida;    /* Um byte por forma: faixas nunca compartilham bytes */
+} TesteAtingimento;
+
+/**
+ * Testa uma faixa de formas de uma só vez: os pontos de amostra de todas as
+ * formas da faixa vão num único lote para visibilidade_pontos_atingidos().
+ * Linhas sem extremo atingido ainda passam pelo teste de interseção de arestas.
+ */
+static void testar_faixa(void *arg, int faixa) {
+    TesteAtingimento *t = (TesteAtingimento*)arg;
+    int ini = faixa * t->tam_faixa;
+    int fim = ini + t->tam_faixa;
+    if (fim > t->n) fim = t->n;
+    int m = fim - ini;
+
+    double *xs = malloc((AMOSTRAS_POR_FORMA * m) * sizeof(double));
+    double *ys = malloc((AMOSTRAS_POR_FORMA * m) * sizeof(double));
+    int *inicio = malloc((m + 1) * sizeof(int));
+    unsigned char *pontos = malloc(BITMAP_BYTES(AMOSTRAS_POR_FORMA * m) + 1);
+    if (!xs || !ys || !inicio || !pontos) {
+        // Sem memória para o lote: testa ponto a ponto
+        for (int i = ini; i < fim; i++) {
+            double px[AMOSTRAS_POR_FORMA], py[AMOSTRAS_POR_FORMA];
+            unsigned char mapa[BITMAP_BYTES(AMOSTRAS_POR_FORMA)];
+            int q = amostras_forma(&t->elementos[i], px, py);
+            visibilidade_pontos_atingidos(t->pol, px, py, q, mapa);
+            bool hit = false;
+            for (int k = 0; k < q && !hit; k++) hit = BITMAP_TESTAR(mapa, k);
+            if (!hit && t->elementos[i].tipo == LINE) {
+                Ponto p1 = criar_ponto(px[0], py[0]);
+                Ponto p2 = criar_ponto(px[1], py[1]);
+                hit = visibilidade_segmento_atingido(t->pol, p1, p2);
+                destruir_ponto(p1); destruir_ponto(p2);
+            }
+            t->atingida[i] = hit;
+        }
+        free(pontos); free(inicio); free(xs); free(ys);
+        return;
+    }
+
+    int total = 0;
+    for (int i = 0; i < m; i++) {
+        inicio[i] = total;
+        total += amostras_forma(&t->elementos[ini + i], xs + total, ys + total);
+    }
+    inicio[m] = total;
+    visibilidade_pontos_atingidos(t->pol, xs, ys, total, pontos);
+
+    for (int i = 0; i < m; i++) {
+        bool hit = false;
+        for (int k = inicio[i]; k < inicio[i + 1] && !hit; k++) {
+            if (BITMAP_TESTAR(pontos, k)) hit = true;
+        }
+        if (!hit && t->elementos[ini + i].tipo == LINE) {
+            Ponto p1 = criar_ponto(xs[inicio[i]], ys[inicio[i]]);
+            Ponto p2 = criar_ponto(xs[inicio[i] + 1], ys[inicio[i] + 1]);
+            hit = visibilidade_segmento_atingido(t->pol, p1, p2);
+            destruir_ponto(p1); destruir_ponto(p2);
+        }
+        t->atingida[ini + i] = hit;
+    }
+
+    free(pontos);
+    free(inicio);
+    free(xs);
+    free(ys);
+}
+
+static void copiar_elemento(TipoForma tipo, void *forma, void *contexto) {
+    ElementoGeo **destino = (ElementoGeo**)contexto;
+    (*destino)->tipo = tipo;
+    (*destino)->forma = forma;
+    (*destino)++;
+}
+
+/* Folga da caixa do polígono: o teste de arestas tolera GEO_EPSILON */
+#define FOLGA_CAIXA (4 * GEO_EPSILON)
+
+/**
+ * Fase de detecção: testa as formas da cidade contra o polígono, em faixas
+ * distribuídas pelo pool, sem alterar a cidade. Só as formas cuja caixa
+ * toca a caixa do polígono (consulta por região da cidade) são testadas.
+ * @return Formas atingidas, na ordem da cidade; *num_atingidas recebe a quantidade
+ */
+static ElementoGeo* formas_atingidas(PoolThreads pool, PoligonoVisibilidade pol, Geo cidade,
+                                     int *num_atingidas) {
+    *num_atingidas = 0;
+    double min_x, min_y, max_x, max_y;
+    void **candidatas = NULL;
+    TipoForma *tipos = NULL;
+    int n;
+    if (visibilidade_caixa(pol, &min_x, &min_y, &max_x, &max_y)) {
+        n = geo_formas_na_regiao(cidade, min_x - FOLGA_CAIXA, min_y - FOLGA_CAIXA,
+                                 max_x + FOLGA_CAIXA, max_y + FOLGA_CAIXA, &candidatas, &tipos);
+    } else {
+        n = geo_num_formas(cidade);
+    }
+    ElementoGeo *atingidas = malloc((n + 1) * sizeof(ElementoGeo));
+    if (!atingidas || !pol || n == 0) {
+        free(candidatas); free(tipos);
+        return atingidas;
+    }
+
+    TesteAtingimento teste;
+    teste.pol = pol;
+    teste.n = n;
+    teste.elementos = malloc(n * sizeof(ElementoGeo));
+    teste.atingida = calloc(n, 1);
+    if (!teste.elementos || !teste.atingida) {
+        free(teste.elementos); free(teste.atingida); free(atingidas);
+        free(candidatas); free(tipos);
+        return NULL;
+    }
+    if (candidatas) {
+        for (int i = 0; i < n; i++) {
+            teste.elementos[i].tipo = tipos[i];
+            teste.elementos[i].forma = candidatas[i];
+        }
+        free(candidatas); free(tipos);
+    } else {
+        ElementoGeo *cursor = teste.elementos;
+        geo_para_cada(cidade, copiar_elemento, &cursor);
+    }
+
+    // Algumas faixas por thread para equilibrar a carga
+    int por_thread = (n + 4 * pool_num_threads(pool) - 1) / (4 * pool_num_threads(pool));
+    teste.tam_faixa = (por_thread > FORMAS_POR_FAIXA) ? por_thread : FORMAS_POR_FAIXA;
+    int num_faixas = (n + teste.tam_faixa - 1) / teste.tam_faixa;
+    pool_executar(pool, testar_faixa, &teste, num_faixas);
+
+    for (int i = 0; i < n; i++) {
+        if (teste.atingida[i]) atingidas[(*num_atingidas)++] = teste.elementos[i];
+    }
+
+    free(teste.elementos);
+    free(teste.atingida);
+    return atingidas;
 }
 
 static int g_anteparo_id_counter = 5000;
@@ -165,16 +312,25 @@ static void resetar_bbox_acumulada(void) {
     g_bbox_acum_max_y = 0;
 }
 
-static void adicionar_forma_geo(LinkedList formas, void* nova_forma, TipoForma tipo) {
-    ElementoGeo* novo_el = malloc(sizeof(ElementoGeo));
-    novo_el->tipo = tipo;
-    novo_el->forma = nova_forma;
-    list_insert_back(formas, novo_el);
-}
-
 void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const char* geoName) {
     // Resetar estado da bbox acumulada para este arquivo QRY
     resetar_bbox_acumulada();
+
+    // Pool para a detecção de formas atingidas (NULL = serial)
+    PoolThreads pool = (g_num_threads > 1) ? pool_criar(g_num_threads) : NULL;
+    // O mesmo pool serve à ordenação paralela de eventos (-to p) e aos
+    // setores da varredura (-ns)
+    ordenar_definir_pool(pool);
+    visibilidade_set_pool(pool);
+    // Temporários das consultas de visibilidade, reaproveitados de bomba em bomba
+    Arena arena = arena_criar(0);
+    // Polígonos de bombas repetidas (mesma posição e mesmas barreiras)
+    CacheVisibilidade cache = cache_visibilidade_criar(0);
+    // Triangulação dos anteparos (-tri), refeita quando a versão das
+    // barreiras muda; o biombo fica fora dela, como moldura da consulta
+    MalhaVisibilidade malha = NULL;
+    bool malha_montada = false;
+    unsigned long versao_malha = 0;
     
     char *qryBase = strrchr(qryPath, '/');
     qryBase = (qryBase) ? qryBase + 1 : (char*)qryPath;
@@ -200,6 +356,11 @@ void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const c
         if(ftxt) fclose(ftxt);
         if(fsvg_final) fclose(fsvg_final);
         list_destroy(visibility_polygons);
+        ordenar_definir_pool(NULL);
+        visibilidade_set_pool(NULL);
+        pool_destruir(pool);
+        arena_destruir(arena);
+        cache_visibilidade_destruir(cache);
         return;
     }
 
@@ -213,6 +374,10 @@ void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const c
         char cor[50] = "";
         double dx = 0, dy = 0;
         bool is_bomb = false;
+        // Ação da bomba (d, p ou cln); as variantes r e c limitam o alcance
+        char acao[10] = "";
+        LimitesVisao lim = { 0, 0, 0 };
+        double ang_min = 0, ang_max = 0;
 
         int id_ini, id_fim;
         char orientacao = 'v';
@@ -223,132 +388,129 @@ void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const c
 
             fprintf(ftxt, "[*] a\n");
 
-            LinkedList formas = geo_get_formas(cidade);
+            // Só as formas do intervalo, na ordem da cidade (índice por id)
+            void **no_intervalo = NULL;
+            TipoForma *tipos = NULL;
+            int n = geo_formas_no_intervalo(cidade, id_ini, id_fim, &no_intervalo, &tipos);
             LinkedList novas_formas = list_create();
-            LinkedList ids_remover = list_create();
-
-            int n = list_size(formas);
+            int *ids_remover = malloc((n + 1) * sizeof(int));
+            int num_remover = 0;
             for (int i = 0; i < n; i++) {
-                ElementoGeo* el = (ElementoGeo*)list_get_at(formas, i);
+                ElementoGeo elemento = { tipos[i], no_intervalo[i] };
+                ElementoGeo* el = &elemento;
                 int id = obter_id(el->forma, el->tipo);
 
-                if (id >= id_ini && id <= id_fim) {
-                    if (el->tipo == LINE) {
-                        // Linhas: a original é substituída por um anteparo com mesma geometria
-                        void* l = el->forma;
-                        double x1 = line_get_x1(l);
-                        double y1 = line_get_y1(l);
-                        double x2 = line_get_x2(l);
-                        double y2 = line_get_y2(l);
-                        const char* cor = line_get_color(l);
-                        
-                        int seg_id = g_anteparo_id_counter++;
-                        void* new_line = line_create(seg_id, x1, y1, x2, y2, cor);
-                        adicionar_forma_geo(novas_formas, new_line, LINE);
-                        
-                        fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
-                                id, obter_tipo_str(LINE), seg_id, x1, y1, x2, y2);
-                        
-                        // Marca para remoção (a linha original é substituída pelo anteparo)
-                        int* ptr_id = malloc(sizeof(int)); *ptr_id = id;
-                        list_insert_back(ids_remover, ptr_id);
-                        continue;
-                    }
+                if (el->tipo == LINE) {
+                    // Linhas: a original é substituída por um anteparo com mesma geometria
+                    void* l = el->forma;
+                    double x1 = line_get_x1(l);
+                    double y1 = line_get_y1(l);
+                    double x2 = line_get_x2(l);
+                    double y2 = line_get_y2(l);
+                    const char* cor = line_get_color(l);
+                    
+                    int seg_id = g_anteparo_id_counter++;
+                    void* new_line = line_create(seg_id, x1, y1, x2, y2, cor);
+                    list_insert_back(novas_formas, new_line);
+                    
+                    fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
+                            id, obter_tipo_str(LINE), seg_id, x1, y1, x2, y2);
+                    
+                    // Marca para remoção (a linha original é substituída pelo anteparo)
+                    ids_remover[num_remover++] = id;
+                    continue;
+                }
 
-                    int* ptr_id = malloc(sizeof(int)); *ptr_id = id;
-                    list_insert_back(ids_remover, ptr_id);
-
-                    if (el->tipo == CIRCLE) {
-                        void* c = el->forma;
-                        double cx = circulo_get_x(c);
-                        double cy = circulo_get_y(c);
-                        double r = circulo_get_raio(c);
-                        const char* cor_borda = circulo_get_cor_borda(c);
-
-                        int seg_id = g_anteparo_id_counter++;
-                        void* seg = NULL;
-                        
-                        if (orientacao == 'h') {
-                            // Segmento horizontal passando pelo centro
-                            seg = line_create(seg_id, cx - r, cy, cx + r, cy, cor_borda);
-                            fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
-                                    id, obter_tipo_str(CIRCLE), seg_id, cx - r, cy, cx + r, cy);
-                        } else {
-                            // Segmento vertical passando pelo centro
-                            seg = line_create(seg_id, cx, cy - r, cx, cy + r, cor_borda);
-                            fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
-                                    id, obter_tipo_str(CIRCLE), seg_id, cx, cy - r, cx, cy + r);
-                        }
-                        adicionar_forma_geo(novas_formas, seg, LINE);
-                    }
-                    else if (el->tipo == RECTANGLE) {
-                        void* r = el->forma;
-                        double rx = retangulo_get_x(r);
-                        double ry = retangulo_get_y(r);
-                        double w = retangulo_get_largura(r);
-                        double h = retangulo_get_altura(r);
-                        const char* cor_borda = retangulo_get_cor_borda(r);
-
-                        double coords[4][4] = {
-                            {rx, ry, rx + w, ry},
-                            {rx + w, ry, rx + w, ry + h},
-                            {rx + w, ry + h, rx, ry + h},
-                            {rx, ry + h, rx, ry}
-                        };
-
-                        for(int k=0; k<4; k++) {
-                            int new_id = g_anteparo_id_counter++;
-                            void* l = line_create(new_id, coords[k][0], coords[k][1], coords[k][2], coords[k][3], cor_borda);
-                            adicionar_forma_geo(novas_formas, l, LINE);
-                            fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
-                                    id, obter_tipo_str(RECTANGLE), new_id, coords[k][0], coords[k][1], coords[k][2], coords[k][3]);
-                        }
-                    }
-                    else if (el->tipo == TEXT) {
-                        void* t = el->forma;
-                        double tx = text_get_x(t);
-                        double ty = text_get_y(t);
-                        char anchor = text_get_anchor(t);
-                        const char* conteudo = text_get_text(t);
-                        const char* cor_borda = text_get_border_color(t);
-                        
-                        double len = (double)strlen(conteudo);
-                        double width = 10.0 * len;
-                        
-                        double x1, x2;
-                        if (anchor == 'i' || anchor == 's') {
-                            x1 = tx; 
-                            x2 = tx + width;
-                        } else if (anchor == 'f' || anchor == 'e') {
-                            x1 = tx - width;
-                            x2 = tx;
-                        } else {
-                            x1 = tx - width/2.0;
-                            x2 = tx + width/2.0;
-                        }
-                        double y1 = ty; double y2 = ty;
+                ids_remover[num_remover++] = id;
 
+                if (el->tipo == CIRCLE) {
+                    void* c = el->forma;
+                    double cx = circulo_get_x(c);
+                    double cy = circulo_get_y(c);
+                    double r = circulo_get_raio(c);
+                    const char* cor_borda = circulo_get_cor_borda(c);
+
+                    int seg_id = g_anteparo_id_counter++;
+                    void* seg = NULL;
+                    
+                    if (orientacao == 'h') {
+                        // Segmento horizontal passando pelo centro
+                        seg = line_create(seg_id, cx - r, cy, cx + r, cy, cor_borda);
+                        fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
+                                id, obter_tipo_str(CIRCLE), seg_id, cx - r, cy, cx + r, cy);
+                    } else {
+                        // Segmento vertical passando pelo centro
+                        seg = line_create(seg_id, cx, cy - r, cx, cy + r, cor_borda);
+                        fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
+                                id, obter_tipo_str(CIRCLE), seg_id, cx, cy - r, cx, cy + r);
+                    }
+                    list_insert_back(novas_formas, seg);
+                }
+                else if (el->tipo == RECTANGLE) {
+                    void* r = el->forma;
+                    double rx = retangulo_get_x(r);
+                    double ry = retangulo_get_y(r);
+                    double w = retangulo_get_largura(r);
+                    double h = retangulo_get_altura(r);
+                    const char* cor_borda = retangulo_get_cor_borda(r);
+
+                    double coords[4][4] = {
+                        {rx, ry, rx + w, ry},
+                        {rx + w, ry, rx + w, ry + h},
+                        {rx + w, ry + h, rx, ry + h},
+                        {rx, ry + h, rx, ry}
+                    };
+
+                    for(int k=0; k<4; k++) {
                         int new_id = g_anteparo_id_counter++;
-                        void* l = line_create(new_id, x1, y1, x2, y2, cor_borda);
-                        adicionar_forma_geo(novas_formas, l, LINE);
-                        
+                        void* l = line_create(new_id, coords[k][0], coords[k][1], coords[k][2], coords[k][3], cor_borda);
+                        list_insert_back(novas_formas, l);
                         fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
-                                id, obter_tipo_str(TEXT), new_id, x1, y1, x2, y2);
+                                id, obter_tipo_str(RECTANGLE), new_id, coords[k][0], coords[k][1], coords[k][2], coords[k][3]);
                     }
                 }
-            }
+                else if (el->tipo == TEXT) {
+                    void* t = el->forma;
+                    double tx = text_get_x(t);
+                    double ty = text_get_y(t);
+                    char anchor = text_get_anchor(t);
+                    const char* conteudo = text_get_text(t);
+                    const char* cor_borda = text_get_border_color(t);
+                    
+                    double len = (double)strlen(conteudo);
+                    double width = 10.0 * len;
+                    
+                    double x1, x2;
+                    if (anchor == 'i' || anchor == 's') {
+                        x1 = tx; 
+                        x2 = tx + width;
+                    } else if (anchor == 'f' || anchor == 'e') {
+                        x1 = tx - width;
+                        x2 = tx;
+                    } else {
+                        x1 = tx - width/2.0;
+                        x2 = tx + width/2.0;
+                    }
+                    double y1 = ty; double y2 = ty;
 
-            while(!list_is_empty(ids_remover)) {
-                int* ptr = (int*)list_remove_front(ids_remover);
-                geo_remover_forma(cidade, *ptr);
-                free(ptr);
+                    int new_id = g_anteparo_id_counter++;
+                    void* l = line_create(new_id, x1, y1, x2, y2, cor_borda);
+                    list_insert_back(novas_formas, l);
+                    
+                    fprintf(ftxt, "\t%d (%s) -> %d (anteparo) %.2f %.2f %.2f %.2f\n", 
+                            id, obter_tipo_str(TEXT), new_id, x1, y1, x2, y2);
+                }
             }
-            list_destroy(ids_remover);
 
-            LinkedList lista_cidade = geo_get_formas(cidade);
+            free(no_intervalo);
+            free(tipos);
+
+            // Todas as remoções numa única passada pela cidade
+            geo_remover_formas(cidade, ids_remover, num_remover);
+            free(ids_remover);
+
             while(!list_is_empty(novas_formas)) {
-                ElementoGeo* el = list_remove_front(novas_formas);
-                list_insert_back(lista_cidade, el);
+                geo_inserir_forma(cidade, LINE, list_remove_front(novas_formas));
             }
             list_destroy(novas_formas);
         }
@@ -367,65 +529,228 @@ void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const c
             fprintf(ftxt, "[*] cln x=%.2f y=%.2f dx=%.2f dy=%.2f\n", x, y, dx, dy);
             is_bomb = true;
         }
+        // Com raio: dr x y r sfx | pr x y r cor sfx | clnr x y r dx dy sfx
+        else if (strcmp(cmd, "dr") == 0) {
+            sscanf(linha, "%*s %lf %lf %lf %s", &x, &y, &lim.raio, sfx);
+            fprintf(ftxt, "[*] dr x=%.2f y=%.2f r=%.2f\n", x, y, lim.raio);
+            is_bomb = true;
+        }
+        else if (strcmp(cmd, "pr") == 0) {
+            sscanf(linha, "%*s %lf %lf %lf %s %s", &x, &y, &lim.raio, cor, sfx);
+            fprintf(ftxt, "[*] pr x=%.2f y=%.2f r=%.2f %s\n", x, y, lim.raio, cor);
+            is_bomb = true;
+        }
+        else if (strcmp(cmd, "clnr") == 0) {
+            sscanf(linha, "%*s %lf %lf %lf %lf %lf %s", &x, &y, &lim.raio, &dx, &dy, sfx);
+            fprintf(ftxt, "[*] clnr x=%.2f y=%.2f r=%.2f dx=%.2f dy=%.2f\n", x, y, lim.raio, dx, dy);
+            is_bomb = true;
+        }
+        // Em cone (ângulos em graus; r = 0 sem alcance):
+        // dc x y r a1 a2 sfx | pc x y r a1 a2 cor sfx | clnc x y r a1 a2 dx dy sfx
+        else if (strcmp(cmd, "dc") == 0) {
+            sscanf(linha, "%*s %lf %lf %lf %lf %lf %s", &x, &y, &lim.raio, &ang_min, &ang_max, sfx);
+            fprintf(ftxt, "[*] dc x=%.2f y=%.2f r=%.2f a=%.2f..%.2f\n", x, y, lim.raio, ang_min, ang_max);
+            is_bomb = true;
+        }
+        else if (strcmp(cmd, "pc") == 0) {
+            sscanf(linha, "%*s %lf %lf %lf %lf %lf %s %s", &x, &y, &lim.raio, &ang_min, &ang_max, cor, sfx);
+            fprintf(ftxt, "[*] pc x=%.2f y=%.2f r=%.2f a=%.2f..%.2f %s\n", x, y, lim.raio, ang_min, ang_max, cor);
+            is_bomb = true;
+        }
+        else if (strcmp(cmd, "clnc") == 0) {
+            sscanf(linha, "%*s %lf %lf %lf %lf %lf %lf %lf %s", &x, &y, &lim.raio, &ang_min, &ang_max, &dx, &dy, sfx);
+            fprintf(ftxt, "[*] clnc x=%.2f y=%.2f r=%.2f a=%.2f..%.2f dx=%.2f dy=%.2f\n",
+                    x, y, lim.raio, ang_min, ang_max, dx, dy);
+            is_bomb = true;
+        }
+        else if (strcmp(cmd, "path") == 0) {
+            // Observador percorrendo um segmento: só relata, não age sobre a cidade
+            double x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+            int passos = 1;
+            sscanf(linha, "%*s %lf %lf %lf %lf %d %s", &x0, &y0, &x1, &y1, &passos, sfx);
+            if (passos < 1) passos = 1;
+            fprintf(ftxt, "[*] path x0=%.2f y0=%.2f x1=%.2f y1=%.2f passos=%d\n",
+                    x0, y0, x1, y1, passos);
+
+            // As barreiras e o biombo valem para o percurso inteiro
+            geo_get_bounding_box(cidade, &min_x, &min_y, &max_x, &max_y);
+            atualizar_bbox_acumulada(&min_x, &min_y, &max_x, &max_y, x0, y0);
+            atualizar_bbox_acumulada(&min_x, &min_y, &max_x, &max_y, x1, y1);
+
+            Ponto inicio = criar_ponto(x0, y0);
+            LinkedList barreiras = geo_obter_todas_barreiras(cidade);
+            LinkedList biombo = geo_gerar_biombo_com_limites(cidade, inicio,
+                                    g_bbox_acum_min_x, g_bbox_acum_min_y,
+                                    g_bbox_acum_max_x, g_bbox_acum_max_y);
+            while(!list_is_empty(biombo)) {
+                list_insert_back(barreiras, list_remove_front(biombo));
+            }
+            list_destroy(biombo);
+            destruir_ponto(inicio);
+
+            // Cada passo conserta a ordem de eventos do anterior
+            VisibilidadeCinetica vc = visibilidade_cinetica_criar(barreiras);
+            LinkedList poligonos = list_create();
+
+            for (int k = 0; k <= passos && vc; k++) {
+                double t = (double)k / passos;
+                double px = x0 + t * (x1 - x0);
+                double py = y0 + t * (y1 - y0);
+                Ponto obs = criar_ponto(px, py);
+                PoligonoVisibilidade pol = visibilidade_cinetica_calcular(vc, obs, arena);
+                destruir_ponto(obs);
+
+                fprintf(ftxt, "\tpasso %d x=%.2f y=%.2f\n", k, px, py);
+                int num_atingidas = 0;
+                ElementoGeo *atingidas = formas_atingidas(pool, pol, cidade, &num_atingidas);
+                for (int h = 0; h < num_atingidas && atingidas; h++) {
+                    fprintf(ftxt, "\t\t%d %s\n", obter_id(atingidas[h].forma, atingidas[h].tipo),
+                            obter_tipo_str(atingidas[h].tipo));
+                }
+                free(atingidas);
+
+                if (pol) list_insert_back(poligonos, pol);
+            }
+            visibilidade_cinetica_destruir(vc);
+
+            if (strcmp(sfx, "-") == 0) {
+                while(!list_is_empty(poligonos)) {
+                    list_insert_back(visibility_polygons, list_remove_front(poligonos));
+                }
+            } else {
+                char snapshotPath[512];
+                sprintf(snapshotPath, "%s/%s-%s-%s.svg", outPath, geoName, qryNoExt, sfx);
+                FILE *fsnap = fopen(snapshotPath, "w");
+                if (fsnap) {
+                    geo_get_bounding_box(cidade, &min_x, &min_y, &max_x, &max_y);
+                    atualizar_bbox_acumulada(&min_x, &min_y, &max_x, &max_y, x1, y1);
+                    svg_iniciar(fsnap, min_x - margin, min_y - margin, (max_x - min_x) + 2*margin, (max_y - min_y) + 2*margin);
+                    svg_desenhar_cidade(fsnap, cidade);
+                    for(ListCursor c = list_cursor_first(poligonos); list_cursor_valid(&c); list_cursor_next(&c)) {
+                        svg_desenhar_poligono(fsnap, (PoligonoVisibilidade)list_cursor_get(&c), "yellow", 0.5);
+                    }
+                    svg_finalizar(fsnap);
+                    fclose(fsnap);
+                }
+                while(!list_is_empty(poligonos)) {
+                    visibilidade_destruir((PoligonoVisibilidade)list_remove_front(poligonos));
+                }
+            }
+            list_destroy(poligonos);
+
+            while(!list_is_empty(barreiras)) {
+                destruir_segmento((Segmento)list_remove_front(barreiras));
+            }
+            list_destroy(barreiras);
+        }
 
         if (is_bomb) {
             Ponto bomba = criar_ponto(x, y);
+            // "dr", "dc" -> "d"; "clnr", "clnc" -> "cln"
+            strcpy(acao, cmd);
+            if (strcmp(acao, "d") != 0 && strcmp(acao, "p") != 0 && strcmp(acao, "cln") != 0) {
+                acao[strlen(acao) - 1] = '\0';
+            }
+            lim.angulo_min = ang_min * M_PI / 180.0;
+            lim.angulo_max = ang_max * M_PI / 180.0;
 
             // Atualizar bbox acumulada com posição da bomba ANTES de calcular visibilidade
             geo_get_bounding_box(cidade, &min_x, &min_y, &max_x, &max_y);
             atualizar_bbox_acumulada(&min_x, &min_y, &max_x, &max_y, x, y);
             
-            LinkedList barreiras = geo_obter_todas_barreiras(cidade);
-            // Usar biombo com limites da bbox acumulada para garantir que
-            // o polígono de visibilidade nunca diminui
-            LinkedList biombo = geo_gerar_biombo_com_limites(cidade, bomba, 
-                                    g_bbox_acum_min_x, g_bbox_acum_min_y, 
-                                    g_bbox_acum_max_x, g_bbox_acum_max_y);
+            // Mesma posição, barreiras e biombo: o polígono já calculado serve
+            ChaveVisibilidade chave = { x, y, geo_versao_barreiras(cidade),
+                                        g_bbox_acum_min_x, g_bbox_acum_min_y,
+                                        g_bbox_acum_max_x, g_bbox_acum_max_y, lim };
+            // A prévia relata o seu limite de erro, que o cache não guarda
+            bool sem_limites = (lim.raio <= 0 && lim.angulo_min == lim.angulo_max);
+            bool usar_aproximada = (g_faixas_aproximada > 0 && sem_limites);
+            double erro_area = -1.0;
+            PoligonoVisibilidade pol = usar_aproximada ? NULL : cache_visibilidade_obter(cache, &chave);
+            if (pol == NULL && g_triangulacao && sem_limites && !usar_aproximada) {
+                if (!malha_montada || versao_malha != geo_versao_barreiras(cidade)) {
+                    // Anteparos novos ou removidos: a malha antiga não serve
+                    LinkedList anteparos = geo_obter_todas_barreiras(cidade);
+                    malha_visibilidade_destruir(malha);
+                    malha = malha_visibilidade_criar(anteparos);
+                    while(!list_is_empty(anteparos)) {
+                        destruir_segmento((Segmento)list_remove_front(anteparos));
+                    }
+                    list_destroy(anteparos);
+                    versao_malha = geo_versao_barreiras(cidade);
+                    malha_montada = true;
+                }
+                double mx0, my0, mx1, my1;
+                geo_limites_biombo(cidade, bomba, g_bbox_acum_min_x, g_bbox_acum_min_y,
+                                   g_bbox_acum_max_x, g_bbox_acum_max_y, &mx0, &my0, &mx1, &my1);
+                pol = malha_visibilidade_calcular_moldura(malha, bomba, mx0, my0, mx1, my1);
+                if (pol != NULL) cache_visibilidade_guardar(cache, &chave, pol);
+            }
+            if (pol == NULL) {
+                // Com alcance, só os anteparos que chegam ao disco
+                LinkedList barreiras = geo_obter_barreiras_proximas(cidade, x, y, lim.raio);
+                // Usar biombo com limites da bbox acumulada para garantir que
+                // o polígono de visibilidade nunca diminui
+                LinkedList biombo = geo_gerar_biombo_com_limites(cidade, bomba, 
+                                        g_bbox_acum_min_x, g_bbox_acum_min_y, 
+                                        g_bbox_acum_max_x, g_bbox_acum_max_y);
+
+                while(!list_is_empty(biombo)) {
+                    list_insert_back(barreiras, list_remove_front(biombo));
+                }
+                list_destroy(biombo);
 
-            while(!list_is_empty(biombo)) {
-                list_insert_back(barreiras, list_remove_front(biombo));
+                if (usar_aproximada) {
+                    pol = visibilidade_aproximada_calcular(bomba, barreiras, g_faixas_aproximada, &erro_area);
+                }
+                // Sem malha, ou bomba sobre uma aresta dela: motor escolhido
+                // em visibilidade (varredura ou grade)
+                if (pol == NULL) {
+                    erro_area = -1.0;
+                    pol = visibilidade_calcular_limitada(bomba, barreiras, &lim, arena);
+                }
+                if (erro_area < 0) cache_visibilidade_guardar(cache, &chave, pol);
+
+                while(!list_is_empty(barreiras)) {
+                    destruir_segmento((Segmento)list_remove_front(barreiras));
+                }
+                list_destroy(barreiras);
             }
-            list_destroy(biombo);
 
-            PoligonoVisibilidade pol = visibilidade_calcular(bomba, barreiras);
+            if (erro_area >= 0) fprintf(ftxt, "\terro de area <= %.2f\n", erro_area);
 
-            LinkedList formas = geo_get_formas(cidade);
-            int n = list_size(formas);
-            LinkedList to_remove_ids = list_create(); 
+            // Detecção em paralelo; o relatório segue em série, na ordem da cidade
+            int num_atingidas = 0;
+            ElementoGeo *atingidas = formas_atingidas(pool, pol, cidade, &num_atingidas);
+            int *ids_atingidos = malloc((num_atingidas + 1) * sizeof(int));
 
-            for(int i = 0; i < n; i++) {
-                ElementoGeo* el = (ElementoGeo*)list_get_at(formas, i);
+            for(int h = 0; h < num_atingidas && ids_atingidos; h++) {
+                ElementoGeo* el = &atingidas[h];
+                int id = obter_id(el->forma, el->tipo);
+                ids_atingidos[h] = id;
                 
-                if (forma_foi_atingida(pol, el)) {
-                    int id = obter_id(el->forma, el->tipo);
-                    
-                    if (strcmp(cmd, "d") == 0) {
-                        fprintf(ftxt, "\t%d %s\n", id, obter_tipo_str(el->tipo));
-                        int* id_ptr = malloc(sizeof(int)); *id_ptr = id;
-                        list_insert_back(to_remove_ids, id_ptr);
-                    }
-                    else if (strcmp(cmd, "p") == 0) {
-                        fprintf(ftxt, "\t%d %s\n", id, obter_tipo_str(el->tipo));
-                        geo_alterar_cor(cidade, id, cor);
-                    }
-                    else if (strcmp(cmd, "cln") == 0) {
-                        fprintf(ftxt, "\t%d %s (clone do %d %s)\n", 
-                            id + 10000, obter_tipo_str(el->tipo), id, obter_tipo_str(el->tipo));
-                        geo_clonar_forma(cidade, id, dx, dy);
-                    }
+                if (strcmp(acao, "d") == 0 || strcmp(acao, "p") == 0) {
+                    fprintf(ftxt, "\t%d %s\n", id, obter_tipo_str(el->tipo));
+                }
+                else if (strcmp(acao, "cln") == 0) {
+                    fprintf(ftxt, "\t%d %s (clone do %d %s)\n", 
+                        id + 10000, obter_tipo_str(el->tipo), id, obter_tipo_str(el->tipo));
                 }
             }
+            free(atingidas);
 
-            while(!list_is_empty(to_remove_ids)) {
-                int* id_ptr = (int*)list_remove_front(to_remove_ids);
-                geo_remover_forma(cidade, *id_ptr);
-                free(id_ptr);
+            // As ações entram em lote, cada uma numa única passada pela cidade
+            if (ids_atingidos) {
+                if (strcmp(acao, "d") == 0) geo_remover_formas(cidade, ids_atingidos, num_atingidas);
+                else if (strcmp(acao, "p") == 0) geo_alterar_cores(cidade, ids_atingidos, num_atingidas, cor);
+                else if (strcmp(acao, "cln") == 0) geo_clonar_formas(cidade, ids_atingidos, num_atingidas, dx, dy);
             }
-            list_destroy(to_remove_ids);
+            free(ids_atingidos);
 
 
             if (strcmp(sfx, "-") == 0) {
                 // Store the polygon to draw at the end (after city is drawn with final state)
+                visibilidade_soltar_testes(pol);
                 list_insert_back(visibility_polygons, pol);
                 // Importante: atualizar bbox para incluir a posição da bomba
                 geo_get_bounding_box(cidade, &min_x, &min_y, &max_x, &max_y);
@@ -448,11 +773,6 @@ void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const c
             
             // Cleanup - sempre executado independente do sufixo
             destruir_ponto(bomba);
-            
-            while(!list_is_empty(barreiras)) {
-                destruir_segmento((Segmento)list_remove_front(barreiras));
-            }
-            list_destroy(barreiras);
         }
 
     }
@@ -476,6 +796,12 @@ void qry_processar(Geo cidade, const char* qryPath, const char* outPath, const c
     }
     
     list_destroy(visibility_polygons);
+    ordenar_definir_pool(NULL);
+    visibilidade_set_pool(NULL);
+    pool_destruir(pool);
+    arena_destruir(arena);
+    cache_visibilidade_destruir(cache);
+    malha_visibilidade_destruir(malha);
     if (ftxt) fclose(ftxt);
     if (fqry) fclose(fqry);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef QRY_H
 #define QRY_H
 
+#include <stdbool.h>
 #include "../geo/geo.h"
 
 /**
@@ -14,4 +15,31 @@
  */
 void qry_processar(Geo cidade, const char *qryPath, const char *outPath, const char *geoName);
 
+/**
+ * Define quantas threads testam as formas contra o polígono de cada bomba.
+ * A detecção roda em paralelo; as ações (d, p, cln) continuam em série,
+ * na ordem da lista, então a saída não depende do número de threads.
+ * 
+ * @param num_threads Número de threads (1 = serial, padrão)
+ */
+void qry_set_num_threads(int num_threads);
+
+/**
+ * Usa a expansão triangular (ver triangulacao.h) nas bombas sem alcance nem
+ * setor: as barreiras e o biombo são triangulados uma vez e a malha só é
+ * refeita quando eles mudam (anteparos novos, bbox acumulada maior).
+ * Bombas sobre arestas da malha caem em visibilidade_calcular (varredura,
+ * ou grade com visibilidade_set_grade). Desligado por padrão.
+ */
+void qry_set_triangulacao(bool ativa);
+
+/**
+ * Usa a visibilidade aproximada por faixas angulares (ver aproximada.h)
+ * nas bombas sem alcance nem setor, para prévias rápidas. Tem precedência
+ * sobre a expansão triangular.
+ *
+ * @param num_faixas Número de faixas (< 3 desliga, padrão)
+ */
+void qry_set_aproximada(int num_faixas);
+
 #endif
@@ -0,0 +1,129 @@
+/* arena.c
+ *
+ * Implementação da arena: uma lista de blocos, percorrida em ordem.
+ * Após um reset a alocação recomeça no primeiro bloco e reaproveita os
+ * seguintes antes de pedir um novo.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define TAM_BLOCO_PADRAO (64 * 1024)
+#define ALINHAMENTO 16
+
+typedef struct bloco
+{
+    struct bloco *prox;
+    size_t capacidade;
+    size_t usado;
+    /* Dados logo após o cabeçalho (alinhado) */
+} Bloco;
+
+typedef struct
+{
+    Bloco *primeiro;
+    Bloco *atual;
+    size_t tam_bloco;
+    size_t total;
+} ArenaInternal;
+
+#define CABECALHO ((sizeof(Bloco) + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1))
+
+static unsigned char *dados(Bloco *b)
+{
+    return (unsigned char *)b + CABECALHO;
+}
+
+static Bloco *novo_bloco(size_t capacidade)
+{
+    Bloco *b = (Bloco *)malloc(CABECALHO + capacidade);
+    if (b == NULL) return NULL;
+    b->prox = NULL;
+    b->capacidade = capacidade;
+    b->usado = 0;
+    return b;
+}
+
+Arena arena_criar(size_t tam_bloco)
+{
+    ArenaInternal *a = (ArenaInternal *)malloc(sizeof(ArenaInternal));
+    if (a == NULL) return NULL;
+
+    a->tam_bloco = (tam_bloco > 0) ? tam_bloco : TAM_BLOCO_PADRAO;
+    a->primeiro = novo_bloco(a->tam_bloco);
+    if (a->primeiro == NULL)
+    {
+        free(a);
+        return NULL;
+    }
+    a->atual = a->primeiro;
+    a->total = 0;
+    return (Arena)a;
+}
+
+void *arena_alocar(Arena arena, size_t bytes)
+{
+    ArenaInternal *a = (ArenaInternal *)arena;
+    if (a == NULL) return NULL;
+
+    size_t tam = (bytes + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1);
+    if (tam == 0) tam = ALINHAMENTO;
+
+    // Avança pelos blocos já existentes (reaproveitados após reset)
+    while (a->atual->usado + tam > a->atual->capacidade)
+    {
+        if (a->atual->prox == NULL)
+        {
+            size_t cap = (tam > a->tam_bloco) ? tam : a->tam_bloco;
+            Bloco *b = novo_bloco(cap);
+            if (b == NULL) return NULL;
+            a->atual->prox = b;
+        }
+        a->atual = a->atual->prox;
+        a->atual->usado = 0;
+    }
+
+    void *p = dados(a->atual) + a->atual->usado;
+    a->atual->usado += tam;
+    a->total += tam;
+    return p;
+}
+
+void *arena_alocar_zerado(Arena arena, size_t bytes)
+{
+    void *p = arena_alocar(arena, bytes);
+    if (p != NULL) memset(p, 0, bytes);
+    return p;
+}
+
+void arena_resetar(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal *)arena;
+    if (a == NULL) return;
+
+    a->atual = a->primeiro;
+    a->primeiro->usado = 0;
+    a->total = 0;
+}
+
+size_t arena_usado(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal *)arena;
+    return a ? a->total : 0;
+}
+
+void arena_destruir(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal *)arena;
+    if (a == NULL) return;
+
+    Bloco *b = a->primeiro;
+    while (b != NULL)
+    {
+        Bloco *prox = b->prox;
+        free(b);
+        b = prox;
+    }
+    free(a);
+}
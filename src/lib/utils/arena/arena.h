@@ -0,0 +1,55 @@
+/* arena.h
+ *
+ * Alocador por região (bump allocator) para temporários de uma consulta.
+ * As alocações só avançam um ponteiro dentro de blocos grandes; não há
+ * liberação individual. arena_resetar() devolve tudo de uma vez e mantém
+ * os blocos para a próxima consulta, sem voltar ao malloc.
+ *
+ * Não é segura para uso concorrente: cada thread deve ter a sua.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* Tipo opaco para a arena */
+typedef void* Arena;
+
+/**
+ * Cria uma arena vazia.
+ *
+ * @param tam_bloco Tamanho dos blocos pedidos ao sistema (0 usa o padrão)
+ * @return Nova arena, ou NULL em caso de erro
+ */
+Arena arena_criar(size_t tam_bloco);
+
+/**
+ * Reserva bytes alinhados a 16. A memória vale até o próximo
+ * arena_resetar() ou arena_destruir(); não a passe para free().
+ *
+ * @return Ponteiro para a região, ou NULL se faltar memória
+ */
+void *arena_alocar(Arena arena, size_t bytes);
+
+/**
+ * Como arena_alocar, mas zera a região.
+ */
+void *arena_alocar_zerado(Arena arena, size_t bytes);
+
+/**
+ * Invalida todas as alocações, mantendo os blocos para reuso.
+ */
+void arena_resetar(Arena arena);
+
+/**
+ * Total de bytes entregues desde o último reset (inclui alinhamento).
+ */
+size_t arena_usado(Arena arena);
+
+/**
+ * Libera a arena e todos os seus blocos.
+ */
+void arena_destruir(Arena arena);
+
+#endif /* ARENA_H */
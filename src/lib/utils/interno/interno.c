@@ -0,0 +1,125 @@
+/* interno.c
+ *
+ * Implementação da tabela de strings internadas: um hash de endereçamento
+ * aberto (protegido por mutex) aponta para blocos de tamanho fixo que nunca
+ * são realocados, de modo que interno_texto() lê sem travar.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "interno.h"
+#include "../utils.h"
+
+#define BITS_BLOCO 10
+#define TAM_BLOCO (1 << BITS_BLOCO)
+#define MAX_BLOCOS 4096
+
+static char **blocos[MAX_BLOCOS];
+static int num_strings = 0;
+
+/* Hash: posição -> id + 1 (0 = vazia); capacidade sempre potência de 2 */
+static int *tabela = NULL;
+static int cap_tabela = 0;
+
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+/* FNV-1a */
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u;
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static const char *texto_sem_trava(int id)
+{
+    return blocos[id >> BITS_BLOCO][id & (TAM_BLOCO - 1)];
+}
+
+/* Dobra a tabela e reespalha os ids. Chamada com a trava. */
+static int crescer_tabela(void)
+{
+    int nova_cap = cap_tabela ? 2 * cap_tabela : 256;
+    int *nova = calloc(nova_cap, sizeof(int));
+    if (nova == NULL)
+        return 0;
+
+    for (int i = 0; i < num_strings; i++)
+    {
+        unsigned int pos = hash_string(texto_sem_trava(i)) & (nova_cap - 1);
+        while (nova[pos] != 0)
+            pos = (pos + 1) & (nova_cap - 1);
+        nova[pos] = i + 1;
+    }
+
+    free(tabela);
+    tabela = nova;
+    cap_tabela = nova_cap;
+    return 1;
+}
+
+IdString interno_registrar(const char *s)
+{
+    if (s == NULL)
+        return STRING_NENHUMA;
+
+    unsigned int h = hash_string(s);
+    IdString id = STRING_NENHUMA;
+
+    pthread_mutex_lock(&trava);
+
+    // Ocupação máxima de 1/2
+    if (2 * (num_strings + 1) > cap_tabela && !crescer_tabela())
+    {
+        pthread_mutex_unlock(&trava);
+        return STRING_NENHUMA;
+    }
+
+    unsigned int pos = h & (cap_tabela - 1);
+    while (tabela[pos] != 0)
+    {
+        if (strcmp(texto_sem_trava(tabela[pos] - 1), s) == 0)
+        {
+            id = tabela[pos] - 1;
+            pthread_mutex_unlock(&trava);
+            return id;
+        }
+        pos = (pos + 1) & (cap_tabela - 1);
+    }
+
+    int bloco = num_strings >> BITS_BLOCO;
+    if (bloco < MAX_BLOCOS && blocos[bloco] == NULL)
+        blocos[bloco] = calloc(TAM_BLOCO, sizeof(char *));
+
+    char *copia = (bloco < MAX_BLOCOS && blocos[bloco]) ? duplicate_string(s) : NULL;
+    if (copia != NULL)
+    {
+        id = num_strings++;
+        blocos[bloco][id & (TAM_BLOCO - 1)] = copia;
+        tabela[pos] = id + 1;
+    }
+
+    pthread_mutex_unlock(&trava);
+    return id;
+}
+
+const char *interno_texto(IdString id)
+{
+    if (id < 0 || (id >> BITS_BLOCO) >= MAX_BLOCOS || blocos[id >> BITS_BLOCO] == NULL)
+        return NULL;
+    return texto_sem_trava(id);
+}
+
+int interno_quantidade(void)
+{
+    pthread_mutex_lock(&trava);
+    int n = num_strings;
+    pthread_mutex_unlock(&trava);
+    return n;
+}
@@ -0,0 +1,40 @@
+/* interno.h
+ *
+ * Tabela global de strings internadas (cores, fontes).
+ * Cada string distinta é guardada uma única vez e identificada por um
+ * inteiro pequeno; comparar ou trocar uma cor passa a ser copiar um int.
+ * As strings internadas vivem até o fim do programa.
+ */
+
+#ifndef INTERNO_H
+#define INTERNO_H
+
+/* Identificador de uma string internada; STRING_NENHUMA representa NULL */
+typedef int IdString;
+
+#define STRING_NENHUMA (-1)
+
+/**
+ * Retorna o identificador de s, internando-a na primeira vez.
+ * Segura para chamadas concorrentes.
+ *
+ * @param s String a internar (NULL resulta em STRING_NENHUMA)
+ * @return Identificador (>= 0), ou STRING_NENHUMA se s for NULL ou faltar memória
+ */
+IdString interno_registrar(const char *s);
+
+/**
+ * Retorna o texto de um identificador. O ponteiro é estável e não deve
+ * ser liberado. Não trava: o identificador precisa ter sido obtido antes
+ * (na mesma thread ou publicado por outra via sincronização).
+ *
+ * @return Texto internado, ou NULL para STRING_NENHUMA
+ */
+const char *interno_texto(IdString id);
+
+/**
+ * Número de strings distintas já internadas.
+ */
+int interno_quantidade(void);
+
+#endif /* INTERNO_H */
@@ -1,5 +1,7 @@
+#define _POSIX_C_SOURCE 200809L
 #include "lista.h"
 #include <stdlib.h>
+#include <pthread.h>
 
 typedef struct node_t
 {
@@ -7,6 +9,120 @@ typedef struct node_t
     struct node_t *next;
 } Node;
 
+/* ==========================================================================
+ * Pool de nós
+ * ==========================================================================
+ * Cada thread guarda os nós liberados numa free list própria (variável
+ * __thread, nunca compartilhada) e os reaproveita nas próximas inserções.
+ * A free list é limitada a LIST_POOL_MAX nós; o excedente volta ao malloc.
+ * Ao término de uma thread criada com pthread_create a sua free list é
+ * devolvida por um destrutor de pthread_key; a thread principal não passa
+ * por esse destrutor e deve chamar list_pool_liberar() antes de sair.
+ * ========================================================================== */
+
+#define LIST_POOL_MAX 4096
+
+typedef struct
+{
+    Node *livres;
+    ListPoolStats stats;
+} PoolNos;
+
+static __thread PoolNos pool_local;
+static __thread int pool_registrado = 0;
+
+static pthread_key_t chave_pool;
+static pthread_once_t chave_once = PTHREAD_ONCE_INIT;
+
+static void liberar_livres(PoolNos *pool)
+{
+    Node *curr = pool->livres;
+    while (curr != NULL)
+    {
+        Node *next = curr->next;
+        free(curr);
+        curr = next;
+    }
+    pool->livres = NULL;
+    pool->stats.cached = 0;
+}
+
+static void destrutor_pool(void *arg)
+{
+    liberar_livres((PoolNos *)arg);
+}
+
+static void criar_chave(void)
+{
+    pthread_key_create(&chave_pool, destrutor_pool);
+}
+
+static Node *alocar_no(void)
+{
+    PoolNos *pool = &pool_local;
+    Node *node = pool->livres;
+    if (node != NULL)
+    {
+        pool->livres = node->next;
+        pool->stats.cached--;
+        pool->stats.reused++;
+        return node;
+    }
+
+    node = (Node *)malloc(sizeof(Node));
+    if (node != NULL)
+    {
+        pool->stats.allocated++;
+    }
+    return node;
+}
+
+static void devolver_no(Node *node)
+{
+    PoolNos *pool = &pool_local;
+    if (pool->stats.cached >= LIST_POOL_MAX)
+    {
+        free(node);
+        pool->stats.released++;
+        return;
+    }
+
+    if (!pool_registrado)
+    {
+        pthread_once(&chave_once, criar_chave);
+        pthread_setspecific(chave_pool, pool);
+        pool_registrado = 1;
+    }
+    node->next = pool->livres;
+    pool->livres = node;
+    pool->stats.cached++;
+}
+
+void list_pool_stats(ListPoolStats *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = pool_local.stats;
+    }
+}
+
+void list_pool_trim()
+{
+    PoolNos *pool = &pool_local;
+    pool->stats.released += pool->stats.cached;
+    liberar_livres(pool);
+}
+
+void list_pool_liberar()
+{
+    list_pool_trim();
+    if (pool_registrado)
+    {
+        pthread_setspecific(chave_pool, NULL);
+        pool_registrado = 0;
+    }
+}
+
 typedef struct list_t
 {
     Node *head;
@@ -37,7 +153,7 @@ void list_insert_front(LinkedList list, void *value)
         return;
     }
 
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = alocar_no();
     if (node == NULL)
     {
         return;
@@ -62,7 +178,7 @@ void list_insert_back(LinkedList list, void *value)
         return;
     }
 
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = alocar_no();
     if (node == NULL)
     {
         return;
@@ -101,7 +217,7 @@ void *list_remove_front(LinkedList list)
         impl->tail = NULL;
     }
     impl->size--;
-    free(temp);
+    devolver_no(temp);
     return value;
 }
 
@@ -117,7 +233,7 @@ void *list_remove_back(LinkedList list)
 
     if (impl->head == impl->tail)
     {
-        free(impl->head);
+        devolver_no(impl->head);
         impl->head = NULL;
         impl->tail = NULL;
     }
@@ -128,7 +244,7 @@ void *list_remove_back(LinkedList list)
         {
             curr = curr->next;
         }
-        free(impl->tail);
+        devolver_no(impl->tail);
         impl->tail = curr;
         curr->next = NULL;
     }
@@ -224,11 +340,165 @@ void *list_remove_at(LinkedList list, int index)
     void *value = to_remove->data;
     prev->next = to_remove->next;
 
-    free(to_remove);
+    devolver_no(to_remove);
     impl->size--;
     return value;
 }
 
+void list_for_each(LinkedList list, void (*fn)(void *value, void *context), void *context)
+{
+    ListImpl impl = as_impl(list);
+    if (impl == NULL || fn == NULL)
+    {
+        return;
+    }
+
+    for (Node *curr = impl->head; curr != NULL; curr = curr->next)
+    {
+        fn(curr->data, context);
+    }
+}
+
+int list_remove_if(LinkedList list, int (*predicate)(void *value, void *context), void *context)
+{
+    ListImpl impl = as_impl(list);
+    if (impl == NULL || predicate == NULL)
+    {
+        return 0;
+    }
+
+    int removed = 0;
+    Node *prev = NULL;
+    Node *curr = impl->head;
+    while (curr != NULL)
+    {
+        Node *next = curr->next;
+        if (predicate(curr->data, context))
+        {
+            if (prev == NULL)
+            {
+                impl->head = next;
+            }
+            else
+            {
+                prev->next = next;
+            }
+            devolver_no(curr);
+            removed++;
+        }
+        else
+        {
+            prev = curr;
+        }
+        curr = next;
+    }
+
+    impl->tail = prev;
+    impl->size -= removed;
+    return removed;
+}
+
+ListCursor list_cursor_first(LinkedList list)
+{
+    ListImpl impl = as_impl(list);
+    ListCursor cursor;
+    cursor.list = list;
+    cursor.prev = NULL;
+    cursor.curr = (impl != NULL) ? impl->head : NULL;
+    return cursor;
+}
+
+int list_cursor_valid(const ListCursor *cursor)
+{
+    return cursor != NULL && cursor->curr != NULL;
+}
+
+void list_cursor_next(ListCursor *cursor)
+{
+    if (cursor == NULL || cursor->curr == NULL)
+    {
+        return;
+    }
+    cursor->prev = cursor->curr;
+    cursor->curr = ((Node *)cursor->curr)->next;
+}
+
+void *list_cursor_get(const ListCursor *cursor)
+{
+    if (cursor == NULL || cursor->curr == NULL)
+    {
+        return NULL;
+    }
+    return ((Node *)cursor->curr)->data;
+}
+
+void *list_cursor_remove(ListCursor *cursor)
+{
+    if (cursor == NULL || cursor->curr == NULL)
+    {
+        return NULL;
+    }
+
+    ListImpl impl = as_impl(cursor->list);
+    Node *prev = (Node *)cursor->prev;
+    Node *to_remove = (Node *)cursor->curr;
+    void *value = to_remove->data;
+
+    if (prev == NULL)
+    {
+        impl->head = to_remove->next;
+    }
+    else
+    {
+        prev->next = to_remove->next;
+    }
+    if (impl->tail == to_remove)
+    {
+        impl->tail = prev;
+    }
+    impl->size--;
+
+    cursor->curr = to_remove->next;
+    devolver_no(to_remove);
+    return value;
+}
+
+void list_cursor_insert_after(ListCursor *cursor, void *value)
+{
+    if (cursor == NULL)
+    {
+        return;
+    }
+
+    Node *curr = (Node *)cursor->curr;
+    if (curr == NULL)
+    {
+        list_insert_back(cursor->list, value);
+        // O cursor continua no fim; o novo último vira o anterior
+        ListImpl impl = as_impl(cursor->list);
+        if (impl != NULL)
+        {
+            cursor->prev = impl->tail;
+        }
+        return;
+    }
+
+    ListImpl impl = as_impl(cursor->list);
+    Node *node = alocar_no();
+    if (node == NULL)
+    {
+        return;
+    }
+    node->data = value;
+    node->next = curr->next;
+    curr->next = node;
+    if (impl->tail == curr)
+    {
+        impl->tail = node;
+    }
+    impl->size++;
+}
+
 void list_destroy(LinkedList list)
 {
     ListImpl impl = as_impl(list);
@@ -241,7 +511,7 @@ void list_destroy(LinkedList list)
     while (curr != NULL)
     {
         Node *next = curr->next;
-        free(curr);
+        devolver_no(curr);
         curr = next;
     }
     free(impl);
@@ -4,6 +4,16 @@
 // Tipo opaco da lista encadeada
 typedef void *LinkedList;
 
+// Estatísticas do pool de nós da thread chamadora. Os nós removidos ficam
+// numa free list por thread e são reaproveitados pelas próximas inserções
+typedef struct
+{
+    long allocated; // nós obtidos do malloc
+    long reused;    // inserções atendidas pela free list
+    long released;  // nós devolvidos ao free (free list cheia ou trim)
+    long cached;    // nós parados na free list agora
+} ListPoolStats;
+
 // Cria uma lista vazia
 LinkedList list_create();
 
@@ -40,4 +50,52 @@ void *list_get_at(LinkedList list, int index);
 // Remove elemento em indice especifico
 void *list_remove_at(LinkedList list, int index);
 
+// Chama fn(valor, contexto) para cada elemento, do primeiro ao último
+void list_for_each(LinkedList list, void (*fn)(void *value, void *context), void *context);
+
+// Remove, numa única passada, os elementos com predicate(valor, contexto) != 0,
+// preservando a ordem dos demais. Não libera os dados; retorna quantos saíram
+int list_remove_if(LinkedList list, int (*predicate)(void *value, void *context), void *context);
+
+// Cursor de percurso: aponta para um elemento da lista (ou para o fim) e
+// guarda o anterior, permitindo remover ou inserir na posição em O(1).
+// É um valor leve; os campos são internos
+typedef struct
+{
+    LinkedList list;
+    void *prev;
+    void *curr;
+} ListCursor;
+
+// Cursor no primeiro elemento (ou no fim, se a lista estiver vazia)
+ListCursor list_cursor_first(LinkedList list);
+
+// Retorna 1 enquanto o cursor aponta para um elemento, 0 no fim
+int list_cursor_valid(const ListCursor *cursor);
+
+// Avança para o próximo elemento
+void list_cursor_next(ListCursor *cursor);
+
+// Retorna o elemento sob o cursor (NULL no fim)
+void *list_cursor_get(const ListCursor *cursor);
+
+// Remove e retorna o elemento sob o cursor, que passa a apontar para o
+// seguinte. Não libera o dado; retorna NULL no fim
+void *list_cursor_remove(ListCursor *cursor);
+
+// Insere valor logo após o elemento sob o cursor, sem movê-lo. No fim da
+// lista equivale a list_insert_back
+void list_cursor_insert_after(ListCursor *cursor, void *value);
+
+// Copia as estatísticas do pool de nós da thread chamadora
+void list_pool_stats(ListPoolStats *stats);
+
+// Devolve ao malloc os nós parados na free list da thread chamadora
+void list_pool_trim();
+
+// Libera a free list da thread chamadora e a desvincula do destrutor de
+// thread. A thread principal deve chamá-la ao sair (ex.: via atexit), pois o
+// destrutor de pthread_key só roda para threads criadas com pthread_create
+void list_pool_liberar();
+
 #endif // LISTA_H
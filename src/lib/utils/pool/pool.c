@@ -0,0 +1,150 @@
+/* pool.c
+ *
+ * Implementação do pool de threads.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <pthread.h>
+#include "pool.h"
+
+typedef struct {
+    pthread_t *threads;
+    int num_auxiliares;
+    
+    pthread_mutex_t trava;
+    pthread_cond_t tem_trabalho;    /* Nova rodada publicada (ou encerramento) */
+    pthread_cond_t terminou;        /* Última tarefa da rodada concluída */
+    
+    /* Rodada atual, protegida por 'trava' */
+    FuncaoTarefa tarefa;
+    void *arg;
+    int num_tarefas;
+    int proxima;                    /* Próximo índice a distribuir */
+    int pendentes;                  /* Tarefas ainda não concluídas */
+    unsigned long rodada;           /* Incrementada a cada pool_executar */
+    int encerrar;
+} PoolInternal;
+
+/* Consome tarefas da rodada atual até esgotá-las. Chamada com a trava. */
+static void consumir_tarefas(PoolInternal *p)
+{
+    while (p->proxima < p->num_tarefas)
+    {
+        int i = p->proxima++;
+        FuncaoTarefa tarefa = p->tarefa;
+        void *arg = p->arg;
+        
+        pthread_mutex_unlock(&p->trava);
+        tarefa(arg, i);
+        pthread_mutex_lock(&p->trava);
+        
+        if (--p->pendentes == 0)
+        {
+            pthread_cond_broadcast(&p->terminou);
+        }
+    }
+}
+
+static void* trabalhador(void *arg)
+{
+    PoolInternal *p = (PoolInternal*)arg;
+    unsigned long vista = 0;
+    
+    pthread_mutex_lock(&p->trava);
+    while (1)
+    {
+        while (!p->encerrar && p->rodada == vista)
+        {
+            pthread_cond_wait(&p->tem_trabalho, &p->trava);
+        }
+        if (p->encerrar) break;
+        
+        vista = p->rodada;
+        consumir_tarefas(p);
+    }
+    pthread_mutex_unlock(&p->trava);
+    return NULL;
+}
+
+PoolThreads pool_criar(int num_threads)
+{
+    if (num_threads < 1) return NULL;
+    
+    PoolInternal *p = (PoolInternal*)calloc(1, sizeof(PoolInternal));
+    if (p == NULL) return NULL;
+    
+    p->threads = (pthread_t*)malloc((num_threads > 1 ? num_threads - 1 : 1) * sizeof(pthread_t));
+    if (p->threads == NULL)
+    {
+        free(p);
+        return NULL;
+    }
+    pthread_mutex_init(&p->trava, NULL);
+    pthread_cond_init(&p->tem_trabalho, NULL);
+    pthread_cond_init(&p->terminou, NULL);
+    
+    for (int i = 0; i < num_threads - 1; i++)
+    {
+        if (pthread_create(&p->threads[i], NULL, trabalhador, p) != 0) break;
+        p->num_auxiliares++;
+    }
+    return (PoolThreads)p;
+}
+
+void pool_executar(PoolThreads pool, FuncaoTarefa tarefa, void *arg, int num_tarefas)
+{
+    PoolInternal *p = (PoolInternal*)pool;
+    if (tarefa == NULL || num_tarefas <= 0) return;
+    
+    if (p == NULL || p->num_auxiliares == 0 || num_tarefas == 1)
+    {
+        for (int i = 0; i < num_tarefas; i++) tarefa(arg, i);
+        return;
+    }
+    
+    pthread_mutex_lock(&p->trava);
+    p->tarefa = tarefa;
+    p->arg = arg;
+    p->num_tarefas = num_tarefas;
+    p->proxima = 0;
+    p->pendentes = num_tarefas;
+    p->rodada++;
+    pthread_cond_broadcast(&p->tem_trabalho);
+    
+    /* A thread chamadora também trabalha */
+    consumir_tarefas(p);
+    while (p->pendentes > 0)
+    {
+        pthread_cond_wait(&p->terminou, &p->trava);
+    }
+    pthread_mutex_unlock(&p->trava);
+}
+
+int pool_num_threads(PoolThreads pool)
+{
+    PoolInternal *p = (PoolInternal*)pool;
+    return (p == NULL) ? 1 : p->num_auxiliares + 1;
+}
+
+void pool_destruir(PoolThreads pool)
+{
+    PoolInternal *p = (PoolInternal*)pool;
+    if (p == NULL) return;
+    
+    pthread_mutex_lock(&p->trava);
+    p->encerrar = 1;
+    pthread_cond_broadcast(&p->tem_trabalho);
+    pthread_mutex_unlock(&p->trava);
+    
+    for (int i = 0; i < p->num_auxiliares; i++)
+    {
+        pthread_join(p->threads[i], NULL);
+    }
+    
+    pthread_cond_destroy(&p->tem_trabalho);
+    pthread_cond_destroy(&p->terminou);
+    pthread_mutex_destroy(&p->trava);
+    free(p->threads);
+    free(p);
+}
@@ -0,0 +1,51 @@
+/* pool.h
+ *
+ * Pool de threads de tamanho fixo para laços paralelos.
+ * As threads são criadas uma vez e reaproveitadas entre as chamadas
+ * de pool_executar(), que funciona como um "parallel for" com barreira.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+/* Tipo opaco para o pool */
+typedef void* PoolThreads;
+
+/* Corpo de uma tarefa: recebe o argumento comum e o índice da tarefa */
+typedef void (*FuncaoTarefa)(void *arg, int indice);
+
+/**
+ * Cria um pool com num_threads threads no total. A thread chamadora conta
+ * como uma delas, então são criadas num_threads - 1 threads auxiliares.
+ * 
+ * @param num_threads Número total de threads (>= 1)
+ * @return Novo pool, ou NULL em caso de erro
+ */
+PoolThreads pool_criar(int num_threads);
+
+/**
+ * Executa tarefa(arg, i) para i em [0, num_tarefas) e retorna quando todas
+ * terminarem. As tarefas são distribuídas dinamicamente entre as threads,
+ * sem ordem garantida; cada índice é executado exatamente uma vez.
+ * Com pool NULL as tarefas rodam em série na thread chamadora.
+ * 
+ * @param pool Pool de threads (ou NULL)
+ * @param tarefa Função executada para cada índice
+ * @param arg Argumento repassado a todas as tarefas
+ * @param num_tarefas Número de tarefas
+ * 
+ * @note Não é reentrante: uma tarefa não pode chamar pool_executar no mesmo pool.
+ */
+void pool_executar(PoolThreads pool, FuncaoTarefa tarefa, void *arg, int num_tarefas);
+
+/**
+ * Retorna o número total de threads do pool (1 se pool for NULL).
+ */
+int pool_num_threads(PoolThreads pool);
+
+/**
+ * Encerra as threads auxiliares e libera o pool.
+ */
+void pool_destruir(PoolThreads pool);
+
+#endif /* POOL_H */
@@ -0,0 +1,177 @@
+/* calibracao.c
+ *
+ * Escolha do algoritmo de ordenação por faixa de tamanho. As medidas vêm
+ * do medidor de quem ordena, para que os candidatos sejam cronometrados
+ * no mesmo caminho (tipo, comparação, semente do TimSort) que usam de fato.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "calibracao.h"
+
+#define MAX_N_PADRAO 131072
+#define ELEMENTOS_POR_MEDIDA 131072
+#define REPETICOES 3
+
+typedef struct {
+    AlgoritmoOrdenacao alg;
+    int limiar;
+} Candidato;
+
+/* Segundos por elemento do candidato em vetores de tamanho n (melhor de
+ * REPETICOES); cada medida ordena ELEMENTOS_POR_MEDIDA elementos no total.
+ * Negativo se o medidor falhar */
+static double medir(MedidorOrdenacao medidor, const Candidato *c, int n)
+{
+    int rodadas = ELEMENTOS_POR_MEDIDA / n;
+    if (rodadas < 1) rodadas = 1;
+
+    double melhor = 1e30;
+    for (int r = 0; r < REPETICOES; r++)
+    {
+        double total = medidor(c->alg, c->limiar, n, rodadas);
+        if (total < 0) return -1;
+        if (total < melhor) melhor = total;
+    }
+    return melhor / ((double)rodadas * n);
+}
+
+int calibracao_executar(ConfigOrdenacao *cfg, PoolThreads pool, int max_n, MedidorOrdenacao medidor)
+{
+    if (cfg == NULL || medidor == NULL) return 0;
+    if (max_n <= 0) max_n = MAX_N_PADRAO;
+
+    Candidato candidatos[8];
+    int num_candidatos = 0;
+    candidatos[num_candidatos++] = (Candidato){ ALG_QSORT, 0 };
+    int limiares[] = { 4, 8, 16, 32 };
+    for (int i = 0; i < 4; i++) candidatos[num_candidatos++] = (Candidato){ ALG_MERGESORT, limiares[i] };
+    candidatos[num_candidatos++] = (Candidato){ ALG_TIMSORT, 0 };
+    if (pool_num_threads(pool) > 1) candidatos[num_candidatos++] = (Candidato){ ALG_PARALLEL_MERGESORT, 16 };
+
+    /* Tamanhos 32, 256, 2048, ... (fator 8) até max_n */
+    int tamanhos[MAX_FAIXAS_ORDENACAO];
+    int num_tamanhos = 0;
+    for (int n = 32; n <= max_n && num_tamanhos < MAX_FAIXAS_ORDENACAO; n *= 8) tamanhos[num_tamanhos++] = n;
+    if (num_tamanhos == 0) tamanhos[num_tamanhos++] = max_n;
+
+    ordenar_definir_pool(pool);
+
+    cfg->num_faixas = 0;
+    for (int t = 0; t < num_tamanhos; t++)
+    {
+        int n = tamanhos[t];
+        int melhor = 0;
+        double melhor_tempo = 1e30;
+        for (int c = 0; c < num_candidatos; c++)
+        {
+            double tempo = medir(medidor, &candidatos[c], n);
+            if (tempo < 0)
+            {
+                ordenar_definir_pool(NULL);
+                return 0;
+            }
+            if (tempo < melhor_tempo)
+            {
+                melhor_tempo = tempo;
+                melhor = c;
+            }
+        }
+
+        /* A faixa vai até a média geométrica com o próximo tamanho */
+        FaixaOrdenacao f;
+        f.max_n = (t + 1 < num_tamanhos) ? (int)sqrt((double)n * tamanhos[t + 1]) : -1;
+        f.alg = candidatos[melhor].alg;
+        f.limiar = candidatos[melhor].limiar;
+
+        /* Faixas vizinhas com a mesma escolha são fundidas */
+        FaixaOrdenacao *ultima = (cfg->num_faixas > 0) ? &cfg->faixas[cfg->num_faixas - 1] : NULL;
+        if (ultima != NULL && ultima->alg == f.alg && ultima->limiar == f.limiar) ultima->max_n = f.max_n;
+        else cfg->faixas[cfg->num_faixas++] = f;
+    }
+
+    ordenar_definir_pool(NULL);
+    return 1;
+}
+
+char calibracao_letra(AlgoritmoOrdenacao alg)
+{
+    switch (alg)
+    {
+        case ALG_MERGESORT: return 'm';
+        case ALG_TIMSORT: return 't';
+        case ALG_PARALLEL_MERGESORT: return 'p';
+        default: return 'q';
+    }
+}
+
+int calibracao_algoritmo(char letra)
+{
+    switch (letra)
+    {
+        case 'q': return ALG_QSORT;
+        case 'm': return ALG_MERGESORT;
+        case 't': return ALG_TIMSORT;
+        case 'p': return ALG_PARALLEL_MERGESORT;
+        default: return -1;
+    }
+}
+
+int calibracao_salvar(const ConfigOrdenacao *cfg, const char *path)
+{
+    if (cfg == NULL || path == NULL) return 0;
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return 0;
+
+    fprintf(f, "# max_n algoritmo limiar\n");
+    for (int i = 0; i < cfg->num_faixas; i++)
+    {
+        const FaixaOrdenacao *faixa = &cfg->faixas[i];
+        if (faixa->max_n < 0) fprintf(f, "* %c %d\n", calibracao_letra(faixa->alg), faixa->limiar);
+        else fprintf(f, "%d %c %d\n", faixa->max_n, calibracao_letra(faixa->alg), faixa->limiar);
+    }
+    return fclose(f) == 0;
+}
+
+int calibracao_carregar(ConfigOrdenacao *cfg, const char *path)
+{
+    if (cfg == NULL || path == NULL) return 0;
+    cfg->num_faixas = 0;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+
+    char linha[128];
+    while (fgets(linha, sizeof(linha), f) && cfg->num_faixas < MAX_FAIXAS_ORDENACAO)
+    {
+        char max_str[32], letra;
+        int limiar;
+        if (linha[0] == '#') continue;
+        if (sscanf(linha, "%31s %c %d", max_str, &letra, &limiar) != 3) continue;
+
+        int alg = calibracao_algoritmo(letra);
+        if (alg < 0 || limiar < 0) continue;
+        // Os MergeSorts param no Insertion Sort: limiar 0 nunca chega ao caso base
+        if ((alg == ALG_MERGESORT || alg == ALG_PARALLEL_MERGESORT) && limiar < 1) continue;
+        FaixaOrdenacao faixa;
+        faixa.max_n = (strcmp(max_str, "*") == 0) ? -1 : atoi(max_str);
+        faixa.alg = (AlgoritmoOrdenacao)alg;
+        faixa.limiar = limiar;
+        cfg->faixas[cfg->num_faixas++] = faixa;
+        if (faixa.max_n < 0) break;
+    }
+    fclose(f);
+    return cfg->num_faixas > 0;
+}
+
+const FaixaOrdenacao *calibracao_escolher(const ConfigOrdenacao *cfg, int n)
+{
+    if (cfg == NULL || cfg->num_faixas == 0) return NULL;
+    for (int i = 0; i < cfg->num_faixas; i++)
+    {
+        if (cfg->faixas[i].max_n < 0 || n <= cfg->faixas[i].max_n) return &cfg->faixas[i];
+    }
+    /* Arquivo sem faixa ilimitada: a última cobre o resto */
+    return &cfg->faixas[cfg->num_faixas - 1];
+}
@@ -0,0 +1,82 @@
+/* calibracao.h
+ *
+ * Calibração da ordenação na máquina atual. Mede os algoritmos (e os
+ * limiares do Insertion Sort) com um medidor fornecido por quem ordena (a
+ * varredura usa visibilidade_medir_ordenacao, que roda as suas próprias
+ * instâncias de ordenação), em vários tamanhos, e guarda o vencedor de
+ * cada faixa de tamanho num arquivo de configuração pequeno, em texto:
+ *
+ *   # max_n algoritmo limiar
+ *   256 m 8
+ *   8192 q 0
+ *   * m 16
+ *
+ * O algoritmo usa as mesmas letras de -to: q, m, t e p.
+ */
+
+#ifndef CALIBRACAO_H
+#define CALIBRACAO_H
+
+#include "sort.h"
+#include "../pool/pool.h"
+
+#define MAX_FAIXAS_ORDENACAO 8
+
+/* Escolha para vetores com até max_n elementos (max_n < 0: sem limite) */
+typedef struct {
+    int max_n;
+    AlgoritmoOrdenacao alg;
+    int limiar;
+} FaixaOrdenacao;
+
+/* Faixas em ordem crescente de max_n; a última não tem limite */
+typedef struct {
+    int num_faixas;
+    FaixaOrdenacao faixas[MAX_FAIXAS_ORDENACAO];
+} ConfigOrdenacao;
+
+/**
+ * Segundos gastos em rodadas ordenações de n elementos com alg e limiar,
+ * sem contar a preparação da entrada; < 0 se faltar memória.
+ */
+typedef double (*MedidorOrdenacao)(AlgoritmoOrdenacao alg, int limiar, int n, int rodadas);
+
+/**
+ * Mede os candidatos e preenche cfg com o mais rápido de cada tamanho.
+ * ALG_PARALLEL_MERGESORT só entra com um pool de 2 ou mais threads, que
+ * é instalado com ordenar_definir_pool() durante a medida; ao final o
+ * pool de ordenação volta a ser NULL.
+ *
+ * @param cfg Configuração de saída
+ * @param pool Pool para o MergeSort paralelo (ou NULL)
+ * @param max_n Maior tamanho medido (<= 0 usa o padrão)
+ * @param medir Medidor dos candidatos
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int calibracao_executar(ConfigOrdenacao *cfg, PoolThreads pool, int max_n, MedidorOrdenacao medir);
+
+/**
+ * Grava a configuração no arquivo.
+ * @return 1 em caso de sucesso, 0 em caso de erro de E/S
+ */
+int calibracao_salvar(const ConfigOrdenacao *cfg, const char *path);
+
+/**
+ * Lê a configuração do arquivo; linhas inválidas são ignoradas, inclusive
+ * as de MergeSort (m, p) com limiar menor que 1.
+ * @return 1 se ao menos uma faixa foi lida, 0 caso contrário
+ */
+int calibracao_carregar(ConfigOrdenacao *cfg, const char *path);
+
+/**
+ * Retorna a faixa que cobre n elementos (NULL se cfg estiver vazia).
+ */
+const FaixaOrdenacao *calibracao_escolher(const ConfigOrdenacao *cfg, int n);
+
+/**
+ * Letra de -to correspondente ao algoritmo, e o inverso (-1 se inválida).
+ */
+char calibracao_letra(AlgoritmoOrdenacao alg);
+int calibracao_algoritmo(char letra);
+
+#endif /* CALIBRACAO_H */
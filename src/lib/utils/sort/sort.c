@@ -13,13 +13,43 @@
  * Algoritmos Auxiliares
  * ============================================================================ */
 
+/* Troca os bytes de dois elementos, sem memória auxiliar */
+static void trocar_elementos(char *a, char *b, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        char t = a[i];
+        a[i] = b[i];
+        b[i] = t;
+    }
+}
+
+/**
+ * Insertion Sort por trocas de vizinhos, in-place e sem alocar: a saída
+ * estável de quem fica sem memória para o vetor auxiliar.
+ */
+static void insercao_por_trocas(char *base, size_t nmemb, size_t size, FuncaoComparacao compar)
+{
+    for (size_t i = 1; i < nmemb; i++)
+    {
+        for (size_t j = i; j > 0 && compar(base + j * size, base + (j - 1) * size) < 0; j--)
+        {
+            trocar_elementos(base + j * size, base + (j - 1) * size, size);
+        }
+    }
+}
+
 /**
  * Insertion Sort para pequenos arrays/subarrays.
  */
 static void insertion_sort(char *base, size_t nmemb, size_t size, FuncaoComparacao compar)
 {
     char *temp = (char*)malloc(size);
-    if (temp == NULL) return;
+    if (temp == NULL)
+    {
+        insercao_por_trocas(base, nmemb, size, compar);
+        return;
+    }
 
     for (size_t i = 1; i < nmemb; i++)
     {
@@ -117,10 +147,9 @@ static void mergesort_hibrido(void *base, size_t nmemb, size_t size, FuncaoCompa
     char *aux = (char*)malloc(nmemb * size);
     if (aux == NULL)
     {
-        /* Fallback para qsort em caso de falta de memória ??
-           Ou tenta fazer insertion sort in-place (muito lento para arrays grandes).
-           Vamos assumir qsort como fallback seguro. */
-        qsort(base, nmemb, size, compar);
+        /* Sem memória: qsort não é estável, então insertion sort in-place
+           (lento para arrays grandes, mas mantém a ordem dos empates) */
+        insercao_por_trocas((char*)base, nmemb, size, compar);
         return;
     }
     
@@ -129,6 +158,411 @@ static void mergesort_hibrido(void *base, size_t nmemb, size_t size, FuncaoCompa
     free(aux);
 }
 
+/* ============================================================================
+ * TimSort
+ * ============================================================================
+ * Percorre o vetor em trechos ("runs") já ordenados; trechos decrescentes
+ * são invertidos e trechos curtos são estendidos até MIN_RUN por inserção
+ * binária. Os trechos vão para uma pilha e são intercalados mantendo as
+ * invariantes do TimSort (tamanhos decrescentes à la Fibonacci), o que
+ * limita a pilha a O(log n). Em vez do galloping completo, cada
+ * intercalação apara por busca binária as pontas já em ordem e insere
+ * o lado restante por busca binária quando ele é curto, o que basta para
+ * entradas quase ordenadas.
+ */
+
+#define MIN_MERGE 32
+#define MIN_GALOPE 7
+#define MAX_PILHA 85
+
+typedef struct {
+    size_t inicio;
+    size_t tamanho;
+} Run;
+
+/* Tamanho mínimo de trecho: entre MIN_MERGE/2 e MIN_MERGE, escolhido para
+ * que n / min_run fique perto de uma potência de 2 */
+static size_t calcular_min_run(size_t n)
+{
+    size_t r = 0;
+    while (n >= MIN_MERGE)
+    {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+static void inverter(char *base, size_t ini, size_t fim, size_t size, char *temp)
+{
+    while (fim > ini + 1)
+    {
+        fim--;
+        memcpy(temp, base + ini * size, size);
+        memcpy(base + ini * size, base + fim * size, size);
+        memcpy(base + fim * size, temp, size);
+        ini++;
+    }
+}
+
+/* Tamanho do trecho ordenado em [ini, n); trechos estritamente
+ * decrescentes são invertidos (estritos para preservar a estabilidade) */
+static size_t contar_run(char *base, size_t ini, size_t n, size_t size,
+                         FuncaoComparacao compar, char *temp)
+{
+    size_t fim = ini + 1;
+    if (fim == n) return 1;
+
+    if (compar(base + fim * size, base + ini * size) < 0)
+    {
+        fim++;
+        while (fim < n && compar(base + fim * size, base + (fim - 1) * size) < 0) fim++;
+        inverter(base, ini, fim, size, temp);
+    }
+    else
+    {
+        fim++;
+        while (fim < n && compar(base + fim * size, base + (fim - 1) * size) >= 0) fim++;
+    }
+    return fim - ini;
+}
+
+/* Inserção binária em [0, n), sabendo que [0, ordenados) já está em ordem */
+static void insercao_binaria(char *base, size_t n, size_t ordenados, size_t size,
+                             FuncaoComparacao compar, char *temp)
+{
+    for (size_t i = ordenados; i < n; i++)
+    {
+        memcpy(temp, base + i * size, size);
+        size_t esq = 0, dir = i;
+        while (esq < dir)
+        {
+            size_t meio = esq + (dir - esq) / 2;
+            if (compar(temp, base + meio * size) < 0) dir = meio;
+            else esq = meio + 1;
+        }
+        memmove(base + (esq + 1) * size, base + esq * size, (i - esq) * size);
+        memcpy(base + esq * size, temp, size);
+    }
+}
+
+/* Primeira posição de [ini, fim) cujo elemento é >= chave; com
+ * depois_de_iguais, a primeira com elemento > chave */
+static size_t buscar_posicao(char *base, size_t ini, size_t fim, const void *chave,
+                             size_t size, FuncaoComparacao compar, int depois_de_iguais)
+{
+    while (ini < fim)
+    {
+        size_t meio = ini + (fim - ini) / 2;
+        int c = compar(base + meio * size, chave);
+        if (c < 0 || (depois_de_iguais && c == 0)) ini = meio + 1;
+        else fim = meio;
+    }
+    return ini;
+}
+
+/* Intercala [ini, meio) curto em [meio, fim) por busca binária:
+ * O(na log nb) comparações em vez de O(na + nb) */
+static void inserir_esquerda(char *base, size_t ini, size_t meio, size_t fim,
+                             size_t size, FuncaoComparacao compar, char *aux)
+{
+    size_t na = meio - ini;
+    memcpy(aux, base + ini * size, na * size);
+    size_t destino = ini, ib = meio;
+    for (size_t i = 0; i < na; i++)
+    {
+        char *a = aux + i * size;
+        size_t p = buscar_posicao(base, ib, fim, a, size, compar, 0);
+        memmove(base + destino * size, base + ib * size, (p - ib) * size);
+        destino += p - ib;
+        ib = p;
+        memcpy(base + destino * size, a, size);
+        destino++;
+    }
+}
+
+/* Simétrico: [meio, fim) curto, inserido de trás para frente */
+static void inserir_direita(char *base, size_t ini, size_t meio, size_t fim,
+                            size_t size, FuncaoComparacao compar, char *aux)
+{
+    size_t nb = fim - meio;
+    memcpy(aux, base + meio * size, nb * size);
+    size_t destino = fim, ia = meio;
+    for (size_t i = nb; i-- > 0; )
+    {
+        char *b = aux + i * size;
+        size_t q = buscar_posicao(base, ini, ia, b, size, compar, 1);
+        destino -= ia - q;
+        memmove(base + destino * size, base + q * size, (ia - q) * size);
+        ia = q;
+        destino--;
+        memcpy(base + destino * size, b, size);
+    }
+}
+
+/* Intercala os trechos i e i+1 da pilha. Antes, descarta por busca binária
+ * o começo de A que já precede B e o fim de B que já sucede A; se um dos
+ * lados restantes for curto, insere-o por busca binária. */
+static void intercalar_runs(char *base, Run *pilha, int i, size_t size,
+                            FuncaoComparacao compar, char *aux)
+{
+    size_t ini = pilha[i].inicio;
+    size_t meio = ini + pilha[i].tamanho;
+    size_t fim = meio + pilha[i + 1].tamanho;
+    pilha[i].tamanho += pilha[i + 1].tamanho;
+
+    ini = buscar_posicao(base, ini, meio, base + meio * size, size, compar, 1);
+    if (ini == meio) return;
+    fim = buscar_posicao(base, meio, fim, base + (meio - 1) * size, size, compar, 0);
+
+    if (meio - ini <= MIN_GALOPE)
+    {
+        inserir_esquerda(base, ini, meio, fim, size, compar, aux);
+    }
+    else if (fim - meio <= MIN_GALOPE)
+    {
+        inserir_direita(base, ini, meio, fim, size, compar, aux);
+    }
+    else
+    {
+        merge(base, ini, meio, fim, size, compar, aux);
+    }
+}
+
+static void timsort(void *vbase, size_t nmemb, size_t size, FuncaoComparacao compar)
+{
+    if (nmemb < 2) return;
+
+    char *base = (char*)vbase;
+    char *aux = (char*)malloc(nmemb * size);
+    char *temp = (char*)malloc(size);
+    if (aux == NULL || temp == NULL)
+    {
+        free(aux);
+        free(temp);
+        insercao_por_trocas(base, nmemb, size, compar);
+        return;
+    }
+
+    Run pilha[MAX_PILHA];
+    int topo = 0;
+    size_t min_run = calcular_min_run(nmemb);
+
+    for (size_t ini = 0; ini < nmemb; )
+    {
+        size_t tam = contar_run(base, ini, nmemb, size, compar, temp);
+        if (tam < min_run)
+        {
+            size_t forcado = (nmemb - ini < min_run) ? nmemb - ini : min_run;
+            insercao_binaria(base + ini * size, forcado, tam, size, compar, temp);
+            tam = forcado;
+        }
+        pilha[topo].inicio = ini;
+        pilha[topo].tamanho = tam;
+        topo++;
+        ini += tam;
+
+        /* Restaura as invariantes |Z| > |Y| + |X| e |Y| > |X| no topo */
+        while (topo > 1)
+        {
+            int n = topo - 2;
+            if ((n > 0 && pilha[n - 1].tamanho <= pilha[n].tamanho + pilha[n + 1].tamanho) ||
+                (n > 1 && pilha[n - 2].tamanho <= pilha[n - 1].tamanho + pilha[n].tamanho))
+            {
+                if (pilha[n - 1].tamanho < pilha[n + 1].tamanho) n--;
+            }
+            else if (pilha[n].tamanho > pilha[n + 1].tamanho)
+            {
+                break;
+            }
+            intercalar_runs(base, pilha, n, size, compar, aux);
+            for (int k = n + 1; k < topo - 1; k++) pilha[k] = pilha[k + 1];
+            topo--;
+        }
+    }
+
+    while (topo > 1)
+    {
+        int n = topo - 2;
+        if (n > 0 && pilha[n - 1].tamanho < pilha[n + 1].tamanho) n--;
+        intercalar_runs(base, pilha, n, size, compar, aux);
+        for (int k = n + 1; k < topo - 1; k++) pilha[k] = pilha[k + 1];
+        topo--;
+    }
+
+    free(temp);
+    free(aux);
+}
+
+/* ============================================================================
+ * MergeSort Paralelo
+ * ============================================================================
+ * Fase 1: o vetor é cortado em blocos contíguos, ordenados em paralelo pelo
+ * MergeSort híbrido (mesmo limiar). Fase 2: rodadas de intercalação aos
+ * pares, alternando entre o vetor e o auxiliar. Cada par é repartido em
+ * pedaços da saída; o co-ranking (busca binária) acha onde cada pedaço
+ * começa em A e em B, e os pedaços são intercalados de forma independente.
+ * Empates vêm sempre de A, então o resultado é o mesmo do MergeSort serial.
+ */
+
+#define GRAO_PARALELO 4096
+#define TAREFAS_POR_THREAD 4
+
+static PoolThreads pool_ordenacao = NULL;
+
+void ordenar_definir_pool(PoolThreads pool)
+{
+    pool_ordenacao = pool;
+}
+
+typedef struct {
+    char *base;
+    char *aux;
+    size_t nmemb;
+    size_t size;
+    FuncaoComparacao compar;
+    int limiar;
+    /* Fase 1 */
+    size_t tam_bloco;
+    /* Fase 2: trechos ordenados de tamanho largura em origem -> destino */
+    char *origem;
+    char *destino;
+    size_t largura;
+    size_t pedacos;     /* Pedaços por par */
+} OrdenacaoParalela;
+
+static void tarefa_bloco(void *arg, int indice)
+{
+    OrdenacaoParalela *o = (OrdenacaoParalela*)arg;
+    size_t ini = (size_t)indice * o->tam_bloco;
+    size_t fim = ini + o->tam_bloco;
+    if (fim > o->nmemb) fim = o->nmemb;
+    if (fim - ini < 2) return;
+    mergesort_recursivo(o->base, ini, fim, o->size, o->compar, o->aux, o->limiar);
+}
+
+/* Quantos elementos de A estão entre os k primeiros da intercalação
+ * estável de A (na) com B (nb) */
+static size_t co_rank(size_t k, const char *a, size_t na, const char *b, size_t nb,
+                      size_t size, FuncaoComparacao compar)
+{
+    size_t ini = (k > nb) ? k - nb : 0;
+    size_t fim = (k < na) ? k : na;
+    while (ini < fim)
+    {
+        size_t i = ini + (fim - ini) / 2;
+        size_t j = k - i;
+        /* A[i] <= B[j-1]: A[i] ainda sai antes de B[j-1] */
+        if (j > 0 && compar(a + i * size, b + (j - 1) * size) <= 0) ini = i + 1;
+        else fim = i;
+    }
+    return ini;
+}
+
+static void intercalar_em(char *destino, const char *a, size_t na, const char *b, size_t nb,
+                          size_t size, FuncaoComparacao compar)
+{
+    size_t i = 0, j = 0;
+    while (i < na && j < nb)
+    {
+        if (compar(a + i * size, b + j * size) <= 0)
+        {
+            memcpy(destino, a + i * size, size);
+            i++;
+        }
+        else
+        {
+            memcpy(destino, b + j * size, size);
+            j++;
+        }
+        destino += size;
+    }
+    memcpy(destino, a + i * size, (na - i) * size);
+    destino += (na - i) * size;
+    memcpy(destino, b + j * size, (nb - j) * size);
+}
+
+static void tarefa_intercalacao(void *arg, int indice)
+{
+    OrdenacaoParalela *o = (OrdenacaoParalela*)arg;
+    size_t par = (size_t)indice / o->pedacos;
+    size_t pedaco = (size_t)indice % o->pedacos;
+    size_t size = o->size;
+
+    size_t ini = par * 2 * o->largura;
+    if (ini >= o->nmemb) return;
+    size_t meio = ini + o->largura;
+    if (meio > o->nmemb) meio = o->nmemb;
+    size_t fim = meio + o->largura;
+    if (fim > o->nmemb) fim = o->nmemb;
+
+    const char *a = o->origem + ini * size;
+    const char *b = o->origem + meio * size;
+    size_t na = meio - ini, nb = fim - meio;
+    size_t total = na + nb;
+
+    size_t k0 = total * pedaco / o->pedacos;
+    size_t k1 = total * (pedaco + 1) / o->pedacos;
+    if (k0 == k1) return;
+    size_t i0 = co_rank(k0, a, na, b, nb, size, o->compar);
+    size_t i1 = co_rank(k1, a, na, b, nb, size, o->compar);
+
+    intercalar_em(o->destino + (ini + k0) * size, a + i0 * size, i1 - i0,
+                  b + (k0 - i0) * size, (k1 - i1) - (k0 - i0), size, o->compar);
+}
+
+static void mergesort_paralelo(void *base, size_t nmemb, size_t size,
+                               FuncaoComparacao compar, int limiar)
+{
+    PoolThreads pool = pool_ordenacao;
+    int threads = pool_num_threads(pool);
+    if (pool == NULL || threads < 2 || nmemb < 2 * GRAO_PARALELO)
+    {
+        mergesort_hibrido(base, nmemb, size, compar, limiar);
+        return;
+    }
+
+    char *aux = (char*)malloc(nmemb * size);
+    if (aux == NULL)
+    {
+        mergesort_hibrido(base, nmemb, size, compar, limiar);
+        return;
+    }
+
+    OrdenacaoParalela o;
+    o.base = (char*)base;
+    o.aux = aux;
+    o.nmemb = nmemb;
+    o.size = size;
+    o.compar = compar;
+    o.limiar = limiar;
+
+    size_t num_blocos = nmemb / GRAO_PARALELO;
+    if (num_blocos > (size_t)threads * TAREFAS_POR_THREAD) num_blocos = (size_t)threads * TAREFAS_POR_THREAD;
+    o.tam_bloco = (nmemb + num_blocos - 1) / num_blocos;
+    num_blocos = (nmemb + o.tam_bloco - 1) / o.tam_bloco;
+    pool_executar(pool, tarefa_bloco, &o, (int)num_blocos);
+
+    o.origem = o.base;
+    o.destino = aux;
+    for (o.largura = o.tam_bloco; o.largura < nmemb; o.largura *= 2)
+    {
+        size_t pares = (nmemb + 2 * o.largura - 1) / (2 * o.largura);
+        size_t pedacos = ((size_t)threads * TAREFAS_POR_THREAD + pares - 1) / pares;
+        size_t max_pedacos = (2 * o.largura) / GRAO_PARALELO;
+        if (pedacos > max_pedacos) pedacos = max_pedacos;
+        o.pedacos = (pedacos > 0) ? pedacos : 1;
+        pool_executar(pool, tarefa_intercalacao, &o, (int)(pares * o.pedacos));
+
+        char *troca = o.origem;
+        o.origem = o.destino;
+        o.destino = troca;
+    }
+
+    if (o.origem != o.base) memcpy(o.base, o.origem, nmemb * size);
+    free(aux);
+}
+
 /* ============================================================================
  * Interface Pública
  * ============================================================================ */
@@ -140,6 +574,14 @@ void ordenar(void *base, size_t nmemb, size_t size,
     {
         mergesort_hibrido(base, nmemb, size, compar, limiar);
     }
+    else if (alg == ALG_TIMSORT)
+    {
+        timsort(base, nmemb, size, compar);
+    }
+    else if (alg == ALG_PARALLEL_MERGESORT)
+    {
+        mergesort_paralelo(base, nmemb, size, compar, limiar);
+    }
     else
     {
         /* Default: QSort padrão da libc */
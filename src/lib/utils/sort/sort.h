@@ -1,18 +1,24 @@
 /* sort.h
  *
  * Módulo de ordenação genérica.
- * Suporta QSort e MergeSort Híbrido (Merge + Insertion).
+ * Suporta QSort, MergeSort Híbrido (Merge + Insertion) e um TimSort
+ * adaptativo, que detecta trechos já ordenados e fica perto de O(n) em
+ * entradas quase ordenadas. ALG_PARALLEL_MERGESORT divide o MergeSort
+ * entre as threads de um pool.
  */
 
 #ifndef SORT_H
 #define SORT_H
 
 #include <stddef.h>
+#include "../pool/pool.h"
 
 /* Tipos de algoritmos de ordenação */
 typedef enum {
     ALG_QSORT,
-    ALG_MERGESORT
+    ALG_MERGESORT,
+    ALG_TIMSORT,
+    ALG_PARALLEL_MERGESORT
 } AlgoritmoOrdenacao;
 
 /* Tipo para função de comparação (estilo qsort) */
@@ -25,10 +31,25 @@ typedef int (*FuncaoComparacao)(const void*, const void*);
  * @param nmemb Número de elementos
  * @param size Tamanho de cada elemento
  * @param compar Função de comparação
- * @param alg Algoritmo a ser utilizado (ALG_QSORT ou ALG_MERGESORT)
- * @param limiar Limiar para Insertion Sort (apenas para ALG_MERGESORT)
+ * @param alg Algoritmo a ser utilizado (ALG_QSORT, ALG_MERGESORT,
+ *            ALG_TIMSORT ou ALG_PARALLEL_MERGESORT)
+ * @param limiar Limiar para Insertion Sort (ALG_MERGESORT e ALG_PARALLEL_MERGESORT)
+ *
+ * @note ALG_MERGESORT, ALG_TIMSORT e ALG_PARALLEL_MERGESORT são estáveis e
+ *       os dois MergeSorts produzem exatamente a mesma ordem. Sem memória
+ *       para o vetor auxiliar eles caem num insertion sort in-place, que
+ *       também é estável; ALG_QSORT (qsort da libc) não garante estabilidade.
  */
 void ordenar(void *base, size_t nmemb, size_t size, 
              FuncaoComparacao compar, AlgoritmoOrdenacao alg, int limiar);
 
+/**
+ * Define o pool usado por ALG_PARALLEL_MERGESORT. Sem pool (NULL, o padrão)
+ * ou com vetores pequenos o algoritmo cai no MergeSort serial.
+ *
+ * @note O pool não é reentrante: não ordene com ALG_PARALLEL_MERGESORT de
+ *       dentro de uma tarefa do mesmo pool.
+ */
+void ordenar_definir_pool(PoolThreads pool);
+
 #endif /* SORT_H */
@@ -0,0 +1,172 @@
+/* sort_tipado.h
+ *
+ * Ordenações especializadas por tipo, geradas por macro. Ao contrário de
+ * ordenar(), o tipo do elemento e a comparação são conhecidos em tempo de
+ * compilação: os elementos são movidos por atribuição (sem memcpy de
+ * tamanho variável nem buffer temporário por chamada) e a comparação é
+ * expandida no lugar, sem ponteiro de função.
+ *
+ * Uso (no escopo de arquivo):
+ *
+ *   #define MENOR_INT(a, b) ((a) < (b))
+ *   DEFINIR_ORDENACAO(ints, int, MENOR_INT)
+ *
+ * gera as funções estáticas
+ *
+ *   void ints_insercao(int *v, size_t n);
+ *   void ints_mergesort(int *v, size_t n, int limiar);   (estável)
+ *   void ints_introsort(int *v, size_t n);               (não estável)
+ *
+ * MENOR(a, b) deve ser uma ordem estrita ("a vem antes de b") e recebe
+ * valores do tipo, não ponteiros. ints_mergesort faz as mesmas divisões
+ * e comparações que ordenar(..., ALG_MERGESORT, limiar), logo produz a
+ * mesma ordem.
+ */
+
+#ifndef SORT_TIPADO_H
+#define SORT_TIPADO_H
+
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Trechos até este tamanho ficam para a inserção final do introsort */
+#define INTROSORT_LIMIAR 16
+
+#define DEFINIR_ORDENACAO(nome, Tipo, MENOR)                                   \
+                                                                               \
+static void nome##_insercao(Tipo *v, size_t n)                                 \
+{                                                                              \
+    for (size_t i = 1; i < n; i++)                                             \
+    {                                                                          \
+        Tipo x = v[i];                                                         \
+        size_t j = i;                                                          \
+        while (j > 0 && MENOR(x, v[j - 1]))                                    \
+        {                                                                      \
+            v[j] = v[j - 1];                                                   \
+            j--;                                                               \
+        }                                                                      \
+        v[j] = x;                                                              \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void nome##_intercalar(Tipo *v, size_t meio, size_t n, Tipo *aux)       \
+{                                                                              \
+    size_t i = 0, j = meio, k = 0;                                             \
+    while (i < meio && j < n)                                                  \
+    {                                                                          \
+        if (MENOR(v[j], v[i])) aux[k++] = v[j++];                              \
+        else aux[k++] = v[i++];                                                \
+    }                                                                          \
+    while (i < meio) aux[k++] = v[i++];                                        \
+    while (j < n) aux[k++] = v[j++];                                           \
+    for (k = 0; k < n; k++) v[k] = aux[k];                                     \
+}                                                                              \
+                                                                               \
+static void nome##_mergesort_rec(Tipo *v, size_t n, Tipo *aux, int limiar)     \
+{                                                                              \
+    if ((int)n <= limiar || n < 2)                                             \
+    {                                                                          \
+        nome##_insercao(v, n);                                                 \
+        return;                                                                \
+    }                                                                          \
+    size_t meio = n / 2;                                                       \
+    nome##_mergesort_rec(v, meio, aux, limiar);                                \
+    nome##_mergesort_rec(v + meio, n - meio, aux + meio, limiar);              \
+    nome##_intercalar(v, meio, n, aux);                                        \
+}                                                                              \
+                                                                               \
+static void nome##_introsort(Tipo *v, size_t n);                               \
+                                                                               \
+static void nome##_mergesort(Tipo *v, size_t n, int limiar)                    \
+{                                                                              \
+    if (n < 2) return;                                                         \
+    Tipo *aux = (Tipo*)malloc(n * sizeof(Tipo));                               \
+    if (aux == NULL)                                                           \
+    {                                                                          \
+        nome##_introsort(v, n);                                                \
+        return;                                                                \
+    }                                                                          \
+    nome##_mergesort_rec(v, n, aux, limiar);                                   \
+    free(aux);                                                                 \
+}                                                                              \
+                                                                               \
+static void nome##_descer(Tipo *v, size_t i, size_t n)                         \
+{                                                                              \
+    Tipo x = v[i];                                                             \
+    for (;;)                                                                   \
+    {                                                                          \
+        size_t filho = 2 * i + 1;                                              \
+        if (filho >= n) break;                                                 \
+        if (filho + 1 < n && MENOR(v[filho], v[filho + 1])) filho++;           \
+        if (!MENOR(x, v[filho])) break;                                        \
+        v[i] = v[filho];                                                       \
+        i = filho;                                                             \
+    }                                                                          \
+    v[i] = x;                                                                  \
+}                                                                              \
+                                                                               \
+static void nome##_heapsort(Tipo *v, size_t n)                                 \
+{                                                                              \
+    for (size_t i = n / 2; i-- > 0; ) nome##_descer(v, i, n);                  \
+    for (size_t fim = n; fim-- > 1; )                                          \
+    {                                                                          \
+        Tipo x = v[0]; v[0] = v[fim]; v[fim] = x;                              \
+        nome##_descer(v, 0, fim);                                              \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void nome##_introsort_rec(Tipo *v, size_t n, int profundidade)          \
+{                                                                              \
+    while (n > INTROSORT_LIMIAR)                                               \
+    {                                                                          \
+        if (profundidade-- == 0)                                               \
+        {                                                                      \
+            nome##_heapsort(v, n);                                             \
+            return;                                                            \
+        }                                                                      \
+        /* Mediana de três para o meio; Hoare em torno dela */                 \
+        size_t m = (n - 1) / 2;                                                \
+        Tipo t;                                                                \
+        if (MENOR(v[m], v[0])) { t = v[m]; v[m] = v[0]; v[0] = t; }            \
+        if (MENOR(v[n - 1], v[m]))                                             \
+        {                                                                      \
+            t = v[m]; v[m] = v[n - 1]; v[n - 1] = t;                           \
+            if (MENOR(v[m], v[0])) { t = v[m]; v[m] = v[0]; v[0] = t; }        \
+        }                                                                      \
+        Tipo pivo = v[m];                                                      \
+        size_t i = 0, j = n - 1;                                               \
+        for (;;)                                                               \
+        {                                                                      \
+            while (MENOR(v[i], pivo)) i++;                                     \
+            while (MENOR(pivo, v[j])) j--;                                     \
+            if (i >= j) break;                                                 \
+            t = v[i]; v[i] = v[j]; v[j] = t;                                   \
+            i++;                                                               \
+            j--;                                                               \
+        }                                                                      \
+        /* [0, j] e [j + 1, n): recursão no menor, laço no maior */            \
+        size_t esq = j + 1;                                                    \
+        if (esq < n - esq)                                                     \
+        {                                                                      \
+            nome##_introsort_rec(v, esq, profundidade);                        \
+            v += esq;                                                          \
+            n -= esq;                                                          \
+        }                                                                      \
+        else                                                                   \
+        {                                                                      \
+            nome##_introsort_rec(v + esq, n - esq, profundidade);              \
+            n = esq;                                                           \
+        }                                                                      \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void nome##_introsort(Tipo *v, size_t n)                                \
+{                                                                              \
+    if (n < 2) return;                                                         \
+    int profundidade = 0;                                                      \
+    for (size_t k = n; k > 1; k >>= 1) profundidade += 2;                      \
+    nome##_introsort_rec(v, n, profundidade);                                  \
+    nome##_insercao(v, n);                                                     \
+}
+
+#endif /* SORT_TIPADO_H */
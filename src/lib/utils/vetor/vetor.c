@@ -0,0 +1,137 @@
+/* vetor.c
+ *
+ * Implementação do vetor genérico: um único bloco contíguo que cresce
+ * por duplicação.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "vetor.h"
+
+#define CAPACIDADE_INICIAL 16
+
+typedef struct
+{
+    unsigned char *dados;
+    int tamanho;
+    int capacidade;
+    size_t tam_elemento;
+} VetorInternal;
+
+static unsigned char *posicao(VetorInternal *v, int i)
+{
+    return v->dados + (size_t)i * v->tam_elemento;
+}
+
+Vetor vetor_criar(size_t tam_elemento)
+{
+    if (tam_elemento == 0) return NULL;
+    VetorInternal *v = (VetorInternal *)calloc(1, sizeof(VetorInternal));
+    if (v == NULL) return NULL;
+    v->tam_elemento = tam_elemento;
+    return (Vetor)v;
+}
+
+int vetor_reservar(Vetor vetor, int capacidade)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL) return 0;
+    if (capacidade <= v->capacidade) return 1;
+
+    unsigned char *novo = (unsigned char *)realloc(v->dados, (size_t)capacidade * v->tam_elemento);
+    if (novo == NULL) return 0;
+    v->dados = novo;
+    v->capacidade = capacidade;
+    return 1;
+}
+
+void *vetor_inserir(Vetor vetor, const void *elemento)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL) return NULL;
+    if (v->tamanho >= v->capacidade)
+    {
+        int nova_cap = v->capacidade ? 2 * v->capacidade : CAPACIDADE_INICIAL;
+        if (!vetor_reservar(vetor, nova_cap)) return NULL;
+    }
+
+    unsigned char *destino = posicao(v, v->tamanho++);
+    if (elemento != NULL) memcpy(destino, elemento, v->tam_elemento);
+    else memset(destino, 0, v->tam_elemento);
+    return destino;
+}
+
+int vetor_remover_ultimo(Vetor vetor, void *saida)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL || v->tamanho == 0) return 0;
+    v->tamanho--;
+    if (saida != NULL) memcpy(saida, posicao(v, v->tamanho), v->tam_elemento);
+    return 1;
+}
+
+int vetor_remover_troca(Vetor vetor, int i, void *saida)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL || i < 0 || i >= v->tamanho) return 0;
+    if (saida != NULL) memcpy(saida, posicao(v, i), v->tam_elemento);
+    v->tamanho--;
+    if (i != v->tamanho) memcpy(posicao(v, i), posicao(v, v->tamanho), v->tam_elemento);
+    return 1;
+}
+
+int vetor_remover_ordenado(Vetor vetor, int i, void *saida)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL || i < 0 || i >= v->tamanho) return 0;
+    if (saida != NULL) memcpy(saida, posicao(v, i), v->tam_elemento);
+    memmove(posicao(v, i), posicao(v, i + 1), (size_t)(v->tamanho - i - 1) * v->tam_elemento);
+    v->tamanho--;
+    return 1;
+}
+
+void *vetor_obter(Vetor vetor, int i)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL || i < 0 || i >= v->tamanho) return NULL;
+    return posicao(v, i);
+}
+
+void *vetor_dados(Vetor vetor)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    return v ? v->dados : NULL;
+}
+
+int vetor_tamanho(Vetor vetor)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    return v ? v->tamanho : 0;
+}
+
+void vetor_truncar(Vetor vetor, int n)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL || n < 0 || n >= v->tamanho) return;
+    v->tamanho = n;
+}
+
+void vetor_limpar(Vetor vetor)
+{
+    vetor_truncar(vetor, 0);
+}
+
+void vetor_ordenar(Vetor vetor, FuncaoComparacao compar, AlgoritmoOrdenacao alg, int limiar)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL || compar == NULL || v->tamanho < 2) return;
+    ordenar(v->dados, (size_t)v->tamanho, v->tam_elemento, compar, alg, limiar);
+}
+
+void vetor_destruir(Vetor vetor)
+{
+    VetorInternal *v = (VetorInternal *)vetor;
+    if (v == NULL) return;
+    free(v->dados);
+    free(v);
+}
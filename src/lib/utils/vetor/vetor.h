@@ -0,0 +1,103 @@
+/* vetor.h
+ *
+ * Vetor genérico contíguo e redimensionável. Os elementos são guardados
+ * por valor (tam_elemento bytes cada), com acesso por índice em O(1).
+ * A capacidade dobra quando enche; ponteiros obtidos com vetor_obter() ou
+ * vetor_dados() deixam de valer após uma inserção que realoque.
+ */
+
+#ifndef VETOR_H
+#define VETOR_H
+
+#include <stddef.h>
+#include "../sort/sort.h"
+
+/* Tipo opaco para o vetor */
+typedef void* Vetor;
+
+/**
+ * Cria um vetor vazio.
+ *
+ * @param tam_elemento Tamanho de cada elemento em bytes (> 0)
+ * @return Novo vetor, ou NULL em caso de erro
+ */
+Vetor vetor_criar(size_t tam_elemento);
+
+/**
+ * Garante espaço para ao menos capacidade elementos sem realocar.
+ *
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int vetor_reservar(Vetor v, int capacidade);
+
+/**
+ * Copia o elemento para o fim do vetor. Com elemento NULL a nova
+ * posição é zerada.
+ *
+ * @return Ponteiro para a posição inserida, ou NULL se faltar memória
+ */
+void *vetor_inserir(Vetor v, const void *elemento);
+
+/**
+ * Remove o último elemento, copiando-o para saida (se não for NULL).
+ *
+ * @return 1 se havia elemento, 0 se o vetor estava vazio
+ */
+int vetor_remover_ultimo(Vetor v, void *saida);
+
+/**
+ * Remove o elemento i movendo o último para o seu lugar: O(1), mas não
+ * preserva a ordem.
+ *
+ * @return 1 em caso de sucesso, 0 se o índice for inválido
+ */
+int vetor_remover_troca(Vetor v, int i, void *saida);
+
+/**
+ * Remove o elemento i deslocando os seguintes: O(n), preserva a ordem.
+ *
+ * @return 1 em caso de sucesso, 0 se o índice for inválido
+ */
+int vetor_remover_ordenado(Vetor v, int i, void *saida);
+
+/**
+ * Retorna o endereço do elemento i, ou NULL se o índice for inválido.
+ */
+void *vetor_obter(Vetor v, int i);
+
+/**
+ * Retorna o início do armazenamento contíguo (NULL se nunca alocado).
+ */
+void *vetor_dados(Vetor v);
+
+/**
+ * Retorna o número de elementos.
+ */
+int vetor_tamanho(Vetor v);
+
+/**
+ * Descarta os elementos a partir de n (n maior que o tamanho é ignorado).
+ * A capacidade é mantida.
+ */
+void vetor_truncar(Vetor v, int n);
+
+/**
+ * Esvazia o vetor mantendo a capacidade.
+ */
+void vetor_limpar(Vetor v);
+
+/**
+ * Ordena o vetor no lugar com ordenar().
+ *
+ * @param compar Função de comparação entre dois elementos
+ * @param alg Algoritmo de ordenação
+ * @param limiar Limiar para Insertion Sort (apenas para ALG_MERGESORT)
+ */
+void vetor_ordenar(Vetor v, FuncaoComparacao compar, AlgoritmoOrdenacao alg, int limiar);
+
+/**
+ * Libera o vetor e o seu armazenamento. Aceita NULL.
+ */
+void vetor_destruir(Vetor v);
+
+#endif /* VETOR_H */
@@ -0,0 +1,219 @@
+/* aproximada.c
+ *
+ * A faixa i cobre os ângulos [i, i + 1) * passo e é amostrada no raio
+ * central (i + 0.5) * passo. A cunha j fica entre os raios centrais j e
+ * j + 1; é nela que o polígono liga as amostras por um lado reto.
+ *
+ * Uma cunha é "limpa" quando as duas amostras atingem a mesma barreira S,
+ * nenhuma barreira cabe inteira nela e nenhum extremo de barreira fica no
+ * triângulo entre a origem e as duas amostras. Outra barreira que passasse
+ * na frente de S teria de entrar nesse triângulo por um dos raios (e seria
+ * a mais próxima naquela amostra) ou cruzar S duas vezes; logo o lado do
+ * polígono é exatamente o trecho visível de S. As demais cunhas ("sujas")
+ * podem errar em qualquer ponto do setor até o raio máximo da cena.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "aproximada.h"
+#include "../geometria/segmento/segmento.h"
+#include "../poligono/poligono.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MARGEM_BBOX 5.0     /* Mesma margem das bordas da varredura */
+#define TOL_RADIAL 1e-12    /* Segmentos alinhados com a origem não bloqueiam área */
+
+typedef struct {
+    double x1, y1, x2, y2;  /* Relativos à origem */
+} Trecho;
+
+static double angulo_positivo(double y, double x)
+{
+    double a = atan2(y, x);
+    return (a < 0) ? a + 2 * M_PI : a;
+}
+
+/* Cunha que contém o ângulo a (entre os raios centrais j e j + 1) */
+static int cunha_do_angulo(double a, double passo, int k)
+{
+    int j = (int)floor(a / passo - 0.5);
+    j %= k;
+    return (j < 0) ? j + k : j;
+}
+
+/* Copia as barreiras relativas à origem, acrescentando bordas se faltarem */
+static Trecho* copiar_trechos(LinkedList barreiras, double ox, double oy, int *num)
+{
+    int n = list_size(barreiras);
+    Trecho *t = (Trecho*)malloc((n + 4) * sizeof(Trecho));
+    if (t == NULL) return NULL;
+
+    double min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    int tem_bordas = 0, m = 0;
+    for (ListCursor c = list_cursor_first(barreiras); list_cursor_valid(&c); list_cursor_next(&c))
+    {
+        Segmento s = (Segmento)list_cursor_get(&c);
+        double x1 = get_segmento_x1(s), y1 = get_segmento_y1(s);
+        double x2 = get_segmento_x2(s), y2 = get_segmento_y2(s);
+        if (get_segmento_id(s) < 0) tem_bordas = 1;
+        min_x = fmin(min_x, fmin(x1, x2));
+        max_x = fmax(max_x, fmax(x1, x2));
+        min_y = fmin(min_y, fmin(y1, y2));
+        max_y = fmax(max_y, fmax(y1, y2));
+        Trecho tr = { x1 - ox, y1 - oy, x2 - ox, y2 - oy };
+        t[m++] = tr;
+    }
+    if (!tem_bordas)
+    {
+        // Mesma caixa que criar_bounding_box() usaria, com a origem dentro
+        min_x = fmin(min_x, ox) - MARGEM_BBOX - ox;
+        min_y = fmin(min_y, oy) - MARGEM_BBOX - oy;
+        max_x = fmax(max_x, ox) + MARGEM_BBOX - ox;
+        max_y = fmax(max_y, oy) + MARGEM_BBOX - oy;
+        Trecho bordas[4] = { { min_x, min_y, max_x, min_y }, { max_x, min_y, max_x, max_y },
+                             { max_x, max_y, min_x, max_y }, { min_x, max_y, min_x, min_y } };
+        for (int i = 0; i < 4; i++) t[m++] = bordas[i];
+    }
+    *num = m;
+    return t;
+}
+
+/* Temporários de uma consulta, um elemento por faixa */
+typedef struct {
+    double *prof, *cosseno, *seno;
+    int *dono;
+    unsigned char *suja;
+} Faixas;
+
+static Poligono rasterizar(const Trecho *t, int n, int k, double ox, double oy,
+                           Faixas *f, double *erro_area)
+{
+    double passo = 2 * M_PI / k;
+    double *prof = f->prof, *cosseno = f->cosseno, *seno = f->seno;
+    int *dono = f->dono;
+    unsigned char *suja = f->suja;
+
+    for (int i = 0; i < k; i++)
+    {
+        double a = (i + 0.5) * passo;
+        cosseno[i] = cos(a);
+        seno[i] = sin(a);
+        prof[i] = INFINITY;
+        dono[i] = -1;
+        suja[i] = 0;
+    }
+
+    // Cada barreira nas faixas cujo raio central ela cruza
+    double raio_max = 0;
+    for (int s = 0; s < n; s++)
+    {
+        double x1 = t[s].x1, y1 = t[s].y1, x2 = t[s].x2, y2 = t[s].y2;
+        raio_max = fmax(raio_max, fmax(hypot(x1, y1), hypot(x2, y2)));
+        double cruz = x1 * y2 - y1 * x2;
+        if (fabs(cruz) <= TOL_RADIAL * (x1 * x1 + y1 * y1 + x2 * x2 + y2 * y2)) continue;
+        if (cruz < 0)
+        {
+            // Do primeiro para o segundo extremo no sentido anti-horário
+            double tx = x1, ty = y1;
+            x1 = x2; y1 = y2; x2 = tx; y2 = ty;
+        }
+        double a1 = angulo_positivo(y1, x1);
+        double largura = angulo_positivo(y2, x2) - a1;
+        if (largura < 0) largura += 2 * M_PI;
+
+        int primeira = (int)ceil(a1 / passo - 0.5);
+        int ultima = (int)floor((a1 + largura) / passo - 0.5);
+        if (primeira > ultima)
+        {
+            // Cabe entre dois raios centrais: nenhuma amostra a vê
+            suja[cunha_do_angulo(a1, passo, k)] = 1;
+            continue;
+        }
+        double ex = x2 - x1, ey = y2 - y1;
+        double num = x1 * ey - y1 * ex;
+        for (int j = primeira; j <= ultima; j++)
+        {
+            int i = j % k;
+            double den = cosseno[i] * ey - seno[i] * ex;
+            if (den == 0) continue;
+            double d = fmax(num / den, 0.0);
+            if (d < prof[i])
+            {
+                prof[i] = d;
+                dono[i] = s;
+            }
+        }
+    }
+
+    // Cunhas em que a barreira mais próxima muda
+    for (int i = 0; i < k; i++)
+    {
+        if (dono[i] < 0) prof[i] = raio_max;
+        if (dono[i] < 0 || dono[i] != dono[(i + 1) % k]) suja[i] = 1;
+    }
+    // Extremos de barreira à frente das amostras da sua cunha
+    for (int s = 0; s < n; s++)
+    {
+        double ext[2][2] = { { t[s].x1, t[s].y1 }, { t[s].x2, t[s].y2 } };
+        for (int e = 0; e < 2; e++)
+        {
+            int j = cunha_do_angulo(angulo_positivo(ext[e][1], ext[e][0]), passo, k);
+            if (hypot(ext[e][0], ext[e][1]) <= fmax(prof[j], prof[(j + 1) % k])) suja[j] = 1;
+        }
+    }
+
+    if (erro_area != NULL)
+    {
+        int sujas = 0;
+        for (int i = 0; i < k; i++) sujas += suja[i];
+        *erro_area = sujas * 0.5 * passo * raio_max * raio_max;
+    }
+
+    // Amostras no meio de uma mesma barreira são colineares com as vizinhas
+    int trocas = 0;
+    for (int i = 0; i < k; i++) trocas += (dono[i] != dono[(i + 1) % k]);
+    Poligono pol = poligono_criar();
+    for (int i = 0; i < k && pol != NULL; i++)
+    {
+        int d = dono[i];
+        if (trocas > 0 && d >= 0 && d == dono[(i + k - 1) % k] && d == dono[(i + 1) % k]) continue;
+        poligono_inserir_vertice(pol, ox + prof[i] * cosseno[i], oy + prof[i] * seno[i]);
+    }
+    return pol;
+}
+
+PoligonoVisibilidade visibilidade_aproximada_calcular(Ponto centro, LinkedList barreiras,
+                                                      int num_faixas, double *erro_area)
+{
+    if (centro == NULL || barreiras == NULL || num_faixas < 3 || list_size(barreiras) == 0) return NULL;
+    int k = num_faixas;
+    double ox = get_ponto_x(centro), oy = get_ponto_y(centro);
+
+    int n = 0;
+    Trecho *t = copiar_trechos(barreiras, ox, oy, &n);
+    Faixas f;
+    f.prof = (double*)malloc(k * sizeof(double));
+    f.cosseno = (double*)malloc(k * sizeof(double));
+    f.seno = (double*)malloc(k * sizeof(double));
+    f.dono = (int*)malloc(k * sizeof(int));
+    f.suja = (unsigned char*)malloc(k);
+
+    Poligono pol = NULL;
+    if (t != NULL && f.prof != NULL && f.cosseno != NULL && f.seno != NULL &&
+        f.dono != NULL && f.suja != NULL)
+    {
+        pol = rasterizar(t, n, k, ox, oy, &f, erro_area);
+    }
+
+    free(t);
+    free(f.prof);
+    free(f.cosseno);
+    free(f.seno);
+    free(f.dono);
+    free(f.suja);
+    return (PoligonoVisibilidade)pol;
+}
@@ -0,0 +1,39 @@
+/* aproximada.h
+ *
+ * Visibilidade aproximada por faixas angulares, para prévias e triagem.
+ * A volta é dividida em K faixas iguais; cada barreira é rasterizada nas
+ * faixas cujo raio central ela cruza, e cada faixa guarda a profundidade
+ * da barreira mais próxima nesse raio (um z-buffer angular). O polígono
+ * liga os pontos atingidos pelos raios centrais. Custo O(n + K + soma das
+ * faixas cobertas), sem ordenação.
+ *
+ * Entre dois raios consecutivos que atingem a mesma barreira o lado do
+ * polígono está sobre ela, então o erro fica confinado às cunhas em que a
+ * barreira mais próxima pode mudar (perto de extremos de barreiras). O
+ * cálculo devolve um limite para a área errada somando essas cunhas.
+ */
+
+#ifndef APROXIMADA_H
+#define APROXIMADA_H
+
+#include "../utils/lista/lista.h"
+#include "../geometria/ponto/ponto.h"
+#include "visibilidade.h"
+
+/**
+ * Polígono de visibilidade com K faixas angulares. Segmentos com id
+ * negativo são as bordas da cena; sem eles, as bordas são a caixa
+ * envolvente com a mesma margem da varredura.
+ *
+ * @param centro Ponto de vista
+ * @param barreiras Lista de Segmento
+ * @param num_faixas K (>= 3); mais faixas, menos erro e mais tempo
+ * @param erro_area Se não for NULL, recebe um limite superior da área da
+ *        diferença simétrica entre este polígono e o exato
+ * @return Polígono em sentido anti-horário (destruir com
+ *         visibilidade_destruir), ou NULL se K < 3 ou a lista for vazia
+ */
+PoligonoVisibilidade visibilidade_aproximada_calcular(Ponto centro, LinkedList barreiras,
+                                                      int num_faixas, double *erro_area);
+
+#endif /* APROXIMADA_H */
@@ -0,0 +1,146 @@
+/* cache_visibilidade.c
+ *
+ * Entradas num vetor fixo, com busca linear: com dezenas de entradas a
+ * varredura custa menos que manter um hash e uma lista duplamente
+ * encadeada. A recência é um relógio lógico; a vítima é a de menor marca.
+ */
+
+#include <stdlib.h>
+#include "cache_visibilidade.h"
+#include "../poligono/poligono.h"
+
+typedef struct {
+    ChaveVisibilidade chave;
+    Poligono pol;
+    unsigned long uso;      /* Relógio do último acesso */
+} EntradaCache;
+
+typedef struct {
+    EntradaCache *entradas;
+    int num, capacidade;
+    unsigned long relogio;
+    unsigned long versao;   /* Maior versão vista */
+    CacheVisibilidadeStats stats;
+} CacheInternal;
+
+CacheVisibilidade cache_visibilidade_criar(int capacidade)
+{
+    CacheInternal *c = (CacheInternal*)calloc(1, sizeof(CacheInternal));
+    if (c == NULL) return NULL;
+    c->capacidade = (capacidade > 0) ? capacidade : CACHE_VISIBILIDADE_PADRAO;
+    c->entradas = (EntradaCache*)malloc(c->capacidade * sizeof(EntradaCache));
+    if (c->entradas == NULL)
+    {
+        free(c);
+        return NULL;
+    }
+    return (CacheVisibilidade)c;
+}
+
+static int chaves_iguais(const ChaveVisibilidade *a, const ChaveVisibilidade *b)
+{
+    return a->x == b->x && a->y == b->y && a->versao == b->versao &&
+           a->min_x == b->min_x && a->min_y == b->min_y &&
+           a->max_x == b->max_x && a->max_y == b->max_y &&
+           a->lim.raio == b->lim.raio && a->lim.angulo_min == b->lim.angulo_min &&
+           a->lim.angulo_max == b->lim.angulo_max;
+}
+
+static void remover_entrada(CacheInternal *c, int i)
+{
+    poligono_destruir(c->entradas[i].pol);
+    c->entradas[i] = c->entradas[--c->num];
+    c->stats.descartes++;
+}
+
+/* Uma versão nova torna inalcançáveis todas as entradas anteriores */
+static void observar_versao(CacheInternal *c, unsigned long versao)
+{
+    if (versao <= c->versao) return;
+    c->versao = versao;
+    for (int i = c->num - 1; i >= 0; i--)
+    {
+        if (c->entradas[i].chave.versao < versao) remover_entrada(c, i);
+    }
+}
+
+PoligonoVisibilidade cache_visibilidade_obter(CacheVisibilidade cache, const ChaveVisibilidade *chave)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (c == NULL || chave == NULL) return NULL;
+    observar_versao(c, chave->versao);
+
+    for (int i = 0; i < c->num; i++)
+    {
+        if (chaves_iguais(&c->entradas[i].chave, chave))
+        {
+            Poligono copia = poligono_clonar(c->entradas[i].pol);
+            if (copia == NULL) break;
+            c->entradas[i].uso = ++c->relogio;
+            c->stats.acertos++;
+            return (PoligonoVisibilidade)copia;
+        }
+    }
+    c->stats.faltas++;
+    return NULL;
+}
+
+void cache_visibilidade_guardar(CacheVisibilidade cache, const ChaveVisibilidade *chave,
+                                PoligonoVisibilidade pol)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (c == NULL || chave == NULL || pol == NULL) return;
+    observar_versao(c, chave->versao);
+    if (chave->versao < c->versao) return;
+
+    Poligono copia = poligono_clonar((Poligono)pol);
+    if (copia == NULL) return;
+
+    for (int i = 0; i < c->num; i++)
+    {
+        if (chaves_iguais(&c->entradas[i].chave, chave))
+        {
+            poligono_destruir(c->entradas[i].pol);
+            c->entradas[i].pol = copia;
+            c->entradas[i].uso = ++c->relogio;
+            return;
+        }
+    }
+
+    if (c->num == c->capacidade)
+    {
+        int vitima = 0;
+        for (int i = 1; i < c->num; i++)
+        {
+            if (c->entradas[i].uso < c->entradas[vitima].uso) vitima = i;
+        }
+        remover_entrada(c, vitima);
+    }
+    EntradaCache *e = &c->entradas[c->num++];
+    e->chave = *chave;
+    e->pol = copia;
+    e->uso = ++c->relogio;
+}
+
+void cache_visibilidade_stats(CacheVisibilidade cache, CacheVisibilidadeStats *stats)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (stats == NULL) return;
+    if (c == NULL)
+    {
+        CacheVisibilidadeStats vazio = { 0, 0, 0, 0 };
+        *stats = vazio;
+        return;
+    }
+    *stats = c->stats;
+    stats->ocupadas = c->num;
+}
+
+void cache_visibilidade_destruir(CacheVisibilidade cache)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (c == NULL) return;
+    for (int i = 0; i < c->num; i++) poligono_destruir(c->entradas[i].pol);
+    free(c->entradas);
+    free(c);
+}
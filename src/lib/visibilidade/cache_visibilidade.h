@@ -0,0 +1,72 @@
+/* cache_visibilidade.h
+ *
+ * Cache LRU de polígonos de visibilidade. Scripts .qry repetem bombas nas
+ * mesmas coordenadas sem mudar as barreiras entre elas; com a mesma chave
+ * o polígono guardado é devolvido em vez de refazer a varredura.
+ *
+ * A chave reúne tudo de que o polígono depende: a posição, a versão das
+ * barreiras da cidade (geo_versao_barreiras), os limites do biombo e o
+ * alcance e setor da consulta.
+ * Como a versão só cresce, entradas de versões antigas são descartadas
+ * assim que uma versão nova aparece.
+ */
+
+#ifndef CACHE_VISIBILIDADE_H
+#define CACHE_VISIBILIDADE_H
+
+#include "visibilidade.h"
+
+/* Capacidade usada quando cache_visibilidade_criar recebe 0 */
+#define CACHE_VISIBILIDADE_PADRAO 32
+
+/* Tipo opaco para o cache */
+typedef void* CacheVisibilidade;
+
+/* Chave de uma consulta; comparada campo a campo, sem tolerância */
+typedef struct {
+    double x, y;                        /* Ponto de vista */
+    unsigned long versao;               /* Versão das barreiras */
+    double min_x, min_y, max_x, max_y;  /* Limites usados no biombo */
+    LimitesVisao lim;                   /* Alcance e setor (zeros = sem limite) */
+} ChaveVisibilidade;
+
+typedef struct {
+    long acertos;       /* Consultas atendidas pelo cache */
+    long faltas;        /* Consultas que precisaram de varredura */
+    long descartes;     /* Entradas expulsas (LRU ou versão antiga) */
+    int ocupadas;       /* Entradas guardadas agora */
+} CacheVisibilidadeStats;
+
+/**
+ * Cria um cache vazio.
+ *
+ * @param capacidade Número máximo de polígonos guardados (0 usa o padrão)
+ * @return Novo cache, ou NULL em caso de erro
+ */
+CacheVisibilidade cache_visibilidade_criar(int capacidade);
+
+/**
+ * Procura a chave. Num acerto a entrada vira a mais recente.
+ *
+ * @return Cópia do polígono guardado (o chamador a destrói), ou NULL
+ */
+PoligonoVisibilidade cache_visibilidade_obter(CacheVisibilidade cache, const ChaveVisibilidade *chave);
+
+/**
+ * Guarda uma cópia de pol sob a chave, expulsando a entrada usada há mais
+ * tempo se o cache estiver cheio. pol continua pertencendo ao chamador.
+ */
+void cache_visibilidade_guardar(CacheVisibilidade cache, const ChaveVisibilidade *chave,
+                                PoligonoVisibilidade pol);
+
+/**
+ * Contadores desde a criação.
+ */
+void cache_visibilidade_stats(CacheVisibilidade cache, CacheVisibilidadeStats *stats);
+
+/**
+ * Libera o cache e os polígonos guardados.
+ */
+void cache_visibilidade_destruir(CacheVisibilidade cache);
+
+#endif /* CACHE_VISIBILIDADE_H */
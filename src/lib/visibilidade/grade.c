@@ -0,0 +1,602 @@
+/* grade.c
+ *
+ * Shadowcasting simétrico: cada quadrante é varrido em linhas de
+ * profundidade crescente, entre duas inclinações. Um trecho livre que
+ * termina em parede empilha a linha seguinte com o fim do cone naquela
+ * parede; uma parede seguida de célula livre move o início do cone. As
+ * inclinações são frações exatas (2c - 1) / 2d, então o arredondamento
+ * das pontas de cada linha não depende de ponto flutuante. Uma pilha
+ * explícita faz o papel da recursão (a profundidade chega ao lado da grade).
+ *
+ * Nos quadrantes 0 e 1 (y crescente e decrescente) as linhas do cone são
+ * linhas da grade; nos quadrantes 2 e 3 (x crescente e decrescente), são
+ * linhas da transposta. Assim toda linha é uma sequência de palavras.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "grade.h"
+#include "../geometria/segmento/segmento.h"
+#include "../geometria/calculos/calculos.h"
+#include "../poligono/poligono.h"
+
+#define MARGEM_BBOX 5.0         /* Mesma margem das bordas da varredura */
+#define RESOLUCAO_MAXIMA 8192
+#define TOL_COLINEAR 1e-9
+
+typedef struct {
+    double min_x, min_y, tam;   /* Canto da grade e lado da célula */
+    double cx, cy;              /* Ponto de vista */
+    int nx, ny;                 /* Colunas e linhas */
+    int px, py;                 /* Palavras por linha da grade e da transposta */
+    int ox, oy;                 /* Célula do ponto de vista */
+    uint64_t *parede, *luz;     /* Linha y, bit x */
+    uint64_t *parede_t, *luz_t; /* Linha x, bit y (só durante o cálculo) */
+    int referencias;            /* grade_visibilidade_reter / _destruir */
+} Grade;
+
+/* Inclinação num / den, com den > 0 */
+typedef struct {
+    long long num, den;
+} Inclinacao;
+
+/* Linha de um quadrante a varrer: profundidade e cone */
+typedef struct {
+    int prof;
+    Inclinacao inicio, fim;
+} LinhaCone;
+
+typedef struct {
+    LinhaCone *itens;
+    int n, cap;
+} Pilha;
+
+/* ============================================================================
+ * Bits
+ * ============================================================================ */
+
+static int contar_zeros_finais(uint64_t w)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    int n = 0;
+    while (!(w & 1)) { w >>= 1; n++; }
+    return n;
+#endif
+}
+
+static int contar_zeros_iniciais(uint64_t w)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(w);
+#else
+    int n = 0;
+    while (!(w >> 63)) { w <<= 1; n++; }
+    return n;
+#endif
+}
+
+static int contar_bits(uint64_t w)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    int n = 0;
+    for (; w; w &= w - 1) n++;
+    return n;
+#endif
+}
+
+static int bit(const uint64_t *linha, int p)
+{
+    return (int)((linha[p >> 6] >> (p & 63)) & 1);
+}
+
+static void ligar(uint64_t *linha, int p)
+{
+    linha[p >> 6] |= (uint64_t)1 << (p & 63);
+}
+
+/* Fora de [0, n) tudo é parede */
+static int celula_parede(const uint64_t *linha, int n, int p)
+{
+    return (p < 0 || p >= n) ? 1 : bit(linha, p);
+}
+
+/**
+ * Última posição do trecho que começa em p com células iguais a parede,
+ * sem passar de fim. Pula palavras inteiras e acha a mudança contando
+ * zeros; fora da grade o trecho é de parede até a borda.
+ */
+static int fim_do_trecho(const uint64_t *linha, int n, int p, int fim, int parede)
+{
+    if (p < 0) return (fim < -1) ? fim : -1;
+    if (p >= n) return fim;
+    int ultimo = (fim < n - 1) ? fim : n - 1;
+    uint64_t inverter = parede ? ~(uint64_t)0 : 0;
+    int w = p >> 6;
+    uint64_t diferentes = (linha[w] ^ inverter) & (~(uint64_t)0 << (p & 63));
+    while (diferentes == 0)
+    {
+        w++;
+        if ((w << 6) > ultimo) return ultimo;
+        diferentes = linha[w] ^ inverter;
+    }
+    int q = (w << 6) + contar_zeros_finais(diferentes) - 1;
+    return (q < ultimo) ? q : ultimo;
+}
+
+/* Liga as posições a..b (cortadas a [0, n)) com máscaras de palavra */
+static void acender(uint64_t *linha, int n, int a, int b)
+{
+    if (a < 0) a = 0;
+    if (b > n - 1) b = n - 1;
+    if (a > b) return;
+    int wa = a >> 6, wb = b >> 6;
+    uint64_t ma = ~(uint64_t)0 << (a & 63);
+    uint64_t mb = ~(uint64_t)0 >> (63 - (b & 63));
+    if (wa == wb)
+    {
+        linha[wa] |= ma & mb;
+        return;
+    }
+    linha[wa] |= ma;
+    for (int w = wa + 1; w < wb; w++) linha[w] = ~(uint64_t)0;
+    linha[wb] |= mb;
+}
+
+/* Transpõe um bloco 64x64 (bit j da palavra i vai para o bit i da palavra j) */
+static void transpor_bloco(uint64_t a[64])
+{
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, m ^= m << j)
+    {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j)
+        {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+/* Soma a luz dos quadrantes transpostos à grade */
+static void juntar_transposta(Grade *g)
+{
+    uint64_t bloco[64];
+    for (int bx = 0; bx < g->px; bx++)
+    {
+        for (int by = 0; by < g->py; by++)
+        {
+            uint64_t algum = 0;
+            for (int i = 0; i < 64; i++)
+            {
+                int x = 64 * bx + i;
+                bloco[i] = (x < g->nx) ? g->luz_t[(size_t)x * g->py + by] : 0;
+                algum |= bloco[i];
+            }
+            if (algum == 0) continue;
+            transpor_bloco(bloco);
+            for (int j = 0; j < 64 && 64 * by + j < g->ny; j++)
+            {
+                g->luz[(size_t)(64 * by + j) * g->px + bx] |= bloco[j];
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * Percurso de células
+ * ============================================================================ */
+
+static int celula(double v, double min, double tam, int n)
+{
+    double c = floor((v - min) / tam);
+    return (c < 0) ? 0 : (c >= n) ? n - 1 : (int)c;
+}
+
+/* Células cruzadas por um segmento, andando em x ou em y a cada passo (sem
+ * atalhos pela diagonal, para que paredes rasterizadas não deixem frestas) */
+typedef struct {
+    int cx, cy, fx, fy, sx, sy, restantes;
+    double tx, ty, dtx, dty;
+    double t;                   /* Parâmetro em que a célula atual foi alcançada */
+} Percurso;
+
+static void percurso_iniciar(const Grade *g, Percurso *p, double x1, double y1, double x2, double y2)
+{
+    p->cx = celula(x1, g->min_x, g->tam, g->nx);
+    p->cy = celula(y1, g->min_y, g->tam, g->ny);
+    p->fx = celula(x2, g->min_x, g->tam, g->nx);
+    p->fy = celula(y2, g->min_y, g->tam, g->ny);
+    p->sx = (p->fx >= p->cx) ? 1 : -1;
+    p->sy = (p->fy >= p->cy) ? 1 : -1;
+    p->restantes = abs(p->fx - p->cx) + abs(p->fy - p->cy);
+    p->t = 0;
+
+    double dx = x2 - x1, dy = y2 - y1;
+    p->tx = p->ty = INFINITY;
+    p->dtx = p->dty = 0;
+    if (p->fx != p->cx && dx != 0)
+    {
+        p->tx = (g->min_x + (p->cx + (p->sx > 0)) * g->tam - x1) / dx;
+        p->dtx = g->tam / fabs(dx);
+    }
+    if (p->fy != p->cy && dy != 0)
+    {
+        p->ty = (g->min_y + (p->cy + (p->sy > 0)) * g->tam - y1) / dy;
+        p->dty = g->tam / fabs(dy);
+    }
+}
+
+static bool percurso_avancar(Percurso *p)
+{
+    if (p->restantes == 0) return false;
+    if (p->cy == p->fy || (p->cx != p->fx && p->tx < p->ty))
+    {
+        p->cx += p->sx;
+        p->t = p->tx;
+        p->tx += p->dtx;
+    }
+    else
+    {
+        p->cy += p->sy;
+        p->t = p->ty;
+        p->ty += p->dty;
+    }
+    p->restantes--;
+    return true;
+}
+
+static void rasterizar(Grade *g, LinkedList barreiras)
+{
+    for (ListCursor c = list_cursor_first(barreiras); list_cursor_valid(&c); list_cursor_next(&c))
+    {
+        Segmento s = (Segmento)list_cursor_get(&c);
+        Percurso p;
+        percurso_iniciar(g, &p, get_segmento_x1(s), get_segmento_y1(s),
+                         get_segmento_x2(s), get_segmento_y2(s));
+        do
+        {
+            ligar(g->parede + (size_t)p.cy * g->px, p.cx);
+            ligar(g->parede_t + (size_t)p.cx * g->py, p.cy);
+        } while (percurso_avancar(&p));
+    }
+}
+
+/* ============================================================================
+ * Shadowcasting
+ * ============================================================================ */
+
+static long long div_piso(long long a, long long b)
+{
+    long long q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+static bool empilhar(Pilha *p, LinhaCone l)
+{
+    if (p->n == p->cap)
+    {
+        int cap = p->cap ? 2 * p->cap : 64;
+        LinhaCone *novo = (LinhaCone*)realloc(p->itens, cap * sizeof(LinhaCone));
+        if (novo == NULL) return false;
+        p->itens = novo;
+        p->cap = cap;
+    }
+    p->itens[p->n++] = l;
+    return true;
+}
+
+static bool varrer_quadrante(Grade *g, int q, Pilha *pilha)
+{
+    bool transposto = (q >= 2);
+    int sentido = (q % 2 == 0) ? 1 : -1;
+    int n = transposto ? g->ny : g->nx;         /* Células por linha */
+    int num_linhas = transposto ? g->nx : g->ny;
+    int palavras = transposto ? g->py : g->px;
+    int base = transposto ? g->oy : g->ox;      /* Posição da coluna 0 do cone */
+    int origem = transposto ? g->ox : g->oy;
+    const uint64_t *parede = transposto ? g->parede_t : g->parede;
+    uint64_t *luz = transposto ? g->luz_t : g->luz;
+
+    LinhaCone primeira = { 1, { -1, 1 }, { 1, 1 } };
+    pilha->n = 0;
+    if (!empilhar(pilha, primeira)) return false;
+
+    while (pilha->n > 0)
+    {
+        LinhaCone lin = pilha->itens[--pilha->n];
+        int r = origem + sentido * lin.prof;
+        if (r < 0 || r >= num_linhas) continue;   /* Fora da grade: só parede */
+
+        long long d = lin.prof;
+        Inclinacao ini = lin.inicio, fim = lin.fim;
+        int lo = (int)div_piso(2 * d * ini.num + ini.den, 2 * ini.den);
+        int hi = (int)-div_piso(fim.den - 2 * d * fim.num, 2 * fim.den);
+        if (lo > hi) continue;
+        const uint64_t *ocup = parede + (size_t)r * palavras;
+
+        // Paredes no cone sempre acendem; células livres nas pontas só com o centro dentro
+        int a = lo, b = hi;
+        if (!celula_parede(ocup, n, base + lo) && lo * ini.den < d * ini.num) a++;
+        if (!celula_parede(ocup, n, base + hi) && hi * fim.den > d * fim.num) b--;
+        acender(luz + (size_t)r * palavras, n, base + a, base + b);
+
+        int anterior = -1;
+        for (int c = lo; c <= hi; )
+        {
+            int eh_parede = celula_parede(ocup, n, base + c);
+            int ultima = fim_do_trecho(ocup, n, base + c, base + hi, eh_parede) - base;
+            Inclinacao borda = { 2LL * c - 1, 2 * d };
+            if (anterior == 1 && !eh_parede) ini = borda;
+            if (anterior == 0 && eh_parede)
+            {
+                LinhaCone prox = { lin.prof + 1, ini, borda };
+                if (!empilhar(pilha, prox)) return false;
+            }
+            anterior = eh_parede;
+            c = ultima + 1;
+        }
+        if (anterior == 0)
+        {
+            LinhaCone prox = { lin.prof + 1, ini, fim };
+            if (!empilhar(pilha, prox)) return false;
+        }
+    }
+    return true;
+}
+
+/* ============================================================================
+ * API
+ * ============================================================================ */
+
+void grade_visibilidade_destruir(GradeVisibilidade gv)
+{
+    Grade *g = (Grade*)gv;
+    if (g == NULL || --g->referencias > 0) return;
+    free(g->parede);
+    free(g->luz);
+    free(g->parede_t);
+    free(g->luz_t);
+    free(g);
+}
+
+GradeVisibilidade grade_visibilidade_calcular(Ponto centro, LinkedList barreiras, int resolucao)
+{
+    if (centro == NULL || barreiras == NULL || resolucao < 1 || list_size(barreiras) == 0) return NULL;
+    if (resolucao > RESOLUCAO_MAXIMA) resolucao = RESOLUCAO_MAXIMA;
+    double cx = get_ponto_x(centro), cy = get_ponto_y(centro);
+
+    double min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    int tem_bordas = 0;
+    for (ListCursor c = list_cursor_first(barreiras); list_cursor_valid(&c); list_cursor_next(&c))
+    {
+        Segmento s = (Segmento)list_cursor_get(&c);
+        if (get_segmento_id(s) < 0) tem_bordas = 1;
+        min_x = fmin(min_x, fmin(get_segmento_x1(s), get_segmento_x2(s)));
+        max_x = fmax(max_x, fmax(get_segmento_x1(s), get_segmento_x2(s)));
+        min_y = fmin(min_y, fmin(get_segmento_y1(s), get_segmento_y2(s)));
+        max_y = fmax(max_y, fmax(get_segmento_y1(s), get_segmento_y2(s)));
+    }
+    if (!tem_bordas)
+    {
+        min_x = fmin(min_x, cx) - MARGEM_BBOX;
+        min_y = fmin(min_y, cy) - MARGEM_BBOX;
+        max_x = fmax(max_x, cx) + MARGEM_BBOX;
+        max_y = fmax(max_y, cy) + MARGEM_BBOX;
+    }
+    double lado = fmax(max_x - min_x, max_y - min_y);
+    if (!(lado > 0)) return NULL;
+
+    Grade *g = (Grade*)calloc(1, sizeof(Grade));
+    if (g == NULL) return NULL;
+    g->referencias = 1;
+    g->min_x = min_x;
+    g->min_y = min_y;
+    g->tam = lado / resolucao;
+    g->cx = cx;
+    g->cy = cy;
+    g->nx = (int)ceil((max_x - min_x) / g->tam);
+    g->ny = (int)ceil((max_y - min_y) / g->tam);
+    g->nx = (g->nx < 2) ? 2 : (g->nx > resolucao) ? resolucao : g->nx;
+    g->ny = (g->ny < 2) ? 2 : (g->ny > resolucao) ? resolucao : g->ny;
+    g->px = (g->nx + 63) / 64;
+    g->py = (g->ny + 63) / 64;
+    g->ox = celula(cx, g->min_x, g->tam, g->nx);
+    g->oy = celula(cy, g->min_y, g->tam, g->ny);
+
+    size_t palavras = (size_t)g->ny * g->px;
+    size_t palavras_t = (size_t)g->nx * g->py;
+    g->parede = (uint64_t*)calloc(palavras, sizeof(uint64_t));
+    g->luz = (uint64_t*)calloc(palavras, sizeof(uint64_t));
+    g->parede_t = (uint64_t*)calloc(palavras_t, sizeof(uint64_t));
+    g->luz_t = (uint64_t*)calloc(palavras_t, sizeof(uint64_t));
+    if (g->parede == NULL || g->luz == NULL || g->parede_t == NULL || g->luz_t == NULL)
+    {
+        grade_visibilidade_destruir(g);
+        return NULL;
+    }
+
+    rasterizar(g, barreiras);
+    ligar(g->luz + (size_t)g->oy * g->px, g->ox);
+
+    Pilha pilha = { NULL, 0, 0 };
+    bool ok = true;
+    for (int q = 0; q < 4 && ok; q++) ok = varrer_quadrante(g, q, &pilha);
+    free(pilha.itens);
+    if (!ok)
+    {
+        grade_visibilidade_destruir(g);
+        return NULL;
+    }
+
+    juntar_transposta(g);
+    free(g->parede_t);
+    free(g->luz_t);
+    g->parede_t = g->luz_t = NULL;
+    return g;
+}
+
+GradeVisibilidade grade_visibilidade_reter(GradeVisibilidade gv)
+{
+    Grade *g = (Grade*)gv;
+    if (g != NULL) g->referencias++;
+    return gv;
+}
+
+void grade_visibilidade_dimensoes(GradeVisibilidade gv, int *colunas, int *linhas, double *tam_celula)
+{
+    Grade *g = (Grade*)gv;
+    if (g == NULL) return;
+    if (colunas) *colunas = g->nx;
+    if (linhas) *linhas = g->ny;
+    if (tam_celula) *tam_celula = g->tam;
+}
+
+long grade_visibilidade_num_iluminadas(GradeVisibilidade gv)
+{
+    Grade *g = (Grade*)gv;
+    if (g == NULL) return 0;
+    long total = 0;
+    size_t palavras = (size_t)g->ny * g->px;
+    for (size_t i = 0; i < palavras; i++) total += contar_bits(g->luz[i]);
+    return total;
+}
+
+bool grade_visibilidade_caixa(GradeVisibilidade gv, double *min_x, double *min_y,
+                              double *max_x, double *max_y)
+{
+    Grade *g = (Grade*)gv;
+    if (g == NULL) return false;
+    int x0 = g->nx, x1 = -1, y0 = g->ny, y1 = -1;
+    for (int y = 0; y < g->ny; y++)
+    {
+        const uint64_t *linha = g->luz + (size_t)y * g->px;
+        int primeira = 0, ultima = g->px - 1;
+        while (primeira <= ultima && linha[primeira] == 0) primeira++;
+        if (primeira > ultima) continue;
+        while (linha[ultima] == 0) ultima--;
+        int a = (primeira << 6) + contar_zeros_finais(linha[primeira]);
+        int b = (ultima << 6) + 63 - contar_zeros_iniciais(linha[ultima]);
+        if (a < x0) x0 = a;
+        if (b > x1) x1 = b;
+        if (y0 > y) y0 = y;
+        y1 = y;
+    }
+    if (x1 < 0) return false;
+    *min_x = g->min_x + x0 * g->tam;
+    *min_y = g->min_y + y0 * g->tam;
+    *max_x = g->min_x + (x1 + 1) * g->tam;
+    *max_y = g->min_y + (y1 + 1) * g->tam;
+    return true;
+}
+
+/* Pontos fora da grade não são atingidos */
+static bool iluminada(const Grade *g, double x, double y)
+{
+    double fx = (x - g->min_x) / g->tam, fy = (y - g->min_y) / g->tam;
+    if (!(fx >= 0 && fy >= 0 && fx <= g->nx && fy <= g->ny)) return false;
+    int cx = ((int)fx < g->nx) ? (int)fx : g->nx - 1;
+    int cy = ((int)fy < g->ny) ? (int)fy : g->ny - 1;
+    return bit(g->luz + (size_t)cy * g->px, cx);
+}
+
+bool grade_visibilidade_ponto_atingido(GradeVisibilidade gv, Ponto p)
+{
+    if (gv == NULL || p == NULL) return false;
+    return iluminada((Grade*)gv, get_ponto_x(p), get_ponto_y(p));
+}
+
+void grade_visibilidade_pontos_atingidos(GradeVisibilidade gv, const double *xs, const double *ys,
+                                         int n, unsigned char *mapa)
+{
+    if (xs == NULL || ys == NULL || mapa == NULL || n <= 0) return;
+    memset(mapa, 0, BITMAP_BYTES(n));
+    if (gv == NULL) return;
+    for (int i = 0; i < n; i++)
+    {
+        if (iluminada((Grade*)gv, xs[i], ys[i])) mapa[i >> 3] |= (unsigned char)(1u << (i & 7));
+    }
+}
+
+bool grade_visibilidade_segmento_atingido(GradeVisibilidade gv, Ponto p1, Ponto p2)
+{
+    Grade *g = (Grade*)gv;
+    if (g == NULL || p1 == NULL || p2 == NULL) return false;
+    Percurso p;
+    percurso_iniciar(g, &p, get_ponto_x(p1), get_ponto_y(p1), get_ponto_x(p2), get_ponto_y(p2));
+    do
+    {
+        if (bit(g->luz + (size_t)p.cy * g->px, p.cx)) return true;
+    } while (percurso_avancar(&p));
+    return false;
+}
+
+/* i-ésima célula da borda, em sentido anti-horário a partir de (0, 0) */
+static void celula_da_borda(const Grade *g, int i, int *bx, int *by)
+{
+    int nx = g->nx, ny = g->ny;
+    if (i < nx) { *bx = i; *by = 0; }
+    else if (i < nx + ny - 1) { *bx = nx - 1; *by = i - nx + 1; }
+    else if (i < 2 * nx + ny - 2) { *bx = nx - 2 - (i - (nx + ny - 1)); *by = ny - 1; }
+    else { *bx = 0; *by = ny - 2 - (i - (2 * nx + ny - 2)); }
+}
+
+PoligonoVisibilidade grade_visibilidade_poligono(GradeVisibilidade gv)
+{
+    Grade *g = (Grade*)gv;
+    if (g == NULL) return NULL;
+    int total = 2 * (g->nx + g->ny) - 4;
+    double *vx = (double*)malloc(total * sizeof(double));
+    double *vy = (double*)malloc(total * sizeof(double));
+    if (vx == NULL || vy == NULL)
+    {
+        free(vx);
+        free(vy);
+        return NULL;
+    }
+
+    for (int i = 0; i < total; i++)
+    {
+        int bx, by;
+        celula_da_borda(g, i, &bx, &by);
+        double ax = g->min_x + (bx + 0.5) * g->tam;
+        double ay = g->min_y + (by + 0.5) * g->tam;
+        Percurso p;
+        percurso_iniciar(g, &p, g->cx, g->cy, ax, ay);
+        double t = 1;
+        while (percurso_avancar(&p))
+        {
+            size_t linha = (size_t)p.cy * g->px;
+            if (bit(g->parede + linha, p.cx) || !bit(g->luz + linha, p.cx))
+            {
+                t = p.t;
+                break;
+            }
+        }
+        vx[i] = g->cx + t * (ax - g->cx);
+        vy[i] = g->cy + t * (ay - g->cy);
+    }
+
+    // Funde vértices repetidos e os que seguem reto ao longo de uma parede
+    Poligono pol = poligono_criar();
+    int ultimo = total - 1;
+    for (int i = 0; i < total && pol != NULL; i++)
+    {
+        int prox = (i + 1) % total;
+        double ax = vx[i] - vx[ultimo], ay = vy[i] - vy[ultimo];
+        double bx = vx[prox] - vx[i], by = vy[prox] - vy[i];
+        double escala = hypot(ax, ay) * hypot(bx, by);
+        if (fabs(ax * by - ay * bx) <= TOL_COLINEAR * escala && ax * bx + ay * by >= 0) continue;
+        poligono_inserir_vertice(pol, vx[i], vy[i]);
+        ultimo = i;
+    }
+    free(vx);
+    free(vy);
+    return (PoligonoVisibilidade)pol;
+}
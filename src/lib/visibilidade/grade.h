@@ -0,0 +1,98 @@
+/* grade.h
+ *
+ * Motor de visibilidade em grade, para cenas muito densas (milhões de
+ * barreiras curtas), em que a geometria exata fica cara. As barreiras são
+ * rasterizadas numa grade de ocupação com um bit por célula, e as células
+ * visíveis saem de um shadowcasting simétrico a partir da célula do ponto
+ * de vista. O teste de atingimento consulta as células das formas na
+ * máscara de células iluminadas. Escolhido por visibilidade_set_grade(),
+ * o motor responde a visibilidade_calcular(): o polígono devolvido é o
+ * contorno, para desenho, e leva a máscara junto para os testes.
+ *
+ * As linhas da grade são palavras de 64 bits: o shadowcasting anda pelas
+ * linhas em trechos (livre/parede) achados contando zeros nas palavras e
+ * acende as células com máscaras de palavra. Os quadrantes leste e oeste
+ * trabalham sobre a grade transposta, para que toda varredura siga as
+ * palavras, e a luz deles volta à grade por transposição em blocos 64x64.
+ */
+
+#ifndef GRADE_H
+#define GRADE_H
+
+#include <stdbool.h>
+#include "../utils/lista/lista.h"
+#include "../geometria/ponto/ponto.h"
+#include "visibilidade.h"
+
+/* Tipo opaco para a máscara de células iluminadas */
+typedef void* GradeVisibilidade;
+
+/**
+ * Rasteriza as barreiras e calcula as células visíveis a partir do centro.
+ * Segmentos com id negativo são as bordas da cena; sem eles, a grade cobre
+ * a caixa envolvente das barreiras com a mesma margem da varredura. Fora
+ * da grade tudo é parede.
+ *
+ * @param centro Ponto de vista
+ * @param barreiras Lista de Segmento
+ * @param resolucao Células no lado maior da cena (limitada a 8192)
+ * @return Grade (destruir com grade_visibilidade_destruir), ou NULL se a
+ *         lista for vazia ou a resolução menor que 1
+ */
+GradeVisibilidade grade_visibilidade_calcular(Ponto centro, LinkedList barreiras, int resolucao);
+
+/**
+ * Mais uma referência à grade (por exemplo, para um polígono que a leva
+ * junto). Cada referência é desfeita por grade_visibilidade_destruir(), e
+ * a grade só é liberada na última.
+ * @return A própria grade
+ */
+GradeVisibilidade grade_visibilidade_reter(GradeVisibilidade g);
+
+/**
+ * Colunas, linhas e lado da célula da grade. Qualquer saída pode ser NULL.
+ */
+void grade_visibilidade_dimensoes(GradeVisibilidade g, int *colunas, int *linhas, double *tam_celula);
+
+/**
+ * Quantidade de células iluminadas (paredes visíveis incluídas).
+ */
+long grade_visibilidade_num_iluminadas(GradeVisibilidade g);
+
+/**
+ * Caixa das células iluminadas; nenhum ponto fora dela é atingido.
+ * @return false se a grade for NULL ou nenhuma célula estiver iluminada
+ */
+bool grade_visibilidade_caixa(GradeVisibilidade g, double *min_x, double *min_y,
+                              double *max_x, double *max_y);
+
+/**
+ * Verdadeiro se a célula de p estiver iluminada.
+ */
+bool grade_visibilidade_ponto_atingido(GradeVisibilidade g, Ponto p);
+
+/**
+ * Versão em lote, no formato de visibilidade_pontos_atingidos().
+ * @param mapa Saída com BITMAP_BYTES(n) bytes: bit i ligado se o ponto i foi atingido
+ */
+void grade_visibilidade_pontos_atingidos(GradeVisibilidade g, const double *xs, const double *ys,
+                                         int n, unsigned char *mapa);
+
+/**
+ * Verdadeiro se alguma célula cruzada pelo segmento p1-p2 estiver iluminada.
+ */
+bool grade_visibilidade_segmento_atingido(GradeVisibilidade g, Ponto p1, Ponto p2);
+
+/**
+ * Contorno da região iluminada, para desenho: um raio do ponto de vista
+ * até cada célula da borda da grade, parando na primeira parede ou célula
+ * escura. Vértices colineares são fundidos.
+ *
+ * @return Polígono em sentido anti-horário (destruir com visibilidade_destruir)
+ */
+PoligonoVisibilidade grade_visibilidade_poligono(GradeVisibilidade g);
+
+/* Desfaz uma referência; a última libera a grade */
+void grade_visibilidade_destruir(GradeVisibilidade g);
+
+#endif /* GRADE_H */
@@ -0,0 +1,398 @@
+/* oclusao.c
+ *
+ * Quadtree na arena: cada segmento fica no nó mais fundo cuja caixa contém
+ * a sua; os que cruzam as linhas de divisão ficam no próprio nó. A visita
+ * é um heap de mínimo pela distância da origem a nós e segmentos, então
+ * os itens saem em distância crescente.
+ *
+ * A cobertura é um vetor ordenado de intervalos angulares disjuntos em
+ * [0, 2π]. Um segmento mantido não entra nela na hora: fica num segundo
+ * heap até a visita passar da sua distância máxima. Assim tudo o que está
+ * na cobertura fica estritamente à frente de qualquer item visitado dali
+ * em diante, e estar coberto basta para descartar o item.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "oclusao.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define EPSILON 1e-9
+#define CAPACIDADE_FOLHA 8
+#define PROFUNDIDADE_MAX 8
+
+/* ============================================================================
+ * Quadtree
+ * ============================================================================ */
+
+typedef struct {
+    double min_x, min_y, max_x, max_y;
+    int inicio, num;    /* Segmentos do próprio nó: ordem[inicio .. inicio+num) */
+    int filhos[4];      /* Bit 0: metade direita; bit 1: metade de cima; -1 = vazio */
+} NoQuadtree;
+
+typedef struct {
+    const double *caixas;   /* min_x, min_y, max_x, max_y de cada segmento */
+    int *ordem;             /* Índices agrupados por nó */
+    int *tmp;
+    NoQuadtree *nos;
+    int num_nos;
+} Quadtree;
+
+/* Quadrante que contém a caixa do segmento, ou 4 se ela cruza o meio */
+static int quadrante(const double *c, double mx, double my)
+{
+    int q = 0;
+    if (c[0] >= mx) q |= 1;
+    else if (c[2] > mx) return 4;
+    if (c[1] >= my) q |= 2;
+    else if (c[3] > my) return 4;
+    return q;
+}
+
+/*
+ * Cada nó dividido tem mais de CAPACIDADE_FOLHA segmentos na subárvore e
+ * os nós de uma mesma profundidade são disjuntos, então há no máximo
+ * 1 + 4 * PROFUNDIDADE_MAX * n / (CAPACIDADE_FOLHA + 1) < 4n + 1 nós.
+ */
+static void construir_no(Quadtree *qt, int no, int inicio, int n, int prof)
+{
+    NoQuadtree *nd = &qt->nos[no];
+    nd->inicio = inicio;
+    nd->num = n;
+    for (int k = 0; k < 4; k++) nd->filhos[k] = -1;
+    if (n <= CAPACIDADE_FOLHA || prof >= PROFUNDIDADE_MAX) return;
+
+    double mx = (nd->min_x + nd->max_x) / 2;
+    double my = (nd->min_y + nd->max_y) / 2;
+    int *idx = qt->ordem + inicio;
+    int cont[5] = { 0, 0, 0, 0, 0 };
+    for (int i = 0; i < n; i++) cont[quadrante(qt->caixas + 4 * idx[i], mx, my)]++;
+    if (cont[4] == n) return;
+
+    // Os que ficam no nó primeiro, depois um bloco por quadrante
+    int pos[5];
+    pos[4] = 0;
+    pos[0] = cont[4];
+    for (int q = 1; q < 4; q++) pos[q] = pos[q - 1] + cont[q - 1];
+    for (int i = 0; i < n; i++)
+    {
+        qt->tmp[pos[quadrante(qt->caixas + 4 * idx[i], mx, my)]++] = idx[i];
+    }
+    memcpy(idx, qt->tmp, n * sizeof(int));
+    nd->num = cont[4];
+
+    int desloc = inicio + cont[4];
+    for (int q = 0; q < 4; q++)
+    {
+        if (cont[q] == 0) continue;
+        int f = qt->num_nos++;
+        NoQuadtree *filho = &qt->nos[f];
+        filho->min_x = (q & 1) ? mx : nd->min_x;
+        filho->max_x = (q & 1) ? nd->max_x : mx;
+        filho->min_y = (q & 2) ? my : nd->min_y;
+        filho->max_y = (q & 2) ? nd->max_y : my;
+        nd->filhos[q] = f;
+        construir_no(qt, f, desloc, cont[q], prof + 1);
+        desloc += cont[q];
+    }
+}
+
+/* ============================================================================
+ * Heap de Mínimo
+ * ============================================================================ */
+
+typedef struct {
+    double chave;
+    int ref;    /* >= 0: nó da quadtree; < 0: segmento -(ref + 1) */
+} ItemHeap;
+
+typedef struct {
+    ItemHeap *v;
+    int n;
+} Heap;
+
+static void heap_inserir(Heap *h, double chave, int ref)
+{
+    int i = h->n++;
+    while (i > 0 && h->v[(i - 1) / 2].chave > chave)
+    {
+        h->v[i] = h->v[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->v[i].chave = chave;
+    h->v[i].ref = ref;
+}
+
+static ItemHeap heap_remover(Heap *h)
+{
+    ItemHeap topo = h->v[0];
+    ItemHeap ultimo = h->v[--h->n];
+    int i = 0;
+    for (;;)
+    {
+        int f = 2 * i + 1;
+        if (f >= h->n) break;
+        if (f + 1 < h->n && h->v[f + 1].chave < h->v[f].chave) f++;
+        if (h->v[f].chave >= ultimo.chave) break;
+        h->v[i] = h->v[f];
+        i = f;
+    }
+    if (h->n > 0) h->v[i] = ultimo;
+    return topo;
+}
+
+/* ============================================================================
+ * Cobertura Angular
+ * ============================================================================ */
+
+typedef struct {
+    double ini, fim;
+} Intervalo;
+
+typedef struct {
+    Intervalo *v;
+    int n;
+} Cobertura;
+
+/* Primeiro intervalo com fim >= a */
+static int primeiro_ate(const Cobertura *c, double a)
+{
+    int lo = 0, hi = c->n;
+    while (lo < hi)
+    {
+        int m = (lo + hi) / 2;
+        if (c->v[m].fim < a) lo = m + 1;
+        else hi = m;
+    }
+    return lo;
+}
+
+/* Une [a, b] (0 <= a <= b <= 2π); intervalos que se tocam são fundidos */
+static void cobertura_inserir(Cobertura *c, double a, double b)
+{
+    int i = primeiro_ate(c, a);
+    int j = i;
+    while (j < c->n && c->v[j].ini <= b) j++;
+
+    if (i == j)
+    {
+        memmove(&c->v[i + 1], &c->v[i], (c->n - i) * sizeof(Intervalo));
+        c->v[i].ini = a;
+        c->v[i].fim = b;
+        c->n++;
+        return;
+    }
+    if (c->v[i].ini < a) a = c->v[i].ini;
+    if (c->v[j - 1].fim > b) b = c->v[j - 1].fim;
+    c->v[i].ini = a;
+    c->v[i].fim = b;
+    memmove(&c->v[i + 1], &c->v[j], (c->n - j) * sizeof(Intervalo));
+    c->n -= j - i - 1;
+}
+
+static int cobertura_contem(const Cobertura *c, double a, double b)
+{
+    int i = primeiro_ate(c, a);
+    return i < c->n && c->v[i].ini <= a && c->v[i].fim >= b;
+}
+
+/* Arco de ini a fim no sentido anti-horário; fim < ini dá a volta por zero */
+static int arco_coberto(const Cobertura *c, double ini, double fim)
+{
+    if (ini < 0) ini += 2 * M_PI;
+    if (fim >= 2 * M_PI) fim -= 2 * M_PI;
+    if (ini <= fim) return cobertura_contem(c, ini, fim);
+    return cobertura_contem(c, ini, 2 * M_PI) && cobertura_contem(c, 0.0, fim);
+}
+
+static void arco_inserir(Cobertura *c, double ini, double fim)
+{
+    if (ini <= fim)
+    {
+        cobertura_inserir(c, ini, fim);
+        return;
+    }
+    cobertura_inserir(c, ini, 2 * M_PI);
+    cobertura_inserir(c, 0.0, fim);
+}
+
+/* Ângulo em [0, 2π); pontos iguais dão sempre o mesmo valor */
+static double angulo_de(double x, double y)
+{
+    double a = atan2(y, x);
+    return (a < 0) ? a + 2 * M_PI : a;
+}
+
+/* ============================================================================
+ * Vãos e Distâncias (coordenadas relativas à origem)
+ * ============================================================================ */
+
+static double distancia_caixa(const NoQuadtree *nd, double ox, double oy)
+{
+    double dx = fmax(fmax(nd->min_x - ox, ox - nd->max_x), 0.0);
+    double dy = fmax(fmax(nd->min_y - oy, oy - nd->max_y), 0.0);
+    return hypot(dx, dy);
+}
+
+static double distancia_segmento(double x1, double y1, double x2, double y2)
+{
+    double dx = x2 - x1, dy = y2 - y1;
+    double comp2 = dx * dx + dy * dy;
+    double t = (comp2 > 0) ? -(x1 * dx + y1 * dy) / comp2 : 0.0;
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    return hypot(x1 + t * dx, y1 + t * dy);
+}
+
+/* Vão do segmento (que não passa pela origem), do extremo horário ao anti-horário */
+static void vao_segmento(double x1, double y1, double x2, double y2, double *ini, double *fim)
+{
+    if (x1 * y2 - y1 * x2 >= 0)
+    {
+        *ini = angulo_de(x1, y1);
+        *fim = angulo_de(x2, y2);
+    }
+    else
+    {
+        *ini = angulo_de(x2, y2);
+        *fim = angulo_de(x1, y1);
+    }
+}
+
+/* Vão de uma caixa que não contém a origem: os cantos angularmente extremos */
+static void vao_caixa(const NoQuadtree *nd, double ox, double oy, double *ini, double *fim)
+{
+    double cx[4] = { nd->min_x - ox, nd->max_x - ox, nd->max_x - ox, nd->min_x - ox };
+    double cy[4] = { nd->min_y - oy, nd->min_y - oy, nd->max_y - oy, nd->max_y - oy };
+    double ref = atan2(cy[0] + cy[2], cx[0] + cx[2]);
+    double lo = 0, hi = 0;
+    int i_lo = 0, i_hi = 0;
+    for (int k = 0; k < 4; k++)
+    {
+        double d = atan2(cy[k], cx[k]) - ref;
+        if (d > M_PI) d -= 2 * M_PI;
+        if (d <= -M_PI) d += 2 * M_PI;
+        if (k == 0 || d < lo) { lo = d; i_lo = k; }
+        if (k == 0 || d > hi) { hi = d; i_hi = k; }
+    }
+    *ini = angulo_de(cx[i_lo], cy[i_lo]);
+    *fim = angulo_de(cx[i_hi], cy[i_hi]);
+}
+
+/* ============================================================================
+ * Filtro
+ * ============================================================================ */
+
+int oclusao_filtrar(Arena arena, double ox, double oy, Segmento *segmentos, int n)
+{
+    if (arena == NULL || segmentos == NULL || n < 2) return n;
+
+    double *caixas = (double*)arena_alocar(arena, 4 * n * sizeof(double));
+    double *dist_max = (double*)arena_alocar(arena, n * sizeof(double));
+    unsigned char *manter = (unsigned char*)arena_alocar_zerado(arena, n);
+    Quadtree qt;
+    qt.caixas = caixas;
+    qt.ordem = (int*)arena_alocar(arena, n * sizeof(int));
+    qt.tmp = (int*)arena_alocar(arena, n * sizeof(int));
+    qt.nos = (NoQuadtree*)arena_alocar(arena, (4 * n + 1) * sizeof(NoQuadtree));
+    qt.num_nos = 1;
+    Heap visita = { (ItemHeap*)arena_alocar(arena, (5 * n + 1) * sizeof(ItemHeap)), 0 };
+    Heap pendentes = { (ItemHeap*)arena_alocar(arena, n * sizeof(ItemHeap)), 0 };
+    Cobertura cob = { (Intervalo*)arena_alocar(arena, (2 * n + 2) * sizeof(Intervalo)), 0 };
+    if (caixas == NULL || dist_max == NULL || manter == NULL || qt.ordem == NULL ||
+        qt.tmp == NULL || qt.nos == NULL || visita.v == NULL || pendentes.v == NULL || cob.v == NULL)
+    {
+        return n;
+    }
+
+    NoQuadtree *raiz = &qt.nos[0];
+    for (int i = 0; i < n; i++)
+    {
+        double x1 = get_segmento_x1(segmentos[i]), y1 = get_segmento_y1(segmentos[i]);
+        double x2 = get_segmento_x2(segmentos[i]), y2 = get_segmento_y2(segmentos[i]);
+        double *c = caixas + 4 * i;
+        c[0] = fmin(x1, x2);
+        c[1] = fmin(y1, y2);
+        c[2] = fmax(x1, x2);
+        c[3] = fmax(y1, y2);
+        if (i == 0 || c[0] < raiz->min_x) raiz->min_x = c[0];
+        if (i == 0 || c[1] < raiz->min_y) raiz->min_y = c[1];
+        if (i == 0 || c[2] > raiz->max_x) raiz->max_x = c[2];
+        if (i == 0 || c[3] > raiz->max_y) raiz->max_y = c[3];
+        dist_max[i] = fmax(hypot(x1 - ox, y1 - oy), hypot(x2 - ox, y2 - oy));
+        qt.ordem[i] = i;
+    }
+    construir_no(&qt, 0, 0, n, 0);
+
+    heap_inserir(&visita, distancia_caixa(raiz, ox, oy), 0);
+    while (visita.n > 0)
+    {
+        ItemHeap item = heap_remover(&visita);
+        double ini, fim;
+
+        // Bloqueadores que terminam antes desta distância passam a valer
+        while (pendentes.n > 0 && pendentes.v[0].chave + EPSILON < item.chave)
+        {
+            int s = heap_remover(&pendentes).ref;
+            vao_segmento(get_segmento_x1(segmentos[s]) - ox, get_segmento_y1(segmentos[s]) - oy,
+                         get_segmento_x2(segmentos[s]) - ox, get_segmento_y2(segmentos[s]) - oy,
+                         &ini, &fim);
+            arco_inserir(&cob, ini, fim);
+        }
+
+        if (item.ref >= 0)
+        {
+            const NoQuadtree *nd = &qt.nos[item.ref];
+            if (item.chave > EPSILON)
+            {
+                // Folga nas bordas: os cantos escolhidos podem errar por arredondamento
+                vao_caixa(nd, ox, oy, &ini, &fim);
+                if (arco_coberto(&cob, ini - EPSILON, fim + EPSILON)) continue;
+            }
+            for (int k = 0; k < nd->num; k++)
+            {
+                int s = qt.ordem[nd->inicio + k];
+                heap_inserir(&visita,
+                             distancia_segmento(get_segmento_x1(segmentos[s]) - ox,
+                                                get_segmento_y1(segmentos[s]) - oy,
+                                                get_segmento_x2(segmentos[s]) - ox,
+                                                get_segmento_y2(segmentos[s]) - oy),
+                             -(s + 1));
+            }
+            for (int q = 0; q < 4; q++)
+            {
+                int f = nd->filhos[q];
+                if (f >= 0) heap_inserir(&visita, distancia_caixa(&qt.nos[f], ox, oy), f);
+            }
+        }
+        else
+        {
+            int s = -(item.ref + 1);
+            // Passa pela origem: visível em qualquer direção e não bloqueia
+            if (item.chave <= EPSILON)
+            {
+                manter[s] = 1;
+                continue;
+            }
+            vao_segmento(get_segmento_x1(segmentos[s]) - ox, get_segmento_y1(segmentos[s]) - oy,
+                         get_segmento_x2(segmentos[s]) - ox, get_segmento_y2(segmentos[s]) - oy,
+                         &ini, &fim);
+            if (arco_coberto(&cob, ini, fim)) continue;
+            manter[s] = 1;
+            heap_inserir(&pendentes, dist_max[s], s);
+        }
+    }
+
+    int mantidos = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (manter[i]) segmentos[mantidos++] = segmentos[i];
+    }
+    return mantidos;
+}
@@ -0,0 +1,39 @@
+/* oclusao.h
+ *
+ * Descarte por oclusão antes da varredura angular. Numa cidade densa a
+ * maior parte das barreiras fica inteira atrás de outras mais próximas e,
+ * mesmo assim, gera eventos, entra na ordenação e passa pela árvore.
+ *
+ * As barreiras são indexadas numa quadtree e visitadas da mais próxima
+ * para a mais distante da origem, mantendo o conjunto de intervalos
+ * angulares já cobertos. Células e segmentos cujo vão angular está todo
+ * coberto por barreiras estritamente mais próximas são descartados sem
+ * ser abertos; só os potencialmente visíveis seguem para a varredura.
+ */
+
+#ifndef OCLUSAO_H
+#define OCLUSAO_H
+
+#include "../geometria/segmento/segmento.h"
+#include "../utils/arena/arena.h"
+
+/**
+ * Remove do vetor os segmentos que certamente não aparecem no polígono de
+ * visibilidade visto de (ox, oy). O teste é conservador: um segmento só
+ * sai se, em todas as direções do seu vão angular, outro segmento é
+ * atingido antes dele.
+ *
+ * @note Com segmentos em posição geral o polígono da varredura não muda.
+ *       Quando dois segmentos empatam numa quina, a varredura desempata
+ *       pela forma da árvore de segmentos ativos, que depende de todos os
+ *       inseridos; sem os escondidos, o empate pode cair do outro lado.
+ *
+ * @param arena Arena para a quadtree e os temporários (não é resetada)
+ * @param segmentos Vetor compactado no lugar, mantendo a ordem relativa
+ * @param n Número de segmentos
+ * @return Número de segmentos mantidos (os n primeiros do vetor), ou n
+ *         se faltar memória (nada é descartado)
+ */
+int oclusao_filtrar(Arena arena, double ox, double oy, Segmento *segmentos, int n);
+
+#endif /* OCLUSAO_H */
@@ -0,0 +1,1061 @@
+/* triangulacao.c
+ *
+ * Construção, em ordem:
+ *  1. Os segmentos são cortados nas interseções mútuas (inclusive extremos
+ *     que tocam outro segmento e trechos colineares sobrepostos).
+ *  2. Pontos a menos de tol uns dos outros viram o mesmo vértice.
+ *  3. Os vértices entram, em ordem embaralhada, num triângulo externo
+ *     enorme (Lawson: divide o triângulo ou a aresta e legaliza por trocas).
+ *  4. Cada pedaço de barreira vira aresta restrita: as arestas que o
+ *     cruzam são trocadas até ele aparecer (Sloan).
+ *
+ * Triângulos com vértices em sentido anti-horário; adj[i] e restrita[i]
+ * se referem à aresta oposta a v[i].
+ *
+ * Consulta: pilha explícita de cones (aresta, raio direito, raio
+ * esquerdo). Atravessar uma aresta livre divide o cone no vértice oposto;
+ * uma aresta restrita (ou do triângulo externo) devolve o trecho visível
+ * dela. Como o lado direito é sempre processado antes, os trechos saem em
+ * ordem anti-horária e os consecutivos se ligam por segmentos radiais (as
+ * bordas das sombras).
+ *
+ * A moldura não entra na malha: o polígono da expansão é recortado pelo
+ * retângulo da consulta. Com o centro dentro do retângulo, o polígono é
+ * estrelado a partir dele e o recorte por cada semiplano continua sendo
+ * um polígono simples, igual ao que a moldura como barreira daria.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "triangulacao.h"
+#include "../geometria/segmento/segmento.h"
+#include "../poligono/poligono.h"
+#include "../utils/vetor/vetor.h"
+
+#define TOL_RELATIVA 1e-9   /* Tolerância de distância, relativa ao tamanho da cena */
+#define MARGEM_BBOX 5.0     /* Mesma margem das bordas da varredura */
+#define ESCALA_EXTERNO 100.0
+#define PROFUNDIDADE_CORTE 32
+
+typedef struct {
+    int v[3];
+    int adj[3];
+    unsigned char restrita[3];
+} Triangulo;
+
+typedef struct {
+    double *x, *y;
+    int num_vertices;       /* Os 3 últimos são do triângulo externo */
+    Triangulo *tri;
+    int num_tri;
+    int *vt;                /* Um triângulo que contém cada vértice */
+    int ultimo;             /* Início da próxima busca */
+    double tol;
+    int *pilha;             /* Temporários de legalização e rotação */
+    int cap_pilha;
+    double moldura[4];      /* Padrão de malha_visibilidade_calcular (min x, min y, max x, max y) */
+} MalhaInternal;
+
+/* ============================================================================
+ * Predicados
+ * ============================================================================ */
+
+static double orientacao(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+/* Distância com sinal de p à reta ab (positiva à esquerda de a→b) */
+static double lado(const MalhaInternal *m, int a, int b, double px, double py)
+{
+    double comp = hypot(m->x[b] - m->x[a], m->y[b] - m->y[a]);
+    if (comp == 0) return 0;
+    return orientacao(m->x[a], m->y[a], m->x[b], m->y[b], px, py) / comp;
+}
+
+static double lado_v(const MalhaInternal *m, int a, int b, int c)
+{
+    return lado(m, a, b, m->x[c], m->y[c]);
+}
+
+/* > 0 se d está dentro do círculo de (a, b, c), em sentido anti-horário */
+static double no_circulo(const MalhaInternal *m, int a, int b, int c, int d)
+{
+    double adx = m->x[a] - m->x[d], ady = m->y[a] - m->y[d];
+    double bdx = m->x[b] - m->x[d], bdy = m->y[b] - m->y[d];
+    double cdx = m->x[c] - m->x[d], cdy = m->y[c] - m->y[d];
+    return (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+         - (bdx * bdx + bdy * bdy) * (adx * cdy - cdx * ady)
+         + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+}
+
+/* As diagonais p-q e r-s do quadrilátero se cruzam no interior de ambas */
+static int cruzam(const MalhaInternal *m, int p, int q, int r, int s)
+{
+    double o1 = lado_v(m, p, q, r), o2 = lado_v(m, p, q, s);
+    double o3 = lado_v(m, r, s, p), o4 = lado_v(m, r, s, q);
+    return ((o1 > m->tol && o2 < -m->tol) || (o1 < -m->tol && o2 > m->tol)) &&
+           ((o3 > m->tol && o4 < -m->tol) || (o3 < -m->tol && o4 > m->tol));
+}
+
+/* ============================================================================
+ * Topologia
+ * ============================================================================ */
+
+static void definir(MalhaInternal *m, int t, int a, int b, int c,
+                    int na, int nb, int nc, int ra, int rb, int rc)
+{
+    Triangulo *tr = &m->tri[t];
+    tr->v[0] = a; tr->v[1] = b; tr->v[2] = c;
+    tr->adj[0] = na; tr->adj[1] = nb; tr->adj[2] = nc;
+    tr->restrita[0] = (unsigned char)ra;
+    tr->restrita[1] = (unsigned char)rb;
+    tr->restrita[2] = (unsigned char)rc;
+    m->vt[a] = m->vt[b] = m->vt[c] = t;
+}
+
+static void trocar_vizinho(MalhaInternal *m, int t, int antigo, int novo)
+{
+    if (t < 0) return;
+    for (int k = 0; k < 3; k++)
+    {
+        if (m->tri[t].adj[k] == antigo)
+        {
+            m->tri[t].adj[k] = novo;
+            return;
+        }
+    }
+}
+
+static int lado_do_vizinho(const MalhaInternal *m, int t, int vizinho)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        if (m->tri[t].adj[k] == vizinho) return k;
+    }
+    return -1;
+}
+
+static int indice_vertice(const MalhaInternal *m, int t, int v)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        if (m->tri[t].v[k] == v) return k;
+    }
+    return -1;
+}
+
+static int empilhar(MalhaInternal *m, int *topo, int valor)
+{
+    if (*topo == m->cap_pilha)
+    {
+        int cap = m->cap_pilha ? 2 * m->cap_pilha : 256;
+        int *nova = (int*)realloc(m->pilha, cap * sizeof(int));
+        if (nova == NULL) return 0;
+        m->pilha = nova;
+        m->cap_pilha = cap;
+    }
+    m->pilha[(*topo)++] = valor;
+    return 1;
+}
+
+/*
+ * Troca a diagonal da aresta k de t. Com x = v[k] e (u, w) a aresta, e y o
+ * vértice oposto no vizinho, o quadrilátero x u y w vira t = (x, u, y) e
+ * vizinho = (x, y, w), com x no índice 0 dos dois.
+ */
+static void trocar_diagonal(MalhaInternal *m, int t, int k)
+{
+    Triangulo T = m->tri[t];
+    int n = T.adj[k];
+    Triangulo N = m->tri[n];
+    int j = lado_do_vizinho(m, n, t);
+    int x = T.v[k], u = T.v[(k + 1) % 3], w = T.v[(k + 2) % 3];
+    int y = N.v[j];
+    int A = T.adj[(k + 1) % 3], rA = T.restrita[(k + 1) % 3];   /* w-x */
+    int B = T.adj[(k + 2) % 3], rB = T.restrita[(k + 2) % 3];   /* x-u */
+    int C = N.adj[(j + 1) % 3], rC = N.restrita[(j + 1) % 3];   /* u-y */
+    int D = N.adj[(j + 2) % 3], rD = N.restrita[(j + 2) % 3];   /* y-w */
+
+    definir(m, t, x, u, y, C, n, B, rC, 0, rB);
+    definir(m, n, x, y, w, D, A, t, rD, rA, 0);
+    trocar_vizinho(m, C, n, t);
+    trocar_vizinho(m, A, t, n);
+}
+
+/* Legaliza as arestas da pilha (pares t, k) opostas ao vértice novo */
+static int legalizar(MalhaInternal *m, int topo)
+{
+    while (topo > 0)
+    {
+        int k = m->pilha[--topo];
+        int t = m->pilha[--topo];
+        const Triangulo *T = &m->tri[t];
+        int n = T->adj[k];
+        if (n < 0 || T->restrita[k]) continue;
+        int j = lado_do_vizinho(m, n, t);
+        int p = T->v[k], b = T->v[(k + 1) % 3], c = T->v[(k + 2) % 3];
+        int d = m->tri[n].v[j];
+        if (no_circulo(m, p, b, c, d) <= 0 || !cruzam(m, p, d, b, c)) continue;
+
+        trocar_diagonal(m, t, k);
+        if (!empilhar(m, &topo, t) || !empilhar(m, &topo, 0) ||
+            !empilhar(m, &topo, n) || !empilhar(m, &topo, 0))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * Localização
+ * ============================================================================ */
+
+/* Onde o ponto está no triângulo: 0 interior, 1 sobre a aresta k, 2 sobre o vértice k */
+static int classificar(const MalhaInternal *m, int t, double px, double py, int *k)
+{
+    const Triangulo *T = &m->tri[t];
+    for (int i = 0; i < 3; i++)
+    {
+        if (hypot(m->x[T->v[i]] - px, m->y[T->v[i]] - py) <= m->tol)
+        {
+            *k = i;
+            return 2;
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        if (fabs(lado(m, T->v[(i + 1) % 3], T->v[(i + 2) % 3], px, py)) <= m->tol)
+        {
+            *k = i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Caminha até o triângulo que contém o ponto; -1 se está fora da malha */
+static int localizar(MalhaInternal *m, double px, double py, int *onde, int *k)
+{
+    int t = (m->ultimo >= 0 && m->ultimo < m->num_tri) ? m->ultimo : 0;
+    for (int passo = 0; passo < m->num_tri + 16; passo++)
+    {
+        const Triangulo *T = &m->tri[t];
+        int mover = -1;
+        for (int e0 = 0; e0 < 3 && mover < 0; e0++)
+        {
+            // O lado inicial varia para a caminhada não ficar em ciclo
+            int e = (e0 + passo) % 3;
+            if (lado(m, T->v[(e + 1) % 3], T->v[(e + 2) % 3], px, py) < -m->tol) mover = e;
+        }
+        if (mover < 0)
+        {
+            m->ultimo = t;
+            *onde = classificar(m, t, px, py, k);
+            return t;
+        }
+        if (T->adj[mover] < 0) return -1;
+        t = T->adj[mover];
+    }
+
+    // Malha restrita não é Delaunay: a caminhada pode não convergir
+    for (t = 0; t < m->num_tri; t++)
+    {
+        const Triangulo *T = &m->tri[t];
+        int dentro = 1;
+        for (int e = 0; e < 3 && dentro; e++)
+        {
+            if (lado(m, T->v[(e + 1) % 3], T->v[(e + 2) % 3], px, py) < -m->tol) dentro = 0;
+        }
+        if (dentro)
+        {
+            m->ultimo = t;
+            *onde = classificar(m, t, px, py, k);
+            return t;
+        }
+    }
+    return -1;
+}
+
+/* ============================================================================
+ * Inserção de Vértices
+ * ============================================================================ */
+
+/* Divide t = (a, b, c) em três triângulos em volta de p */
+static int dividir_triangulo(MalhaInternal *m, int t, int p)
+{
+    Triangulo T = m->tri[t];
+    int a = T.v[0], b = T.v[1], c = T.v[2];
+    int t1 = m->num_tri++, t2 = m->num_tri++;
+
+    definir(m, t, a, b, p, t1, t2, T.adj[2], 0, 0, T.restrita[2]);
+    definir(m, t1, b, c, p, t2, t, T.adj[0], 0, 0, T.restrita[0]);
+    definir(m, t2, c, a, p, t, t1, T.adj[1], 0, 0, T.restrita[1]);
+    trocar_vizinho(m, T.adj[0], t, t1);
+    trocar_vizinho(m, T.adj[1], t, t2);
+
+    int topo = 0;
+    return empilhar(m, &topo, t) && empilhar(m, &topo, 2) &&
+           empilhar(m, &topo, t1) && empilhar(m, &topo, 2) &&
+           empilhar(m, &topo, t2) && empilhar(m, &topo, 2) &&
+           legalizar(m, topo);
+}
+
+/* Divide a aresta k de t (e o vizinho) em quatro triângulos em volta de p */
+static int dividir_aresta(MalhaInternal *m, int t, int k, int p)
+{
+    Triangulo T = m->tri[t];
+    int n = T.adj[k];
+    if (n < 0) return 0;
+    Triangulo N = m->tri[n];
+    int j = lado_do_vizinho(m, n, t);
+    int c = T.v[k], a = T.v[(k + 1) % 3], b = T.v[(k + 2) % 3];
+    int d = N.v[j];
+    int r = T.restrita[k];
+    int Ta = T.adj[(k + 1) % 3], rTa = T.restrita[(k + 1) % 3];
+    int Tb = T.adj[(k + 2) % 3], rTb = T.restrita[(k + 2) % 3];
+    int Nb = N.adj[(j + 1) % 3], rNb = N.restrita[(j + 1) % 3];
+    int Na = N.adj[(j + 2) % 3], rNa = N.restrita[(j + 2) % 3];
+    int t1 = m->num_tri++, n1 = m->num_tri++;
+
+    definir(m, t, c, a, p, n1, t1, Tb, r, 0, rTb);
+    definir(m, t1, c, p, b, n, Ta, t, r, rTa, 0);
+    definir(m, n, d, b, p, t1, n1, Na, r, 0, rNa);
+    definir(m, n1, d, p, a, t, Nb, n, r, rNb, 0);
+    trocar_vizinho(m, Ta, t, t1);
+    trocar_vizinho(m, Nb, n, n1);
+
+    int topo = 0;
+    return empilhar(m, &topo, t) && empilhar(m, &topo, 2) &&
+           empilhar(m, &topo, t1) && empilhar(m, &topo, 1) &&
+           empilhar(m, &topo, n) && empilhar(m, &topo, 2) &&
+           empilhar(m, &topo, n1) && empilhar(m, &topo, 1) &&
+           legalizar(m, topo);
+}
+
+/* Insere o vértice p; devolve p, o vértice já existente no lugar, ou -1 */
+static int inserir_vertice(MalhaInternal *m, int p)
+{
+    int onde = 0, k = 0;
+    int t = localizar(m, m->x[p], m->y[p], &onde, &k);
+    if (t < 0) return -1;
+    if (onde == 2) return m->tri[t].v[k];
+    if (onde == 1) return dividir_aresta(m, t, k, p) ? p : -1;
+    return dividir_triangulo(m, t, p) ? p : -1;
+}
+
+/* ============================================================================
+ * Arestas Restritas
+ * ============================================================================ */
+
+/* Triângulos em volta do vértice v, em m->pilha[0 .. n) */
+static int triangulos_em_volta(MalhaInternal *m, int v)
+{
+    int n = 0;
+    int inicio = m->vt[v], t = inicio;
+    do
+    {
+        if (!empilhar(m, &n, t)) return -1;
+        int i = indice_vertice(m, t, v);
+        t = m->tri[t].adj[(i + 1) % 3];
+    } while (t >= 0 && t != inicio);
+
+    if (t < 0)
+    {
+        // Borda do triângulo externo: completa no outro sentido
+        int i = indice_vertice(m, inicio, v);
+        t = m->tri[inicio].adj[(i + 2) % 3];
+        while (t >= 0)
+        {
+            if (!empilhar(m, &n, t)) return -1;
+            i = indice_vertice(m, t, v);
+            t = m->tri[t].adj[(i + 2) % 3];
+        }
+    }
+    return n;
+}
+
+/* Triângulo com a aresta {u, w}; em *k o índice oposto a ela */
+static int triangulo_com_aresta(MalhaInternal *m, int u, int w, int *k)
+{
+    int n = triangulos_em_volta(m, u);
+    for (int i = 0; i < n; i++)
+    {
+        int t = m->pilha[i];
+        int iu = indice_vertice(m, t, u);
+        if (m->tri[t].v[(iu + 1) % 3] == w) { *k = (iu + 2) % 3; return t; }
+        if (m->tri[t].v[(iu + 2) % 3] == w) { *k = (iu + 1) % 3; return t; }
+    }
+    return -1;
+}
+
+static void marcar_restrita(MalhaInternal *m, int t, int k)
+{
+    m->tri[t].restrita[k] = 1;
+    int n = m->tri[t].adj[k];
+    if (n >= 0) m->tri[n].restrita[lado_do_vizinho(m, n, t)] = 1;
+}
+
+static int recuperar_aresta(MalhaInternal *m, int a, int b, int prof);
+
+/* O vértice c está sobre o pedaço a-b: recupera a-c e c-b */
+static int recuperar_partes(MalhaInternal *m, int a, int c, int b, int prof)
+{
+    return recuperar_aresta(m, a, c, prof + 1) && recuperar_aresta(m, c, b, prof + 1);
+}
+
+static int recuperar_aresta(MalhaInternal *m, int a, int b, int prof)
+{
+    if (a == b) return 1;
+    if (prof > PROFUNDIDADE_CORTE) return 0;
+
+    int k;
+    int t = triangulo_com_aresta(m, a, b, &k);
+    if (t >= 0)
+    {
+        marcar_restrita(m, t, k);
+        return 1;
+    }
+
+    // Triângulo em volta de a cujo lado oposto é cruzado por a→b
+    double bx = m->x[b] - m->x[a], by = m->y[b] - m->y[a];
+    int n = triangulos_em_volta(m, a);
+    int p = -1, q = -1;
+    t = -1;
+    for (int i = 0; i < n && t < 0; i++)
+    {
+        int ti = m->pilha[i];
+        int ia = indice_vertice(m, ti, a);
+        int vp = m->tri[ti].v[(ia + 1) % 3], vq = m->tri[ti].v[(ia + 2) % 3];
+        double op = lado_v(m, a, b, vp), oq = lado_v(m, a, b, vq);
+        if (fabs(op) <= m->tol && (m->x[vp] - m->x[a]) * bx + (m->y[vp] - m->y[a]) * by > 0)
+        {
+            return recuperar_partes(m, a, vp, b, prof);
+        }
+        if (fabs(oq) <= m->tol && (m->x[vq] - m->x[a]) * bx + (m->y[vq] - m->y[a]) * by > 0)
+        {
+            return recuperar_partes(m, a, vq, b, prof);
+        }
+        if (op < 0 && oq > 0)
+        {
+            t = ti;
+            p = vp;
+            q = vq;
+        }
+    }
+    if (t < 0) return 0;
+
+    // Arestas cruzadas por a-b, de a até b (p à direita, q à esquerda)
+    Vetor fila = vetor_criar(2 * sizeof(int));
+    if (fila == NULL) return 0;
+    int ok = 1;
+    for (;;)
+    {
+        int par[2] = { p, q };
+        int kk = 3 - indice_vertice(m, t, p) - indice_vertice(m, t, q);
+        if (m->tri[t].restrita[kk] || m->tri[t].adj[kk] < 0 || vetor_inserir(fila, par) == NULL)
+        {
+            ok = 0;
+            break;
+        }
+        int nt = m->tri[t].adj[kk];
+        int w = m->tri[nt].v[lado_do_vizinho(m, nt, t)];
+        if (w == b) break;
+        double ow = lado_v(m, a, b, w);
+        if (fabs(ow) <= m->tol)
+        {
+            vetor_destruir(fila);
+            return recuperar_partes(m, a, w, b, prof);
+        }
+        if (ow < 0) p = w;
+        else q = w;
+        t = nt;
+    }
+
+    // Troca diagonais até nenhuma aresta cruzar a-b
+    int limite = 64 * vetor_tamanho(fila) + 1024;
+    for (int cabeca = 0; ok && cabeca < vetor_tamanho(fila); cabeca++)
+    {
+        if (cabeca > limite)
+        {
+            ok = 0;
+            break;
+        }
+        int *par = (int*)vetor_obter(fila, cabeca);
+        int u = par[0], w = par[1];
+        t = triangulo_com_aresta(m, u, w, &k);
+        if (t < 0)
+        {
+            ok = 0;
+            break;
+        }
+        int x = m->tri[t].v[k];
+        int nt = m->tri[t].adj[k];
+        int y = m->tri[nt].v[lado_do_vizinho(m, nt, t)];
+        int novo[2] = { x, y };
+        if (!cruzam(m, x, y, u, w))
+        {
+            // Quadrilátero não convexo: tenta de novo depois das outras
+            int volta[2] = { u, w };
+            if (vetor_inserir(fila, volta) == NULL) ok = 0;
+            continue;
+        }
+        trocar_diagonal(m, t, k);
+        if (x != a && x != b && y != a && y != b && cruzam(m, a, b, x, y))
+        {
+            if (vetor_inserir(fila, novo) == NULL) ok = 0;
+        }
+    }
+    vetor_destruir(fila);
+    if (!ok) return 0;
+
+    t = triangulo_com_aresta(m, a, b, &k);
+    if (t < 0) return 0;
+    marcar_restrita(m, t, k);
+    return 1;
+}
+
+/* ============================================================================
+ * Cortes nas Interseções
+ * ============================================================================ */
+
+typedef struct {
+    int seg;
+    double t;       /* Parâmetro ao longo do segmento */
+    double x, y;
+    int vertice;
+} Corte;
+
+typedef struct {
+    double x1, y1, x2, y2;
+} Coords;
+
+static int adicionar_corte(Vetor cortes, const Coords *s, int seg, double t)
+{
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    Corte c = { seg, t, s->x1 + t * (s->x2 - s->x1), s->y1 + t * (s->y2 - s->y1), -1 };
+    return vetor_inserir(cortes, &c) != NULL;
+}
+
+/* Parâmetro da projeção de (px, py) em s, se estiver a até tol dele; senão -1 */
+static double projecao_no_segmento(const Coords *s, double px, double py, double tol)
+{
+    double dx = s->x2 - s->x1, dy = s->y2 - s->y1;
+    double comp2 = dx * dx + dy * dy;
+    double t = ((px - s->x1) * dx + (py - s->y1) * dy) / comp2;
+    if (t < 0 || t > 1) return -1;
+    if (hypot(s->x1 + t * dx - px, s->y1 + t * dy - py) > tol) return -1;
+    return t;
+}
+
+static int cortar_par(Vetor cortes, const Coords *s, int i, int j, double tol)
+{
+    const Coords *a = &s[i], *b = &s[j];
+    double ex = a->x2 - a->x1, ey = a->y2 - a->y1;
+    double fx = b->x2 - b->x1, fy = b->y2 - b->y1;
+    double den = ex * fy - ey * fx;
+    double la = hypot(ex, ey), lb = hypot(fx, fy);
+    int ok = 1;
+
+    if (fabs(den) > tol * (la + lb) * 1e-3)
+    {
+        double gx = b->x1 - a->x1, gy = b->y1 - a->y1;
+        double t = (gx * fy - gy * fx) / den;
+        double u = (gx * ey - gy * ex) / den;
+        double folga_t = tol / la, folga_u = tol / lb;
+        if (t >= -folga_t && t <= 1 + folga_t && u >= -folga_u && u <= 1 + folga_u)
+        {
+            ok = adicionar_corte(cortes, a, i, t) && adicionar_corte(cortes, b, j, u);
+        }
+    }
+
+    // Extremos de um sobre o outro (toques e trechos colineares)
+    double t;
+    if ((t = projecao_no_segmento(a, b->x1, b->y1, tol)) >= 0) ok = ok && adicionar_corte(cortes, a, i, t);
+    if ((t = projecao_no_segmento(a, b->x2, b->y2, tol)) >= 0) ok = ok && adicionar_corte(cortes, a, i, t);
+    if ((t = projecao_no_segmento(b, a->x1, a->y1, tol)) >= 0) ok = ok && adicionar_corte(cortes, b, j, t);
+    if ((t = projecao_no_segmento(b, a->x2, a->y2, tol)) >= 0) ok = ok && adicionar_corte(cortes, b, j, t);
+    return ok;
+}
+
+typedef struct {
+    double min_x;
+    int seg;
+} Faixa;
+
+static int comparar_faixa(const void *a, const void *b)
+{
+    const Faixa *fa = (const Faixa*)a, *fb = (const Faixa*)b;
+    return (fa->min_x > fb->min_x) - (fa->min_x < fb->min_x);
+}
+
+static int comparar_corte_x(const void *a, const void *b)
+{
+    const Corte *ca = (const Corte*)a, *cb = (const Corte*)b;
+    if (ca->x != cb->x) return (ca->x > cb->x) - (ca->x < cb->x);
+    return (ca->y > cb->y) - (ca->y < cb->y);
+}
+
+static int comparar_corte_seg(const void *a, const void *b)
+{
+    const Corte *ca = (const Corte*)a, *cb = (const Corte*)b;
+    if (ca->seg != cb->seg) return (ca->seg > cb->seg) - (ca->seg < cb->seg);
+    return (ca->t > cb->t) - (ca->t < cb->t);
+}
+
+static int comparar_pares(const void *a, const void *b)
+{
+    const int *pa = (const int*)a, *pb = (const int*)b;
+    if (pa[0] != pb[0]) return (pa[0] > pb[0]) - (pa[0] < pb[0]);
+    return (pa[1] > pb[1]) - (pa[1] < pb[1]);
+}
+
+static int raiz(int *pai, int i)
+{
+    while (pai[i] != i)
+    {
+        pai[i] = pai[pai[i]];
+        i = pai[i];
+    }
+    return i;
+}
+
+/* Corta os segmentos, funde pontos próximos e lista os pedaços (pares de vértices) */
+static Vetor montar_grafo(const Coords *s, int n, double tol, double **vx, double **vy, int *num_vertices)
+{
+    Vetor cortes = vetor_criar(sizeof(Corte));
+    Vetor pedacos = vetor_criar(2 * sizeof(int));
+    Faixa *ordem = (Faixa*)malloc(n * sizeof(Faixa));
+    int *pai = NULL;
+    int ok = (cortes != NULL && pedacos != NULL && ordem != NULL);
+
+    for (int i = 0; ok && i < n; i++)
+    {
+        ordem[i].min_x = fmin(s[i].x1, s[i].x2);
+        ordem[i].seg = i;
+        ok = adicionar_corte(cortes, &s[i], i, 0.0) && adicionar_corte(cortes, &s[i], i, 1.0);
+    }
+
+    // Pares candidatos: faixas em x que se sobrepõem
+    if (ok) qsort(ordem, n, sizeof(Faixa), comparar_faixa);
+    for (int a = 0; ok && a < n; a++)
+    {
+        const Coords *sa = &s[ordem[a].seg];
+        double max_xa = fmax(sa->x1, sa->x2) + tol;
+        double min_ya = fmin(sa->y1, sa->y2) - tol, max_ya = fmax(sa->y1, sa->y2) + tol;
+        for (int b = a + 1; ok && b < n; b++)
+        {
+            const Coords *sb = &s[ordem[b].seg];
+            if (ordem[b].min_x > max_xa) break;
+            if (fmax(sb->y1, sb->y2) < min_ya || fmin(sb->y1, sb->y2) > max_ya) continue;
+            ok = cortar_par(cortes, s, ordem[a].seg, ordem[b].seg, tol);
+        }
+    }
+
+    // Funde pontos a até tol: ordena por x e une vizinhos próximos
+    int nc = ok ? vetor_tamanho(cortes) : 0;
+    Corte *c = ok ? (Corte*)vetor_dados(cortes) : NULL;
+    if (ok)
+    {
+        qsort(c, nc, sizeof(Corte), comparar_corte_x);
+        pai = (int*)malloc(nc * sizeof(int));
+        ok = (pai != NULL);
+    }
+    for (int i = 0; ok && i < nc; i++) pai[i] = i;
+    for (int i = 0; ok && i < nc; i++)
+    {
+        for (int j = i + 1; j < nc && c[j].x - c[i].x <= tol; j++)
+        {
+            if (fabs(c[j].y - c[i].y) <= tol) pai[raiz(pai, j)] = raiz(pai, i);
+        }
+    }
+    int nv = 0;
+    if (ok)
+    {
+        *vx = (double*)malloc((nc + 3) * sizeof(double));
+        *vy = (double*)malloc((nc + 3) * sizeof(double));
+        ok = (*vx != NULL && *vy != NULL);
+    }
+    for (int i = 0; ok && i < nc; i++)
+    {
+        int r = raiz(pai, i);
+        if (r == i)
+        {
+            (*vx)[nv] = c[i].x;
+            (*vy)[nv] = c[i].y;
+            c[i].vertice = nv++;
+        }
+    }
+    for (int i = 0; ok && i < nc; i++) c[i].vertice = c[raiz(pai, i)].vertice;
+
+    // Pedaços: vértices consecutivos ao longo de cada segmento
+    if (ok) qsort(c, nc, sizeof(Corte), comparar_corte_seg);
+    for (int i = 0; ok && i + 1 < nc; i++)
+    {
+        if (c[i].seg != c[i + 1].seg || c[i].vertice == c[i + 1].vertice) continue;
+        int par[2] = { c[i].vertice, c[i + 1].vertice };
+        if (par[0] > par[1]) { int tmp = par[0]; par[0] = par[1]; par[1] = tmp; }
+        ok = vetor_inserir(pedacos, par) != NULL;
+    }
+    if (ok) vetor_ordenar(pedacos, comparar_pares, ALG_QSORT, 0);
+
+    free(ordem);
+    free(pai);
+    vetor_destruir(cortes);
+    if (!ok)
+    {
+        vetor_destruir(pedacos);
+        return NULL;
+    }
+    *num_vertices = nv;
+    return pedacos;
+}
+
+/* ============================================================================
+ * Construção
+ * ============================================================================ */
+
+static void liberar_malha(MalhaInternal *m)
+{
+    if (m == NULL) return;
+    free(m->x);
+    free(m->y);
+    free(m->tri);
+    free(m->vt);
+    free(m->pilha);
+    free(m);
+}
+
+static int triangular(MalhaInternal *m, Vetor pedacos, double min_x, double min_y,
+                      double max_x, double max_y)
+{
+    int nv = m->num_vertices;
+
+    // Triângulo externo bem maior que a cena
+    double cx = (min_x + max_x) / 2, cy = (min_y + max_y) / 2;
+    double r = ESCALA_EXTERNO * fmax(fmax(max_x - min_x, max_y - min_y), 1.0);
+    m->x[nv] = cx - 2 * r;  m->y[nv] = cy - r;
+    m->x[nv + 1] = cx + 2 * r;  m->y[nv + 1] = cy - r;
+    m->x[nv + 2] = cx;  m->y[nv + 2] = cy + 2 * r;
+    m->num_tri = 1;
+    definir(m, 0, nv, nv + 1, nv + 2, -1, -1, -1, 0, 0, 0);
+
+    // Ordem embaralhada (LCG fixo: a malha não depende de rand())
+    int *ordem = (int*)malloc((nv + 1) * sizeof(int));
+    int *apelido = (int*)malloc((nv + 1) * sizeof(int));
+    if (ordem == NULL || apelido == NULL)
+    {
+        free(ordem);
+        free(apelido);
+        return 0;
+    }
+    unsigned long semente = 2463534242UL;
+    for (int i = 0; i < nv; i++) ordem[i] = i;
+    for (int i = nv - 1; i > 0; i--)
+    {
+        semente = semente * 6364136223846793005UL + 1442695040888963407UL;
+        int j = (int)((semente >> 33) % (unsigned long)(i + 1));
+        int tmp = ordem[i]; ordem[i] = ordem[j]; ordem[j] = tmp;
+    }
+
+    int ok = 1;
+    for (int i = 0; ok && i < nv; i++)
+    {
+        int v = ordem[i];
+        apelido[v] = inserir_vertice(m, v);
+        ok = (apelido[v] >= 0);
+    }
+
+    int np = vetor_tamanho(pedacos);
+    for (int i = 0; ok && i < np; i++)
+    {
+        int *par = (int*)vetor_obter(pedacos, i);
+        ok = recuperar_aresta(m, apelido[par[0]], apelido[par[1]], 0);
+    }
+    free(ordem);
+    free(apelido);
+    return ok;
+}
+
+MalhaVisibilidade malha_visibilidade_criar(LinkedList segmentos)
+{
+    int n = (segmentos != NULL) ? list_size(segmentos) : 0;
+    if (n == 0) return NULL;
+
+    MalhaInternal *m = (MalhaInternal*)calloc(1, sizeof(MalhaInternal));
+    Coords *s = (Coords*)malloc(n * sizeof(Coords));
+    if (m == NULL || s == NULL)
+    {
+        free(s);
+        free(m);
+        return NULL;
+    }
+
+    double min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    int tem_bordas = 0, ns = 0;
+    for (ListCursor c = list_cursor_first(segmentos); list_cursor_valid(&c); list_cursor_next(&c))
+    {
+        Segmento seg = (Segmento)list_cursor_get(&c);
+        Coords co = { get_segmento_x1(seg), get_segmento_y1(seg), get_segmento_x2(seg), get_segmento_y2(seg) };
+        if (get_segmento_id(seg) < 0) tem_bordas = 1;
+        min_x = fmin(min_x, fmin(co.x1, co.x2));
+        max_x = fmax(max_x, fmax(co.x1, co.x2));
+        min_y = fmin(min_y, fmin(co.y1, co.y2));
+        max_y = fmax(max_y, fmax(co.y1, co.y2));
+        s[ns++] = co;
+    }
+    if (!tem_bordas)
+    {
+        min_x -= MARGEM_BBOX; min_y -= MARGEM_BBOX;
+        max_x += MARGEM_BBOX; max_y += MARGEM_BBOX;
+    }
+    m->moldura[0] = min_x; m->moldura[1] = min_y;
+    m->moldura[2] = max_x; m->moldura[3] = max_y;
+    m->tol = TOL_RELATIVA * fmax(fmax(max_x - min_x, max_y - min_y), 1.0);
+
+    // Segmentos degenerados não bloqueiam nada
+    int vivos = 0;
+    for (int i = 0; i < ns; i++)
+    {
+        if (hypot(s[i].x2 - s[i].x1, s[i].y2 - s[i].y1) > m->tol) s[vivos++] = s[i];
+    }
+
+    Vetor pedacos = montar_grafo(s, vivos, m->tol, &m->x, &m->y, &m->num_vertices);
+    free(s);
+    if (pedacos == NULL)
+    {
+        liberar_malha(m);
+        return NULL;
+    }
+
+    int total = m->num_vertices + 3;
+    m->tri = (Triangulo*)malloc(2 * total * sizeof(Triangulo));
+    m->vt = (int*)malloc(total * sizeof(int));
+    int ok = (m->tri != NULL && m->vt != NULL) &&
+             triangular(m, pedacos, min_x, min_y, max_x, max_y);
+    vetor_destruir(pedacos);
+    if (!ok)
+    {
+        liberar_malha(m);
+        return NULL;
+    }
+    return (MalhaVisibilidade)m;
+}
+
+int malha_visibilidade_num_triangulos(MalhaVisibilidade malha)
+{
+    MalhaInternal *m = (MalhaInternal*)malha;
+    return m ? m->num_tri : 0;
+}
+
+void malha_visibilidade_destruir(MalhaVisibilidade malha)
+{
+    liberar_malha((MalhaInternal*)malha);
+}
+
+/* ============================================================================
+ * Expansão Triangular
+ * ============================================================================ */
+
+/* Aresta k de t a tratar, vista de dentro de t, no cone de R (direita) a L */
+typedef struct {
+    int t, k;
+    double rx, ry, lx, ly;
+} Cone;
+
+/* Ponto da aresta a-b atingido pelo raio que sai de o na direção de d */
+static void raio_na_aresta(double ox, double oy, double dx, double dy,
+                           double ax, double ay, double bx, double by, double *px, double *py)
+{
+    double ex = bx - ax, ey = by - ay;
+    double den = dx * ey - dy * ex;
+    double s = (den != 0) ? ((ax - ox) * dy - (ay - oy) * dx) / den : 0.0;
+    if (s < 0) s = 0;
+    if (s > 1) s = 1;
+    *px = ax + s * ex;
+    *py = ay + s * ey;
+}
+
+static void acrescentar(Poligono pol, double x, double y, double tol)
+{
+    int n = 0;
+    double *v = poligono_get_vertices_ref(pol, &n);
+    if (n > 0 && hypot(v[2 * n - 2] - x, v[2 * n - 1] - y) <= tol) return;
+    poligono_inserir_vertice(pol, x, y);
+}
+
+/* Sem repetições nem vértices no meio de lados retos */
+static Poligono simplificar(Poligono pol, double tol)
+{
+    int n = 0;
+    double *v = poligono_get_vertices_ref(pol, &n);
+    while (n > 1 && hypot(v[0] - v[2 * n - 2], v[1] - v[2 * n - 1]) <= tol) n--;
+
+    Poligono saida = poligono_criar();
+    for (int i = 0; i < n; i++)
+    {
+        double *a = &v[2 * ((i + n - 1) % n)], *b = &v[2 * i], *c = &v[2 * ((i + 1) % n)];
+        double comp = hypot(c[0] - a[0], c[1] - a[1]);
+        double desvio = (comp > 0) ? fabs(orientacao(a[0], a[1], b[0], b[1], c[0], c[1])) / comp : 0.0;
+        int no_meio = desvio <= tol && (b[0] - a[0]) * (c[0] - b[0]) + (b[1] - a[1]) * (c[1] - b[1]) >= 0;
+        if (n > 3 && no_meio) continue;
+        poligono_inserir_vertice(saida, b[0], b[1]);
+    }
+    poligono_destruir(pol);
+    return saida;
+}
+
+/* Recorta pol pelo semiplano sinal * (coordenada eixo - limite) <= 0
+ * (Sutherland-Hodgman); os pontos de corte ficam exatamente na reta */
+static Poligono recortar(Poligono pol, int eixo, double sinal, double limite, double tol)
+{
+    int n = 0;
+    double *v = poligono_get_vertices_ref(pol, &n);
+    Poligono saida = poligono_criar();
+    if (saida == NULL)
+    {
+        poligono_destruir(pol);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        double *p = &v[2 * ((i + n - 1) % n)], *q = &v[2 * i];
+        double dp = sinal * (p[eixo] - limite), dq = sinal * (q[eixo] - limite);
+        if ((dp <= tol) != (dq <= tol))
+        {
+            double t = fmin(fmax(dp / (dp - dq), 0.0), 1.0);
+            double corte[2];
+            corte[eixo] = limite;
+            corte[1 - eixo] = p[1 - eixo] + t * (q[1 - eixo] - p[1 - eixo]);
+            acrescentar(saida, corte[0], corte[1], tol);
+        }
+        if (dq <= tol) acrescentar(saida, q[0], q[1], tol);
+    }
+    poligono_destruir(pol);
+    return saida;
+}
+
+/* A moldura cabe no triângulo externo: os raios que passam dela acabam nele */
+static int moldura_coberta(const MalhaInternal *m, const double *moldura)
+{
+    int nv = m->num_vertices;
+    for (int i = 0; i < 4; i++)
+    {
+        double px = moldura[(i & 1) ? 2 : 0], py = moldura[(i & 2) ? 3 : 1];
+        for (int e = 0; e < 3; e++)
+        {
+            int a = nv + e, b = nv + (e + 1) % 3;
+            if (lado(m, a, b, px, py) <= m->tol) return 0;
+        }
+    }
+    return 1;
+}
+
+PoligonoVisibilidade malha_visibilidade_calcular(MalhaVisibilidade malha, Ponto centro)
+{
+    MalhaInternal *m = (MalhaInternal*)malha;
+    if (m == NULL) return NULL;
+    return malha_visibilidade_calcular_moldura(malha, centro, m->moldura[0], m->moldura[1],
+                                               m->moldura[2], m->moldura[3]);
+}
+
+PoligonoVisibilidade malha_visibilidade_calcular_moldura(MalhaVisibilidade malha, Ponto centro,
+                                                         double min_x, double min_y,
+                                                         double max_x, double max_y)
+{
+    MalhaInternal *m = (MalhaInternal*)malha;
+    if (m == NULL || centro == NULL) return NULL;
+    double ox = get_ponto_x(centro), oy = get_ponto_y(centro);
+    double moldura[4] = { min_x, min_y, max_x, max_y };
+    // Centro fora da moldura ou moldura além do triângulo externo: varredura
+    if (!(ox > min_x + m->tol && ox < max_x - m->tol && oy > min_y + m->tol && oy < max_y - m->tol))
+    {
+        return NULL;
+    }
+    if (!moldura_coberta(m, moldura)) return NULL;
+
+    int onde = 0, k = 0;
+    int t0 = localizar(m, ox, oy, &onde, &k);
+    if (t0 < 0 || onde != 0) return NULL;
+
+    int cap = 64, topo = 0;
+    Cone *pilha = (Cone*)malloc(cap * sizeof(Cone));
+    Poligono pol = poligono_criar();
+    if (pilha == NULL || pol == NULL)
+    {
+        free(pilha);
+        if (pol) poligono_destruir(pol);
+        return NULL;
+    }
+
+    // Lados do triângulo inicial em ordem anti-horária: 2 (v0-v1), 0, 1
+    const int primeiros[3] = { 1, 0, 2 };
+    for (int i = 0; i < 3; i++)
+    {
+        int kk = primeiros[i];
+        int a = m->tri[t0].v[(kk + 1) % 3], b = m->tri[t0].v[(kk + 2) % 3];
+        Cone c = { t0, kk, m->x[a], m->y[a], m->x[b], m->y[b] };
+        pilha[topo++] = c;
+    }
+
+    while (topo > 0)
+    {
+        Cone c = pilha[--topo];
+        const Triangulo *T = &m->tri[c.t];
+        int a = T->v[(c.k + 1) % 3], b = T->v[(c.k + 2) % 3];
+        int n = T->adj[c.k];
+
+        if (T->restrita[c.k] || n < 0)
+        {
+            double px, py;
+            raio_na_aresta(ox, oy, c.rx - ox, c.ry - oy, m->x[a], m->y[a], m->x[b], m->y[b], &px, &py);
+            acrescentar(pol, px, py, m->tol);
+            raio_na_aresta(ox, oy, c.lx - ox, c.ly - oy, m->x[a], m->y[a], m->x[b], m->y[b], &px, &py);
+            acrescentar(pol, px, py, m->tol);
+            continue;
+        }
+
+        // Entra no vizinho: o vértice oposto divide o cone
+        int j = lado_do_vizinho(m, n, c.t);
+        int v = m->tri[n].v[j];
+        double vx = m->x[v], vy = m->y[v];
+        int depois_de_r = orientacao(ox, oy, c.rx, c.ry, vx, vy) > 0;
+        int antes_de_l = orientacao(ox, oy, vx, vy, c.lx, c.ly) > 0;
+
+        if (topo + 2 > cap)
+        {
+            cap *= 2;
+            Cone *nova = (Cone*)realloc(pilha, cap * sizeof(Cone));
+            if (nova == NULL)
+            {
+                free(pilha);
+                poligono_destruir(pol);
+                return NULL;
+            }
+            pilha = nova;
+        }
+        // Esquerda empilhada antes: a direita sai primeiro
+        if (antes_de_l)
+        {
+            Cone esq = { n, (j + 2) % 3, depois_de_r ? vx : c.rx, depois_de_r ? vy : c.ry, c.lx, c.ly };
+            pilha[topo++] = esq;
+        }
+        if (depois_de_r)
+        {
+            Cone dir = { n, (j + 1) % 3, c.rx, c.ry, antes_de_l ? vx : c.lx, antes_de_l ? vy : c.ly };
+            pilha[topo++] = dir;
+        }
+    }
+    free(pilha);
+
+    // Moldura: semiplanos x >= min_x, x <= max_x, y >= min_y, y <= max_y
+    pol = recortar(pol, 0, -1, min_x, m->tol);
+    if (pol != NULL) pol = recortar(pol, 0, 1, max_x, m->tol);
+    if (pol != NULL) pol = recortar(pol, 1, -1, min_y, m->tol);
+    if (pol != NULL) pol = recortar(pol, 1, 1, max_y, m->tol);
+    if (pol == NULL) return NULL;
+    return (PoligonoVisibilidade)simplificar(pol, m->tol);
+}
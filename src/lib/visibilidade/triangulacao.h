@@ -0,0 +1,68 @@
+/* triangulacao.h
+ *
+ * Motor alternativo de visibilidade por expansão triangular. A varredura
+ * angular paga O(n log n) a cada consulta; aqui as barreiras são
+ * pré-processadas uma vez numa triangulação restrita (Delaunay por
+ * inserção incremental, com as barreiras recuperadas como arestas por
+ * trocas de diagonal). Cada consulta parte do triângulo do ponto de vista
+ * e se expande de triângulo em triângulo, estreitando o cone de visão, até
+ * bater em arestas de barreira.
+ *
+ * As bordas da cena (o biombo) ficam fora da malha e chegam como moldura
+ * de cada consulta, de modo que a malha só precisa ser refeita quando as
+ * barreiras mudam, não quando a caixa da cidade cresce.
+ *
+ * Barreiras que se cruzam ou se sobrepõem são cortadas nas interseções
+ * antes da triangulação.
+ */
+
+#ifndef TRIANGULACAO_H
+#define TRIANGULACAO_H
+
+#include "../utils/lista/lista.h"
+#include "../geometria/ponto/ponto.h"
+#include "visibilidade.h"
+
+/* Tipo opaco para a triangulação pré-processada */
+typedef void* MalhaVisibilidade;
+
+/**
+ * Triangula as barreiras. A moldura padrão de malha_visibilidade_calcular()
+ * é a caixa envolvente dos segmentos; se nenhum tiver id negativo (as
+ * bordas da cena), ela ganha a mesma margem da varredura.
+ *
+ * @param segmentos Lista de Segmento (as coordenadas são copiadas)
+ * @return Nova malha, ou NULL se a lista for vazia ou a triangulação
+ *         falhar (o chamador deve usar a varredura)
+ */
+MalhaVisibilidade malha_visibilidade_criar(LinkedList segmentos);
+
+/**
+ * Polígono de visibilidade por expansão triangular, com os vértices em
+ * sentido anti-horário. Equivale ao de calcular_visibilidade() com as
+ * mesmas barreiras, a menos da ordem e de vértices colineares.
+ *
+ * @return Polígono (destruir com visibilidade_destruir), ou NULL se o
+ *         centro estiver fora das bordas, sobre uma aresta ou sobre um
+ *         vértice da malha; nesses casos o chamador usa a varredura
+ */
+PoligonoVisibilidade malha_visibilidade_calcular(MalhaVisibilidade malha, Ponto centro);
+
+/**
+ * Como malha_visibilidade_calcular(), com as bordas da cena dadas pelo
+ * retângulo: o polígono é o que o retângulo como barreira daria. Também
+ * devolve NULL se o centro não estiver dentro do retângulo ou se ele for
+ * grande demais para a malha.
+ */
+PoligonoVisibilidade malha_visibilidade_calcular_moldura(MalhaVisibilidade malha, Ponto centro,
+                                                         double min_x, double min_y,
+                                                         double max_x, double max_y);
+
+/**
+ * Número de triângulos da malha (inclui os ligados ao triângulo externo).
+ */
+int malha_visibilidade_num_triangulos(MalhaVisibilidade malha);
+
+void malha_visibilidade_destruir(MalhaVisibilidade malha);
+
+#endif /* TRIANGULACAO_H */
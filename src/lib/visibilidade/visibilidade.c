@@ -4,19 +4,27 @@
  * Varredura Angular (Angular Plane Sweep)
  */
 
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 
 #include "visibilidade.h"
 #include "../utils/lista/lista.h"
 #include "../utils/sort/sort.h"
+#include "../utils/sort/sort_tipado.h"
+#include "../utils/arena/arena.h"
+#include "../utils/pool/pool.h"
 #include "../geometria/ponto/ponto.h"
 #include "../geometria/segmento/segmento.h"
 #include "../geometria/calculos/calculos.h"
 #include "../arvore/arvore.h"
 #include "../poligono/poligono.h"
+#include "oclusao.h"
+#include "grade.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -24,40 +32,78 @@
 
 #define EPSILON 1e-9
 #define MARGEM_BBOX 5.0
+#define MIN_EVENTOS_POR_SETOR 64
+#define EVENTOS_AQUECIMENTO 64
 
 // Compatibility Globals
 static char g_sort_method = 'q';
+static int g_num_setores = 1;
+static int g_limiar_insercao = 10;
+static bool g_oclusao = false;
+static int g_resolucao_grade = 0;
+static ConfigOrdenacao g_config_ordenacao;
+static PoolThreads g_pool = NULL;
 
 void visibilidade_set_sort_method(char method) {
     g_sort_method = method;
 }
 
+void visibilidade_set_limiar_insercao(int limiar) {
+    g_limiar_insercao = (limiar > 0) ? limiar : 1;
+}
+
+void visibilidade_set_config_ordenacao(const ConfigOrdenacao *cfg) {
+    if (cfg != NULL) g_config_ordenacao = *cfg;
+    else g_config_ordenacao.num_faixas = 0;
+}
+
+void visibilidade_set_num_setores(int num_setores) {
+    g_num_setores = (num_setores > 1) ? num_setores : 1;
+}
+
+void visibilidade_set_pool(PoolThreads pool) {
+    g_pool = pool;
+}
+
+void visibilidade_set_oclusao(bool ativa) {
+    g_oclusao = ativa;
+}
+
+void visibilidade_set_grade(int resolucao) {
+    g_resolucao_grade = (resolucao > 0) ? resolucao : 0;
+}
+
 // Adapters
 void visibilidade_destruir(PoligonoVisibilidade pol) {
     destruir_poligono_visibilidade(pol);
 }
 
+void visibilidade_soltar_testes(PoligonoVisibilidade pol) {
+    poligono_anexar(pol, NULL, NULL, NULL);
+}
+
 LinkedList visibilidade_obter_vertices(PoligonoVisibilidade pol) {
     return poligono_obter_vertices(pol);
 }
 
 PoligonoVisibilidade visibilidade_calcular(Ponto centro, LinkedList barreiras) {
-    // Default call from src's QRY
-    const char *sort_str = (g_sort_method == 'm') ? "mergesort" : "qsort";
-    int limiar = 10;
-    
+    return visibilidade_calcular_em(centro, barreiras, NULL);
+}
+
+// Bounds of the barriers; with none, a 100-unit box around the center
+static void limites_barreiras(Ponto centro, LinkedList barreiras,
+                              double *bmin_x, double *bmin_y, double *bmax_x, double *bmax_y) {
     double min_x = 1e9, min_y = 1e9, max_x = -1e9, max_y = -1e9;
     
     // Iterate barriers to find bounds
-    int n = list_size(barreiras);
-    if(n == 0) {
+    if(list_is_empty(barreiras)) {
         min_x = get_ponto_x(centro) - 100;
         max_x = get_ponto_x(centro) + 100;
         min_y = get_ponto_y(centro) - 100;
         max_y = get_ponto_y(centro) + 100;
     } else {
-        for(int i=0; i<n; i++) {
-            Segmento s = (Segmento)list_get_at(barreiras, i);
+        for(ListCursor c = list_cursor_first(barreiras); list_cursor_valid(&c); list_cursor_next(&c)) {
+            Segmento s = (Segmento)list_cursor_get(&c);
             double x1 = get_segmento_x1(s), y1 = get_segmento_y1(s);
             double x2 = get_segmento_x2(s), y2 = get_segmento_y2(s);
             if(x1 < min_x) min_x = x1; if(x1 > max_x) max_x = x1;
@@ -66,6 +112,36 @@ PoligonoVisibilidade visibilidade_calcular(Ponto centro, LinkedList barreiras) {
             if(y2 < min_y) min_y = y2; if(y2 > max_y) max_y = y2;
         }
     }
+    *bmin_x = min_x; *bmin_y = min_y;
+    *bmax_x = max_x; *bmax_y = max_y;
+}
+
+static const char* metodo_ordenacao_str(void) {
+    return (g_sort_method == 'm') ? "mergesort"
+         : (g_sort_method == 't') ? "timsort"
+         : (g_sort_method == 'p') ? "mergesort_paralelo"
+         : (g_sort_method == 'i') ? "insertion"
+         : (g_sort_method == 'a') ? "auto" : "qsort";
+}
+
+PoligonoVisibilidade visibilidade_calcular_em(Ponto centro, LinkedList barreiras, Arena arena) {
+    // Motor em grade: o contorno leva a máscara, que responde aos testes
+    if (g_resolucao_grade > 0) {
+        GradeVisibilidade grade = grade_visibilidade_calcular(centro, barreiras, g_resolucao_grade);
+        PoligonoVisibilidade pol = grade_visibilidade_poligono(grade);
+        if (pol != NULL) {
+            poligono_anexar(pol, grade, grade_visibilidade_reter, grade_visibilidade_destruir);
+            return pol;
+        }
+        grade_visibilidade_destruir(grade);
+    }
+
+    // Default call from src's QRY
+    const char *sort_str = metodo_ordenacao_str();
+    int limiar = g_limiar_insercao;
+    
+    double min_x, min_y, max_x, max_y;
+    limites_barreiras(centro, barreiras, &min_x, &min_y, &max_x, &max_y);
     
     // Include center
     if(get_ponto_x(centro) < min_x) min_x = get_ponto_x(centro);
@@ -73,11 +149,13 @@ PoligonoVisibilidade visibilidade_calcular(Ponto centro, LinkedList barreiras) {
     if(get_ponto_y(centro) < min_y) min_y = get_ponto_y(centro);
     if(get_ponto_y(centro) > max_y) max_y = get_ponto_y(centro);
 
-    return calcular_visibilidade(centro, barreiras, min_x, min_y, max_x, max_y, sort_str, limiar);
+    return calcular_visibilidade_em(arena, centro, barreiras, min_x, min_y, max_x, max_y, sort_str, limiar);
 }
 
 bool visibilidade_ponto_atingido(PoligonoVisibilidade pol, Ponto p) {
     if (!pol) return false;
+    GradeVisibilidade grade = poligono_anexo(pol);
+    if (grade) return grade_visibilidade_ponto_atingido(grade, p);
     // Export vertices array for checking
     double *coords;
     int num = 0;
@@ -85,8 +163,27 @@ bool visibilidade_ponto_atingido(PoligonoVisibilidade pol, Ponto p) {
     return ponto_no_poligono(get_ponto_x(p), get_ponto_y(p), coords, num);
 }
 
+void visibilidade_pontos_atingidos(PoligonoVisibilidade pol, const double *xs, const double *ys,
+                                   int n, unsigned char *mapa) {
+    if (n <= 0 || mapa == NULL) return;
+    if (!pol) {
+        memset(mapa, 0, BITMAP_BYTES(n));
+        return;
+    }
+    GradeVisibilidade grade = poligono_anexo(pol);
+    if (grade) {
+        grade_visibilidade_pontos_atingidos(grade, xs, ys, n, mapa);
+        return;
+    }
+    int num = 0;
+    double *coords = poligono_get_vertices_ref(pol, &num);
+    pontos_no_poligono(xs, ys, n, coords, num, mapa);
+}
+
 bool visibilidade_segmento_atingido(PoligonoVisibilidade pol, Ponto p1, Ponto p2) {
     if (!pol) return false;
+    GradeVisibilidade grade = poligono_anexo(pol);
+    if (grade) return grade_visibilidade_segmento_atingido(grade, p1, p2);
     // Reuse implicit check manually?
     // Using simple endpoint check + intersection check?
     // See srcAndre `forma_no_poligono` logic for LINE.
@@ -123,48 +220,57 @@ bool visibilidade_segmento_atingido(PoligonoVisibilidade pol, Ponto p1, Ponto p2
     return false;
 }
 
+bool visibilidade_caixa(PoligonoVisibilidade pol, double *min_x, double *min_y,
+                        double *max_x, double *max_y) {
+    if (!pol) return false;
+    // A máscara pode acender células fora do contorno
+    GradeVisibilidade grade = poligono_anexo(pol);
+    if (grade) return grade_visibilidade_caixa(grade, min_x, min_y, max_x, max_y);
+    int num = 0;
+    double *coords = poligono_get_vertices_ref(pol, &num);
+    if (coords == NULL || num <= 0) return false;
+    *min_x = *max_x = coords[0];
+    *min_y = *max_y = coords[1];
+    for (int i = 1; i < num; i++) {
+        if (coords[2*i] < *min_x) *min_x = coords[2*i];
+        if (coords[2*i] > *max_x) *max_x = coords[2*i];
+        if (coords[2*i+1] < *min_y) *min_y = coords[2*i+1];
+        if (coords[2*i+1] > *max_y) *max_y = coords[2*i+1];
+    }
+    return true;
+}
+
 typedef enum {
     EVENTO_INICIO,
     EVENTO_FIM
 } TipoEvento;
 typedef struct evento
 {
-    Ponto ponto;        /* Coordenada do vértice */
+    Ponto ponto;        /* Vértice (extremo do próprio segmento, não é cópia) */
     double angulo;      /* Ângulo polar em relação à origem */
     double distancia;   /* Distância até a origem */
     TipoEvento tipo;    /* INICIO ou FIM */
     Segmento segmento;  /* Segmento ao qual pertence */
+    int indice_segmento; /* Posição do segmento no vetor da consulta */
 } Evento;
 
-static Evento* criar_evento(Ponto ponto, TipoEvento tipo, Segmento seg, Ponto origem)
+static Evento* criar_evento(Arena arena, Ponto ponto, TipoEvento tipo, Segmento seg, Ponto origem)
 {
-    Evento *e = (Evento*)malloc(sizeof(Evento));
+    Evento *e = (Evento*)arena_alocar(arena, sizeof(Evento));
     if (e == NULL) return NULL;
     
-    e->ponto = clonar_ponto(ponto);
+    e->ponto = ponto;
     e->tipo = tipo;
     e->segmento = seg;
+    e->indice_segmento = -1;
     e->angulo = ponto_angulo_polar(origem, ponto);
     e->distancia = ponto_distancia(origem, ponto);
     
     return e;
 }
 
-static void destruir_evento(void *ptr)
+static inline int comparar_evento_ptr(const Evento *e1, const Evento *e2)
 {
-    Evento *e = (Evento*)ptr;
-    if (e != NULL)
-    {
-        destruir_ponto(e->ponto);
-        free(e);
-    }
-}
-
-static int comparar_eventos(const void *a, const void *b)
-{
-    Evento *e1 = *(Evento**)a;
-    Evento *e2 = *(Evento**)b;
-    
     if (fabs(e1->angulo - e2->angulo) > EPSILON)
     {
         return (e1->angulo < e2->angulo) ? -1 : 1;
@@ -180,38 +286,52 @@ static int comparar_eventos(const void *a, const void *b)
         return (e1->tipo == EVENTO_INICIO) ? -1 : 1;
     }
     
-    return 0;
+    /* Empate: ordem de extração. Deixa o resultado independente do
+     * algoritmo e da ordem de entrada (semente do TimSort) */
+    return (e1->indice_segmento > e2->indice_segmento) - (e1->indice_segmento < e2->indice_segmento);
 }
 
-static void destruir_segmento_callback(void *ptr)
+static int comparar_eventos(const void *a, const void *b)
 {
-    destruir_segmento((Segmento)ptr);
+    return comparar_evento_ptr(*(Evento* const*)a, *(Evento* const*)b);
 }
 
-static void criar_bounding_box(LinkedList segmentos, double min_x, double min_y, 
-                                double max_x, double max_y)
+/* Instâncias de sort_tipado.h para Evento*: sem ponteiro de função e
+ * sem memcpy por elemento nos caminhos "qsort" e "mergesort" */
+#define EVENTO_ANTES(a, b) (comparar_evento_ptr((a), (b)) < 0)
+DEFINIR_ORDENACAO(eventos, Evento*, EVENTO_ANTES)
+
+/* Acrescenta as 4 bordas ao vetor (que deve ter espaço para elas) */
+static void criar_bounding_box(Arena arena, Segmento *segmentos, int *n,
+                               double min_x, double min_y, double max_x, double max_y)
 {
     min_x -= MARGEM_BBOX;
     min_y -= MARGEM_BBOX;
     max_x += MARGEM_BBOX;
     max_y += MARGEM_BBOX;
     
-    list_insert_back(segmentos, criar_segmento(-1, -1, min_x, min_y, max_x, min_y, "none"));
-    list_insert_back(segmentos, criar_segmento(-2, -1, max_x, min_y, max_x, max_y, "none"));
-    list_insert_back(segmentos, criar_segmento(-3, -1, max_x, max_y, min_x, max_y, "none"));
-    list_insert_back(segmentos, criar_segmento(-4, -1, min_x, max_y, min_x, min_y, "none"));
+    IdString borda = segmento_cor_borda();
+    Segmento bordas[4];
+    bordas[0] = criar_segmento_com_cor(arena, -1, -1, min_x, min_y, max_x, min_y, borda);
+    bordas[1] = criar_segmento_com_cor(arena, -2, -1, max_x, min_y, max_x, max_y, borda);
+    bordas[2] = criar_segmento_com_cor(arena, -3, -1, max_x, max_y, min_x, max_y, borda);
+    bordas[3] = criar_segmento_com_cor(arena, -4, -1, min_x, max_y, min_x, min_y, borda);
+    for (int i = 0; i < 4; i++)
+    {
+        if (bordas[i] != NULL) segmentos[(*n)++] = bordas[i];
+    }
 }
 
-static LinkedList extrair_eventos(LinkedList segmentos, Ponto origem)
+static Evento** extrair_eventos(Arena arena, Segmento *segmentos, int num_segmentos, Ponto origem, int *num_eventos)
 {
-    LinkedList eventos = list_create();
+    *num_eventos = 0;
+    Evento **eventos = (Evento**)arena_alocar(arena, (2 * num_segmentos + 1) * sizeof(Evento*));
     if (eventos == NULL) return NULL;
     
-    // Iterate list
-    int n = list_size(segmentos);
-    for(int i=0; i<n; i++)
+    int n = 0;
+    for(int i=0; i<num_segmentos; i++)
     {
-        Segmento seg = (Segmento)list_get_at(segmentos, i);
+        Segmento seg = segmentos[i];
         
         Ponto p1 = get_segmento_p1(seg);
         Ponto p2 = get_segmento_p2(seg);
@@ -222,100 +342,820 @@ static LinkedList extrair_eventos(LinkedList segmentos, Ponto origem)
         // O ponto com menor ângulo é INICIO, o com maior é FIM
         Evento *e1, *e2;
         if (angulo1 <= angulo2) {
-            e1 = criar_evento(p1, EVENTO_INICIO, seg, origem);
-            e2 = criar_evento(p2, EVENTO_FIM, seg, origem);
+            e1 = criar_evento(arena, p1, EVENTO_INICIO, seg, origem);
+            e2 = criar_evento(arena, p2, EVENTO_FIM, seg, origem);
         } else {
-            e1 = criar_evento(p2, EVENTO_INICIO, seg, origem);
-            e2 = criar_evento(p1, EVENTO_FIM, seg, origem);
+            e1 = criar_evento(arena, p2, EVENTO_INICIO, seg, origem);
+            e2 = criar_evento(arena, p1, EVENTO_FIM, seg, origem);
         }
         
-        if (e1 != NULL) list_insert_back(eventos, e1);
-        if (e2 != NULL) list_insert_back(eventos, e2);
+        if (e1 != NULL) { e1->indice_segmento = i; eventos[n++] = e1; }
+        if (e2 != NULL) { e2->indice_segmento = i; eventos[n++] = e2; }
     }
     
+    *num_eventos = n;
     return eventos;
 }
 
-static void ordenar_eventos_lista(LinkedList eventos, const char *tipo_ordenacao, int limiar)
+/* ============================================================================
+ * Ordem da Consulta Anterior (semente do TimSort)
+ * ============================================================================
+ * Bombas próximas produzem ordens angulares parecidas. Com "timsort" cada
+ * thread guarda a ordem final dos eventos da sua última consulta, indexada
+ * por (id do segmento, vértice). A consulta seguinte arruma os seus eventos
+ * nessa ordem antes de ordenar; os eventos sem correspondente vão para o
+ * fim. A entrada chega quase ordenada e o TimSort fica perto de O(n).
+ */
+
+typedef struct {
+    int id;
+    double x, y;        /* Vértice do evento */
+    double ox, oy;      /* Outro extremo: distingue as arestas de uma mesma forma */
+} ChaveEvento;
+
+typedef struct {
+    ChaveEvento *chaves;    /* Ordem da consulta anterior */
+    int num, cap;
+    int *tabela;            /* Hash: posição + 1 (0 = vazia); potência de 2 */
+    int cap_tabela;
+} OrdemAnterior;
+
+static __thread OrdemAnterior ordem_local;
+static __thread int ordem_registrada = 0;
+static pthread_key_t chave_ordem;
+static pthread_once_t chave_ordem_once = PTHREAD_ONCE_INIT;
+
+static void liberar_ordem(void *arg)
 {
-    int n = list_size(eventos);
-    if (n <= 1) return;
-    
-    Evento **arr = (Evento**)malloc(n * sizeof(Evento*));
-    if (arr == NULL) return;
+    OrdemAnterior *o = (OrdemAnterior*)arg;
+    free(o->chaves);
+    free(o->tabela);
+    memset(o, 0, sizeof(*o));
+}
+
+static void criar_chave_ordem(void)
+{
+    pthread_key_create(&chave_ordem, liberar_ordem);
+}
+
+static ChaveEvento chave_evento(const Evento *e)
+{
+    ChaveEvento c;
+    c.id = get_segmento_id(e->segmento);
+    c.x = get_ponto_x(e->ponto);
+    c.y = get_ponto_y(e->ponto);
+    Ponto outro = (e->ponto == get_segmento_p1(e->segmento)) ? get_segmento_p2(e->segmento)
+                                                              : get_segmento_p1(e->segmento);
+    c.ox = get_ponto_x(outro);
+    c.oy = get_ponto_y(outro);
+    return c;
+}
+
+static unsigned int hash_chave(const ChaveEvento *c)
+{
+    unsigned long long bx, by, box, boy;
+    memcpy(&bx, &c->x, sizeof(bx));
+    memcpy(&by, &c->y, sizeof(by));
+    memcpy(&box, &c->ox, sizeof(box));
+    memcpy(&boy, &c->oy, sizeof(boy));
+    unsigned long long h = (unsigned long long)(unsigned int)c->id * 0x9E3779B97F4A7C15ULL;
+    h ^= bx + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= by + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= box + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= boy + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return (unsigned int)(h ^ (h >> 32));
+}
+
+static int chaves_iguais(const ChaveEvento *a, const ChaveEvento *b)
+{
+    return a->id == b->id && a->x == b->x && a->y == b->y &&
+           a->ox == b->ox && a->oy == b->oy;
+}
+
+/* Posição do evento na consulta anterior, ou -1 */
+static int posicao_anterior(const OrdemAnterior *o, const ChaveEvento *c)
+{
+    if (o->cap_tabela == 0) return -1;
+    unsigned int pos = hash_chave(c) & (o->cap_tabela - 1);
+    while (o->tabela[pos] != 0)
+    {
+        int k = o->tabela[pos] - 1;
+        if (chaves_iguais(&o->chaves[k], c)) return k;
+        pos = (pos + 1) & (o->cap_tabela - 1);
+    }
+    return -1;
+}
+
+/* Reordena os eventos pela ordem anterior; novos (ou repetidos) no fim.
+ * Devolve quantos eventos tinham posição anterior (0 se nada mudou) */
+static int semear_eventos(Arena arena, OrdemAnterior *o, Evento **eventos, int n)
+{
+    if (o->num == 0) return 0;
+
+    Evento **lugar = (Evento**)arena_alocar_zerado(arena, o->num * sizeof(Evento*));
+    Evento **novos = (Evento**)arena_alocar(arena, (n + 1) * sizeof(Evento*));
+    if (lugar == NULL || novos == NULL) return 0;
+
+    int num_novos = 0;
+    for (int i = 0; i < n; i++)
+    {
+        ChaveEvento c = chave_evento(eventos[i]);
+        int k = posicao_anterior(o, &c);
+        if (k >= 0 && lugar[k] == NULL) lugar[k] = eventos[i];
+        else novos[num_novos++] = eventos[i];
+    }
+
+    int j = 0;
+    for (int k = 0; k < o->num; k++)
+    {
+        if (lugar[k] != NULL) eventos[j++] = lugar[k];
+    }
+    memcpy(eventos + j, novos, num_novos * sizeof(Evento*));
+    return j;
+}
+
+/* Guarda a ordem final desta consulta para a próxima */
+static void guardar_ordem(OrdemAnterior *o, Evento **eventos, int n)
+{
+    if (n > o->cap)
+    {
+        ChaveEvento *chaves = (ChaveEvento*)realloc(o->chaves, n * sizeof(ChaveEvento));
+        if (chaves == NULL)
+        {
+            o->num = 0;
+            return;
+        }
+        o->chaves = chaves;
+        o->cap = n;
+    }
+    int cap_tabela = 64;
+    while (cap_tabela < 2 * n) cap_tabela *= 2;
+    if (cap_tabela > o->cap_tabela)
+    {
+        int *tabela = (int*)realloc(o->tabela, cap_tabela * sizeof(int));
+        if (tabela == NULL)
+        {
+            o->num = 0;
+            return;
+        }
+        o->tabela = tabela;
+        o->cap_tabela = cap_tabela;
+    }
+
+    memset(o->tabela, 0, o->cap_tabela * sizeof(int));
+    o->num = n;
+    for (int i = 0; i < n; i++)
+    {
+        o->chaves[i] = chave_evento(eventos[i]);
+        unsigned int pos = hash_chave(&o->chaves[i]) & (o->cap_tabela - 1);
+        while (o->tabela[pos] != 0)
+        {
+            if (chaves_iguais(&o->chaves[o->tabela[pos] - 1], &o->chaves[i])) break;
+            pos = (pos + 1) & (o->cap_tabela - 1);
+        }
+        /* Chave repetida: vale a primeira ocorrência */
+        if (o->tabela[pos] == 0) o->tabela[pos] = i + 1;
+    }
+}
+
+/* Ordem da thread para o TimSort, liberada quando a thread termina */
+static OrdemAnterior* ordem_da_thread(void)
+{
+    if (!ordem_registrada)
+    {
+        pthread_once(&chave_ordem_once, criar_chave_ordem);
+        pthread_setspecific(chave_ordem, &ordem_local);
+        ordem_registrada = 1;
+    }
+    return &ordem_local;
+}
+
+/* ============================================================================
+ * Visibilidade Cinética (ponto de vista em movimento)
+ * ============================================================================
+ * Entre duas posições próximas do observador, a ordem angular dos vértices
+ * só muda quando o observador cruza a reta que passa por dois deles: cada
+ * cruzamento troca dois eventos vizinhos. O estado guarda a ordem do passo
+ * anterior; o passo seguinte parte dela e a conserta com trocas adjacentes
+ * (insertion sort), em O(n + trocas) em vez de O(n log n). Passos longos
+ * demais, com mais de n log2 n trocas, deixam de compensar e caem no
+ * introsort.
+ *
+ * É só uma ordenação aquecida: o conjunto ativo não passa de um passo para
+ * o outro. A árvore é semeada de novo no raio de ângulo zero e a varredura
+ * inteira roda a cada passo, porque o desempate entre barreiras
+ * equidistantes segue a forma da árvore, que depende da ordem de inserções
+ * e remoções; aplicar as trocas a uma árvore mantida daria polígonos
+ * diferentes dos de visibilidade_calcular_em() nesses empates.
+ */
+
+typedef struct {
+    LinkedList barreiras;       /* Emprestada: não muda durante o percurso */
+    double min_x, min_y, max_x, max_y;
+    OrdemAnterior ordem;
+    long trocas;                /* Trocas adjacentes do último passo */
+} EstadoCinetico;
+
+/* Conserta por trocas adjacentes uma ordem quase correta; -1 se estourar o orçamento */
+static long reparar_por_trocas(Evento **eventos, int n, long orcamento)
+{
+    long trocas = 0;
+    for (int i = 1; i < n; i++)
+    {
+        Evento *e = eventos[i];
+        int j = i;
+        while (j > 0 && EVENTO_ANTES(e, eventos[j - 1]))
+        {
+            eventos[j] = eventos[j - 1];
+            j--;
+        }
+        eventos[j] = e;
+        trocas += i - j;
+        if (trocas > orcamento) return -1;
+    }
+    return trocas;
+}
+
+/* Intercala as duas metades ordenadas [0, meio) e [meio, n) */
+static int intercalar_eventos(Arena arena, Evento **eventos, int meio, int n)
+{
+    Evento **esq = (Evento**)arena_alocar(arena, (meio + 1) * sizeof(Evento*));
+    if (esq == NULL) return 0;
+    memcpy(esq, eventos, meio * sizeof(Evento*));
     
-    for(int i=0; i<n; i++) {
-        arr[i] = (Evento*)list_get_at(eventos, i);
+    int i = 0, j = meio, k = 0;
+    while (i < meio && j < n)
+    {
+        eventos[k++] = EVENTO_ANTES(eventos[j], esq[i]) ? eventos[j++] : esq[i++];
     }
+    while (i < meio) eventos[k++] = esq[i++];
+    return 1;
+}
+
+static void ordenar_cinetico(Arena arena, EstadoCinetico *cin, Evento **eventos, int n)
+{
+    long trocas = -1;
+    int conhecidos = semear_eventos(arena, &cin->ordem, eventos, n);
+    if (conhecidos > 0)
+    {
+        long orcamento = 0;
+        for (int m = n; m > 0; m >>= 1) orcamento += n;
+        trocas = reparar_por_trocas(eventos, conhecidos, orcamento);
+        
+        // Eventos sem posição anterior (pedaços dos segmentos cortados no
+        // ângulo zero, que mudam a cada passo) entram por intercalação
+        if (trocas >= 0 && conhecidos < n)
+        {
+            eventos_introsort(eventos + conhecidos, n - conhecidos);
+            if (!intercalar_eventos(arena, eventos, conhecidos, n)) trocas = -1;
+        }
+    }
+    // Primeiro passo (sem ordem anterior) ou salto longo: ordenação completa
+    if (trocas < 0) eventos_introsort(eventos, n);
+    cin->trocas = trocas;
+    guardar_ordem(&cin->ordem, eventos, n);
+}
+
+/* Ordena com o algoritmo dado. No TimSort a entrada é semeada com a ordem
+ * o (NULL: a da thread) e a ordem final fica guardada nela */
+static void ordenar_eventos_com(Arena arena, Evento **eventos, int n, AlgoritmoOrdenacao alg,
+                                int limiar, OrdemAnterior *o)
+{
+    switch (alg)
+    {
+        case ALG_QSORT:
+            eventos_introsort(eventos, n);
+            break;
+        case ALG_MERGESORT:
+            eventos_mergesort(eventos, n, limiar);
+            break;
+        case ALG_TIMSORT:
+        {
+            if (o == NULL) o = ordem_da_thread();
+            semear_eventos(arena, o, eventos, n);
+            ordenar((void*)eventos, n, sizeof(Evento*), comparar_eventos, alg, limiar);
+            guardar_ordem(o, eventos, n);
+            break;
+        }
+        default:
+            ordenar((void*)eventos, n, sizeof(Evento*), comparar_eventos, alg, limiar);
+            break;
+    }
+}
+
+static void ordenar_eventos(Arena arena, Evento **eventos, int n, const char *tipo_ordenacao, int limiar)
+{
+    if (n <= 1) return;
     
     AlgoritmoOrdenacao alg_enum = ALG_QSORT;
-    if (tipo_ordenacao != NULL && strcmp(tipo_ordenacao, "mergesort") == 0)
+    if (tipo_ordenacao == NULL || strcmp(tipo_ordenacao, "qsort") == 0)
+    {
+        alg_enum = ALG_QSORT;
+    }
+    else if (strcmp(tipo_ordenacao, "mergesort") == 0)
     {
         alg_enum = ALG_MERGESORT;
     }
+    else if (strcmp(tipo_ordenacao, "mergesort_paralelo") == 0)
+    {
+        alg_enum = ALG_PARALLEL_MERGESORT;
+    }
+    else if (strcmp(tipo_ordenacao, "timsort") == 0)
+    {
+        alg_enum = ALG_TIMSORT;
+    }
+    else if (strcmp(tipo_ordenacao, "insertion") == 0)
+    {
+        eventos_insercao(eventos, n);
+        return;
+    }
+    else if (strcmp(tipo_ordenacao, "auto") == 0)
+    {
+        // Escolha da calibração para este tamanho (sem calibração: qsort)
+        const FaixaOrdenacao *faixa = calibracao_escolher(&g_config_ordenacao, n);
+        if (faixa != NULL)
+        {
+            alg_enum = faixa->alg;
+            limiar = faixa->limiar;
+        }
+    }
     
-    ordenar((void*)arr, n, sizeof(Evento*), comparar_eventos, alg_enum, limiar);
+    ordenar_eventos_com(arena, eventos, n, alg_enum, limiar, NULL);
+}
+
+/* ============================================================================
+ * Medidor para a Calibração
+ * ============================================================================
+ * A calibração (calibracao_executar) compara os algoritmos por este medidor,
+ * que ordena eventos de verdade de uma cena sintética pelo mesmo caminho da
+ * varredura: as instâncias tipadas para Evento* e, no TimSort, a semente da
+ * ordem de uma bomba vizinha, com o custo de semear e guardar a ordem.
+ */
+
+static double relogio(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+double visibilidade_medir_ordenacao(AlgoritmoOrdenacao alg, int limiar, int n, int rodadas)
+{
+    Arena cena = arena_criar(0);
+    Arena rascunho = arena_criar(0);
+    if (cena == NULL || rascunho == NULL)
+    {
+        arena_destruir(cena);
+        arena_destruir(rascunho);
+        return -1;
+    }
     
-    // Rebuild list
-    while (!list_is_empty(eventos)) {
-        list_remove_front(eventos);
+    /* Segmentos curtos em volta da origem: n eventos ao todo */
+    int num_segs = (n + 1) / 2;
+    Segmento *segs = (Segmento*)arena_alocar(cena, num_segs * sizeof(Segmento));
+    unsigned int semente = 12345;
+    for (int i = 0; segs != NULL && i < num_segs; i++)
+    {
+        semente = semente * 1103515245u + 12345u;
+        double a = (semente >> 8) / (double)(1u << 24) * 2 * M_PI;
+        double d = 1 + (semente & 0xff);
+        semente = semente * 1103515245u + 12345u;
+        double b = a + (semente >> 8) / (double)(1u << 24) * (M_PI / 32);
+        double e = d + (semente & 0xf);
+        segs[i] = criar_segmento_em(cena, i, i, d * cos(a), d * sin(a), e * cos(b), e * sin(b), "none");
+        if (segs[i] == NULL) segs = NULL;
     }
     
-    for (int i = 0; i < n; i++) {
-        list_insert_back(eventos, arr[i]);
+    /* Ordem que a bomba anterior, um pouco ao lado, deixou para o TimSort */
+    Ponto anterior = criar_ponto_em(cena, 0.0, 0.0);
+    Ponto atual = criar_ponto_em(cena, 0.25, 0.25);
+    int m = 0, m_anterior = 0;
+    Evento **ordem_vizinha = NULL, **original = NULL, **trabalho = NULL;
+    if (segs != NULL && anterior != NULL && atual != NULL)
+    {
+        ordem_vizinha = extrair_eventos(cena, segs, num_segs, anterior, &m_anterior);
+        original = extrair_eventos(cena, segs, num_segs, atual, &m);
+        trabalho = (Evento**)arena_alocar(cena, (m + 1) * sizeof(Evento*));
+    }
+    if (ordem_vizinha == NULL || original == NULL || trabalho == NULL)
+    {
+        arena_destruir(cena);
+        arena_destruir(rascunho);
+        return -1;
     }
+    eventos_introsort(ordem_vizinha, m_anterior);
     
-    free(arr);
+    OrdemAnterior ordem;
+    memset(&ordem, 0, sizeof(ordem));
+    double total = 0;
+    for (int r = 0; r < rodadas; r++)
+    {
+        memcpy(trabalho, original, m * sizeof(Evento*));
+        if (alg == ALG_TIMSORT) guardar_ordem(&ordem, ordem_vizinha, m_anterior);
+        arena_resetar(rascunho);
+        double t0 = relogio();
+        ordenar_eventos_com(rascunho, trabalho, m, alg, limiar, &ordem);
+        total += relogio() - t0;
+    }
+    
+    liberar_ordem(&ordem);
+    arena_destruir(cena);
+    arena_destruir(rascunho);
+    return total;
 }
 
-PoligonoVisibilidade calcular_visibilidade(Ponto origem, LinkedList segmentos_entrada,
-                                            double min_x, double min_y,
-                                            double max_x, double max_y,
-                                            const char *tipo_ordenacao,
-                                            int limiar_insertion)
+/* ============================================================================
+ * Coordenadas em Estrutura de Vetores
+ * ============================================================================ */
+
+/* Extremos dos segmentos da consulta, no formato do kernel distancias_raio_lote() */
+typedef struct {
+    double *x1, *y1, *x2, *y2;
+} CoordsSegmentos;
+
+static int criar_coords(Arena arena, CoordsSegmentos *c, Segmento *segmentos, int n)
 {
-    if (origem == NULL) return NULL;
+    c->x1 = (double*)arena_alocar(arena, 4 * (n + 1) * sizeof(double));
+    if (c->x1 == NULL) return 0;
+    c->y1 = c->x1 + (n + 1);
+    c->x2 = c->y1 + (n + 1);
+    c->y2 = c->x2 + (n + 1);
+    for (int i = 0; i < n; i++)
+    {
+        c->x1[i] = get_segmento_x1(segmentos[i]);
+        c->y1[i] = get_segmento_y1(segmentos[i]);
+        c->x2[i] = get_segmento_x2(segmentos[i]);
+        c->y2[i] = get_segmento_y2(segmentos[i]);
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * Varredura Setorial (paralela)
+ *
+ * A sequência ordenada de eventos é dividida em setores contíguos. Cada
+ * setor varre o seu trecho com árvore e conjunto ativo próprios e emite o
+ * seu pedaço do polígono; os pedaços são concatenados em ordem.
+ *
+ * Empates de distância são decididos pela ordem de visita da árvore, que
+ * depende de toda a sequência de inserções e remoções. Por isso a árvore de
+ * um setor é montada reaplicando as inserções e remoções anteriores a ele
+ * (sem as consultas, que são o custo da varredura): fica idêntica à árvore
+ * serial naquele ponto.
+ *
+ * O biombo e o último vértice no início de um setor só se conhecem ao fim
+ * do anterior. O setor parte de um palpite: o biombo sai de uma varredura
+ * sem emissão dos EVENTOS_AQUECIMENTO eventos anteriores (a troca de biombo
+ * não depende dos vértices emitidos) e o último vértice fica desconhecido.
+ * A costura confere o palpite; um setor que não encaixa é refeito a partir
+ * do estado certo. Assim o polígono é sempre o da varredura serial.
+ * ============================================================================ */
+
+/* Varredura do trecho [ini, fim) da sequência de eventos */
+typedef struct {
+    /* Compartilhado entre os setores (só leitura) */
+    Ponto origem;
+    Evento **eventos;
+    Segmento *segmentos;
+    const CoordsSegmentos *coords;
+    int num_segmentos;
+    const unsigned char *semente;   /* Segmentos inseridos no ângulo 0 */
+    int ini, fim;
     
-    LinkedList segmentos = list_create();
-    if (segmentos == NULL) return NULL;
+    int palpite;                /* Estado inicial adivinhado, conferido na costura */
+    Segmento biombo_inicial;    /* O palpite */
     
-    if (segmentos_entrada != NULL)
+    /* Estado da varredura; sem palpite, o chamador preenche o inicial */
+    Segmento biombo;
+    int tem_ultimo;             /* Já há vértice emitido */
+    double ultimo_x, ultimo_y;
+    int emitindo;               /* 0 durante o aquecimento */
+    int ultimo_incerto;         /* tem_ultimo, mas o valor só se sabe na costura */
+    int primeiro_incerto;       /* O primeiro vértice foi emitido sem comparar */
+    double primeiro_x, primeiro_y;
+    int emitiu;
+    
+    /* Recursos próprios do setor */
+    Arena arena;                /* Nós da árvore e vetores auxiliares */
+    ArvoreSegmentos arvore;
+    int *contagem;              /* Multiplicidade de cada segmento ativo */
+    int *ativos, *posicao;      /* Conjunto ativo e posição de cada segmento nele */
+    double *ax1, *ay1, *ax2, *ay2, *distancias;  /* Coordenadas dos ativos, alinhadas */
+    Segmento *candidatos;
+    int num_ativos;
+    Poligono trecho;            /* Vértices emitidos pelo setor */
+    int falhou;                 /* Falta de memória: o trecho é inválido */
+} Setor;
+
+/* Mesmo critério de ponto_igual() */
+static int mesmo_ponto(double ax, double ay, double bx, double by)
+{
+    return fabs(ax - bx) < EPSILON && fabs(ay - by) < EPSILON;
+}
+
+static void setor_liberar(Setor *s)
+{
+    arvore_destruir(s->arvore);
+    arena_destruir(s->arena);
+    poligono_destruir(s->trecho);
+    s->arvore = NULL;
+    s->arena = NULL;
+    s->trecho = NULL;
+}
+
+/* Conta mais uma inserção de seg; na primeira, ele entra no conjunto ativo */
+static void ativar(Setor *s, int seg)
+{
+    if (s->contagem[seg]++ > 0) return;
+    const CoordsSegmentos *c = s->coords;
+    int p = s->num_ativos++;
+    s->posicao[seg] = p;
+    s->ativos[p] = seg;
+    s->ax1[p] = c->x1[seg]; s->ay1[p] = c->y1[seg];
+    s->ax2[p] = c->x2[seg]; s->ay2[p] = c->y2[seg];
+}
+
+/* Mesma regra de multiplicidade da árvore: remover um ausente não faz nada */
+static void desativar(Setor *s, int seg)
+{
+    if (s->contagem[seg] == 0 || --s->contagem[seg] > 0) return;
+    int p = s->posicao[seg];
+    int u = --s->num_ativos;
+    s->ativos[p] = s->ativos[u];
+    s->ax1[p] = s->ax1[u]; s->ay1[p] = s->ay1[u];
+    s->ax2[p] = s->ax2[u]; s->ay2[p] = s->ay2[u];
+    s->posicao[s->ativos[p]] = p;
+}
+
+/* Aplica um evento na árvore e no conjunto ativo */
+static void setor_aplicar(Setor *s, Evento *evento)
+{
+    arvore_definir_angulo(s->arvore, evento->angulo);
+    if (evento->tipo == EVENTO_INICIO)
+    {
+        arvore_inserir(s->arvore, evento->segmento);
+        ativar(s, evento->indice_segmento);
+    }
+    else
     {
-        int n = list_size(segmentos_entrada);
-        for(int i=0; i<n; i++)
+        arvore_remover(s->arvore, evento->segmento);
+        desativar(s, evento->indice_segmento);
+    }
+}
+
+/**
+ * Segmento ativo mais próximo no ângulo dado: o mesmo que
+ * arvore_obter_primeiro() devolveria (mesma distância e comparação
+ * estrita; empates pela ordem de visita da árvore), com as distâncias
+ * calculadas em lote.
+ */
+static Segmento setor_primeiro(Setor *s, double angulo)
+{
+    distancias_raio_lote(get_ponto_x(s->origem), get_ponto_y(s->origem), cos(angulo), sin(angulo),
+                         s->ax1, s->ay1, s->ax2, s->ay2, s->num_ativos, s->distancias);
+    
+    double menor_dist = 1e18;
+    int qtd = 0;
+    for (int k = 0; k < s->num_ativos; k++)
+    {
+        double dist = s->distancias[k];
+        if (dist < menor_dist)
         {
-            Segmento seg = (Segmento)list_get_at(segmentos_entrada, i);
-            list_insert_back(segmentos, clonar_segmento(seg));
+            menor_dist = dist;
+            qtd = 0;
+            s->candidatos[qtd++] = s->segmentos[s->ativos[k]];
         }
+        else if (dist == menor_dist && qtd > 0)
+        {
+            s->candidatos[qtd++] = s->segmentos[s->ativos[k]];
+        }
+    }
+    if (qtd == 0) return NULL;
+    if (qtd == 1) return s->candidatos[0];
+    return arvore_primeiro_dentre(s->arvore, s->candidatos, qtd);
+}
+
+/* Acrescenta um vértice ao trecho, salvo se repete o último */
+static void emitir(Setor *s, double x, double y)
+{
+    if (!s->emitindo) return;
+    if (s->ultimo_incerto)
+    {
+        // A costura descarta o vértice se ele repetir o fim do setor anterior
+        s->ultimo_incerto = 0;
+        s->primeiro_incerto = 1;
+        s->primeiro_x = x;
+        s->primeiro_y = y;
+    }
+    else if (s->tem_ultimo && mesmo_ponto(s->ultimo_x, s->ultimo_y, x, y))
+    {
+        return;
     }
+    poligono_inserir_vertice(s->trecho, x, y);
+    s->tem_ultimo = 1;
+    s->ultimo_x = x;
+    s->ultimo_y = y;
+    s->emitiu = 1;
+}
+
+/* Emite a interseção do raio origem -> direcao com seg, se houver */
+static void emitir_intersecao(Setor *s, Ponto direcao, Segmento seg)
+{
+    Ponto intersecao = NULL;
+    if (s->emitindo && intersecao_raio_segmento(s->origem, direcao, seg, &intersecao))
+    {
+        emitir(s, get_ponto_x(intersecao), get_ponto_y(intersecao));
+        destruir_ponto(intersecao);
+    }
+}
+
+/* Aloca os recursos do setor e monta a árvore de antes do evento inicio */
+static int setor_preparar(Setor *s, int inicio)
+{
+    int n = s->num_segmentos + 1;
+    s->arena = arena_criar(0);
+    if (s->arena == NULL) return 0;
+    s->contagem = (int*)arena_alocar_zerado(s->arena, 2 * n * sizeof(int));
+    s->ativos = (int*)arena_alocar(s->arena, n * sizeof(int));
+    s->ax1 = (double*)arena_alocar(s->arena, 5 * n * sizeof(double));
+    s->candidatos = (Segmento*)arena_alocar(s->arena, n * sizeof(Segmento));
+    s->arvore = arvore_criar_em(s->origem, s->arena);
+    s->trecho = poligono_criar();
+    if (s->contagem == NULL || s->ativos == NULL || s->ax1 == NULL || s->candidatos == NULL ||
+        s->arvore == NULL || s->trecho == NULL)
+    {
+        return 0;
+    }
+    s->posicao = s->contagem + n;
+    s->ay1 = s->ax1 + n;
+    s->ax2 = s->ay1 + n;
+    s->ay2 = s->ax2 + n;
+    s->distancias = s->ay2 + n;
+    s->num_ativos = 0;
     
-    double ox = get_ponto_x(origem);
-    double oy = get_ponto_y(origem);
-    if (ox < min_x) min_x = ox;
-    if (ox > max_x) max_x = ox;
-    if (oy < min_y) min_y = oy;
-    if (oy > max_y) max_y = oy;
+    // Mesmas inserções, na mesma ordem e nos mesmos ângulos, da árvore serial
+    for (int i = 0; i < s->num_segmentos; i++)
+    {
+        if (!s->semente[i]) continue;
+        arvore_inserir(s->arvore, s->segmentos[i]);
+        ativar(s, i);
+    }
+    for (int i = 0; i < inicio; i++) setor_aplicar(s, s->eventos[i]);
+    return 1;
+}
+
+/* Um passo da varredura: aplica o evento e troca o biombo se preciso */
+static void setor_evento(Setor *s, Evento *evento)
+{
+    Segmento biombo = s->biombo;
     
-    int tem_bbox = 0;
-    int sz_check = list_size(segmentos);
-    for(int i=0; i<sz_check && !tem_bbox; i++)
+    if (evento->tipo == EVENTO_INICIO)
+    {
+        setor_aplicar(s, evento);
+        Segmento novo_biombo = setor_primeiro(s, evento->angulo);
+        
+        // Verificar se o novo biombo e o biombo atual compartilham o vértice atual
+        // Se sim, não trocar - manter o biombo atual para preservar a quina
+        int compartilham_vertice = 0;
+        if (biombo != NULL && novo_biombo != NULL && novo_biombo != biombo)
+        {
+            double dist_biombo = distancia_raio_segmento(s->origem, evento->angulo, biombo);
+            double dist_novo = distancia_raio_segmento(s->origem, evento->angulo, novo_biombo);
+            // Se as distâncias são praticamente iguais, compartilham o vértice
+            if (fabs(dist_biombo - dist_novo) < EPSILON * 10)
+            {
+                compartilham_vertice = 1;
+            }
+        }
+        
+        if (novo_biombo == evento->segmento && biombo != evento->segmento && !compartilham_vertice)
+        {
+            if (biombo != NULL && s->tem_ultimo)
+            {
+                emitir_intersecao(s, evento->ponto, biombo);
+            }
+            emitir(s, get_ponto_x(evento->ponto), get_ponto_y(evento->ponto));
+            s->biombo = novo_biombo;
+        }
+    }
+    else if (evento->segmento == biombo)
+    {
+        emitir(s, get_ponto_x(evento->ponto), get_ponto_y(evento->ponto));
+        
+        setor_aplicar(s, evento);
+        Segmento novo_biombo = setor_primeiro(s, evento->angulo);
+        if (novo_biombo != NULL)
+        {
+            emitir_intersecao(s, evento->ponto, novo_biombo);
+        }
+        s->biombo = novo_biombo;
+    }
+    else
     {
-        Segmento seg = (Segmento)list_get_at(segmentos, i);
-        if (get_segmento_id(seg) < 0) tem_bbox = 1;
+        setor_aplicar(s, evento);
     }
+}
+
+/**
+ * Varre o trecho do setor. O estado inicial é o começo da volta (ini == 0),
+ * um palpite, ou o que o chamador deixou em biombo/tem_ultimo/ultimo_*.
+ */
+static void setor_executar(Setor *s)
+{
+    s->falhou = 0;
+    s->emitiu = 0;
+    s->emitindo = 1;
+    s->ultimo_incerto = 0;
+    s->primeiro_incerto = 0;
     
-    if (!tem_bbox)
+    // Com palpite, o biombo vem de uma varredura sem emissão dos eventos anteriores
+    int inicio = s->ini;
+    if (s->palpite) inicio = (s->ini > EVENTOS_AQUECIMENTO) ? s->ini - EVENTOS_AQUECIMENTO : 0;
+    if (!setor_preparar(s, inicio))
     {
-        criar_bounding_box(segmentos, min_x, min_y, max_x, max_y);
-    }    
+        s->falhou = 1;
+        return;
+    }
     
-    int sz = list_size(segmentos);
-    for(int i=0; i<sz; i++)
+    if (inicio == 0)
     {
-        Segmento seg = (Segmento)list_get_at(segmentos, i);
-        Ponto dir_zero = criar_ponto(ox + 1.0, oy);
-        Ponto intersecao = NULL;
+        s->tem_ultimo = 0;
+        s->emitindo = (s->ini == 0);
+        s->biombo = setor_primeiro(s, 0.0);
+        if (s->biombo != NULL)
+        {
+            Ponto dir = criar_ponto(get_ponto_x(s->origem) + 1000, get_ponto_y(s->origem));
+            if (dir != NULL) emitir_intersecao(s, dir, s->biombo);
+            destruir_ponto(dir);
+        }
+    }
+    else if (s->palpite)
+    {
+        s->emitindo = 0;
+        s->biombo = setor_primeiro(s, s->eventos[inicio - 1]->angulo);
+    }
+    
+    for (int i = inicio; i < s->ini; i++) setor_evento(s, s->eventos[i]);
+    if (s->palpite)
+    {
+        s->biombo_inicial = s->biombo;
+        s->tem_ultimo = 1;
+        s->ultimo_incerto = 1;
+        s->emitindo = 1;
+    }
+    
+    for (int i = s->ini; i < s->fim; i++) setor_evento(s, s->eventos[i]);
+}
+
+static void tarefa_setor(void *arg, int indice)
+{
+    setor_executar(&((Setor*)arg)[indice]);
+}
+
+/**
+ * Confere se o setor, varrido a partir do palpite, começa no estado em que
+ * o anterior terminou. O primeiro vértice emitido sem comparação só é
+ * aceito se a comparação de verdade daria o mesmo resultado.
+ */
+static int setor_encaixa(const Setor *s, Segmento biombo, int tem_ultimo, double ux, double uy)
+{
+    if (s->falhou || s->biombo_inicial != biombo || !tem_ultimo) return 0;
+    if (!s->primeiro_incerto) return 1;
+    if (!mesmo_ponto(ux, uy, s->primeiro_x, s->primeiro_y)) return 1;
+    return ux == s->primeiro_x && uy == s->primeiro_y;
+}
+
+/**
+ * Corta os segmentos que cruzam o raio de ângulo 0, para que nenhum segmento
+ * atravesse a descontinuidade da varredura. Devolve um vetor na mesma ordem
+ * que a remoção/reinserção numa lista produziria: os segmentos intactos
+ * primeiro e, depois, as metades, na ordem em que foram cortadas.
+ * Cada segmento passa pelo teste de raio uma vez: o vetor de entrada muda a
+ * cada consulta (corte por alcance, biombo), então um índice montado aqui
+ * custaria mais que a varredura linear que ele evitaria. Tudo (vetores e
+ * metades) vem da arena; os segmentos cortados ficam nela até o reset.
+ */
+static Segmento* dividir_no_angulo_zero(Arena arena, Ponto origem, Segmento *entrada, int n,
+                                        int *num_saida)
+{
+    double ox = get_ponto_x(origem);
+    double oy = get_ponto_y(origem);
+    Ponto dir_zero = criar_ponto_em(arena, ox + 1.0, oy);
+    if (dir_zero == NULL) return NULL;
+    
+    // Cada corte acrescenta um segmento; as metades podem ser cortadas de novo
+    int cap = n + 8;
+    Segmento *saida = (Segmento*)arena_alocar(arena, cap * sizeof(Segmento));
+    Segmento *fila = (Segmento*)arena_alocar(arena, cap * sizeof(Segmento));
+    if (saida == NULL || fila == NULL) return NULL;
+    
+    int qtd_saida = 0, qtd_fila = 0;
+    for (int i = 0; i < n + qtd_fila; i++)
+    {
+        Segmento seg = (i < n) ? entrada[i] : fila[i - n];
         
+        Ponto intersecao = NULL;
+        int cortado = 0;
         if (intersecao_raio_segmento(origem, dir_zero, seg, &intersecao))
         {
             double ix = get_ponto_x(intersecao);
@@ -326,187 +1166,257 @@ PoligonoVisibilidade calcular_visibilidade(Ponto origem, LinkedList segmentos_en
             double x2 = get_segmento_x2(seg);
             double y2 = get_segmento_y2(seg);
             
-            if (hypot(ix - x1, iy - y1) > EPSILON &&
+            if (n + qtd_fila + 2 > cap)
+            {
+                // A arena não realoca: copia para vetores com o dobro do espaço
+                Segmento *nf = (Segmento*)arena_alocar(arena, 2 * cap * sizeof(Segmento));
+                Segmento *ns = (Segmento*)arena_alocar(arena, 2 * cap * sizeof(Segmento));
+                if (nf != NULL && ns != NULL)
+                {
+                    memcpy(nf, fila, qtd_fila * sizeof(Segmento));
+                    memcpy(ns, saida, qtd_saida * sizeof(Segmento));
+                    fila = nf;
+                    saida = ns;
+                    cap *= 2;
+                }
+            }
+            
+            if (n + qtd_fila + 2 <= cap &&
+                hypot(ix - x1, iy - y1) > EPSILON &&
                 hypot(ix - x2, iy - y2) > EPSILON)
             {
                 int id = get_segmento_id(seg);
                 int id_orig = get_segmento_id_original(seg);
-                const char *cor = get_segmento_cor(seg);
-                
-                Segmento s1 = criar_segmento(id, id_orig, x1, y1, ix, iy, cor);
-                Segmento s2 = criar_segmento(id, id_orig, ix, iy, x2, y2, cor);
-                
-                // Replace current segment with two new ones
-                list_remove_at(segmentos, i);
-                destruir_segmento(seg);
+                IdString cor = get_segmento_cor_id(seg);
                 
-                list_insert_back(segmentos, s1);
-                list_insert_back(segmentos, s2);
-                
-                i--;
-                sz = list_size(segmentos); // update size
+                Segmento a = criar_segmento_com_cor(arena, id, id_orig, x1, y1, ix, iy, cor);
+                Segmento b = criar_segmento_com_cor(arena, id, id_orig, ix, iy, x2, y2, cor);
+                if (a != NULL && b != NULL)
+                {
+                    fila[qtd_fila++] = a;
+                    fila[qtd_fila++] = b;
+                    cortado = 1;
+                }
             }
             destruir_ponto(intersecao);
         }
-        destruir_ponto(dir_zero); 
+        if (!cortado) saida[qtd_saida++] = seg;
     }
+    
+    *num_saida = qtd_saida;
+    return saida;
+}
+
+/* Copia os segmentos de entrada para o vetor da consulta */
+typedef struct {
+    Arena arena;
+    Segmento *destino;
+    int n;
+} CopiaSegmentos;
 
-    LinkedList eventos = extrair_eventos(segmentos, origem);
-    if (eventos == NULL || list_is_empty(eventos))
+static void copiar_segmento(void *valor, void *contexto)
+{
+    CopiaSegmentos *c = (CopiaSegmentos*)contexto;
+    Segmento copia = clonar_segmento_em(c->arena, (Segmento)valor);
+    if (copia != NULL) c->destino[c->n++] = copia;
+}
+
+/**
+ * Varredura de uma consulta. Os temporários compartilhados (cópias dos
+ * segmentos, eventos, vetores auxiliares) saem da arena; árvore e conjunto
+ * ativo de cada setor saem da arena própria dele, liberada ao fim. Só o
+ * polígono resultante é alocado fora delas. O chamador reseta a arena depois.
+ */
+static PoligonoVisibilidade calcular_em(Arena arena, Ponto origem, LinkedList segmentos_entrada,
+                                        double min_x, double min_y,
+                                        double max_x, double max_y,
+                                        const char *tipo_ordenacao,
+                                        int limiar_insertion,
+                                        EstadoCinetico *cin,
+                                        double angulo_fim)
+{
+    int n_entrada = (segmentos_entrada != NULL) ? list_size(segmentos_entrada) : 0;
+    
+    // Espaço extra para as 4 bordas
+    CopiaSegmentos copia = { arena, NULL, 0 };
+    copia.destino = (Segmento*)arena_alocar(arena, (n_entrada + 4) * sizeof(Segmento));
+    if (copia.destino == NULL) return NULL;
+    if (segmentos_entrada != NULL)
     {
-        // free list elements
-        while(!list_is_empty(segmentos)) {
-            destruir_segmento(list_remove_front(segmentos));
-        }
-        list_destroy(segmentos);
-        if (eventos) list_destroy(eventos);
-        return NULL;
+        list_for_each(segmentos_entrada, copiar_segmento, &copia);
     }
+    Segmento *segmentos = copia.destino;
+    int num_entrada = copia.n;
     
-    ordenar_eventos_lista(eventos, tipo_ordenacao, limiar_insertion);
+    double ox = get_ponto_x(origem);
+    double oy = get_ponto_y(origem);
+    if (ox < min_x) min_x = ox;
+    if (ox > max_x) max_x = ox;
+    if (oy < min_y) min_y = oy;
+    if (oy > max_y) max_y = oy;
     
-    ArvoreSegmentos arvore = arvore_criar(origem);
+    int tem_bbox = 0;
+    for(int i=0; i<num_entrada && !tem_bbox; i++)
+    {
+        if (get_segmento_id(segmentos[i]) < 0) tem_bbox = 1;
+    }
     
-    Poligono resultado = poligono_criar();
+    if (!tem_bbox)
+    {
+        criar_bounding_box(arena, segmentos, &num_entrada, min_x, min_y, max_x, max_y);
+    }    
     
-    // Init tree with segments at angle 0
-    sz = list_size(segmentos);
-    for(int i=0; i<sz; i++)
+    // Segmentos escondidos atrás de outros nem geram eventos. O modo
+    // cinético fica de fora: ele depende do mesmo conjunto entre passos
+    if (g_oclusao && cin == NULL)
     {
-        Segmento seg = (Segmento)list_get_at(segmentos, i);
-        double dist = distancia_raio_segmento(origem, 0.0, seg);
-        if (dist < 1e9)
-        {
-            arvore_inserir(arvore, seg);
-        }
+        num_entrada = oclusao_filtrar(arena, ox, oy, segmentos, num_entrada);
     }
     
-    Segmento biombo = arvore_obter_primeiro(arvore);
-    Ponto ultimo_ponto = NULL;
+    // Events and sectors address segments by index in this array
+    int num_segs = 0;
+    Segmento *segs = dividir_no_angulo_zero(arena, origem, segmentos, num_entrada, &num_segs);
+    if (segs == NULL) return NULL;
+
+    int num_ev = 0;
+    Evento **eventos = extrair_eventos(arena, segs, num_segs, origem, &num_ev);
+    if (eventos == NULL || num_ev == 0) return NULL;
     
-    if (biombo != NULL)
+    // Setor limitado: a volta não se completa, então o pedaço cortado que
+    // termina no raio zero (extraído como se começasse nele) passa a começar
+    // no outro extremo. Eventos depois do fim nunca são processados, e a
+    // árvore começa só com os segmentos que partem do raio zero
+    int setor_limitado = (angulo_fim < 2 * M_PI);
+    unsigned char *no_inicio = NULL;
+    if (setor_limitado)
     {
-        Ponto dir = criar_ponto(ox + 1000, oy);
-        Ponto intersecao = NULL;
-        
-        if (intersecao_raio_segmento(origem, dir, biombo, &intersecao))
+        no_inicio = (unsigned char*)arena_alocar_zerado(arena, num_segs + 1);
+        if (no_inicio == NULL) return NULL;
+        for (int i = 0; i + 1 < num_ev; i += 2)
+        {
+            Evento *ini = eventos[i], *fim = eventos[i + 1];
+            if (ini->indice_segmento != fim->indice_segmento) continue;
+            if (ini->angulo < EPSILON && fim->angulo > M_PI)
+            {
+                ini->tipo = EVENTO_FIM;
+                ini->angulo = 2 * M_PI;
+                fim->tipo = EVENTO_INICIO;
+            }
+        }
+        int mantidos = 0;
+        for (int i = 0; i < num_ev; i++)
         {
-            poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-            ultimo_ponto = intersecao; 
+            Evento *e = eventos[i];
+            if (e->angulo > angulo_fim) continue;
+            if (e->tipo == EVENTO_INICIO && e->angulo < EPSILON) no_inicio[e->indice_segmento] = 1;
+            eventos[mantidos++] = e;
         }
-        destruir_ponto(dir);
+        num_ev = mantidos;
+        if (num_ev == 0) return NULL;
     }
     
-    int num_ev = list_size(eventos);
-    for(int i=0; i<num_ev; i++)
+    if (cin != NULL) ordenar_cinetico(arena, cin, eventos, num_ev);
+    else ordenar_eventos(arena, eventos, num_ev, tipo_ordenacao, limiar_insertion);
+    
+    // Segmentos atingidos pelo raio de ângulo 0 (um raio em lote sobre todos)
+    // começam na árvore
+    CoordsSegmentos coords = { NULL, NULL, NULL, NULL };
+    double *dist_zero = (double*)arena_alocar(arena, (num_segs + 1) * sizeof(double));
+    unsigned char *semente = (unsigned char*)arena_alocar_zerado(arena, num_segs + 1);
+    if (dist_zero == NULL || semente == NULL || !criar_coords(arena, &coords, segs, num_segs)) return NULL;
+    distancias_raio_lote(ox, oy, cos(0.0), sin(0.0),
+                         coords.x1, coords.y1, coords.x2, coords.y2, num_segs, dist_zero);
+    for (int i = 0; i < num_segs; i++)
+    {
+        semente[i] = (dist_zero[i] < 1e9 && (no_inicio == NULL || no_inicio[i]));
+    }
+    
+    int num_setores = setor_limitado ? 1 : g_num_setores;
+    if (num_setores > num_ev / MIN_EVENTOS_POR_SETOR) num_setores = num_ev / MIN_EVENTOS_POR_SETOR;
+    if (num_setores < 1) num_setores = 1;
+    Setor *setores = (Setor*)arena_alocar_zerado(arena, num_setores * sizeof(Setor));
+    if (setores == NULL) return NULL;
+    for (int k = 0; k < num_setores; k++)
+    {
+        Setor *s = &setores[k];
+        s->origem = origem;
+        s->eventos = eventos;
+        s->segmentos = segs;
+        s->coords = &coords;
+        s->num_segmentos = num_segs;
+        s->semente = semente;
+        s->ini = (int)((long long)num_ev * k / num_setores);
+        s->fim = (int)((long long)num_ev * (k + 1) / num_setores);
+        s->palpite = (k > 0);
+    }
+    pool_executar(g_pool, tarefa_setor, setores, num_setores);
+    
+    // Costura: cada trecho continua do estado em que o anterior terminou
+    Poligono resultado = poligono_criar();
+    Segmento biombo = NULL;
+    int tem_ultimo = 0;
+    double ultimo_x = 0, ultimo_y = 0;
+    int ok = (resultado != NULL);
+    for (int k = 0; k < num_setores && ok; k++)
     {
-        Evento *evento = (Evento*)list_get_at(eventos, i);
-        arvore_definir_angulo(arvore, evento->angulo);
+        Setor *s = &setores[k];
+        if (k > 0 && !setor_encaixa(s, biombo, tem_ultimo, ultimo_x, ultimo_y))
+        {
+            setor_liberar(s);
+            s->palpite = 0;
+            s->biombo = biombo;
+            s->tem_ultimo = tem_ultimo;
+            s->ultimo_x = ultimo_x;
+            s->ultimo_y = ultimo_y;
+            setor_executar(s);
+        }
+        if (s->falhou)
+        {
+            ok = 0;
+            break;
+        }
         
-        if (evento->tipo == EVENTO_INICIO)
+        int n = 0;
+        double *v = poligono_get_vertices_ref(s->trecho, &n);
+        int j = 0;
+        if (s->primeiro_incerto && mesmo_ponto(ultimo_x, ultimo_y, v[0], v[1])) j = 1;
+        for (; j < n; j++) poligono_inserir_vertice(resultado, v[2 * j], v[2 * j + 1]);
+        
+        biombo = s->biombo;
+        if (s->emitiu)
         {
-            arvore_inserir(arvore, evento->segmento);
-            Segmento novo_biombo = arvore_obter_primeiro(arvore);
-            
-            // Verificar se o novo biombo e o biombo atual compartilham o vértice atual
-            // Se sim, não trocar - manter o biombo atual para preservar a quina
-            int compartilham_vertice = 0;
-            if (biombo != NULL && novo_biombo != NULL && novo_biombo != biombo)
-            {
-                double dist_biombo = distancia_raio_segmento(origem, evento->angulo, biombo);
-                double dist_novo = distancia_raio_segmento(origem, evento->angulo, novo_biombo);
-                // Se as distâncias são praticamente iguais, compartilham o vértice
-                if (fabs(dist_biombo - dist_novo) < EPSILON * 10)
-                {
-                    compartilham_vertice = 1;
-                }
-            }
-            
-            if (novo_biombo == evento->segmento && biombo != evento->segmento && !compartilham_vertice)
-            {
-                if (biombo != NULL && ultimo_ponto != NULL)
-                {
-                    Ponto intersecao = NULL;
-                    if (intersecao_raio_segmento(origem, evento->ponto, biombo, &intersecao))
-                    {
-                        if (!ponto_igual(ultimo_ponto, intersecao))
-                        {
-                            poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-                            destruir_ponto(ultimo_ponto);
-                            ultimo_ponto = intersecao;
-                        }
-                        else
-                        {
-                            destruir_ponto(intersecao);
-                        }
-                    }
-                }
-                
-                Ponto pt = evento->ponto;
-                if (!ultimo_ponto || !ponto_igual(ultimo_ponto, pt))
-                {
-                    poligono_inserir_vertice(resultado, get_ponto_x(pt), get_ponto_y(pt));
-                    if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                    ultimo_ponto = clonar_ponto(pt);
-                }
-                biombo = novo_biombo;
-            }
+            tem_ultimo = 1;
+            ultimo_x = s->ultimo_x;
+            ultimo_y = s->ultimo_y;
         }
-        else /* EVENTO_FIM */
+    }
+    for (int k = 0; k < num_setores; k++) setor_liberar(&setores[k]);
+    if (!ok)
+    {
+        poligono_destruir(resultado);
+        return NULL;
+    }
+    
+    if (setor_limitado)
+    {
+        // Fecha o setor: biombo no raio final e volta à origem
+        if (biombo != NULL)
         {
-            if (evento->segmento == biombo)
+            Ponto dir = criar_ponto_em(arena, ox + 1000 * cos(angulo_fim), oy + 1000 * sin(angulo_fim));
+            Ponto intersecao = NULL;
+            if (dir != NULL && intersecao_raio_segmento(origem, dir, biombo, &intersecao))
             {
-                Ponto pt = evento->ponto;
-                if (!ultimo_ponto || !ponto_igual(ultimo_ponto, pt))
-                {
-                    poligono_inserir_vertice(resultado, get_ponto_x(pt), get_ponto_y(pt));
-                    if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                    ultimo_ponto = clonar_ponto(pt);
-                }
-                
-                arvore_remover(arvore, evento->segmento);
-                Segmento novo_biombo = arvore_obter_primeiro(arvore);
-                
-                if (novo_biombo != NULL)
+                if (!tem_ultimo || !mesmo_ponto(ultimo_x, ultimo_y, get_ponto_x(intersecao), get_ponto_y(intersecao)))
                 {
-                    Ponto intersecao = NULL;
-                    if (intersecao_raio_segmento(origem, evento->ponto, novo_biombo, &intersecao))
-                    {
-                        if (!ultimo_ponto || !ponto_igual(ultimo_ponto, intersecao))
-                        {
-                             poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-                             if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                             ultimo_ponto = intersecao;
-                        }
-                        else
-                        {
-                            destruir_ponto(intersecao);
-                        }
-                    }
+                    poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
                 }
-                biombo = novo_biombo;
-            }
-            else
-            {
-                arvore_remover(arvore, evento->segmento);
+                destruir_ponto(intersecao);
             }
         }
+        poligono_inserir_vertice(resultado, ox, oy);
     }
     
-    if (ultimo_ponto) destruir_ponto(ultimo_ponto);
-    
-    arvore_destruir(arvore);
-    
-    // Cleanup
-    while(!list_is_empty(segmentos)) {
-        destruir_segmento(list_remove_front(segmentos));
-    }
-    list_destroy(segmentos);
-    
-    while(!list_is_empty(eventos)) {
-        destruir_evento(list_remove_front(eventos));
-    }
-    list_destroy(eventos);
+    // Segmentos e eventos ficam na arena
     
     // Se polígono tem menos de 3 vértices, criar polígono que cobre todo o bounding box
     // Isso acontece quando não há anteparos bloqueando a visão
@@ -523,6 +1433,264 @@ PoligonoVisibilidade calcular_visibilidade(Ponto origem, LinkedList segmentos_en
     return (PoligonoVisibilidade)resultado;
 }
 
+PoligonoVisibilidade calcular_visibilidade_em(Arena arena, Ponto origem, LinkedList segmentos,
+                                             double min_x, double min_y,
+                                             double max_x, double max_y,
+                                             const char *tipo_ordenacao,
+                                             int limiar_insertion)
+{
+    if (origem == NULL) return NULL;
+    
+    // Sem arena do chamador: uma temporária só para esta consulta
+    Arena propria = NULL;
+    if (arena == NULL)
+    {
+        propria = arena_criar(0);
+        if (propria == NULL) return NULL;
+        arena = propria;
+    }
+    
+    PoligonoVisibilidade resultado = calcular_em(arena, origem, segmentos, min_x, min_y,
+                                                 max_x, max_y, tipo_ordenacao, limiar_insertion, NULL, 2 * M_PI);
+    
+    if (propria != NULL) arena_destruir(propria);
+    else arena_resetar(arena);
+    return resultado;
+}
+
+PoligonoVisibilidade calcular_visibilidade(Ponto origem, LinkedList segmentos,
+                                            double min_x, double min_y,
+                                            double max_x, double max_y,
+                                            const char *tipo_ordenacao,
+                                            int limiar_insertion)
+{
+    return calcular_visibilidade_em(NULL, origem, segmentos, min_x, min_y, max_x, max_y,
+                                    tipo_ordenacao, limiar_insertion);
+}
+
+VisibilidadeCinetica visibilidade_cinetica_criar(LinkedList barreiras)
+{
+    EstadoCinetico *cin = (EstadoCinetico*)calloc(1, sizeof(EstadoCinetico));
+    if (cin == NULL) return NULL;
+    
+    cin->barreiras = barreiras;
+    if (barreiras != NULL && !list_is_empty(barreiras))
+    {
+        // As barreiras não mudam: os limites valem para todos os passos
+        limites_barreiras(NULL, barreiras, &cin->min_x, &cin->min_y, &cin->max_x, &cin->max_y);
+    }
+    cin->trocas = -1;
+    return (VisibilidadeCinetica)cin;
+}
+
+PoligonoVisibilidade visibilidade_cinetica_calcular(VisibilidadeCinetica vc, Ponto centro, Arena arena)
+{
+    EstadoCinetico *cin = (EstadoCinetico*)vc;
+    if (cin == NULL || centro == NULL) return NULL;
+    
+    // Mesma caixa de visibilidade_calcular_em(), para o mesmo polígono
+    double min_x = cin->min_x, min_y = cin->min_y;
+    double max_x = cin->max_x, max_y = cin->max_y;
+    if (cin->barreiras == NULL || list_is_empty(cin->barreiras))
+    {
+        min_x = get_ponto_x(centro) - 100;
+        max_x = get_ponto_x(centro) + 100;
+        min_y = get_ponto_y(centro) - 100;
+        max_y = get_ponto_y(centro) + 100;
+    }
+    if(get_ponto_x(centro) < min_x) min_x = get_ponto_x(centro);
+    if(get_ponto_x(centro) > max_x) max_x = get_ponto_x(centro);
+    if(get_ponto_y(centro) < min_y) min_y = get_ponto_y(centro);
+    if(get_ponto_y(centro) > max_y) max_y = get_ponto_y(centro);
+    
+    Arena propria = NULL;
+    if (arena == NULL)
+    {
+        propria = arena_criar(0);
+        if (propria == NULL) return NULL;
+        arena = propria;
+    }
+    
+    PoligonoVisibilidade resultado = calcular_em(arena, centro, cin->barreiras, min_x, min_y,
+                                                 max_x, max_y, NULL, g_limiar_insercao, cin, 2 * M_PI);
+    
+    if (propria != NULL) arena_destruir(propria);
+    else arena_resetar(arena);
+    return resultado;
+}
+
+long visibilidade_cinetica_trocas(VisibilidadeCinetica vc)
+{
+    EstadoCinetico *cin = (EstadoCinetico*)vc;
+    return (cin != NULL) ? cin->trocas : -1;
+}
+
+void visibilidade_cinetica_destruir(VisibilidadeCinetica vc)
+{
+    EstadoCinetico *cin = (EstadoCinetico*)vc;
+    if (cin == NULL) return;
+    liberar_ordem(&cin->ordem);
+    free(cin);
+}
+
+/* ============================================================================
+ * Visibilidade Limitada (alcance e setor)
+ * ============================================================================
+ * O cenário é girado em torno da origem para que o setor comece no ângulo
+ * zero, onde a varredura já começa; ela para no fim do setor. Antes disso,
+ * segmentos fora do disco ou do setor são descartados: o custo passa a
+ * depender das barreiras próximas, não do tamanho da cidade. O disco entra
+ * como um polígono circunscrito de LADOS_DISCO lados (contém o círculo).
+ */
+
+#define LADOS_DISCO 64
+
+/* Ângulo relativo ao início do setor, em [0, 2π) */
+static double angulo_relativo(double dx, double dy, double inicio)
+{
+    double a = atan2(dy, dx) - inicio;
+    while (a < 0) a += 2 * M_PI;
+    while (a >= 2 * M_PI) a -= 2 * M_PI;
+    return a;
+}
+
+/* O segmento (relativo à origem) alcança o setor [0, amplitude]? */
+static int segmento_no_setor(double x1, double y1, double x2, double y2,
+                             double inicio, double amplitude)
+{
+    if (amplitude >= 2 * M_PI) return 1;
+    // Passa pela origem: visível em qualquer direção
+    if (fabs(x1 * y2 - x2 * y1) < EPSILON && x1 * x2 + y1 * y2 <= 0) return 1;
+    
+    double a1 = angulo_relativo(x1, y1, inicio);
+    double a2 = angulo_relativo(x2, y2, inicio);
+    if (a1 <= amplitude || a2 <= amplitude) return 1;
+    
+    // Sem extremo dentro, os dois estão em (amplitude, 2π): o segmento só
+    // alcança o setor se o arco que cobre (menor que π) der a volta por zero
+    double lo = (a1 < a2) ? a1 : a2;
+    double hi = (a1 < a2) ? a2 : a1;
+    return hi - lo > M_PI;
+}
+
+static Segmento girar_segmento(Arena arena, Segmento seg, double ox, double oy, double c, double s)
+{
+    double x1 = get_segmento_x1(seg) - ox, y1 = get_segmento_y1(seg) - oy;
+    double x2 = get_segmento_x2(seg) - ox, y2 = get_segmento_y2(seg) - oy;
+    return criar_segmento_com_cor(arena, get_segmento_id(seg), get_segmento_id_original(seg),
+                                  ox + x1 * c - y1 * s, oy + x1 * s + y1 * c,
+                                  ox + x2 * c - y2 * s, oy + x2 * s + y2 * c,
+                                  get_segmento_cor_id(seg));
+}
+
+static void estender_limites(double x, double y, double *min_x, double *min_y,
+                             double *max_x, double *max_y)
+{
+    if (x < *min_x) *min_x = x;
+    if (x > *max_x) *max_x = x;
+    if (y < *min_y) *min_y = y;
+    if (y > *max_y) *max_y = y;
+}
+
+static PoligonoVisibilidade calcular_limitada_em(Arena arena, Ponto centro, LinkedList barreiras,
+                                                 const LimitesVisao *lim)
+{
+    double ox = get_ponto_x(centro), oy = get_ponto_y(centro);
+    double raio = lim->raio;
+    double inicio = 0.0, amplitude = 2 * M_PI;
+    if (lim->angulo_max != lim->angulo_min)
+    {
+        inicio = lim->angulo_min;
+        amplitude = fmod(lim->angulo_max - lim->angulo_min, 2 * M_PI);
+        if (amplitude <= 0) amplitude += 2 * M_PI;
+    }
+    // Gira por -inicio: o setor passa a ser [0, amplitude]
+    double c = cos(-inicio), s = sin(-inicio);
+    int girar = (amplitude < 2 * M_PI && inicio != 0.0);
+    
+    LinkedList locais = list_create();
+    if (locais == NULL) return NULL;
+    double min_x = ox, min_y = oy, max_x = ox, max_y = oy;
+    
+    for (ListCursor cur = list_cursor_first(barreiras); list_cursor_valid(&cur); list_cursor_next(&cur))
+    {
+        Segmento seg = (Segmento)list_cursor_get(&cur);
+        double x1 = get_segmento_x1(seg), y1 = get_segmento_y1(seg);
+        double x2 = get_segmento_x2(seg), y2 = get_segmento_y2(seg);
+        if (raio > 0 && distancia_ponto_segmento(ox, oy, x1, y1, x2, y2) > raio) continue;
+        if (!segmento_no_setor(x1 - ox, y1 - oy, x2 - ox, y2 - oy, inicio, amplitude)) continue;
+        
+        Segmento local = girar ? girar_segmento(arena, seg, ox, oy, c, s) : seg;
+        if (local == NULL) continue;
+        list_insert_back(locais, local);
+        estender_limites(get_segmento_x1(local), get_segmento_y1(local), &min_x, &min_y, &max_x, &max_y);
+        estender_limites(get_segmento_x2(local), get_segmento_y2(local), &min_x, &min_y, &max_x, &max_y);
+    }
+    
+    if (raio > 0)
+    {
+        // Já no referencial girado; lados fora do setor também são descartados
+        double r = raio / cos(M_PI / LADOS_DISCO);
+        for (int k = 0; k < LADOS_DISCO; k++)
+        {
+            double a1 = 2 * M_PI * k / LADOS_DISCO;
+            double a2 = 2 * M_PI * (k + 1) / LADOS_DISCO;
+            double x1 = r * cos(a1), y1 = r * sin(a1);
+            double x2 = r * cos(a2), y2 = r * sin(a2);
+            if (!segmento_no_setor(x1, y1, x2, y2, 0.0, amplitude)) continue;
+            Segmento lado = criar_segmento_com_cor(arena, -1, -1, ox + x1, oy + y1, ox + x2, oy + y2,
+                                                   segmento_cor_borda());
+            if (lado == NULL) continue;
+            list_insert_back(locais, lado);
+            estender_limites(ox + x1, oy + y1, &min_x, &min_y, &max_x, &max_y);
+            estender_limites(ox + x2, oy + y2, &min_x, &min_y, &max_x, &max_y);
+        }
+    }
+    
+    PoligonoVisibilidade resultado = calcular_em(arena, centro, locais, min_x, min_y, max_x, max_y,
+                                                 metodo_ordenacao_str(), g_limiar_insercao,
+                                                 NULL, amplitude);
+    list_destroy(locais);
+    
+    if (resultado != NULL && girar)
+    {
+        // De volta ao referencial da cidade
+        int n = 0;
+        double *v = poligono_get_vertices_ref((Poligono)resultado, &n);
+        for (int i = 0; i < n; i++)
+        {
+            double dx = v[2 * i] - ox, dy = v[2 * i + 1] - oy;
+            v[2 * i] = ox + dx * c + dy * s;
+            v[2 * i + 1] = oy - dx * s + dy * c;
+        }
+    }
+    return resultado;
+}
+
+PoligonoVisibilidade visibilidade_calcular_limitada(Ponto centro, LinkedList barreiras,
+                                                    const LimitesVisao *lim, Arena arena)
+{
+    if (lim == NULL || (lim->raio <= 0 && lim->angulo_min == lim->angulo_max))
+    {
+        return visibilidade_calcular_em(centro, barreiras, arena);
+    }
+    if (centro == NULL || barreiras == NULL) return NULL;
+    
+    Arena propria = NULL;
+    if (arena == NULL)
+    {
+        propria = arena_criar(0);
+        if (propria == NULL) return NULL;
+        arena = propria;
+    }
+    
+    PoligonoVisibilidade resultado = calcular_limitada_em(arena, centro, barreiras, lim);
+    
+    if (propria != NULL) arena_destruir(propria);
+    else arena_resetar(arena);
+    return resultado;
+}
+
 // Converter - Stubbed for now or unimplemented as mentioned
 int converter_formas_para_segmentos(LinkedList lista_formas, LinkedList lista_segmentos, char orientacao) {
     // Requires access to shape data.
@@ -562,4 +1730,4 @@ Ponto poligono_obter_vertice(PoligonoVisibilidade poligono, int indice)
 LinkedList poligono_obter_vertices(PoligonoVisibilidade poligono)
 {
     return poligono_obter_lista((Poligono)poligono);
-}
\ No newline at end of file
+}
@@ -11,7 +11,9 @@
 #include "../utils/lista/lista.h"
 #include "../geometria/ponto/ponto.h"
 #include "../geometria/segmento/segmento.h"
-#include "../poligono/poligono.h" 
+#include "../poligono/poligono.h"
+#include "../utils/sort/calibracao.h" 
+#include "../utils/pool/pool.h"
 
 // Note: src/lib/poligono/poligono.h will be overwritten next.
 // We assume Poligono type is 'Poligono' or opaque void*
@@ -34,7 +36,9 @@ typedef void* PoligonoVisibilidade;
  * @param min_y Limite mínimo Y do cenário
  * @param max_x Limite máximo X do cenário
  * @param max_y Limite máximo Y do cenário
- * @param tipo_ordenacao "qsort" ou "mergesort"
+ * @param tipo_ordenacao "qsort", "mergesort", "mergesort_paralelo" (pool de
+ *        ordenar_definir_pool) ou "timsort" (semeado com a ordem da
+ *        consulta anterior da mesma thread)
  * @param limiar_insertion Limiar para InsertionSort
  * @param segmentos_visiveis Lista opcional para preencher com segmentos visíveis (pode ser NULL)
  * @return Polígono de visibilidade (lista de pontos), ou NULL em caso de erro
@@ -47,6 +51,17 @@ PoligonoVisibilidade calcular_visibilidade(Ponto origem, LinkedList segmentos,
                                             const char *tipo_ordenacao,
                                             int limiar_insertion);
 
+/**
+ * Igual a calcular_visibilidade, mas os temporários da consulta vêm da arena
+ * (resetada ao final; o polígono devolvido não depende dela). Com arena NULL
+ * uma arena própria é criada e destruída na chamada.
+ */
+PoligonoVisibilidade calcular_visibilidade_em(Arena arena, Ponto origem, LinkedList segmentos,
+                                             double min_x, double min_y,
+                                             double max_x, double max_y,
+                                             const char *tipo_ordenacao,
+                                             int limiar_insertion);
+
 // Note: I am merging `calcular_visibilidade` and `calcular_visibilidade_com_segmentos` logic 
 // or providing same interface as srcAndre.
 // srcAndre has both.
@@ -106,14 +121,151 @@ LinkedList poligono_obter_vertices(PoligonoVisibilidade poligono);
  */
 int converter_formas_para_segmentos(LinkedList lista_formas, LinkedList lista_segmentos, char orientacao);
 
-// Compatibility with src main.c calls
+// Compatibility with src main.c calls: 'q' (qsort), 'm' (mergesort),
+// 'p' (mergesort paralelo), 't' (timsort semeado com a consulta anterior),
+// 'i' (insertion sort) ou 'a' (automático, pela calibração)
 void visibilidade_set_sort_method(char method);
 
+/**
+ * Limiar do Insertion Sort nos MergeSorts da varredura (padrão 10).
+ */
+void visibilidade_set_limiar_insercao(int limiar);
+
+/**
+ * Configuração usada pelo modo 'a': algoritmo e limiar por faixa de
+ * número de eventos (copiada). Sem faixas, o modo 'a' usa qsort.
+ */
+void visibilidade_set_config_ordenacao(const ConfigOrdenacao *cfg);
+
+/**
+ * Medidor da varredura para calibracao_executar(): ordena n eventos de uma
+ * cena sintética pelo mesmo caminho da consulta (eventos_introsort,
+ * eventos_mergesort; TimSort semeado com a ordem de uma bomba vizinha).
+ * @return Segundos gastos nas rodadas ordenações, ou < 0 se faltar memória
+ */
+double visibilidade_medir_ordenacao(AlgoritmoOrdenacao alg, int limiar, int n, int rodadas);
+
+/**
+ * Define em quantos setores angulares a varredura é dividida.
+ * Com k > 1, a sequência ordenada de eventos é repartida em k setores
+ * contíguos, cada um varrido com árvore própria (montada reaplicando os
+ * eventos anteriores a ele) numa tarefa do pool de visibilidade_set_pool;
+ * os trechos são costurados em ordem e o polígono é idêntico ao da
+ * varredura serial. Consultas com poucos eventos usam menos setores.
+ * @param num_setores Número de setores (1 = serial, padrão)
+ */
+void visibilidade_set_num_setores(int num_setores);
+
+/**
+ * Define o pool em que os setores da varredura rodam. Sem pool (NULL, o
+ * padrão) os setores rodam em série na thread chamadora.
+ *
+ * @note O pool não é reentrante: não calcule visibilidade setorial de
+ *       dentro de uma tarefa do mesmo pool.
+ */
+void visibilidade_set_pool(PoolThreads pool);
+
+/**
+ * Liga o descarte por oclusão antes da varredura (ver oclusao.h): as
+ * barreiras são visitadas da mais próxima para a mais distante numa
+ * quadtree e as inteiramente escondidas não geram eventos. Desligado por
+ * padrão; não se aplica à visibilidade cinética.
+ */
+void visibilidade_set_oclusao(bool ativa);
+
+/**
+ * Troca a varredura pelo motor em grade (ver grade.h) em
+ * visibilidade_calcular() e nas consultas sem alcance nem setor: as
+ * barreiras são rasterizadas numa grade com `resolucao` células no lado
+ * maior. O polígono devolvido é o contorno da região iluminada e leva a
+ * máscara junto (também nas cópias do cache): visibilidade_*_atingido e
+ * visibilidade_caixa respondem pelas células, não pelo contorno.
+ * @param resolucao Células no lado maior (0 = varredura exata, padrão)
+ */
+void visibilidade_set_grade(int resolucao);
+
 // Mapping OLD src function names to NEW srcAndre function names (adapters in .c)
 PoligonoVisibilidade visibilidade_calcular(Ponto centro, LinkedList barreiras);
+/* Versão que reaproveita a arena do chamador entre consultas consecutivas */
+PoligonoVisibilidade visibilidade_calcular_em(Ponto centro, LinkedList barreiras, Arena arena);
 void visibilidade_destruir(PoligonoVisibilidade pol);
+/* Solta o que o polígono guarda só para os testes (a máscara do motor em
+ * grade); daí em diante ele serve para desenho */
+void visibilidade_soltar_testes(PoligonoVisibilidade pol);
 LinkedList visibilidade_obter_vertices(PoligonoVisibilidade pol);
 bool visibilidade_ponto_atingido(PoligonoVisibilidade pol, Ponto p);
 bool visibilidade_segmento_atingido(PoligonoVisibilidade pol, Ponto p1, Ponto p2);
 
+/* ============================================================================
+ * Visibilidade Limitada
+ * ============================================================================ */
+
+/* Alcance e campo de visão de uma consulta */
+typedef struct {
+    double raio;        /* Alcance; <= 0 sem limite */
+    double angulo_min;  /* Setor de angulo_min a angulo_max, no sentido */
+    double angulo_max;  /* anti-horário, em radianos; iguais = 360° */
+} LimitesVisao;
+
+/**
+ * Polígono de visibilidade restrito a um disco e/ou setor. Segmentos fora
+ * deles são descartados antes da varredura, que começa e termina nas
+ * bordas do setor; com setor, o polígono inclui a origem como vértice.
+ * O disco é aproximado por um polígono circunscrito (contém o círculo).
+ * Sem limites (ou lim NULL) equivale a visibilidade_calcular_em().
+ */
+PoligonoVisibilidade visibilidade_calcular_limitada(Ponto centro, LinkedList barreiras,
+                                                    const LimitesVisao *lim, Arena arena);
+
+/* ============================================================================
+ * Visibilidade Cinética
+ * ============================================================================ */
+
+/* Estado de um observador que se move entre barreiras fixas */
+typedef void* VisibilidadeCinetica;
+
+/**
+ * Cria o estado para calcular polígonos em posições sucessivas do
+ * observador. Cada passo parte da ordem angular de eventos do passo
+ * anterior e a conserta com trocas de eventos vizinhos, em vez de
+ * reordenar tudo; o polígono é o mesmo de visibilidade_calcular_em().
+ * Só a ordenação é incremental: o conjunto ativo é reconstruído e a
+ * varredura completa roda em todo passo.
+ * @param barreiras Lista de Segmento; emprestada, não pode mudar enquanto
+ *        o estado existir
+ */
+VisibilidadeCinetica visibilidade_cinetica_criar(LinkedList barreiras);
+
+/**
+ * Polígono de visibilidade na posição atual do observador. Os temporários
+ * vêm da arena (resetada ao final), como em visibilidade_calcular_em().
+ */
+PoligonoVisibilidade visibilidade_cinetica_calcular(VisibilidadeCinetica vc, Ponto centro, Arena arena);
+
+/**
+ * Trocas adjacentes feitas no último passo, ou -1 se ele precisou de
+ * ordenação completa (primeiro passo ou salto longo demais).
+ */
+long visibilidade_cinetica_trocas(VisibilidadeCinetica vc);
+
+void visibilidade_cinetica_destruir(VisibilidadeCinetica vc);
+
+/**
+ * Testa vários pontos de uma vez contra o polígono de visibilidade
+ * (ver pontos_no_poligono()). Equivale a chamar visibilidade_ponto_atingido()
+ * para cada ponto.
+ * @param xs, ys Coordenadas dos n pontos
+ * @param mapa Saída com BITMAP_BYTES(n) bytes: bit i ligado se o ponto i foi atingido
+ */
+void visibilidade_pontos_atingidos(PoligonoVisibilidade pol, const double *xs, const double *ys,
+                                   int n, unsigned char *mapa);
+
+/**
+ * Caixa envolvente do polígono. Nenhum ponto fora dela é atingido, então
+ * serve para descartar formas antes do teste.
+ * @return false se o polígono for NULL ou não tiver vértices
+ */
+bool visibilidade_caixa(PoligonoVisibilidade pol, double *min_x, double *min_y,
+                        double *max_x, double *max_y);
+
 #endif /* VISIBILIDADE_H */
\ No newline at end of file
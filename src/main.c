@@ -8,6 +8,9 @@
 #include "lib/qry/qry.h"
 #include "lib/visibilidade/visibilidade.h"
 #include "lib/svg/svg.h"
+#include "lib/utils/sort/calibracao.h"
+#include "lib/utils/pool/pool.h"
+#include "lib/utils/lista/lista.h"
 
 // Cores para output no terminal
 #define COLOR_RED     "\033[1;31m"
@@ -87,8 +90,18 @@ void print_usage(const char *prog_name) {
     printf(COLOR_YELLOW "Argumentos opcionais:" COLOR_RESET "\n");
     printf("  -e <caminho_base>   Prefixo de caminho para arquivos de entrada\n");
     printf("  -q <arquivo.qry>    Arquivo de consultas (comandos de bomba)\n");
-    printf("  -to <tipo>          Tipo de ordenação: 'q'(quicksort), 'm'(mergesort)\n");
-    printf("  -i                  Usar insertion sort\n\n");
+    printf("  -to <tipo>          Tipo de ordenação: 'q'(quicksort), 'm'(mergesort), 'p'(mergesort paralelo), 't'(timsort)\n");
+    printf("  -i [n]              Limiar n do insertion sort nos mergesorts; sem n, ordena só por insertion sort\n");
+    printf("  -cal <arquivo>      Escolher a ordenação pelo tamanho, com a calibração do arquivo\n");
+    printf("                      (se ele não existir, calibra nesta máquina e o cria)\n");
+    printf("  -ns <k>             Dividir a varredura angular em k setores paralelos\n");
+    printf("  -nt <k>             Usar k threads na detecção de formas atingidas e nos setores\n");
+    printf("                      (sem -nt, -ns k usa k threads)\n");
+    printf("  -oc                 Descartar barreiras escondidas antes da varredura (quadtree)\n");
+    printf("  -tri                Calcular a visibilidade por expansão triangular (malha das barreiras)\n");
+    printf("  -ap <k>             Visibilidade aproximada com k faixas angulares (prévia rápida)\n");
+    printf("  -gr <n>             Visibilidade em grade de n células no lado maior (cenas muito densas)\n");
+    printf("                      (-ap, -tri e -gr são motores alternativos: com mais de um, vale -ap, depois -tri)\n\n");
     printf(COLOR_YELLOW "Exemplos:" COLOR_RESET "\n");
     printf("  %s -f cidade.geo -o saida\n", prog_name);
     printf("  %s -e dados -f mapa.geo -o resultado -q comandos.qry\n\n", prog_name);
@@ -96,6 +109,9 @@ void print_usage(const char *prog_name) {
 
 int main(int argc, char *argv[])
 {
+    // A free list de nós de lista da thread principal não tem destrutor de thread
+    atexit(list_pool_liberar);
+
     // Pegar argumentos
     const char *base_path = get_arg_value(argc, argv, "-e");
     const char *geo_name = get_arg_value(argc, argv, "-f");
@@ -104,6 +120,14 @@ int main(int argc, char *argv[])
 
     const char *sort_arg = get_arg_value(argc, argv, "-to");
     int insertion_flag = has_flag(argc, argv, "-i");
+    const char *insertion_arg = get_arg_value(argc, argv, "-i");
+    const char *cal_arg = get_arg_value(argc, argv, "-cal");
+    const char *setores_arg = get_arg_value(argc, argv, "-ns");
+    const char *threads_arg = get_arg_value(argc, argv, "-nt");
+    int oclusao_flag = has_flag(argc, argv, "-oc");
+    int triangulacao_flag = has_flag(argc, argv, "-tri");
+    const char *aproximada_arg = get_arg_value(argc, argv, "-ap");
+    const char *grade_arg = get_arg_value(argc, argv, "-gr");
 
     // ========== VALIDAÇÃO DE ARGUMENTOS ==========
     
@@ -176,18 +200,110 @@ int main(int argc, char *argv[])
 
     // ========== CONFIGURAÇÃO ==========
 
-    // Configurar ordenação
+    // Configurar ordenação: "-i n" só muda o limiar; "-i" sozinho escolhe insertion sort
+    if (insertion_flag && insertion_arg) {
+        char *fim = NULL;
+        long limiar = strtol(insertion_arg, &fim, 10);
+        if (fim != insertion_arg && *fim == '\0') {
+            if (limiar >= 1) {
+                visibilidade_set_limiar_insercao((int)limiar);
+            } else {
+                printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Limiar de insertion sort '%s' inválido. Usando padrão (10).\n", insertion_arg);
+            }
+            insertion_flag = 0;
+        }
+    }
     if (insertion_flag) {
         visibilidade_set_sort_method('i');
     } else if (sort_arg) {
         char c = sort_arg[0];
-        if (c == 'm' || c == 'q' || c == 'i') {
+        if (c == 'm' || c == 'q' || c == 'i' || c == 't' || c == 'p') {
              visibilidade_set_sort_method(c);
         } else {
             printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Tipo de ordenação '%s' não reconhecido. Usando padrão (quicksort).\n", sort_arg);
         }
     }
 
+    // Calibração: só decide o algoritmo se nem -to nem "-i" o fixaram
+    if (cal_arg) {
+        ConfigOrdenacao cfg;
+        if (!calibracao_carregar(&cfg, cal_arg)) {
+            printf("Calibrando ordenação nesta máquina...\n");
+            int threads = threads_arg ? atoi(threads_arg) : 1;
+            PoolThreads pool = (threads > 1) ? pool_criar(threads) : NULL;
+            int ok = calibracao_executar(&cfg, pool, 0, visibilidade_medir_ordenacao);
+            pool_destruir(pool);
+            if (ok && !calibracao_salvar(&cfg, cal_arg)) {
+                printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Não foi possível gravar a calibração em %s\n", cal_arg);
+            }
+            if (!ok) cfg.num_faixas = 0;
+        }
+        visibilidade_set_config_ordenacao(&cfg);
+        if (!insertion_flag && !sort_arg) {
+            visibilidade_set_sort_method('a');
+        }
+    }
+
+    // Configurar varredura setorial
+    if (setores_arg) {
+        int setores = atoi(setores_arg);
+        if (setores >= 1) {
+            visibilidade_set_num_setores(setores);
+            // Os setores rodam no pool de -nt; sem -nt, um pool do tamanho deles
+            if (!threads_arg) qry_set_num_threads(setores);
+        } else {
+            printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Número de setores '%s' inválido. Usando varredura serial.\n", setores_arg);
+        }
+    }
+
+    // Configurar threads da detecção de formas atingidas
+    if (threads_arg) {
+        int threads = atoi(threads_arg);
+        if (threads >= 1) {
+            qry_set_num_threads(threads);
+        } else {
+            printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Número de threads '%s' inválido. Usando detecção serial.\n", threads_arg);
+        }
+    }
+
+    // Descarte por oclusão antes da varredura
+    if (oclusao_flag) {
+        visibilidade_set_oclusao(true);
+    }
+
+    // Expansão triangular sobre a malha das barreiras
+    if (triangulacao_flag) {
+        qry_set_triangulacao(true);
+    }
+
+    // Visibilidade aproximada por faixas angulares
+    if (aproximada_arg) {
+        int faixas = atoi(aproximada_arg);
+        if (faixas >= 3) {
+            qry_set_aproximada(faixas);
+        } else {
+            printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Número de faixas '%s' inválido. Usando visibilidade exata.\n", aproximada_arg);
+        }
+    }
+
+    // Shadowcasting numa grade de ocupação
+    if (grade_arg) {
+        int resolucao = atoi(grade_arg);
+        if (resolucao >= 1) {
+            visibilidade_set_grade(resolucao);
+        } else {
+            printf(COLOR_YELLOW "Aviso:" COLOR_RESET " Resolução '%s' inválida. Usando visibilidade exata.\n", grade_arg);
+        }
+    }
+
+    // Os motores não se combinam: a bomba usa o primeiro de -ap, -tri, -gr
+    int aproximada_ativa = aproximada_arg && atoi(aproximada_arg) >= 3;
+    int grade_ativa = grade_arg && atoi(grade_arg) >= 1;
+    if (aproximada_ativa + triangulacao_flag + grade_ativa > 1) {
+        printf(COLOR_YELLOW "Aviso:" COLOR_RESET " -ap, -tri e -gr são motores alternativos. Usando %s.\n",
+               aproximada_ativa ? "-ap" : "-tri");
+    }
+
     // ========== PROCESSAMENTO ==========
 
     // 1. Criar e ler Geo
@@ -0,0 +1,93 @@
+/* cena_teste.h
+ *
+ * Cenas e oráculo de força bruta compartilhados pelos testes dos motores
+ * de visibilidade (triangulação, aproximada, grade), para que os três
+ * sejam conferidos pelo mesmo código. Só para os testes: as funções são
+ * static e cada test_*.c inclui o cabeçalho uma vez.
+ */
+
+#ifndef CENA_TESTE_H
+#define CENA_TESTE_H
+
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "../lib/visibilidade/visibilidade.h"
+#include "../lib/geometria/segmento/segmento.h"
+#include "../lib/poligono/poligono.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double aleatorio(double lo, double hi) {
+    return lo + (hi - lo) * ((double)rand() / RAND_MAX);
+}
+
+/* Área com sinal (positiva no sentido anti-horário) */
+static double area(PoligonoVisibilidade pol) {
+    int n = 0;
+    double *v = poligono_get_vertices_ref((Poligono)pol, &n);
+    double a = 0;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        a += v[2 * i] * v[2 * j + 1] - v[2 * j] * v[2 * i + 1];
+    }
+    return a / 2;
+}
+
+static int segmentos_cruzam(double ax, double ay, double bx, double by,
+                            double cx, double cy, double dx, double dy) {
+    double d1 = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    double d2 = (bx - ax) * (dy - ay) - (by - ay) * (dx - ax);
+    double d3 = (dx - cx) * (ay - cy) - (dy - cy) * (ax - cx);
+    double d4 = (dx - cx) * (by - cy) - (dy - cy) * (bx - cx);
+    return ((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0));
+}
+
+/* Visível por força bruta: o segmento origem-ponto não cruza barreira */
+static int visivel(LinkedList barreiras, double ox, double oy, double px, double py) {
+    for (ListCursor c = list_cursor_first(barreiras); list_cursor_valid(&c); list_cursor_next(&c)) {
+        Segmento s = (Segmento)list_cursor_get(&c);
+        if (segmentos_cruzam(ox, oy, px, py, get_segmento_x1(s), get_segmento_y1(s),
+                             get_segmento_x2(s), get_segmento_y2(s))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Bordas da cena no sentido anti-horário, com ids negativos */
+static void inserir_bordas(LinkedList l, double x0, double y0, double x1, double y1) {
+    list_insert_back(l, criar_segmento(-1, -1, x0, y0, x1, y0, "none"));
+    list_insert_back(l, criar_segmento(-2, -2, x1, y0, x1, y1, "none"));
+    list_insert_back(l, criar_segmento(-3, -3, x1, y1, x0, y1, "none"));
+    list_insert_back(l, criar_segmento(-4, -4, x0, y1, x0, y0, "none"));
+}
+
+static void destruir_segmentos(LinkedList l) {
+    while (!list_is_empty(l)) destruir_segmento((Segmento)list_remove_front(l));
+    list_destroy(l);
+}
+
+/* Um motor visto pelos testes: polígono ou máscara a partir do centro,
+ * com um parâmetro de precisão (faixas, resolução; ignorado se não houver) */
+typedef void *(*MotorTeste)(Ponto centro, LinkedList barreiras, int parametro);
+
+/**
+ * Entradas que todo motor recusa com NULL: lista vazia, centro ou lista
+ * NULL e, se parametro_invalido >= 0, um parâmetro fora do domínio.
+ */
+static void conferir_entradas_invalidas(MotorTeste calcular, int parametro, int parametro_invalido) {
+    LinkedList l = list_create();
+    Ponto c = criar_ponto(0, 0);
+    assert(calcular(c, l, parametro) == NULL);
+    inserir_bordas(l, -10, -10, 10, 10);
+    if (parametro_invalido >= 0) assert(calcular(c, l, parametro_invalido) == NULL);
+    assert(calcular(NULL, l, parametro) == NULL);
+    assert(calcular(c, NULL, parametro) == NULL);
+    destruir_ponto(c);
+    destruir_segmentos(l);
+}
+
+#endif /* CENA_TESTE_H */
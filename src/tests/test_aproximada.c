@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "../lib/visibilidade/aproximada.h"
+#include "../lib/visibilidade/triangulacao.h"
+#include "../lib/visibilidade/visibilidade.h"
+#include "../lib/geometria/segmento/segmento.h"
+#include "../lib/poligono/poligono.h"
+#include "cena_teste.h"
+
+#define AMOSTRAS_ANGULARES (1 << 17)
+
+/* Distância de (cx, cy) à borda do polígono em AMOSTRAS_ANGULARES ângulos
+ * igualmente espaçados. Os dois polígonos são estrelados a partir do ponto
+ * de vista, então cada ângulo cruza uma aresta só */
+static void raios_da_borda(PoligonoVisibilidade pol, double cx, double cy, double *r) {
+    int n = 0;
+    double *v = poligono_get_vertices_ref((Poligono)pol, &n);
+    double passo = 2 * M_PI / AMOSTRAS_ANGULARES;
+    for (int k = 0; k < AMOSTRAS_ANGULARES; k++) r[k] = -1;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        double ax = v[2 * i] - cx, ay = v[2 * i + 1] - cy;
+        double bx = v[2 * j] - cx, by = v[2 * j + 1] - cy;
+        double ini = atan2(ay, ax), vao = atan2(by, bx) - ini;
+        if (ini < 0) ini += 2 * M_PI;
+        if (vao < 0) vao += 2 * M_PI;
+        if (vao <= 0 || vao >= M_PI) continue;   // aresta radial
+        for (long k = (long)ceil(ini / passo - 0.5); (k + 0.5) * passo <= ini + vao; k++) {
+            double t = (k + 0.5) * passo, dx = cos(t), dy = sin(t);
+            double ex = bx - ax, ey = by - ay;
+            r[k % AMOSTRAS_ANGULARES] = (ax * ey - ay * ex) / (dx * ey - dy * ex);
+        }
+    }
+}
+
+/* Área da diferença simétrica entre dois polígonos estrelados a partir de
+ * (cx, cy): integral de |ra² - rb²| / 2 nos ângulos amostrados */
+static double diferenca_simetrica(PoligonoVisibilidade a, PoligonoVisibilidade b, double cx, double cy) {
+    double *ra = malloc(AMOSTRAS_ANGULARES * sizeof(double));
+    double *rb = malloc(AMOSTRAS_ANGULARES * sizeof(double));
+    assert(ra != NULL && rb != NULL);
+    raios_da_borda(a, cx, cy, ra);
+    raios_da_borda(b, cx, cy, rb);
+    double soma = 0;
+    for (int k = 0; k < AMOSTRAS_ANGULARES; k++) {
+        assert(ra[k] >= 0 && rb[k] >= 0);
+        soma += fabs(ra[k] * ra[k] - rb[k] * rb[k]) / 2;
+    }
+    free(ra);
+    free(rb);
+    return soma * 2 * M_PI / AMOSTRAS_ANGULARES;
+}
+
+static void *motor_aproximado(Ponto c, LinkedList l, int faixas) {
+    return visibilidade_aproximada_calcular(c, l, faixas, NULL);
+}
+
+void test_entradas_invalidas() {
+    printf("Testing invalid inputs...\n");
+    conferir_entradas_invalidas(motor_aproximado, 64, 2);
+    printf("Invalid inputs passed.\n");
+}
+
+/* Sala vazia: só as quinas caem em cunhas sujas */
+void test_sala_vazia() {
+    printf("Testing empty room...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, 0, 0, 100, 60);
+    Ponto c = criar_ponto(37, 22);
+    double anterior = INFINITY;
+    for (int k = 16; k <= 4096; k *= 4) {
+        double erro = -1;
+        PoligonoVisibilidade pol = visibilidade_aproximada_calcular(c, l, k, &erro);
+        assert(pol != NULL);
+        assert(area(pol) > 0);
+        assert(fabs(area(pol) - 6000) <= erro);
+        // One dirty wedge per corner: the bound shrinks with K
+        assert(erro < anterior);
+        anterior = erro;
+        // Collinear samples along each wall are merged
+        assert(poligono_qtd_vertices((Poligono)pol) <= 8);
+        visibilidade_destruir(pol);
+    }
+    destruir_ponto(c);
+    destruir_segmentos(l);
+    printf("Empty room passed.\n");
+}
+
+/* Vértices sobre o raio central de cada faixa, exatamente na barreira */
+void test_amostras_sobre_barreira() {
+    printf("Testing samples on the nearest barrier...\n");
+    LinkedList l = list_create();
+    list_insert_back(l, criar_segmento(0, 0, 10, -50, 10, 50, "none"));
+    Ponto c = criar_ponto(0, 0);
+    PoligonoVisibilidade pol = visibilidade_aproximada_calcular(c, l, 360, NULL);
+    assert(pol != NULL);
+    int n = 0;
+    double *v = poligono_get_vertices_ref((Poligono)pol, &n);
+    int na_barreira = 0;
+    for (int i = 0; i < n; i++) {
+        if (fabs(v[2 * i] - 10) < 1e-9) {
+            na_barreira++;
+            assert(fabs(v[2 * i + 1]) <= 50);
+        }
+        // Nothing beyond the barrier on its side
+        if (fabs(v[2 * i + 1]) < 50) assert(v[2 * i] <= 10 + 1e-9);
+    }
+    // Only the two extreme samples survive the collinear merge
+    assert(na_barreira == 2);
+    visibilidade_destruir(pol);
+    destruir_ponto(c);
+    destruir_segmentos(l);
+    printf("Samples on the nearest barrier passed.\n");
+}
+
+/* Barreira pequena entre dois raios centrais: invisível às amostras, coberta pelo limite */
+void test_barreira_entre_amostras() {
+    printf("Testing barrier between sample rays...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, -100, -100, 100, 100);
+    // K = 8: centre rays at 22.5 + 45i degrees; this sits around 0 degrees
+    list_insert_back(l, criar_segmento(0, 0, 5, -1, 5, 1, "none"));
+    Ponto c = criar_ponto(0, 0);
+    double erro_sem = 0, erro_com = 0;
+    PoligonoVisibilidade pol = visibilidade_aproximada_calcular(c, l, 8, &erro_com);
+    destruir_segmento((Segmento)list_remove_back(l));
+    PoligonoVisibilidade sem = visibilidade_aproximada_calcular(c, l, 8, &erro_sem);
+    assert(fabs(area(pol) - area(sem)) < 1e-9);
+    assert(erro_com > erro_sem);
+    visibilidade_destruir(pol);
+    visibilidade_destruir(sem);
+    destruir_ponto(c);
+    destruir_segmentos(l);
+    printf("Barrier between sample rays passed.\n");
+}
+
+/* Cenas aleatórias contra a expansão triangular (exata) */
+void test_limite_de_erro() {
+    printf("Testing the error bound against the exact polygon...\n");
+    srand(49);
+    for (int cena = 0; cena < 20; cena++) {
+        LinkedList l = list_create();
+        inserir_bordas(l, -20, -20, 520, 520);
+        int n = 30 + 10 * cena;
+        for (int i = 0; i < n; i++) {
+            double x = aleatorio(0, 500), y = aleatorio(0, 500);
+            double a = aleatorio(0, 2 * M_PI), c = aleatorio(5, 40);
+            list_insert_back(l, criar_segmento(i, i, x, y, x + c * cos(a), y + c * sin(a), "none"));
+        }
+        MalhaVisibilidade malha = malha_visibilidade_criar(l);
+        assert(malha != NULL);
+        for (int q = 0; q < 4; q++) {
+            Ponto c = criar_ponto(aleatorio(50, 450), aleatorio(50, 450));
+            PoligonoVisibilidade exato = malha_visibilidade_calcular(malha, c);
+            if (exato == NULL) {
+                destruir_ponto(c);
+                continue;
+            }
+            double ae = area(exato);
+            double erro_grosso, erro_fino;
+            PoligonoVisibilidade grosso = visibilidade_aproximada_calcular(c, l, 256, &erro_grosso);
+            PoligonoVisibilidade fino = visibilidade_aproximada_calcular(c, l, 8192, &erro_fino);
+            // The bound covers the symmetric difference, not just the area gap
+            double cx = get_ponto_x(c), cy = get_ponto_y(c);
+            assert(diferenca_simetrica(grosso, exato, cx, cy) <= erro_grosso);
+            assert(diferenca_simetrica(fino, exato, cx, cy) <= erro_fino);
+            assert(erro_fino < erro_grosso);
+            assert(fabs(area(fino) - ae) <= 0.02 * ae);
+            visibilidade_destruir(exato);
+            visibilidade_destruir(grosso);
+            visibilidade_destruir(fino);
+            destruir_ponto(c);
+        }
+        malha_visibilidade_destruir(malha);
+        destruir_segmentos(l);
+    }
+    printf("Error bound passed.\n");
+}
+
+int main() {
+    test_entradas_invalidas();
+    test_sala_vazia();
+    test_amostras_sobre_barreira();
+    test_barreira_entre_amostras();
+    test_limite_de_erro();
+    printf("ALL TESTS PASSED for Aproximada.\n");
+    return 0;
+}
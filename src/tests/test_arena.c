@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "../lib/utils/arena/arena.h"
+
+void test_alignment_and_use() {
+    printf("Testing arena alignment and accounting...\n");
+    Arena a = arena_criar(256);
+    assert(a != NULL);
+    assert(arena_usado(a) == 0);
+
+    char *p1 = arena_alocar(a, 1);
+    double *p2 = arena_alocar(a, 3 * sizeof(double));
+    assert(p1 != NULL && p2 != NULL);
+    assert(((uintptr_t)p1 % 16) == 0 && ((uintptr_t)p2 % 16) == 0);
+    assert((char*)p2 >= p1 + 16);
+    assert(arena_usado(a) == 16 + 32);
+
+    int *z = arena_alocar_zerado(a, 10 * sizeof(int));
+    for (int i = 0; i < 10; i++) assert(z[i] == 0);
+
+    arena_destruir(a);
+    printf("Arena alignment and accounting passed.\n");
+}
+
+void test_large_and_chained() {
+    printf("Testing arena block chaining...\n");
+    Arena a = arena_criar(128);
+    // Many allocations larger than a block, all distinct and writable
+    unsigned char *blocos[50];
+    for (int i = 0; i < 50; i++) {
+        blocos[i] = arena_alocar(a, 100 + 10 * i);
+        assert(blocos[i] != NULL);
+        memset(blocos[i], i, 100 + 10 * i);
+    }
+    for (int i = 0; i < 50; i++) {
+        for (int k = 0; k < 100 + 10 * i; k++) assert(blocos[i][k] == i);
+    }
+    arena_destruir(a);
+    printf("Arena block chaining passed.\n");
+}
+
+void test_reset_reuses_memory() {
+    printf("Testing arena reset...\n");
+    Arena a = arena_criar(1024);
+    void *primeiro = arena_alocar(a, 64);
+    for (int i = 0; i < 100; i++) arena_alocar(a, 200);
+    arena_resetar(a);
+    assert(arena_usado(a) == 0);
+    // Allocation restarts at the first block
+    assert(arena_alocar(a, 64) == primeiro);
+    arena_destruir(a);
+
+    arena_resetar(NULL);
+    arena_destruir(NULL);
+    assert(arena_alocar(NULL, 8) == NULL);
+    printf("Arena reset passed.\n");
+}
+
+int main() {
+    test_alignment_and_use();
+    test_large_and_chained();
+    test_reset_reuses_memory();
+    printf("ALL TESTS PASSED for Arena.\n");
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "../lib/visibilidade/cache_visibilidade.h"
+#include "../lib/poligono/poligono.h"
+
+static Poligono criar_quadrado(double lado) {
+    Poligono p = poligono_criar();
+    poligono_inserir_vertice(p, 0, 0);
+    poligono_inserir_vertice(p, lado, 0);
+    poligono_inserir_vertice(p, lado, lado);
+    poligono_inserir_vertice(p, 0, lado);
+    return p;
+}
+
+static ChaveVisibilidade chave(double x, double y, unsigned long versao) {
+    ChaveVisibilidade c = { x, y, versao, 0, 0, 100, 100 };
+    return c;
+}
+
+void test_poligono_clonar() {
+    printf("Testing polygon clone...\n");
+    Poligono p = criar_quadrado(3);
+    Poligono q = poligono_clonar(p);
+    assert(q != NULL && q != p);
+    int np = 0, nq = 0;
+    double *vp = poligono_get_vertices_ref(p, &np);
+    double *vq = poligono_get_vertices_ref(q, &nq);
+    assert(np == 4 && nq == 4 && vp != vq);
+    for (int i = 0; i < 8; i++) assert(vp[i] == vq[i]);
+    // The copy is independent of the original
+    poligono_inserir_vertice(q, 9, 9);
+    assert(poligono_qtd_vertices(p) == 4 && poligono_qtd_vertices(q) == 5);
+    poligono_destruir(p);
+    poligono_destruir(q);
+    printf("Polygon clone passed.\n");
+}
+
+void test_hit_and_miss() {
+    printf("Testing cache hits and misses...\n");
+    CacheVisibilidade c = cache_visibilidade_criar(4);
+    ChaveVisibilidade k = chave(10, 20, 1);
+    assert(cache_visibilidade_obter(c, &k) == NULL);
+
+    Poligono p = criar_quadrado(5);
+    cache_visibilidade_guardar(c, &k, p);
+    poligono_destruir(p);   // The cache keeps its own copy
+
+    PoligonoVisibilidade a = cache_visibilidade_obter(c, &k);
+    PoligonoVisibilidade b = cache_visibilidade_obter(c, &k);
+    assert(a != NULL && b != NULL && a != b);
+    assert(poligono_qtd_vertices(a) == 4);
+    poligono_destruir(a);
+    poligono_destruir(b);
+
+    // Any field of the key counts
+    ChaveVisibilidade outra = k;
+    outra.max_x = 101;
+    assert(cache_visibilidade_obter(c, &outra) == NULL);
+
+    CacheVisibilidadeStats st;
+    cache_visibilidade_stats(c, &st);
+    assert(st.acertos == 2 && st.faltas == 2 && st.ocupadas == 1);
+    cache_visibilidade_destruir(c);
+    printf("Cache hits and misses passed.\n");
+}
+
+void test_lru_eviction() {
+    printf("Testing cache LRU eviction...\n");
+    CacheVisibilidade c = cache_visibilidade_criar(3);
+    for (int i = 0; i < 3; i++) {
+        ChaveVisibilidade k = chave(i, 0, 1);
+        Poligono p = criar_quadrado(i + 1);
+        cache_visibilidade_guardar(c, &k, p);
+        poligono_destruir(p);
+    }
+    // Touch 0, so 1 becomes the least recently used
+    ChaveVisibilidade k0 = chave(0, 0, 1);
+    poligono_destruir(cache_visibilidade_obter(c, &k0));
+
+    ChaveVisibilidade k3 = chave(3, 0, 1);
+    Poligono p = criar_quadrado(4);
+    cache_visibilidade_guardar(c, &k3, p);
+    poligono_destruir(p);
+
+    ChaveVisibilidade k1 = chave(1, 0, 1);
+    ChaveVisibilidade k2 = chave(2, 0, 1);
+    assert(cache_visibilidade_obter(c, &k1) == NULL);
+    PoligonoVisibilidade r;
+    r = cache_visibilidade_obter(c, &k0); assert(r != NULL); poligono_destruir(r);
+    r = cache_visibilidade_obter(c, &k2); assert(r != NULL); poligono_destruir(r);
+    r = cache_visibilidade_obter(c, &k3); assert(r != NULL); poligono_destruir(r);
+
+    CacheVisibilidadeStats st;
+    cache_visibilidade_stats(c, &st);
+    assert(st.descartes == 1 && st.ocupadas == 3);
+    cache_visibilidade_destruir(c);
+    printf("Cache LRU eviction passed.\n");
+}
+
+void test_version_invalidation() {
+    printf("Testing cache version invalidation...\n");
+    CacheVisibilidade c = cache_visibilidade_criar(0);
+    ChaveVisibilidade velha = chave(1, 1, 7);
+    Poligono p = criar_quadrado(2);
+    cache_visibilidade_guardar(c, &velha, p);
+
+    // A newer version drops every older entry
+    ChaveVisibilidade nova = chave(1, 1, 8);
+    assert(cache_visibilidade_obter(c, &nova) == NULL);
+    CacheVisibilidadeStats st;
+    cache_visibilidade_stats(c, &st);
+    assert(st.ocupadas == 0 && st.descartes == 1);
+
+    // Stale results are not stored
+    cache_visibilidade_guardar(c, &velha, p);
+    cache_visibilidade_stats(c, &st);
+    assert(st.ocupadas == 0);
+    assert(cache_visibilidade_obter(c, &velha) == NULL);
+
+    poligono_destruir(p);
+    cache_visibilidade_destruir(c);
+    printf("Cache version invalidation passed.\n");
+}
+
+int main() {
+    test_poligono_clonar();
+    test_hit_and_miss();
+    test_lru_eviction();
+    test_version_invalidation();
+    printf("ALL TESTS PASSED for CacheVisibilidade.\n");
+    return 0;
+}
@@ -4,6 +4,8 @@
 #include <string.h>
 #include "../lib/geo/geo.h"
 #include "../lib/utils/lista/lista.h"
+#include "../lib/formas/circulo/circulo.h"
+#include "../lib/formas/linha/linha.h"
 
 void create_sample_geo(const char *filename) {
     FILE *f = fopen(filename, "w");
@@ -33,15 +35,303 @@ void test_geo_lifecycle() {
 
     // Test removing a shape
     geo_remover_forma(g, 1);
+    // The view is refreshed by the next call, in the same list
+    assert(geo_get_formas(g) == shapes);
     assert(list_size(shapes) == 3);
 
+    // A wrong type tag is rejected and the city is unchanged
+    assert(geo_inserir_forma(g, RECTANGLE, circulo_criar(9, 0, 0, 1, "red", "blue")) == 0);
+    assert(geo_num_formas(g) == 3);
+
     geo_destruir(g);
     remove(geo_file);
     printf("Geo passes.\n");
 }
 
+typedef struct { int id; int count; } CountById;
+
+static void count_id_visit(TipoForma tipo, void *forma, void *ctx) {
+    CountById *c = (CountById*)ctx;
+    (void)tipo;
+    if (circulo_get_id(forma) == c->id) c->count++;
+}
+
+static int count_shapes(Geo g, int id) {
+    CountById c = { id, 0 };
+    geo_para_cada(g, count_id_visit, &c);
+    return c.count;
+}
+
+typedef struct { int target; int pos; void *forma; } ShapeAt;
+
+static void shape_at_visit(TipoForma tipo, void *forma, void *ctx) {
+    ShapeAt *s = (ShapeAt*)ctx;
+    (void)tipo;
+    if (s->pos++ == s->target) s->forma = forma;
+}
+
+/* i-th shape in city order, through the public traversal */
+static void *shape_at(Geo g, int i) {
+    ShapeAt s = { i, 0, NULL };
+    geo_para_cada(g, shape_at_visit, &s);
+    return s.forma;
+}
+
+void test_geo_bulk() {
+    printf("Testing geo bulk operations...\n");
+    const char *geo_file = "test_sample.geo";
+    FILE *f = fopen(geo_file, "w");
+    assert(f != NULL);
+    // Only circles, so circulo_get_id applies to every element
+    fprintf(f, "c 1 10 10 5 red blue\n");
+    fprintf(f, "c 2 20 20 5 red blue\n");
+    fprintf(f, "c 1 30 30 5 red blue\n");
+    fprintf(f, "c 3 40 40 5 red blue\n");
+    fprintf(f, "c 1 50 50 5 red blue\n");
+    fclose(f);
+
+    Geo g = geo_criar();
+    geo_ler(g, geo_file);
+    assert(list_size(geo_get_formas(g)) == 5);
+
+    // Each repeated id removes one more occurrence; unknown ids are ignored
+    int remover[] = { 1, 3, 1, 99 };
+    geo_remover_formas(g, remover, 4);
+    assert(list_size(geo_get_formas(g)) == 2);
+    assert(count_shapes(g, 1) == 1);
+    assert(count_shapes(g, 3) == 0);
+    void *resto = shape_at(g, 1);
+    assert(circulo_get_x(resto) == 50);
+
+    // Colour changes hit the first shape with each id
+    int pintar[] = { 2, 2 };
+    geo_alterar_cores(g, pintar, 2, "cyan");
+    assert(strcmp(circulo_get_cor_borda(shape_at(g, 0)), "cyan") == 0);
+    assert(strcmp(circulo_get_cor_borda(resto), "red") == 0);
+
+    // Clones are appended in the order of ids
+    int clonar[] = { 1, 2 };
+    geo_clonar_formas(g, clonar, 2, 1, 1);
+    assert(list_size(geo_get_formas(g)) == 4);
+    void *c1 = shape_at(g, 2);
+    void *c2 = shape_at(g, 3);
+    assert(circulo_get_id(c1) == 10001 && circulo_get_x(c1) == 51);
+    assert(circulo_get_id(c2) == 10002 && circulo_get_x(c2) == 21);
+
+    geo_destruir(g);
+    remove(geo_file);
+    printf("Geo bulk operations pass.\n");
+}
+
+void test_geo_id_range() {
+    printf("Testing geo id range index...\n");
+    Geo g = geo_criar();
+    // Ids out of order, with a duplicate
+    int ids[] = { 50, 10, 30, 20, 30, 40 };
+    for (int i = 0; i < 6; i++) {
+        geo_inserir_forma(g, CIRCLE, circulo_criar(ids[i], i, 0, 1, "red", "blue"));
+    }
+
+    void **formas = NULL;
+    TipoForma *tipos = NULL;
+    int k = geo_formas_no_intervalo(g, 20, 40, &formas, &tipos);
+    // City order, not id order: 30, 20, 30, 40
+    assert(k == 4);
+    assert(circulo_get_id(formas[0]) == 30 && circulo_get_x(formas[0]) == 2);
+    assert(circulo_get_id(formas[1]) == 20);
+    assert(circulo_get_id(formas[2]) == 30 && circulo_get_x(formas[2]) == 4);
+    assert(circulo_get_id(formas[3]) == 40);
+    assert(tipos[0] == CIRCLE);
+    free(formas); free(tipos);
+
+    // Removals and later insertions are reflected
+    int remover[] = { 30, 20 };
+    geo_remover_formas(g, remover, 2);
+    geo_inserir_forma(g, CIRCLE, circulo_criar(25, 9, 0, 1, "red", "blue"));
+    k = geo_formas_no_intervalo(g, 20, 40, &formas, &tipos);
+    assert(k == 3);
+    assert(circulo_get_id(formas[0]) == 30 && circulo_get_x(formas[0]) == 4);
+    assert(circulo_get_id(formas[1]) == 40);
+    assert(circulo_get_id(formas[2]) == 25);
+    free(formas); free(tipos);
+
+    k = geo_formas_no_intervalo(g, 60, 70, &formas, &tipos);
+    assert(k == 0);
+    free(formas); free(tipos);
+
+    geo_destruir(g);
+    printf("Geo id range index passes.\n");
+}
+
+static void count_in_range(TipoForma tipo, void *forma, void *ctx) {
+    int *state = (int*)ctx;   // [0] = id_ini, [1] = id_fim, [2] = matches
+    (void)tipo;
+    int id = circulo_get_id(forma);
+    if (id >= state[0] && id <= state[1]) state[2]++;
+}
+
+void test_geo_id_range_interleaved() {
+    printf("Testing geo id range with interleaved inserts...\n");
+    Geo g = geo_criar();
+    for (int i = 0; i < 1500; i++) {
+        geo_inserir_forma(g, CIRCLE, circulo_criar((i * 37) % 500, i, 0, 1, "red", "blue"));
+        if (i % 7 != 0) continue;
+
+        // Pending inserts are found without a full scan, in city order
+        int state[3] = { (i * 13) % 500, (i * 13) % 500 + i % 40, 0 };
+        geo_para_cada(g, count_in_range, state);
+        void **formas = NULL;
+        TipoForma *tipos = NULL;
+        int k = geo_formas_no_intervalo(g, state[0], state[1], &formas, &tipos);
+        assert(k == state[2]);
+        for (int j = 0; j < k; j++) {
+            int id = circulo_get_id(formas[j]);
+            assert(id >= state[0] && id <= state[1]);
+            if (j > 0) assert(circulo_get_x(formas[j]) > circulo_get_x(formas[j - 1]));
+        }
+        free(formas); free(tipos);
+    }
+    geo_destruir(g);
+    printf("Geo id range with interleaved inserts passes.\n");
+}
+
+static void count_in_box(TipoForma tipo, void *forma, void *ctx) {
+    double *box = (double*)ctx;   // [0..3] = region, [4] = matches
+    (void)tipo;
+    double x = circulo_get_x(forma), y = circulo_get_y(forma), r = circulo_get_raio(forma);
+    if (x + r >= box[0] && x - r <= box[2] && y + r >= box[1] && y - r <= box[3]) box[4]++;
+}
+
+static void check_region(Geo g, double x1, double y1, double x2, double y2) {
+    double box[5] = { x1, y1, x2, y2, 0 };
+    geo_para_cada(g, count_in_box, box);
+    void **formas = NULL;
+    TipoForma *tipos = NULL;
+    int k = geo_formas_na_regiao(g, x1, y1, x2, y2, &formas, &tipos);
+    assert(k == (int)box[4]);
+    for (int j = 1; j < k; j++) assert(circulo_get_id(formas[j]) > circulo_get_id(formas[j - 1]));
+    free(formas); free(tipos);
+}
+
+void test_geo_region() {
+    printf("Testing geo region index...\n");
+    Geo g = geo_criar();
+    // Ids follow city order; a few large circles span many cells
+    for (int i = 0; i < 2000; i++) {
+        double r = (i % 250 == 0) ? 400 : 1 + i % 5;
+        geo_inserir_forma(g, CIRCLE, circulo_criar(i, (i * 37) % 1000, (i * 91) % 1000, r, "red", "blue"));
+    }
+    check_region(g, 100, 100, 200, 300);
+    check_region(g, -50, -50, 10, 10);
+    check_region(g, 0, 0, 1000, 1000);
+    check_region(g, 2000, 2000, 3000, 3000);
+
+    // Inserts after the index is built, including outside its extent
+    for (int i = 2000; i < 2600; i++) {
+        geo_inserir_forma(g, CIRCLE, circulo_criar(i, 1500 + i % 300, (i * 7) % 1200, 2, "red", "blue"));
+    }
+    check_region(g, 1400, 0, 1900, 600);
+    check_region(g, 900, 900, 1600, 1100);
+
+    // Removals, then enough of them to compact the slab
+    int ids[1000];
+    for (int i = 0; i < 1000; i++) ids[i] = 2 * i;
+    geo_remover_formas(g, ids, 300);
+    check_region(g, 100, 100, 400, 400);
+    geo_remover_formas(g, ids + 300, 700);
+    check_region(g, 100, 100, 400, 400);
+    check_region(g, -1000, -1000, 5000, 5000);
+
+    geo_destruir(g);
+    printf("Geo region index passes.\n");
+}
+
+static void count_visit(TipoForma tipo, void *forma, void *ctx) {
+    int *state = (int*)ctx;   // [0] = visits, [1] = last id, [2] = out of order
+    (void)tipo;
+    int id = circulo_get_id(forma);
+    if (state[0] > 0 && id <= state[1]) state[2] = 1;
+    state[1] = id;
+    state[0]++;
+}
+
+void test_geo_compaction() {
+    printf("Testing geo slab compaction...\n");
+    Geo g = geo_criar();
+    for (int i = 0; i < 400; i++) {
+        geo_inserir_forma(g, CIRCLE, circulo_criar(i, i, 0, 1, "red", "blue"));
+    }
+    // View requested before the slab is compacted
+    assert(list_size(geo_get_formas(g)) == 400);
+
+    // Remove every other shape: enough tombstones to trigger compaction
+    int ids[200];
+    for (int i = 0; i < 200; i++) ids[i] = 2 * i;
+    geo_remover_formas(g, ids, 200);
+    assert(geo_num_formas(g) == 200);
+    assert(list_size(geo_get_formas(g)) == 200);
+
+    int state[3] = { 0, -1, 0 };
+    geo_para_cada(g, count_visit, state);
+    assert(state[0] == 200 && state[2] == 0);
+
+    // Indices survive compaction
+    void **formas = NULL;
+    TipoForma *tipos = NULL;
+    int k = geo_formas_no_intervalo(g, 100, 110, &formas, &tipos);
+    assert(k == 5);
+    for (int i = 0; i < k; i++) assert(circulo_get_id(formas[i]) == 101 + 2 * i);
+    free(formas); free(tipos);
+
+    geo_alterar_cor(g, 399, "green");
+    geo_clonar_forma(g, 399, 1, 1);
+    assert(list_size(geo_get_formas(g)) == 201);
+    void *clone = shape_at(g, 200);
+    assert(circulo_get_id(clone) == 10399);
+    assert(strcmp(circulo_get_cor_borda(clone), "green") == 0);
+
+    double min_x, min_y, max_x, max_y;
+    geo_get_bounding_box(g, &min_x, &min_y, &max_x, &max_y);
+    assert(min_x == 0 && max_x == 401 && min_y == -1 && max_y == 2);
+
+    geo_destruir(g);
+    printf("Geo slab compaction passes.\n");
+}
+
+void test_geo_versao() {
+    printf("Testing geo barrier version...\n");
+    Geo g = geo_criar();
+    unsigned long v = geo_versao_barreiras(g);
+    geo_inserir_forma(g, LINE, line_create(5000, 0, 0, 4, 0, "black"));
+    assert(geo_versao_barreiras(g) > v);
+
+    // Shapes other than anteparos, colours and removals that find nothing
+    // keep the version, even when the bounding box moves
+    v = geo_versao_barreiras(g);
+    geo_inserir_forma(g, CIRCLE, circulo_criar(1, 0, 0, 1, "red", "blue"));
+    geo_inserir_forma(g, CIRCLE, circulo_criar(2, 50, 50, 1, "red", "blue"));
+    geo_inserir_forma(g, LINE, line_create(7, 0, 1, 4, 1, "black"));
+    geo_alterar_cor(g, 5000, "cyan");
+    geo_remover_forma(g, 99);
+    geo_remover_forma(g, 1);
+    geo_clonar_forma(g, 2, 100, 100);
+    assert(geo_versao_barreiras(g) == v);
+
+    geo_remover_forma(g, 5000);
+    assert(geo_versao_barreiras(g) > v);
+
+    geo_destruir(g);
+    printf("Geo barrier version passes.\n");
+}
+
 int main() {
     test_geo_lifecycle();
+    test_geo_bulk();
+    test_geo_id_range();
+    test_geo_id_range_interleaved();
+    test_geo_region();
+    test_geo_compaction();
+    test_geo_versao();
     printf("ALL TESTS PASSED for Geo.\n");
     return 0;
 }
@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "../lib/visibilidade/grade.h"
+#include "../lib/visibilidade/visibilidade.h"
+#include "../lib/geometria/segmento/segmento.h"
+#include "../lib/geometria/calculos/calculos.h"
+#include "../lib/poligono/poligono.h"
+#include "cena_teste.h"
+
+static bool atingido(GradeVisibilidade g, double x, double y) {
+    Ponto p = criar_ponto(x, y);
+    bool r = grade_visibilidade_ponto_atingido(g, p);
+    destruir_ponto(p);
+    return r;
+}
+
+static void *motor_grade(Ponto c, LinkedList l, int resolucao) {
+    return grade_visibilidade_calcular(c, l, resolucao);
+}
+
+void test_entradas_invalidas() {
+    printf("Testing invalid inputs...\n");
+    conferir_entradas_invalidas(motor_grade, 64, 0);
+    assert(grade_visibilidade_poligono(NULL) == NULL);
+    assert(grade_visibilidade_num_iluminadas(NULL) == 0);
+    printf("Invalid inputs passed.\n");
+}
+
+/* Sala vazia: todas as células acendem, inclusive as paredes das bordas */
+void test_sala_vazia() {
+    printf("Testing empty room...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, 0, 0, 100, 60);
+    Ponto c = criar_ponto(37.3, 22.6);
+    GradeVisibilidade g = grade_visibilidade_calcular(c, l, 100);
+    assert(g != NULL);
+    int nx = 0, ny = 0;
+    double tam = 0;
+    grade_visibilidade_dimensoes(g, &nx, &ny, &tam);
+    assert(nx == 100 && ny == 60);
+    assert(fabs(tam - 1.0) < 1e-12);
+    assert(grade_visibilidade_num_iluminadas(g) == 6000);
+    assert(!atingido(g, -1, 30));
+    assert(!atingido(g, 50, 61));
+
+    // O contorno para na face interna das bordas (98 x 58), cortando as quinas
+    PoligonoVisibilidade pol = grade_visibilidade_poligono(g);
+    assert(pol != NULL);
+    assert(area(pol) <= 98 * 58 + 1e-6);
+    assert(area(pol) >= 0.99 * 98 * 58);
+    assert(poligono_qtd_vertices((Poligono)pol) <= 8);
+    visibilidade_destruir(pol);
+    grade_visibilidade_destruir(g);
+    destruir_ponto(c);
+    destruir_segmentos(l);
+    printf("Empty room passed.\n");
+}
+
+/* Uma parede em cada quadrante, inclusive os transpostos (leste e oeste) */
+void test_paredes_nos_quadrantes() {
+    printf("Testing walls in every quadrant...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, -50, -50, 50, 50);
+    list_insert_back(l, criar_segmento(1, 1, 10.5, -20.5, 10.5, 20.5, "none"));    // leste
+    list_insert_back(l, criar_segmento(2, 2, -10.5, -20.5, -10.5, 20.5, "none"));  // oeste
+    list_insert_back(l, criar_segmento(3, 3, -5.5, 15.5, 5.5, 15.5, "none"));      // norte
+    list_insert_back(l, criar_segmento(4, 4, -5.5, -12.5, 5.5, -12.5, "none"));    // sul
+    Ponto c = criar_ponto(0.3, 0.2);
+    GradeVisibilidade g = grade_visibilidade_calcular(c, l, 100);
+    assert(g != NULL);
+
+    double escuros[][2] = { { 30, 0 }, { 30, 10 }, { -30, 0 }, { -30, -12 }, { 0, 30 }, { 2, 45 }, { 0, -30 } };
+    double claros[][2] = { { 5, 0 }, { -5, 3 }, { 0, 10 }, { 0, -8 }, { 20, 45 }, { 8, -10 }, { -8, 12 } };
+    for (int i = 0; i < 7; i++) {
+        assert(!atingido(g, escuros[i][0], escuros[i][1]));
+        assert(atingido(g, claros[i][0], claros[i][1]));
+    }
+    // As faces das paredes voltadas para o centro acendem
+    assert(atingido(g, 10.5, 0.5));
+    assert(atingido(g, -10.5, 0.5));
+    assert(atingido(g, 0.5, 15.5));
+    assert(atingido(g, 0.5, -12.5));
+
+    // Segmento com os dois extremos no escuro, mas passando pela área clara
+    Ponto a = criar_ponto(30, 0), b = criar_ponto(-30, 0), d = criar_ponto(30, 10);
+    assert(grade_visibilidade_segmento_atingido(g, a, b));
+    assert(!grade_visibilidade_segmento_atingido(g, a, d));
+    destruir_ponto(a); destruir_ponto(b); destruir_ponto(d);
+
+    // Lote igual ao teste um a um
+    double xs[14], ys[14];
+    for (int i = 0; i < 7; i++) {
+        xs[i] = escuros[i][0]; ys[i] = escuros[i][1];
+        xs[7 + i] = claros[i][0]; ys[7 + i] = claros[i][1];
+    }
+    unsigned char mapa[BITMAP_BYTES(14)];
+    grade_visibilidade_pontos_atingidos(g, xs, ys, 14, mapa);
+    for (int i = 0; i < 14; i++) assert(BITMAP_TESTAR(mapa, i) == (i >= 7));
+
+    grade_visibilidade_destruir(g);
+    destruir_ponto(c);
+    destruir_segmentos(l);
+    printf("Walls in every quadrant passed.\n");
+}
+
+/* Escolhida em visibilidade_set_grade, a grade responde a visibilidade_calcular:
+ * os testes do polígono seguem a máscara, também nas cópias */
+void test_motor_visibilidade() {
+    printf("Testing the grid behind visibilidade_calcular...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, -50, -50, 50, 50);
+    list_insert_back(l, criar_segmento(1, 1, 10.5, -20.5, 10.5, 20.5, "none"));
+    list_insert_back(l, criar_segmento(2, 2, -5.5, 15.5, 5.5, 15.5, "none"));
+    Ponto c = criar_ponto(0.3, 0.2);
+    GradeVisibilidade g = grade_visibilidade_calcular(c, l, 100);
+    assert(g != NULL);
+
+    visibilidade_set_grade(100);
+    PoligonoVisibilidade pol = visibilidade_calcular(c, l);
+    visibilidade_set_grade(0);
+    assert(pol != NULL);
+    assert(poligono_anexo((Poligono)pol) != NULL);
+    PoligonoVisibilidade copia = poligono_clonar((Poligono)pol);
+    visibilidade_destruir(pol);
+
+    double xs[400], ys[400];
+    unsigned char mapa[BITMAP_BYTES(400)];
+    for (int i = 0; i < 400; i++) {
+        xs[i] = -49.5 + 5 * (i % 20);
+        ys[i] = -49.5 + 5 * (i / 20);
+    }
+    visibilidade_pontos_atingidos(copia, xs, ys, 400, mapa);
+    for (int i = 0; i < 400; i++) {
+        Ponto p = criar_ponto(xs[i], ys[i]);
+        bool aceso = grade_visibilidade_ponto_atingido(g, p);
+        assert(BITMAP_TESTAR(mapa, i) == aceso);
+        assert(visibilidade_ponto_atingido(copia, p) == aceso);
+        destruir_ponto(p);
+    }
+    // A parede acesa está fora do contorno, mas dentro da caixa
+    Ponto a = criar_ponto(10.5, -5), b = criar_ponto(10.5, 5);
+    assert(visibilidade_segmento_atingido(copia, a, b));
+    double min_x, min_y, max_x, max_y;
+    assert(visibilidade_caixa(copia, &min_x, &min_y, &max_x, &max_y));
+    assert(min_x <= -49 && max_x >= 11 && min_y <= -49 && max_y >= 49);
+
+    // Sem a máscara, só o contorno responde
+    visibilidade_soltar_testes(copia);
+    assert(poligono_anexo((Poligono)copia) == NULL);
+    assert(!visibilidade_ponto_atingido(copia, a));
+    visibilidade_destruir(copia);
+    destruir_ponto(a); destruir_ponto(b);
+
+    // Desligada, volta a varredura exata
+    pol = visibilidade_calcular(c, l);
+    assert(pol != NULL && poligono_anexo((Poligono)pol) == NULL);
+    visibilidade_destruir(pol);
+
+    grade_visibilidade_destruir(g);
+    destruir_ponto(c);
+    destruir_segmentos(l);
+    printf("Grid behind visibilidade_calcular passed.\n");
+}
+
+/* Girar a cena 90 graus troca os quadrantes diretos pelos transpostos:
+ * a máscara tem de girar junto, célula por célula */
+void test_rotacao() {
+    printf("Testing rotation invariance...\n");
+    srand(50);
+    LinkedList l = list_create(), girada = list_create();
+    inserir_bordas(l, 0, 0, 128, 128);
+    inserir_bordas(girada, 0, 0, 128, 128);
+    for (int i = 0; i < 60; i++) {
+        double a = floor(aleatorio(2, 125)) + 0.5, b = floor(aleatorio(2, 125)) + 0.5;
+        double comp = floor(aleatorio(2, 20));
+        double x1 = a, y1 = b, x2 = a, y2 = b;
+        if (i % 2) x2 = fmin(a + comp, 125.5); else y2 = fmin(b + comp, 125.5);
+        list_insert_back(l, criar_segmento(i, i, x1, y1, x2, y2, "none"));
+        // (x, y) -> (128 - y, x)
+        list_insert_back(girada, criar_segmento(i, i, 128 - y1, x1, 128 - y2, x2, "none"));
+    }
+    Ponto c = criar_ponto(64.3, 64.7), cg = criar_ponto(128 - 64.7, 64.3);
+    GradeVisibilidade g = grade_visibilidade_calcular(c, l, 128);
+    GradeVisibilidade gg = grade_visibilidade_calcular(cg, girada, 128);
+    assert(g != NULL && gg != NULL);
+    assert(grade_visibilidade_num_iluminadas(g) == grade_visibilidade_num_iluminadas(gg));
+    assert(grade_visibilidade_num_iluminadas(g) < 128 * 128);
+    for (int i = 0; i < 128; i++) {
+        for (int j = 0; j < 128; j++) {
+            assert(atingido(g, i + 0.5, j + 0.5) == atingido(gg, 127 - j + 0.5, i + 0.5));
+        }
+    }
+    grade_visibilidade_destruir(g);
+    grade_visibilidade_destruir(gg);
+    destruir_ponto(c);
+    destruir_ponto(cg);
+    destruir_segmentos(l);
+    destruir_segmentos(girada);
+    printf("Rotation invariance passed.\n");
+}
+
+/* Cenas aleatórias densas contra a força bruta. As paredes rasterizadas têm
+ * a espessura de uma célula, então o erro fica nas bordas das sombras e em
+ * frestas mais finas que a célula (quase sempre escuro onde há luz) e
+ * diminui com a resolução */
+void test_contra_forca_bruta() {
+    printf("Testing against brute force on dense scenes...\n");
+    srand(51);
+    int resolucoes[2] = { 512, 2048 };
+    long total = 0, acesas_erradas[2] = { 0, 0 }, erros[2] = { 0, 0 };
+    for (int cena = 0; cena < 8; cena++) {
+        LinkedList l = list_create();
+        inserir_bordas(l, 0, 0, 512, 512);
+        int n = 200 + 100 * cena;
+        for (int i = 0; i < n; i++) {
+            double x = aleatorio(10, 500), y = aleatorio(10, 500);
+            double a = aleatorio(0, 2 * M_PI), comp = aleatorio(2, 12);
+            list_insert_back(l, criar_segmento(i, i, x, y, x + comp * cos(a), y + comp * sin(a), "none"));
+        }
+        double ox = aleatorio(100, 400), oy = aleatorio(100, 400);
+        Ponto c = criar_ponto(ox, oy);
+        GradeVisibilidade g[2];
+        for (int r = 0; r < 2; r++) {
+            g[r] = grade_visibilidade_calcular(c, l, resolucoes[r]);
+            assert(g[r] != NULL);
+        }
+        for (int q = 0; q < 400; q++) {
+            double px = aleatorio(5, 507), py = aleatorio(5, 507);
+            bool exato = visivel(l, ox, oy, px, py);
+            total++;
+            for (int r = 0; r < 2; r++) {
+                bool aceso = atingido(g[r], px, py);
+                erros[r] += (aceso != exato);
+                acesas_erradas[r] += (aceso && !exato);
+            }
+        }
+        for (int r = 0; r < 2; r++) grade_visibilidade_destruir(g[r]);
+        destruir_ponto(c);
+        destruir_segmentos(l);
+    }
+    assert(erros[0] <= 0.08 * total);
+    assert(erros[1] <= 0.02 * total);
+    assert(2 * erros[1] < erros[0]);
+    assert(acesas_erradas[0] <= 0.005 * total && acesas_erradas[1] <= 0.005 * total);
+    printf("Brute force passed.\n");
+}
+
+int main() {
+    test_entradas_invalidas();
+    test_sala_vazia();
+    test_paredes_nos_quadrantes();
+    test_motor_visibilidade();
+    test_rotacao();
+    test_contra_forca_bruta();
+    printf("ALL TESTS PASSED for Grade.\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "../lib/utils/interno/interno.h"
+#include "../lib/utils/pool/pool.h"
+#include "../lib/formas/circulo/circulo.h"
+#include "../lib/geometria/segmento/segmento.h"
+
+void test_same_string_same_id() {
+    printf("Testing interning returns stable ids...\n");
+    IdString red = interno_registrar("red");
+    IdString blue = interno_registrar("blue");
+    assert(red != STRING_NENHUMA && blue != STRING_NENHUMA);
+    assert(red != blue);
+
+    char buf[8];
+    strcpy(buf, "red");
+    assert(interno_registrar(buf) == red);
+    assert(strcmp(interno_texto(red), "red") == 0);
+    // The stored text does not alias the caller's buffer
+    assert(interno_texto(red) != buf);
+
+    assert(interno_registrar(NULL) == STRING_NENHUMA);
+    assert(interno_texto(STRING_NENHUMA) == NULL);
+    printf("Interning returns stable ids passed.\n");
+}
+
+void test_growth() {
+    printf("Testing interning many strings...\n");
+    int antes = interno_quantidade();
+    IdString ids[5000];
+    char buf[32];
+    for (int i = 0; i < 5000; i++) {
+        sprintf(buf, "#%06x", i);
+        ids[i] = interno_registrar(buf);
+    }
+    assert(interno_quantidade() == antes + 5000);
+    for (int i = 0; i < 5000; i++) {
+        sprintf(buf, "#%06x", i);
+        assert(interno_registrar(buf) == ids[i]);
+        assert(strcmp(interno_texto(ids[i]), buf) == 0);
+    }
+    printf("Interning many strings passed.\n");
+}
+
+// Every thread interns the same set of names
+static IdString resultados[8][64];
+
+static void internar_nomes(void *arg, int indice) {
+    (void)arg;
+    char buf[32];
+    for (int i = 0; i < 64; i++) {
+        sprintf(buf, "cor-%d", i);
+        resultados[indice][i] = interno_registrar(buf);
+    }
+}
+
+void test_concurrent() {
+    printf("Testing concurrent interning...\n");
+    PoolThreads pool = pool_criar(4);
+    pool_executar(pool, internar_nomes, NULL, 8);
+    pool_destruir(pool);
+    for (int t = 1; t < 8; t++) {
+        for (int i = 0; i < 64; i++) assert(resultados[t][i] == resultados[0][i]);
+    }
+    printf("Concurrent interning passed.\n");
+}
+
+void test_shapes_share_colours() {
+    printf("Testing shapes share interned colours...\n");
+    Circulo a = circulo_criar(1, 0, 0, 1, "orange", "navy");
+    Circulo b = circulo_criar(2, 0, 0, 1, "orange", "navy");
+    int antes = interno_quantidade();
+    circulo_set_cor_borda(a, "navy");
+    // Recolouring with a known colour interns nothing new
+    assert(interno_quantidade() == antes);
+    assert(circulo_get_cor_borda(a) == circulo_get_cor_preenchimento(b));
+    circulo_destruir(a);
+    circulo_destruir(b);
+    printf("Shapes share interned colours passed.\n");
+}
+
+void test_segment_fixed_colours() {
+    printf("Testing fixed segment colours...\n");
+    IdString preto = segmento_cor_barreira(), nenhuma = segmento_cor_borda();
+    assert(preto == interno_registrar("black"));
+    assert(nenhuma == interno_registrar("none"));
+    assert(segmento_cor_barreira() == preto);
+
+    Segmento s = criar_segmento_com_cor(NULL, 5000, 5000, 0, 0, 1, 1, preto);
+    assert(get_segmento_cor_id(s) == preto);
+    assert(strcmp(get_segmento_cor(s), "black") == 0);
+    Segmento c = clonar_segmento(s);
+    assert(get_segmento_cor_id(c) == preto);
+    destruir_segmento(s);
+    destruir_segmento(c);
+    printf("Fixed segment colours passed.\n");
+}
+
+int main() {
+    test_same_string_same_id();
+    test_growth();
+    test_concurrent();
+    test_shapes_share_colours();
+    test_segment_fixed_colours();
+    printf("ALL TESTS PASSED for Interno.\n");
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <pthread.h>
 #include "../lib/utils/lista/lista.h"
 
 // Helper to destroy integers (though we are just storing pointers to stack vars or malloced vars)
@@ -108,11 +109,185 @@ void test_get_remove_at() {
     printf("Get/remove at passed.\n");
 }
 
+static int is_even(void *value, void *context) {
+    (void)context;
+    return (*(int*)value % 2) == 0;
+}
+
+static void sum_values(void *value, void *context) {
+    *(int*)context += *(int*)value;
+}
+
+void test_remove_if_for_each() {
+    printf("Testing remove_if/for_each...\n");
+    LinkedList l = list_create();
+    int values[] = { 2, 1, 4, 3, 6 };
+    for (int i = 0; i < 5; i++) list_insert_back(l, &values[i]);
+
+    int sum = 0;
+    list_for_each(l, sum_values, &sum);
+    assert(sum == 16);
+
+    // Removes the head, a middle node and the tail
+    assert(list_remove_if(l, is_even, NULL) == 3);
+    assert(list_size(l) == 2);
+    assert(*(int*)list_front(l) == 1);
+    assert(*(int*)list_back(l) == 3);
+
+    // Tail must be valid for further appends
+    list_insert_back(l, &values[4]);
+    assert(*(int*)list_back(l) == 6);
+    assert(*(int*)list_get_at(l, 2) == 6);
+
+    assert(list_remove_if(l, is_even, NULL) == 1);
+    assert(list_remove_if(l, is_even, NULL) == 0);
+    assert(list_size(l) == 2);
+
+    list_destroy(l);
+    printf("Remove_if/for_each passed.\n");
+}
+
+void test_cursor() {
+    printf("Testing cursor...\n");
+    LinkedList l = list_create();
+    int values[] = { 1, 2, 3, 4, 5, 6 };
+
+    // Empty list: cursor starts at the end, insert_after appends
+    ListCursor c = list_cursor_first(l);
+    assert(!list_cursor_valid(&c));
+    assert(list_cursor_get(&c) == NULL);
+    assert(list_cursor_remove(&c) == NULL);
+    list_cursor_insert_after(&c, &values[0]);
+    list_cursor_insert_after(&c, &values[2]);
+    assert(list_size(l) == 2);
+    assert(*(int*)list_back(l) == 3);
+
+    // Insert in the middle and after the tail
+    c = list_cursor_first(l);
+    list_cursor_insert_after(&c, &values[1]);
+    assert(*(int*)list_cursor_get(&c) == 1);
+    list_cursor_next(&c);
+    list_cursor_next(&c);
+    list_cursor_insert_after(&c, &values[3]);
+    assert(*(int*)list_back(l) == 4);
+    list_insert_back(l, &values[4]);
+
+    int expected = 1;
+    for (c = list_cursor_first(l); list_cursor_valid(&c); list_cursor_next(&c))
+        assert(*(int*)list_cursor_get(&c) == expected++);
+    assert(expected == 6);
+
+    // Remove the head, a middle element and the tail while iterating
+    c = list_cursor_first(l);
+    assert(*(int*)list_cursor_remove(&c) == 1);
+    assert(*(int*)list_cursor_get(&c) == 2);
+    list_cursor_next(&c);
+    assert(*(int*)list_cursor_remove(&c) == 3);
+    list_cursor_next(&c);
+    assert(*(int*)list_cursor_remove(&c) == 5);
+    assert(!list_cursor_valid(&c));
+    assert(list_size(l) == 2);
+    assert(*(int*)list_front(l) == 2);
+    assert(*(int*)list_back(l) == 4);
+
+    // Tail stays valid for further appends
+    list_insert_back(l, &values[5]);
+    assert(*(int*)list_get_at(l, 2) == 6);
+
+    c = list_cursor_first(l);
+    while (list_cursor_valid(&c)) list_cursor_remove(&c);
+    assert(list_is_empty(l));
+    assert(list_back(l) == NULL);
+    list_insert_back(l, &values[0]);
+    assert(*(int*)list_front(l) == 1);
+
+    list_destroy(l);
+    printf("Cursor passed.\n");
+}
+
+static void *churn_thread(void *arg) {
+    int *values = (int*)arg;
+    LinkedList l = list_create();
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 100; i++) list_insert_back(l, &values[i]);
+        while (!list_is_empty(l)) list_remove_front(l);
+    }
+    ListPoolStats stats;
+    list_pool_stats(&stats);
+    // Each thread has its own pool: only the first round hits malloc
+    assert(stats.allocated == 100);
+    assert(stats.reused == 49 * 100);
+    list_destroy(l);
+    return NULL;
+}
+
+void test_node_pool() {
+    printf("Testing node pool...\n");
+    list_pool_trim();
+    ListPoolStats before, after;
+    list_pool_stats(&before);
+    assert(before.cached == 0);
+
+    int values[100];
+    for (int i = 0; i < 100; i++) values[i] = i;
+
+    LinkedList l = list_create();
+    for (int i = 0; i < 100; i++) list_insert_back(l, &values[i]);
+    list_destroy(l);
+    list_pool_stats(&after);
+    assert(after.cached == 100);
+
+    // A second list is served entirely from the free list
+    l = list_create();
+    for (int i = 0; i < 100; i++) list_insert_front(l, &values[i]);
+    list_pool_stats(&after);
+    assert(after.allocated == before.allocated + 100);
+    assert(after.reused == before.reused + 100);
+    assert(after.cached == 0);
+    assert(*(int*)list_front(l) == 99 && *(int*)list_back(l) == 0);
+
+    assert(*(int*)list_remove_at(l, 50) == 49);
+    assert(*(int*)list_remove_back(l) == 0);
+    list_pool_stats(&after);
+    assert(after.cached == 2);
+    list_destroy(l);
+
+    // Worker threads keep separate pools, released when they exit
+    pthread_t threads[4];
+    for (int t = 0; t < 4; t++) pthread_create(&threads[t], NULL, churn_thread, values);
+    for (int t = 0; t < 4; t++) pthread_join(threads[t], NULL);
+
+    list_pool_stats(&after);
+    assert(after.cached == 100);
+    list_pool_trim();
+    list_pool_stats(&after);
+    assert(after.cached == 0);
+    assert(after.released == before.released + 100);
+
+    // The main thread flushes its pool explicitly; the pool is usable again
+    LinkedList list = list_create();
+    for (int i = 0; i < 10; i++) list_insert_back(list, &values[i]);
+    list_destroy(list);
+    list_pool_liberar();
+    list_pool_stats(&after);
+    assert(after.cached == 0);
+    list = list_create();
+    list_insert_back(list, &values[0]);
+    list_destroy(list);
+    list_pool_stats(&after);
+    assert(after.cached == 1);
+    list_pool_liberar();
+    printf("Node pool passed.\n");
+}
+
 int main() {
     test_create_destroy();
     test_insert_remove_front();
     test_insert_remove_back();
     test_get_remove_at();
+    test_remove_if_for_each();
+    test_cursor();
+    test_node_pool();
     printf("ALL TESTS PASSED for LinkedList.\n");
     return 0;
 }
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "../lib/visibilidade/oclusao.h"
+#include "../lib/visibilidade/visibilidade.h"
+#include "../lib/poligono/poligono.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double aleatorio(double lo, double hi) {
+    return lo + (hi - lo) * ((double)rand() / RAND_MAX);
+}
+
+static int mantido(Segmento *v, int n, int id) {
+    for (int i = 0; i < n; i++) {
+        if (get_segmento_id(v[i]) == id) return 1;
+    }
+    return 0;
+}
+
+/* Segmento mais próximo atingido pelo raio, por força bruta */
+static int mais_proximo(Segmento *v, int n, double ox, double oy, double ang) {
+    double dx = cos(ang), dy = sin(ang);
+    double melhor = INFINITY;
+    int id = -1;
+    for (int i = 0; i < n; i++) {
+        double x1 = get_segmento_x1(v[i]) - ox, y1 = get_segmento_y1(v[i]) - oy;
+        double ex = get_segmento_x2(v[i]) - get_segmento_x1(v[i]);
+        double ey = get_segmento_y2(v[i]) - get_segmento_y1(v[i]);
+        double den = dx * ey - dy * ex;
+        if (fabs(den) < 1e-12) continue;
+        double t = (x1 * ey - y1 * ex) / den;
+        double u = (x1 * dy - y1 * dx) / den;
+        if (t > 0 && u >= 0 && u <= 1 && t < melhor) {
+            melhor = t;
+            id = get_segmento_id(v[i]);
+        }
+    }
+    return id;
+}
+
+void test_parede_esconde() {
+    printf("Testing wall hiding segments behind it...\n");
+    Arena arena = arena_criar(0);
+    Segmento v[32];
+    int n = 0;
+    v[n++] = criar_segmento_em(arena, 0, 0, 20, -5, 20, 5, "none");     // Behind
+    v[n++] = criar_segmento_em(arena, 1, 1, -10, -3, -10, 3, "none");   // Other side
+    v[n++] = criar_segmento_em(arena, 2, 2, 10, -100, 10, 100, "none"); // Wall
+    for (int k = 0; k < 20; k++) {
+        double x = 15 + 2 * k;
+        v[n++] = criar_segmento_em(arena, 3 + k, 3 + k, x, -4, x + 1, 4, "none");
+    }
+    v[n++] = criar_segmento_em(arena, 50, 50, 5, -2, 5, 2, "none");     // In front
+    v[n++] = criar_segmento_em(arena, 51, 51, -40, 150, -30, 160, "none"); // Outside the wall's span
+    int m = oclusao_filtrar(arena, 0, 0, v, n);
+
+    assert(m == 4);
+    // Survivors keep their relative order
+    assert(get_segmento_id(v[0]) == 1);
+    assert(get_segmento_id(v[1]) == 2);
+    assert(get_segmento_id(v[2]) == 50);
+    assert(get_segmento_id(v[3]) == 51);
+    arena_destruir(arena);
+    printf("Wall hiding passed.\n");
+}
+
+void test_segmento_pela_origem() {
+    printf("Testing segment through the origin...\n");
+    Arena arena = arena_criar(0);
+    Segmento v[12];
+    int n = 0;
+    // A closed box around the origin plus one segment crossing it
+    v[n++] = criar_segmento_em(arena, 0, 0, -5, -5, 5, -5, "none");
+    v[n++] = criar_segmento_em(arena, 1, 1, 5, -5, 5, 5, "none");
+    v[n++] = criar_segmento_em(arena, 2, 2, 5, 5, -5, 5, "none");
+    v[n++] = criar_segmento_em(arena, 3, 3, -5, 5, -5, -5, "none");
+    v[n++] = criar_segmento_em(arena, 4, 4, -1, 0, 1, 0, "none");
+    for (int k = 0; k < 6; k++) {
+        v[n++] = criar_segmento_em(arena, 10 + k, 10 + k, 20 + k, -30, 20 + k, 30, "none");
+    }
+    int m = oclusao_filtrar(arena, 0, 0, v, n);
+    assert(m == 5);
+    for (int id = 0; id <= 4; id++) assert(mantido(v, m, id));
+    arena_destruir(arena);
+    printf("Segment through the origin passed.\n");
+}
+
+void test_casos_triviais() {
+    printf("Testing trivial inputs...\n");
+    Arena arena = arena_criar(0);
+    Segmento v[1];
+    v[0] = criar_segmento_em(arena, 0, 0, 1, 1, 2, 2, "none");
+    assert(oclusao_filtrar(arena, 0, 0, v, 1) == 1);
+    assert(oclusao_filtrar(arena, 0, 0, v, 0) == 0);
+    assert(oclusao_filtrar(NULL, 0, 0, v, 1) == 1);
+    arena_destruir(arena);
+    printf("Trivial inputs passed.\n");
+}
+
+/* Quarteirões retangulares: nenhum segmento atingido por um raio é descartado */
+void test_quarteiroes_visiveis_mantidos() {
+    printf("Testing that visible block sides survive culling...\n");
+    Arena arena = arena_criar(0);
+    enum { LADO = 12 };
+    Segmento todos[LADO * LADO * 4], v[LADO * LADO * 4];
+    int n = 0;
+    for (int i = 0; i < LADO; i++) {
+        for (int j = 0; j < LADO; j++) {
+            double x = i * 30, y = j * 30, w = 20, h = 20;
+            todos[n] = criar_segmento_em(arena, n, n, x, y, x + w, y, "none"); n++;
+            todos[n] = criar_segmento_em(arena, n, n, x + w, y, x + w, y + h, "none"); n++;
+            todos[n] = criar_segmento_em(arena, n, n, x + w, y + h, x, y + h, "none"); n++;
+            todos[n] = criar_segmento_em(arena, n, n, x, y + h, x, y, "none"); n++;
+        }
+    }
+    double origens[3][2] = { { 175, 175 }, { 25, 117 }, { -40, 260 } };
+    for (int o = 0; o < 3; o++) {
+        double ox = origens[o][0], oy = origens[o][1];
+        memcpy(v, todos, n * sizeof(Segmento));
+        int m = oclusao_filtrar(arena, ox, oy, v, n);
+        assert(m > 0 && m < n / 4);
+        for (int k = 0; k < 20000; k++) {
+            int id = mais_proximo(todos, n, ox, oy, 2 * M_PI * k / 20000);
+            assert(id < 0 || mantido(v, m, id));
+        }
+    }
+    arena_destruir(arena);
+    printf("Visible block sides passed.\n");
+}
+
+/* Segmentos em posição geral: o polígono com e sem descarte é o mesmo */
+void test_poligono_inalterado() {
+    printf("Testing polygon unchanged by culling...\n");
+    srand(47);
+    for (int cena = 0; cena < 20; cena++) {
+        Arena arena = arena_criar(0);
+        LinkedList barreiras = list_create();
+        int n = 150 + cena * 10;
+        Segmento v[400];
+        for (int i = 0; i < n; i++) {
+            double x = aleatorio(0, 500), y = aleatorio(0, 500);
+            double a = aleatorio(0, 2 * M_PI), c = aleatorio(5, 40);
+            v[i] = criar_segmento(i, i, x, y, x + c * cos(a), y + c * sin(a), "none");
+            list_insert_back(barreiras, v[i]);
+        }
+        Ponto centro = criar_ponto(aleatorio(100, 400), aleatorio(100, 400));
+
+        visibilidade_set_oclusao(false);
+        PoligonoVisibilidade a = visibilidade_calcular_em(centro, barreiras, arena);
+        visibilidade_set_oclusao(true);
+        PoligonoVisibilidade b = visibilidade_calcular_em(centro, barreiras, arena);
+        visibilidade_set_oclusao(false);
+
+        int na = 0, nb = 0;
+        double *va = poligono_get_vertices_ref((Poligono)a, &na);
+        double *vb = poligono_get_vertices_ref((Poligono)b, &nb);
+        assert(na == nb);
+        assert(memcmp(va, vb, 2 * na * sizeof(double)) == 0);
+
+        // And the culling actually dropped something
+        Segmento copia[400];
+        memcpy(copia, v, n * sizeof(Segmento));
+        assert(oclusao_filtrar(arena, get_ponto_x(centro), get_ponto_y(centro), copia, n) < n);
+
+        visibilidade_destruir(a);
+        visibilidade_destruir(b);
+        destruir_ponto(centro);
+        for (int i = 0; i < n; i++) destruir_segmento(v[i]);
+        list_destroy(barreiras);
+        arena_destruir(arena);
+    }
+    printf("Polygon unchanged passed.\n");
+}
+
+int main() {
+    test_casos_triviais();
+    test_parede_esconde();
+    test_segmento_pela_origem();
+    test_quarteiroes_visiveis_mantidos();
+    test_poligono_inalterado();
+    printf("ALL TESTS PASSED for Oclusao.\n");
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "../lib/utils/pool/pool.h"
+
+// Each task bumps its own slot: distinct tasks never share memory
+static void marcar(void *arg, int indice) {
+    int *contagem = (int*)arg;
+    contagem[indice]++;
+}
+
+void test_create_destroy() {
+    printf("Testing pool create and destroy...\n");
+    PoolThreads pool = pool_criar(4);
+    assert(pool != NULL);
+    assert(pool_num_threads(pool) == 4);
+    pool_destruir(pool);
+
+    assert(pool_criar(0) == NULL);
+    assert(pool_num_threads(NULL) == 1);
+    pool_destruir(NULL);
+    printf("Pool create and destroy passed.\n");
+}
+
+void test_each_task_once() {
+    printf("Testing every task runs exactly once...\n");
+    int n = 10000;
+    int *contagem = calloc(n, sizeof(int));
+    PoolThreads pool = pool_criar(4);
+
+    // Several rounds on the same pool, with varying sizes
+    int tamanhos[] = { 1, 2, 7, 100, 10000 };
+    for (int r = 0; r < 5; r++) {
+        for (int i = 0; i < n; i++) contagem[i] = 0;
+        pool_executar(pool, marcar, contagem, tamanhos[r]);
+        for (int i = 0; i < n; i++) {
+            assert(contagem[i] == (i < tamanhos[r] ? 1 : 0));
+        }
+    }
+
+    pool_destruir(pool);
+    free(contagem);
+    printf("Every task runs exactly once passed.\n");
+}
+
+void test_serial_fallback() {
+    printf("Testing NULL pool runs tasks serially...\n");
+    int contagem[16] = { 0 };
+    pool_executar(NULL, marcar, contagem, 16);
+    for (int i = 0; i < 16; i++) assert(contagem[i] == 1);
+    pool_executar(NULL, marcar, contagem, 0);
+    for (int i = 0; i < 16; i++) assert(contagem[i] == 1);
+    printf("NULL pool runs tasks serially passed.\n");
+}
+
+int main() {
+    test_create_destroy();
+    test_each_task_once();
+    test_serial_fallback();
+    printf("ALL TESTS PASSED for Pool.\n");
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "../lib/utils/sort/sort.h"
+#include "../lib/utils/pool/pool.h"
+#include "../lib/utils/sort/sort_tipado.h"
+#include "../lib/utils/sort/calibracao.h"
+#include "../lib/visibilidade/visibilidade.h"
+
+typedef struct {
+    int chave;
+    int origem;  /* Posição antes da ordenação, para checar estabilidade */
+} Item;
+
+static long comparacoes = 0;
+
+static int comparar_chaves(const void *a, const void *b) {
+    const Item *x = (const Item*)a, *y = (const Item*)b;
+    return (x->chave > y->chave) - (x->chave < y->chave);
+}
+
+// Counts comparisons; single-threaded use only
+static int comparar_itens(const void *a, const void *b) {
+    comparacoes++;
+    return comparar_chaves(a, b);
+}
+
+static void checar_estavel(Item *v, int n) {
+    for (int i = 1; i < n; i++) {
+        assert(v[i - 1].chave <= v[i].chave);
+        if (v[i - 1].chave == v[i].chave) assert(v[i - 1].origem < v[i].origem);
+    }
+}
+
+static void preencher(Item *v, int n, int padrao) {
+    for (int i = 0; i < n; i++) {
+        switch (padrao) {
+            case 0: v[i].chave = rand() % 1000; break;         /* Aleatório, com repetições */
+            case 1: v[i].chave = i; break;                     /* Ordenado */
+            case 2: v[i].chave = n - i; break;                 /* Decrescente */
+            case 3: v[i].chave = 7; break;                     /* Todos iguais */
+            default: v[i].chave = (i / 50) % 2 ? n - i : i;    /* Trechos alternados */
+        }
+        v[i].origem = i;
+    }
+}
+
+#define ITEM_ANTES(a, b) ((a).chave < (b).chave)
+DEFINIR_ORDENACAO(itens, Item, ITEM_ANTES)
+
+#define INT_ANTES(a, b) ((a) < (b))
+DEFINIR_ORDENACAO(ints, int, INT_ANTES)
+
+void test_algorithms_agree() {
+    printf("Testing all algorithms on several patterns...\n");
+    int tamanhos[] = { 0, 1, 2, 31, 32, 33, 64, 65, 1000, 5000 };
+    AlgoritmoOrdenacao estaveis[] = { ALG_MERGESORT, ALG_TIMSORT };
+    srand(3);
+    for (int t = 0; t < 10; t++) {
+        int n = tamanhos[t];
+        Item *v = malloc((n + 1) * sizeof(Item));
+        Item *ref = malloc((n + 1) * sizeof(Item));
+        for (int padrao = 0; padrao < 5; padrao++) {
+            preencher(ref, n, padrao);
+            for (int a = 0; a < 2; a++) {
+                memcpy(v, ref, n * sizeof(Item));
+                ordenar(v, n, sizeof(Item), comparar_itens, estaveis[a], 10);
+                checar_estavel(v, n);
+            }
+            memcpy(v, ref, n * sizeof(Item));
+            ordenar(v, n, sizeof(Item), comparar_itens, ALG_QSORT, 0);
+            for (int i = 1; i < n; i++) assert(v[i - 1].chave <= v[i].chave);
+        }
+        free(v);
+        free(ref);
+    }
+    printf("All algorithms passed.\n");
+}
+
+void test_timsort_adaptive() {
+    printf("Testing timsort on nearly sorted input...\n");
+    int n = 100000;
+    Item *v = malloc(n * sizeof(Item));
+
+    // Already sorted: a single run, n - 1 comparisons
+    preencher(v, n, 1);
+    comparacoes = 0;
+    ordenar(v, n, sizeof(Item), comparar_itens, ALG_TIMSORT, 0);
+    assert(comparacoes == n - 1);
+
+    // Reversed: one descending run, reversed in place
+    preencher(v, n, 2);
+    comparacoes = 0;
+    ordenar(v, n, sizeof(Item), comparar_itens, ALG_TIMSORT, 0);
+    assert(comparacoes == n - 1);
+    checar_estavel(v, n);
+
+    // A few displaced elements: close to linear
+    preencher(v, n, 1);
+    srand(5);
+    for (int k = 0; k < 20; k++) {
+        int i = rand() % n, j = rand() % n;
+        Item tmp = v[i]; v[i] = v[j]; v[j] = tmp;
+    }
+    for (int i = 0; i < n; i++) v[i].origem = i;
+    comparacoes = 0;
+    ordenar(v, n, sizeof(Item), comparar_itens, ALG_TIMSORT, 0);
+    checar_estavel(v, n);
+    long quase = comparacoes;
+
+    preencher(v, n, 0);
+    comparacoes = 0;
+    ordenar(v, n, sizeof(Item), comparar_itens, ALG_TIMSORT, 0);
+    checar_estavel(v, n);
+    assert(quase * 4 < comparacoes);
+
+    free(v);
+    printf("Timsort on nearly sorted input passed.\n");
+}
+
+void test_parallel_mergesort() {
+    printf("Testing parallel mergesort...\n");
+    int tamanhos[] = { 100, 8191, 8192, 50000, 300001 };
+    int threads[] = { 2, 3, 4 };
+    srand(9);
+    for (int p = 0; p < 3; p++) {
+        PoolThreads pool = pool_criar(threads[p]);
+        assert(pool != NULL);
+        ordenar_definir_pool(pool);
+        for (int t = 0; t < 5; t++) {
+            int n = tamanhos[t];
+            Item *v = malloc(n * sizeof(Item));
+            Item *ref = malloc(n * sizeof(Item));
+            for (int padrao = 0; padrao < 5; padrao++) {
+                preencher(ref, n, padrao);
+                memcpy(v, ref, n * sizeof(Item));
+                ordenar(v, n, sizeof(Item), comparar_chaves, ALG_PARALLEL_MERGESORT, 10);
+                checar_estavel(v, n);
+                // Same order as the serial mergesort
+                ordenar(ref, n, sizeof(Item), comparar_chaves, ALG_MERGESORT, 10);
+                assert(memcmp(v, ref, n * sizeof(Item)) == 0);
+            }
+            free(v);
+            free(ref);
+        }
+        ordenar_definir_pool(NULL);
+        pool_destruir(pool);
+    }
+
+    // Without a pool it falls back to the serial version
+    Item v[64];
+    preencher(v, 64, 0);
+    ordenar(v, 64, sizeof(Item), comparar_chaves, ALG_PARALLEL_MERGESORT, 10);
+    checar_estavel(v, 64);
+    printf("Parallel mergesort passed.\n");
+}
+
+void test_typed_sorts() {
+    printf("Testing macro-specialised sorts...\n");
+    int tamanhos[] = { 0, 1, 2, 16, 17, 100, 1000, 20000 };
+    srand(13);
+    for (int t = 0; t < 8; t++) {
+        int n = tamanhos[t];
+        Item *v = malloc((n + 1) * sizeof(Item));
+        Item *ref = malloc((n + 1) * sizeof(Item));
+        int *inteiros = malloc((n + 1) * sizeof(int));
+        for (int padrao = 0; padrao < 5; padrao++) {
+            preencher(ref, n, padrao);
+
+            // Stable mergesort: same order as the generic one
+            memcpy(v, ref, n * sizeof(Item));
+            itens_mergesort(v, n, 10);
+            checar_estavel(v, n);
+            Item *generico = malloc((n + 1) * sizeof(Item));
+            memcpy(generico, ref, n * sizeof(Item));
+            ordenar(generico, n, sizeof(Item), comparar_chaves, ALG_MERGESORT, 10);
+            assert(memcmp(v, generico, n * sizeof(Item)) == 0);
+            free(generico);
+
+            memcpy(v, ref, n * sizeof(Item));
+            itens_insercao(v, n < 2000 ? n : 2000);
+            checar_estavel(v, n < 2000 ? n : 2000);
+
+            // Introsort: sorted, and a permutation of the input
+            for (int i = 0; i < n; i++) inteiros[i] = ref[i].chave;
+            ints_introsort(inteiros, n);
+            long soma = 0, soma_ref = 0;
+            for (int i = 0; i < n; i++) {
+                if (i > 0) assert(inteiros[i - 1] <= inteiros[i]);
+                soma += inteiros[i];
+                soma_ref += ref[i].chave;
+            }
+            assert(soma == soma_ref);
+        }
+        free(v);
+        free(ref);
+        free(inteiros);
+    }
+
+    // Organ-pipe input pushes quicksort towards its worst case
+    int n = 50000;
+    int *v = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) v[i] = (i < n / 2) ? i : n - i;
+    ints_introsort(v, n);
+    for (int i = 1; i < n; i++) assert(v[i - 1] <= v[i]);
+    free(v);
+    printf("Macro-specialised sorts passed.\n");
+}
+
+void test_calibration() {
+    printf("Testing sort calibration...\n");
+    ConfigOrdenacao cfg;
+    assert(calibracao_executar(&cfg, NULL, 2048, visibilidade_medir_ordenacao) == 1);
+    assert(cfg.num_faixas >= 1 && cfg.num_faixas <= MAX_FAIXAS_ORDENACAO);
+    assert(cfg.faixas[cfg.num_faixas - 1].max_n < 0);
+    for (int i = 0; i < cfg.num_faixas; i++) {
+        // Without a pool the parallel mergesort is never a candidate
+        assert(cfg.faixas[i].alg != ALG_PARALLEL_MERGESORT);
+        if (i > 0 && cfg.faixas[i].max_n >= 0) assert(cfg.faixas[i].max_n > cfg.faixas[i - 1].max_n);
+    }
+    assert(calibracao_escolher(&cfg, 1 << 30) == &cfg.faixas[cfg.num_faixas - 1]);
+
+    // Round trip through the config file
+    ConfigOrdenacao escrita = { 3, { { 256, ALG_MERGESORT, 8 }, { 8192, ALG_TIMSORT, 0 },
+                                     { -1, ALG_QSORT, 0 } } };
+    const char *path = "/tmp/test_sort_calibracao.cfg";
+    assert(calibracao_salvar(&escrita, path) == 1);
+    ConfigOrdenacao lida;
+    assert(calibracao_carregar(&lida, path) == 1);
+    assert(lida.num_faixas == 3);
+    for (int i = 0; i < 3; i++) {
+        assert(lida.faixas[i].max_n == escrita.faixas[i].max_n);
+        assert(lida.faixas[i].alg == escrita.faixas[i].alg);
+        assert(lida.faixas[i].limiar == escrita.faixas[i].limiar);
+    }
+    remove(path);
+
+    assert(calibracao_escolher(&lida, 10)->alg == ALG_MERGESORT);
+    assert(calibracao_escolher(&lida, 256)->alg == ALG_MERGESORT);
+    assert(calibracao_escolher(&lida, 257)->alg == ALG_TIMSORT);
+    assert(calibracao_escolher(&lida, 100000)->alg == ALG_QSORT);
+
+    // Missing file and garbage lines
+    assert(calibracao_carregar(&lida, "/tmp/nao_existe_calibracao.cfg") == 0);
+    FILE *f = fopen(path, "w");
+    fprintf(f, "# comment\nlixo\n100 x 3\n200 m 0\n300 p 0\n500 m 12\n");
+    fclose(f);
+    assert(calibracao_carregar(&lida, path) == 1);
+    assert(lida.num_faixas == 1 && lida.faixas[0].limiar == 12);
+    // No unbounded band: the last one covers larger inputs
+    assert(calibracao_escolher(&lida, 100000) == &lida.faixas[0]);
+    remove(path);
+
+    assert(calibracao_algoritmo(calibracao_letra(ALG_PARALLEL_MERGESORT)) == ALG_PARALLEL_MERGESORT);
+    printf("Sort calibration passed.\n");
+}
+
+int main() {
+    test_algorithms_agree();
+    test_timsort_adaptive();
+    test_parallel_mergesort();
+    test_typed_sorts();
+    test_calibration();
+    printf("ALL TESTS PASSED for Sort.\n");
+    return 0;
+}
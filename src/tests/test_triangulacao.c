@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "../lib/visibilidade/triangulacao.h"
+#include "../lib/visibilidade/visibilidade.h"
+#include "../lib/geometria/segmento/segmento.h"
+#include "../lib/poligono/poligono.h"
+#include "../lib/utils/arena/arena.h"
+#include "cena_teste.h"
+
+static double dist_segmento(double px, double py, double x1, double y1, double x2, double y2) {
+    double dx = x2 - x1, dy = y2 - y1;
+    double t = ((px - x1) * dx + (py - y1) * dy) / (dx * dx + dy * dy);
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    return hypot(x1 + t * dx - px, y1 + t * dy - py);
+}
+
+/* Ponto dentro do polígono (par-ímpar); *borda recebe a distância ao contorno */
+static int dentro(PoligonoVisibilidade pol, double px, double py, double *borda) {
+    int n = 0;
+    double *v = poligono_get_vertices_ref((Poligono)pol, &n);
+    int c = 0;
+    *borda = INFINITY;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        double xi = v[2 * i], yi = v[2 * i + 1], xj = v[2 * j], yj = v[2 * j + 1];
+        if ((yi > py) != (yj > py) && px < (xj - xi) * (py - yi) / (yj - yi) + xi) c = !c;
+        *borda = fmin(*borda, dist_segmento(px, py, xi, yi, xj, yj));
+    }
+    return c;
+}
+
+/* Amostra pontos longe do contorno; devolve quantos divergem da força bruta */
+static int divergencias(PoligonoVisibilidade pol, LinkedList barreiras, double ox, double oy,
+                        double x0, double y0, double x1, double y1, int amostras) {
+    int erros = 0;
+    for (int k = 0; k < amostras; k++) {
+        double px = aleatorio(x0, x1), py = aleatorio(y0, y1);
+        double borda;
+        int d = dentro(pol, px, py, &borda);
+        if (borda < 1e-6) continue;
+        if (d != visivel(barreiras, ox, oy, px, py)) erros++;
+    }
+    return erros;
+}
+
+static void conferir_amostras(PoligonoVisibilidade pol, LinkedList barreiras, double ox, double oy,
+                              double x0, double y0, double x1, double y1, int amostras) {
+    assert(divergencias(pol, barreiras, ox, oy, x0, y0, x1, y1, amostras) == 0);
+}
+
+/* Malha descartável: cria, consulta uma vez e destrói */
+static void *motor_malha(Ponto c, LinkedList l, int parametro) {
+    (void)parametro;
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    PoligonoVisibilidade pol = malha_visibilidade_calcular(m, c);
+    malha_visibilidade_destruir(m);
+    return pol;
+}
+
+void test_entradas_invalidas() {
+    printf("Testing invalid inputs...\n");
+    conferir_entradas_invalidas(motor_malha, 0, -1);
+    assert(malha_visibilidade_criar(NULL) == NULL);
+    printf("Invalid inputs passed.\n");
+}
+
+void test_sem_barreiras() {
+    printf("Testing empty scene...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, 0, 0, 100, 50);
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    assert(m != NULL);
+    Ponto c = criar_ponto(30, 20);
+    PoligonoVisibilidade pol = malha_visibilidade_calcular(m, c);
+    assert(pol != NULL);
+    assert(poligono_qtd_vertices((Poligono)pol) == 4);
+    assert(fabs(area(pol) - 5000) < 1e-6);
+
+    visibilidade_destruir(pol);
+    destruir_ponto(c);
+    malha_visibilidade_destruir(m);
+    destruir_segmentos(l);
+    printf("Empty scene passed.\n");
+}
+
+void test_contagem_euler() {
+    printf("Testing triangle count...\n");
+    LinkedList l = list_create();
+    // Disjoint segments: 2 vertices each; the default frame is not in the mesh
+    for (int i = 0; i < 10; i++) {
+        list_insert_back(l, criar_segmento(i, i, i * 10, 0, i * 10 + 3, 7, "none"));
+    }
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    assert(m != NULL);
+    int v = 2 * 10;
+    assert(malha_visibilidade_num_triangulos(m) == 2 * (v + 3) - 5);
+    malha_visibilidade_destruir(m);
+    destruir_segmentos(l);
+    printf("Triangle count passed.\n");
+}
+
+void test_centro_invalido() {
+    printf("Testing viewpoints the mesh rejects...\n");
+    LinkedList l = list_create();
+    inserir_bordas(l, 0, 0, 100, 100);
+    list_insert_back(l, criar_segmento(0, 0, 20, 20, 60, 20, "none"));
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    assert(m != NULL);
+
+    Ponto vertice = criar_ponto(20, 20);
+    Ponto aresta = criar_ponto(40, 20);
+    Ponto fora = criar_ponto(150, 50);
+    assert(malha_visibilidade_calcular(m, vertice) == NULL);
+    assert(malha_visibilidade_calcular(m, aresta) == NULL);
+    assert(malha_visibilidade_calcular(m, fora) == NULL);
+    assert(malha_visibilidade_calcular(NULL, vertice) == NULL);
+
+    destruir_ponto(vertice);
+    destruir_ponto(aresta);
+    destruir_ponto(fora);
+    malha_visibilidade_destruir(m);
+    destruir_segmentos(l);
+    printf("Rejected viewpoints passed.\n");
+}
+
+static int livre(LinkedList l, double x, double y, double x2, double y2) {
+    for (ListCursor c = list_cursor_first(l); list_cursor_valid(&c); list_cursor_next(&c)) {
+        Segmento s = (Segmento)list_cursor_get(&c);
+        double sx1 = get_segmento_x1(s), sy1 = get_segmento_y1(s);
+        double sx2 = get_segmento_x2(s), sy2 = get_segmento_y2(s);
+        if (dist_segmento(x, y, sx1, sy1, sx2, sy2) < 1 || dist_segmento(x2, y2, sx1, sy1, sx2, sy2) < 1 ||
+            dist_segmento(sx1, sy1, x, y, x2, y2) < 1 || dist_segmento(sx2, sy2, x, y, x2, y2) < 1 ||
+            segmentos_cruzam(x, y, x2, y2, sx1, sy1, sx2, sy2)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Malha só com as barreiras; as bordas chegam na consulta, como no .qry */
+void test_moldura() {
+    printf("Testing the frame given per query...\n");
+    srand(4850);
+    LinkedList l = list_create();
+    for (int tentativa = 0; list_size(l) < 60 && tentativa < 5000; tentativa++) {
+        double x = aleatorio(0, 300), y = aleatorio(0, 300);
+        double a = aleatorio(0, 2 * M_PI), c = aleatorio(5, 50);
+        double x2 = x + c * cos(a), y2 = y + c * sin(a);
+        if (livre(l, x, y, x2, y2)) list_insert_back(l, criar_segmento(list_size(l), 0, x, y, x2, y2, "none"));
+    }
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    assert(m != NULL);
+
+    // A caixa cresce (outras formas, bombas fora dela) e a malha continua servindo
+    double molduras[3][4] = { { -30, -30, 380, 380 }, { -200, -60, 400, 900 }, { -2000, -2000, 2500, 2500 } };
+    for (int f = 0; f < 3; f++) {
+        double *b = molduras[f];
+        LinkedList com_bordas = list_create();
+        inserir_bordas(com_bordas, b[0], b[1], b[2], b[3]);
+        for (ListCursor k = list_cursor_first(l); list_cursor_valid(&k); list_cursor_next(&k)) {
+            Segmento s = (Segmento)list_cursor_get(&k);
+            list_insert_back(com_bordas, criar_segmento(get_segmento_id(s), 0, get_segmento_x1(s), get_segmento_y1(s),
+                                                        get_segmento_x2(s), get_segmento_y2(s), "none"));
+        }
+        // Referência: a mesma cena com o retângulo como barreira
+        MalhaVisibilidade mb = malha_visibilidade_criar(com_bordas);
+        assert(mb != NULL);
+        for (int q = 0; q < 8; q++) {
+            double ox = aleatorio(b[0] + 1, b[2] - 1), oy = aleatorio(b[1] + 1, b[3] - 1);
+            Ponto c = criar_ponto(ox, oy);
+            PoligonoVisibilidade a = malha_visibilidade_calcular_moldura(m, c, b[0], b[1], b[2], b[3]);
+            PoligonoVisibilidade r = malha_visibilidade_calcular(mb, c);
+            assert((a == NULL) == (r == NULL));
+            if (a != NULL) {
+                assert(fabs(area(a) - area(r)) <= 1e-9 * area(r));
+                conferir_amostras(a, com_bordas, ox, oy, b[0], b[1], b[2], b[3], 500);
+                visibilidade_destruir(a);
+                visibilidade_destruir(r);
+            }
+            destruir_ponto(c);
+        }
+        malha_visibilidade_destruir(mb);
+        destruir_segmentos(com_bordas);
+    }
+
+    // Centro fora da moldura, ou moldura maior que o triângulo externo
+    Ponto c = criar_ponto(150, 150);
+    assert(malha_visibilidade_calcular_moldura(m, c, 200, 200, 400, 400) == NULL);
+    assert(malha_visibilidade_calcular_moldura(m, c, -1e7, -1e7, 1e7, 1e7) == NULL);
+    destruir_ponto(c);
+
+    malha_visibilidade_destruir(m);
+    destruir_segmentos(l);
+    printf("Frame per query passed.\n");
+}
+
+/* Barreiras que se cruzam e se sobrepõem são cortadas antes da triangulação */
+void test_barreiras_cruzadas() {
+    printf("Testing crossing and overlapping barriers...\n");
+    srand(48);
+    LinkedList l = list_create();
+    inserir_bordas(l, -10, -10, 110, 110);
+    list_insert_back(l, criar_segmento(0, 0, 20, 20, 80, 80, "none"));
+    list_insert_back(l, criar_segmento(1, 1, 20, 80, 80, 20, "none"));
+    list_insert_back(l, criar_segmento(2, 2, 10, 50, 40, 50, "none"));
+    list_insert_back(l, criar_segmento(3, 3, 30, 50, 60, 50, "none"));   // Overlaps 2
+    list_insert_back(l, criar_segmento(4, 4, 50, 20, 50, 35, "none"));   // Touches 0 and 1
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    assert(m != NULL);
+
+    double origens[4][2] = { { 50, 10 }, { 5, 40 }, { 90, 60 }, { 45, 60 } };
+    for (int o = 0; o < 4; o++) {
+        Ponto c = criar_ponto(origens[o][0], origens[o][1]);
+        PoligonoVisibilidade pol = malha_visibilidade_calcular(m, c);
+        assert(pol != NULL);
+        assert(area(pol) > 0);
+        conferir_amostras(pol, l, origens[o][0], origens[o][1], -10, -10, 110, 110, 4000);
+        visibilidade_destruir(pol);
+        destruir_ponto(c);
+    }
+    malha_visibilidade_destruir(m);
+    destruir_segmentos(l);
+    printf("Crossing barriers passed.\n");
+}
+
+/*
+ * Salas fechadas em forma de estrela em volta da origem, com um vértice no
+ * raio de ângulo 0: o polígono certo é a própria sala. A malha tem de
+ * acertar sempre; a varredura acerta na maioria (a ordem da árvore é
+ * fixada na inserção e, em algumas salas, ela perde ou devolve a caixa).
+ */
+void test_confere_com_varredura() {
+    printf("Testing agreement with the angular sweep...\n");
+    srand(4848);
+    Arena arena = arena_criar(0);
+    int cenas = 60, iguais = 0;
+    for (int cena = 0; cena < cenas; cena++) {
+        LinkedList l = list_create();
+        inserir_bordas(l, -20, -20, 520, 520);
+        double ox = aleatorio(150, 350), oy = aleatorio(150, 350);
+        int n = 5 + cena;
+        double passo = 2 * M_PI / n;
+        double px = ox + 100, py = oy;
+        for (int i = 1; i <= n; i++) {
+            double ang = (i < n) ? (i + aleatorio(-0.3, 0.3)) * passo : 0;
+            double r = (i < n) ? aleatorio(40, 140) : 100;
+            double qx = ox + r * cos(ang), qy = (i < n) ? oy + r * sin(ang) : oy;
+            list_insert_back(l, criar_segmento(i, i, px, py, qx, qy, "none"));
+            px = qx;
+            py = qy;
+        }
+        MalhaVisibilidade m = malha_visibilidade_criar(l);
+        assert(m != NULL);
+
+        Ponto c = criar_ponto(ox, oy);
+        PoligonoVisibilidade a = malha_visibilidade_calcular(m, c);
+        PoligonoVisibilidade b = visibilidade_calcular_em(c, l, arena);
+        assert(a != NULL && b != NULL);
+        // Tudo na sala é visível: o polígono é a própria sala
+        double sala = 0;
+        for (ListCursor k = list_cursor_first(l); list_cursor_valid(&k); list_cursor_next(&k)) {
+            Segmento s = (Segmento)list_cursor_get(&k);
+            if (get_segmento_id(s) < 0) continue;  // Bordas
+            sala += get_segmento_x1(s) * get_segmento_y2(s) - get_segmento_x2(s) * get_segmento_y1(s);
+        }
+        sala /= 2;
+        assert(fabs(area(a) - sala) <= 1e-6 * sala);
+        conferir_amostras(a, l, ox, oy, ox - 150, oy - 150, ox + 150, oy + 150, 500);
+        if (fabs(fabs(area(b)) - sala) <= 1e-6 * sala) iguais++;
+        visibilidade_destruir(a);
+        visibilidade_destruir(b);
+        destruir_ponto(c);
+        malha_visibilidade_destruir(m);
+        destruir_segmentos(l);
+    }
+    assert(iguais >= cenas / 2);
+    arena_destruir(arena);
+    printf("Agreement with the sweep passed.\n");
+}
+
+/* Cenas aleatórias sem cruzamentos e com oclusão: contra a força bruta */
+void test_cenas_aleatorias() {
+    printf("Testing random occluded scenes...\n");
+    srand(4849);
+    for (int cena = 0; cena < 25; cena++) {
+        LinkedList l = list_create();
+        inserir_bordas(l, -20, -20, 520, 520);
+        int n = 40 + cena * 8;
+        for (int tentativa = 0; list_size(l) < n + 4 && tentativa < 50 * n; tentativa++) {
+            double x = aleatorio(0, 500), y = aleatorio(0, 500);
+            double a = aleatorio(0, 2 * M_PI), c = aleatorio(5, 60);
+            double x2 = x + c * cos(a), y2 = y + c * sin(a);
+            if (livre(l, x, y, x2, y2)) list_insert_back(l, criar_segmento(list_size(l), 0, x, y, x2, y2, "none"));
+        }
+        MalhaVisibilidade m = malha_visibilidade_criar(l);
+        assert(m != NULL);
+        for (int q = 0; q < 6; q++) {
+            double ox = aleatorio(0, 500), oy = aleatorio(0, 500);
+            Ponto c = criar_ponto(ox, oy);
+            PoligonoVisibilidade a = malha_visibilidade_calcular(m, c);
+            if (a != NULL) {
+                assert(area(a) > 0);
+                conferir_amostras(a, l, ox, oy, -20, -20, 520, 520, 500);
+                visibilidade_destruir(a);
+            }
+            destruir_ponto(c);
+        }
+        malha_visibilidade_destruir(m);
+        destruir_segmentos(l);
+    }
+    printf("Random occluded scenes passed.\n");
+}
+
+/* Quarteirões em grade: muitos lados colineares e quinas em comum */
+void test_quarteiroes() {
+    printf("Testing grid of blocks...\n");
+    srand(480);
+    LinkedList l = list_create();
+    inserir_bordas(l, -15, -15, 305, 305);
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            double x = i * 30, y = j * 30, w = 20, h = 20;
+            list_insert_back(l, criar_segmento(0, 0, x, y, x + w, y, "none"));
+            list_insert_back(l, criar_segmento(0, 0, x + w, y, x + w, y + h, "none"));
+            list_insert_back(l, criar_segmento(0, 0, x + w, y + h, x, y + h, "none"));
+            list_insert_back(l, criar_segmento(0, 0, x, y + h, x, y, "none"));
+        }
+    }
+    MalhaVisibilidade m = malha_visibilidade_criar(l);
+    assert(m != NULL);
+    // Quarteirões vizinhos compartilham retas: os cortes não podem fundir lados
+    assert(malha_visibilidade_num_triangulos(m) == 2 * (4 * 100 + 4 + 3) - 5);
+    double origens[4][2] = { { 146.3, 144.1 }, { 25.5, 117 }, { -7, 260 }, { 203, 1.5 } };
+    for (int o = 0; o < 4; o++) {
+        Ponto c = criar_ponto(origens[o][0], origens[o][1]);
+        PoligonoVisibilidade a = malha_visibilidade_calcular(m, c);
+        assert(a != NULL);
+        conferir_amostras(a, l, origens[o][0], origens[o][1], -15, -15, 305, 305, 3000);
+        visibilidade_destruir(a);
+        destruir_ponto(c);
+    }
+    malha_visibilidade_destruir(m);
+    destruir_segmentos(l);
+    printf("Grid of blocks passed.\n");
+}
+
+int main() {
+    test_entradas_invalidas();
+    test_sem_barreiras();
+    test_contagem_euler();
+    test_centro_invalido();
+    test_moldura();
+    test_barreiras_cruzadas();
+    test_confere_com_varredura();
+    test_cenas_aleatorias();
+    test_quarteiroes();
+    printf("ALL TESTS PASSED for Triangulacao.\n");
+    return 0;
+}
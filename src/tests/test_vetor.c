@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "../lib/utils/vetor/vetor.h"
+
+typedef struct {
+    int chave;
+    double valor;
+} Par;
+
+static int comparar_pares(const void *a, const void *b) {
+    const Par *x = (const Par*)a, *y = (const Par*)b;
+    return (x->chave > y->chave) - (x->chave < y->chave);
+}
+
+void test_push_pop_index() {
+    printf("Testing push/pop/index...\n");
+    Vetor v = vetor_criar(sizeof(Par));
+    assert(v != NULL);
+    assert(vetor_tamanho(v) == 0);
+    assert(vetor_obter(v, 0) == NULL);
+    assert(vetor_remover_ultimo(v, NULL) == 0);
+
+    // Grows past the initial capacity
+    for (int i = 0; i < 1000; i++) {
+        Par p = { i, i * 0.5 };
+        assert(vetor_inserir(v, &p) != NULL);
+    }
+    assert(vetor_tamanho(v) == 1000);
+    for (int i = 0; i < 1000; i++) {
+        Par *p = (Par*)vetor_obter(v, i);
+        assert(p->chave == i && p->valor == i * 0.5);
+    }
+    assert(vetor_obter(v, 1000) == NULL && vetor_obter(v, -1) == NULL);
+    assert(((Par*)vetor_dados(v))[999].chave == 999);
+
+    Par saida;
+    assert(vetor_remover_ultimo(v, &saida) == 1);
+    assert(saida.chave == 999 && vetor_tamanho(v) == 999);
+
+    // NULL element inserts a zeroed slot
+    Par *zero = (Par*)vetor_inserir(v, NULL);
+    assert(zero->chave == 0 && zero->valor == 0.0);
+
+    vetor_truncar(v, 10);
+    assert(vetor_tamanho(v) == 10);
+    vetor_truncar(v, 50);
+    assert(vetor_tamanho(v) == 10);
+    vetor_limpar(v);
+    assert(vetor_tamanho(v) == 0);
+
+    vetor_destruir(v);
+    vetor_destruir(NULL);
+    assert(vetor_criar(0) == NULL);
+    printf("Push/pop/index passed.\n");
+}
+
+void test_reserve() {
+    printf("Testing reserve...\n");
+    Vetor v = vetor_criar(sizeof(int));
+    assert(vetor_reservar(v, 500) == 1);
+    int *antes = NULL;
+    for (int i = 0; i < 500; i++) {
+        int *p = (int*)vetor_inserir(v, &i);
+        if (i == 0) antes = p;
+    }
+    // No reallocation happened within the reserved capacity
+    assert(vetor_dados(v) == antes);
+    assert(vetor_reservar(v, 10) == 1);
+    vetor_destruir(v);
+    printf("Reserve passed.\n");
+}
+
+void test_removals() {
+    printf("Testing swap and ordered removal...\n");
+    Vetor v = vetor_criar(sizeof(int));
+    for (int i = 0; i < 6; i++) vetor_inserir(v, &i);
+
+    int saida = -1;
+    // Swap-remove: the last element takes the hole
+    assert(vetor_remover_troca(v, 1, &saida) == 1);
+    assert(saida == 1);
+    int esperado1[] = { 0, 5, 2, 3, 4 };
+    assert(memcmp(vetor_dados(v), esperado1, sizeof(esperado1)) == 0);
+
+    // Ordered removal keeps the order of the rest
+    assert(vetor_remover_ordenado(v, 1, &saida) == 1);
+    assert(saida == 5);
+    int esperado2[] = { 0, 2, 3, 4 };
+    assert(memcmp(vetor_dados(v), esperado2, sizeof(esperado2)) == 0);
+
+    // Removing the last position with either method
+    assert(vetor_remover_troca(v, 3, NULL) == 1);
+    assert(vetor_remover_ordenado(v, 2, NULL) == 1);
+    assert(vetor_tamanho(v) == 2);
+    assert(vetor_remover_troca(v, 2, NULL) == 0);
+    assert(vetor_remover_ordenado(v, -1, NULL) == 0);
+    vetor_destruir(v);
+    printf("Swap and ordered removal passed.\n");
+}
+
+void test_sort() {
+    printf("Testing in-place sort...\n");
+    AlgoritmoOrdenacao algs[] = { ALG_QSORT, ALG_MERGESORT };
+    for (int a = 0; a < 2; a++) {
+        srand(7);
+        Vetor v = vetor_criar(sizeof(Par));
+        for (int i = 0; i < 300; i++) {
+            Par p = { rand() % 100, (double)i };
+            vetor_inserir(v, &p);
+        }
+        vetor_ordenar(v, comparar_pares, algs[a], 10);
+        Par *dados = (Par*)vetor_dados(v);
+        for (int i = 1; i < 300; i++) {
+            assert(dados[i - 1].chave <= dados[i].chave);
+            // Mergesort is stable: ties keep insertion order
+            if (algs[a] == ALG_MERGESORT && dados[i - 1].chave == dados[i].chave)
+                assert(dados[i - 1].valor < dados[i].valor);
+        }
+        vetor_destruir(v);
+    }
+    printf("In-place sort passed.\n");
+}
+
+int main() {
+    test_push_pop_index();
+    test_reserve();
+    test_removals();
+    test_sort();
+    printf("ALL TESTS PASSED for Vetor.\n");
+    return 0;
+}
@@ -0,0 +1,435 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "../lib/visibilidade/visibilidade.h"
+#include "../lib/poligono/poligono.h"
+#include "../lib/geometria/ponto/ponto.h"
+#include "../lib/geometria/segmento/segmento.h"
+#include "../lib/geometria/calculos/calculos.h"
+#include "../lib/utils/lista/lista.h"
+#include "../lib/utils/arena/arena.h"
+#include "../lib/utils/pool/pool.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double aleatorio(double min, double max) {
+    return min + (max - min) * ((double)rand() / RAND_MAX);
+}
+
+// Random walls plus shared-corner boxes (exact distance ties at the corners)
+static LinkedList criar_cenario(int num_segmentos) {
+    LinkedList barreiras = list_create();
+    int id = 5000;
+    for (int i = 0; i < num_segmentos; i++) {
+        double x = aleatorio(0, 1000), y = aleatorio(0, 1000);
+        list_insert_back(barreiras, criar_segmento(id, id, x, y,
+                         x + aleatorio(-60, 60), y + aleatorio(-60, 60), "black"));
+        id++;
+    }
+    for (int i = 0; i < num_segmentos / 8; i++) {
+        double x = aleatorio(0, 950), y = aleatorio(0, 950);
+        double w = aleatorio(5, 40), h = aleatorio(5, 40);
+        list_insert_back(barreiras, criar_segmento(id, id, x, y, x + w, y, "black")); id++;
+        list_insert_back(barreiras, criar_segmento(id, id, x + w, y, x + w, y + h, "black")); id++;
+        list_insert_back(barreiras, criar_segmento(id, id, x + w, y + h, x, y + h, "black")); id++;
+        list_insert_back(barreiras, criar_segmento(id, id, x, y + h, x, y, "black")); id++;
+    }
+    return barreiras;
+}
+
+static void destruir_cenario(LinkedList barreiras) {
+    while (!list_is_empty(barreiras)) {
+        destruir_segmento((Segmento)list_remove_front(barreiras));
+    }
+    list_destroy(barreiras);
+}
+
+static void assert_poligonos_iguais(PoligonoVisibilidade a, PoligonoVisibilidade b) {
+    int na = 0, nb = 0;
+    double *va = poligono_get_vertices_ref((Poligono)a, &na);
+    double *vb = poligono_get_vertices_ref((Poligono)b, &nb);
+    assert(na == nb);
+    for (int i = 0; i < 2 * na; i++) {
+        assert(va[i] == vb[i]);
+    }
+}
+
+void test_setores_igual_serial() {
+    printf("Testing sector sweep against serial sweep...\n");
+    srand(42);
+    // Sectors run as tasks of this pool, each with its own tree
+    PoolThreads pool = pool_criar(4);
+    assert(pool != NULL);
+    visibilidade_set_pool(pool);
+    for (int cenario = 0; cenario < 4; cenario++) {
+        LinkedList barreiras = criar_cenario(300);
+        for (int consulta = 0; consulta < 3; consulta++) {
+            Ponto centro = criar_ponto(aleatorio(0, 1000), aleatorio(0, 1000));
+
+            visibilidade_set_num_setores(1);
+            PoligonoVisibilidade serial = visibilidade_calcular(centro, barreiras);
+            assert(serial != NULL);
+
+            int setores[] = { 2, 3, 8 };
+            for (int k = 0; k < 3; k++) {
+                visibilidade_set_num_setores(setores[k]);
+                PoligonoVisibilidade paralelo = visibilidade_calcular(centro, barreiras);
+                assert(paralelo != NULL);
+                assert_poligonos_iguais(serial, paralelo);
+                visibilidade_destruir(paralelo);
+            }
+
+            visibilidade_destruir(serial);
+            destruir_ponto(centro);
+        }
+        destruir_cenario(barreiras);
+    }
+    visibilidade_set_num_setores(1);
+    visibilidade_set_pool(NULL);
+    pool_destruir(pool);
+    printf("Sector sweep passes.\n");
+}
+
+// Scene as SoA coordinates for the batch kernel
+static void extrair_coords(Segmento *segs, int n, double *x1, double *y1, double *x2, double *y2) {
+    for (int i = 0; i < n; i++) {
+        x1[i] = get_segmento_x1(segs[i]);
+        y1[i] = get_segmento_y1(segs[i]);
+        x2[i] = get_segmento_x2(segs[i]);
+        y2[i] = get_segmento_y2(segs[i]);
+    }
+}
+
+void test_lote_igual_escalar() {
+    printf("Testing batch ray kernel against scalar distance...\n");
+    srand(11);
+    LinkedList barreiras = criar_cenario(203);
+    int n = list_size(barreiras);
+    Segmento *segs = malloc(n * sizeof(Segmento));
+    double *x1 = malloc(n * sizeof(double)), *y1 = malloc(n * sizeof(double));
+    double *x2 = malloc(n * sizeof(double)), *y2 = malloc(n * sizeof(double));
+    double *dist = malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) segs[i] = (Segmento)list_get_at(barreiras, i);
+    extrair_coords(segs, n, x1, y1, x2, y2);
+
+    NivelSimd niveis[] = { SIMD_ESCALAR, SIMD_SSE2, SIMD_AVX2 };
+    for (int k = 0; k < 3; k++) {
+        calculos_set_nivel_simd(niveis[k]);
+        for (int r = 0; r < 100; r++) {
+            Ponto origem = criar_ponto(aleatorio(0, 1000), aleatorio(0, 1000));
+            double angulo = (r == 0) ? 0.0 : aleatorio(0, 2 * M_PI);
+
+            // Odd lengths exercise the scalar tail after the vector loop
+            int m = n - (r % 4);
+            int mais_proximo = distancias_raio_lote(get_ponto_x(origem), get_ponto_y(origem),
+                                                    cos(angulo), sin(angulo),
+                                                    x1, y1, x2, y2, m, dist);
+            int esperado = -1;
+            double menor = INFINITY;
+            for (int i = 0; i < m; i++) {
+                double d = distancia_raio_segmento(origem, angulo, segs[i]);
+                assert(d == dist[i] || (isinf(d) && isinf(dist[i])));
+                if (d < menor) { menor = d; esperado = i; }
+            }
+            assert(mais_proximo == esperado);
+            destruir_ponto(origem);
+        }
+    }
+    calculos_set_nivel_simd(SIMD_AVX2);
+
+    free(x1); free(y1); free(x2); free(y2); free(dist);
+    free(segs);
+    destruir_cenario(barreiras);
+    printf("Batch ray kernel passes.\n");
+}
+
+void test_pontos_no_poligono_igual_escalar() {
+    printf("Testing batch point-in-polygon against scalar test...\n");
+    srand(23);
+    LinkedList barreiras = criar_cenario(200);
+    Ponto centro = criar_ponto(500, 500);
+    PoligonoVisibilidade pol = visibilidade_calcular(centro, barreiras);
+    assert(pol != NULL);
+    int nv = 0;
+    double *vertices = poligono_get_vertices_ref((Poligono)pol, &nv);
+
+    // Random points plus the polygon's own vertices (boundary cases)
+    int n = 1001 + nv;
+    double *xs = malloc(n * sizeof(double)), *ys = malloc(n * sizeof(double));
+    unsigned char *mapa = malloc(BITMAP_BYTES(n));
+    for (int i = 0; i < 1001; i++) {
+        xs[i] = aleatorio(-50, 1050);
+        ys[i] = aleatorio(-50, 1050);
+    }
+    for (int i = 0; i < nv; i++) {
+        xs[1001 + i] = vertices[2 * i];
+        ys[1001 + i] = vertices[2 * i + 1];
+    }
+
+    NivelSimd niveis[] = { SIMD_ESCALAR, SIMD_SSE2, SIMD_AVX2 };
+    for (int k = 0; k < 3; k++) {
+        calculos_set_nivel_simd(niveis[k]);
+        pontos_no_poligono(xs, ys, n, vertices, nv, mapa);
+        int dentro = 0;
+        for (int i = 0; i < n; i++) {
+            Ponto p = criar_ponto(xs[i], ys[i]);
+            int esperado = visibilidade_ponto_atingido(pol, p) ? 1 : 0;
+            assert(BITMAP_TESTAR(mapa, i) == esperado);
+            dentro += esperado;
+            destruir_ponto(p);
+        }
+        assert(dentro > 0 && dentro < n);
+
+        visibilidade_pontos_atingidos(pol, xs, ys, n, mapa);
+        for (int i = 0; i < n; i++) {
+            assert(BITMAP_TESTAR(mapa, i) == ponto_no_poligono(xs[i], ys[i], vertices, nv));
+        }
+    }
+    calculos_set_nivel_simd(SIMD_AVX2);
+
+    free(xs); free(ys); free(mapa);
+    visibilidade_destruir(pol);
+    destruir_ponto(centro);
+    destruir_cenario(barreiras);
+    printf("Batch point-in-polygon passes.\n");
+}
+
+void test_arena_reutilizada() {
+    printf("Testing visibility with a reused arena...\n");
+    srand(11);
+    Arena arena = arena_criar(4096);  // Small blocks: forces chaining
+    for (int cenario = 0; cenario < 3; cenario++) {
+        LinkedList barreiras = criar_cenario(200);
+        for (int consulta = 0; consulta < 4; consulta++) {
+            Ponto centro = criar_ponto(aleatorio(0, 1000), aleatorio(0, 1000));
+            PoligonoVisibilidade propria = visibilidade_calcular(centro, barreiras);
+            PoligonoVisibilidade reusada = visibilidade_calcular_em(centro, barreiras, arena);
+            assert(propria != NULL && reusada != NULL);
+            assert_poligonos_iguais(propria, reusada);
+            // The arena is reset at the end of every query
+            assert(arena_usado(arena) == 0);
+            visibilidade_destruir(propria);
+            visibilidade_destruir(reusada);
+            destruir_ponto(centro);
+        }
+        destruir_cenario(barreiras);
+    }
+    arena_destruir(arena);
+    printf("Reused arena passes.\n");
+}
+
+void test_timsort_semeado() {
+    printf("Testing seeded timsort against qsort...\n");
+    srand(23);
+    LinkedList barreiras = criar_cenario(300);
+    double x = 500, y = 500;
+    // Nearby consecutive bombs reuse the previous event order as seed
+    for (int consulta = 0; consulta < 12; consulta++) {
+        x += aleatorio(-15, 15);
+        y += aleatorio(-15, 15);
+        Ponto centro = criar_ponto(x, y);
+        visibilidade_set_sort_method('q');
+        PoligonoVisibilidade ref = visibilidade_calcular(centro, barreiras);
+        visibilidade_set_sort_method('t');
+        PoligonoVisibilidade semeado = visibilidade_calcular(centro, barreiras);
+        assert(ref != NULL && semeado != NULL);
+        assert_poligonos_iguais(ref, semeado);
+        visibilidade_destruir(ref);
+        visibilidade_destruir(semeado);
+        destruir_ponto(centro);
+    }
+    visibilidade_set_sort_method('q');
+    destruir_cenario(barreiras);
+    printf("Seeded timsort passes.\n");
+}
+
+void test_visibilidade_cinetica() {
+    printf("Testing kinetic visibility along a path...\n");
+    srand(31);
+    LinkedList barreiras = criar_cenario(300);
+    Arena arena = arena_criar(0);
+    VisibilidadeCinetica vc = visibilidade_cinetica_criar(barreiras);
+    assert(vc != NULL);
+    int passos = 40, incrementais = 0;
+    for (int k = 0; k <= passos; k++) {
+        double t = (double)k / passos;
+        Ponto centro = criar_ponto(420 + t * 60, 380 + t * 30);
+        PoligonoVisibilidade ref = visibilidade_calcular(centro, barreiras);
+        PoligonoVisibilidade cin = visibilidade_cinetica_calcular(vc, centro, arena);
+        assert(ref != NULL && cin != NULL);
+        assert_poligonos_iguais(ref, cin);
+        // First step sorts from scratch; short steps are repaired by swaps
+        if (k == 0) assert(visibilidade_cinetica_trocas(vc) == -1);
+        else if (visibilidade_cinetica_trocas(vc) >= 0) incrementais++;
+        visibilidade_destruir(ref);
+        visibilidade_destruir(cin);
+        destruir_ponto(centro);
+    }
+    assert(incrementais == passos);
+    // A long jump still gives the same polygon
+    Ponto longe = criar_ponto(900, 50);
+    PoligonoVisibilidade ref = visibilidade_calcular(longe, barreiras);
+    PoligonoVisibilidade cin = visibilidade_cinetica_calcular(vc, longe, arena);
+    assert_poligonos_iguais(ref, cin);
+    visibilidade_destruir(ref);
+    visibilidade_destruir(cin);
+    destruir_ponto(longe);
+    visibilidade_cinetica_destruir(vc);
+    arena_destruir(arena);
+    destruir_cenario(barreiras);
+    printf("Kinetic visibility passes.\n");
+}
+
+static int dentro(PoligonoVisibilidade pol, double x, double y) {
+    int n = 0;
+    double *v = poligono_get_vertices_ref((Poligono)pol, &n);
+    return ponto_no_poligono(x, y, v, n);
+}
+
+// Every vertex within the (circumscribed) disc and, except the apex, the cone
+static void assert_dentro_dos_limites(PoligonoVisibilidade pol, double ox, double oy,
+                                      double raio, double ini, double fim) {
+    int n = 0;
+    double *v = poligono_get_vertices_ref((Poligono)pol, &n);
+    assert(n >= 3);
+    for (int i = 0; i < n; i++) {
+        double dx = v[2 * i] - ox, dy = v[2 * i + 1] - oy;
+        assert(hypot(dx, dy) <= raio / cos(M_PI / 64) + 1e-6);
+        if (ini == fim || hypot(dx, dy) < 1e-9) continue;
+        double a = atan2(dy, dx);
+        if (a < ini - 1e-6) a += 2 * M_PI;
+        assert(a >= ini - 1e-6 && a <= fim + 1e-6);
+    }
+}
+
+void test_visibilidade_limitada() {
+    printf("Testing radius and field-of-view limited visibility...\n");
+    srand(37);
+    Arena arena = arena_criar(0);
+    double ox = 500, oy = 500, raio = 150;
+    Ponto centro = criar_ponto(ox, oy);
+    // Cone of 100 degrees from 300 to 40 (wraps through zero)
+    double ini = 300 * M_PI / 180, fim = 400 * M_PI / 180;
+    LimitesVisao so_raio = { raio, 0, 0 };
+    LimitesVisao cone = { raio, ini, fim };
+
+    // Open scene: everything within reach is seen
+    LinkedList vazio = list_create();
+    list_insert_back(vazio, criar_segmento(-1, -1, 0, 0, 1000, 0, "none"));
+    list_insert_back(vazio, criar_segmento(-2, -1, 1000, 0, 1000, 1000, "none"));
+    list_insert_back(vazio, criar_segmento(-3, -1, 1000, 1000, 0, 1000, "none"));
+    list_insert_back(vazio, criar_segmento(-4, -1, 0, 1000, 0, 0, "none"));
+    PoligonoVisibilidade disco = visibilidade_calcular_limitada(centro, vazio, &so_raio, arena);
+    PoligonoVisibilidade setor = visibilidade_calcular_limitada(centro, vazio, &cone, arena);
+    assert(disco != NULL && setor != NULL);
+    assert(arena_usado(arena) == 0);
+    for (int i = 0; i < 2000; i++) {
+        double d = aleatorio(0, 2 * raio), a = aleatorio(0, 2 * M_PI);
+        double x = ox + d * cos(a), y = oy + d * sin(a);
+        int no_cone = (a > ini + 0.01) || (a < fim - 2 * M_PI - 0.01);
+        int fora_cone = (a < ini - 0.01) && (a > fim - 2 * M_PI + 0.01);
+        if (d < raio * 0.99) assert(dentro(disco, x, y));
+        if (d > raio * 1.01) assert(!dentro(disco, x, y) && !dentro(setor, x, y));
+        if (d < raio * 0.99 && no_cone) assert(dentro(setor, x, y));
+        if (fora_cone) assert(!dentro(setor, x, y));
+    }
+    visibilidade_destruir(disco);
+    visibilidade_destruir(setor);
+    destruir_cenario(vazio);
+
+    // Walls near the center, plus walls that are beyond reach
+    LinkedList perto = criar_cenario(150);
+    LinkedList com_longe = list_create();
+    for (ListCursor c = list_cursor_first(perto); list_cursor_valid(&c); list_cursor_next(&c)) {
+        list_insert_back(com_longe, clonar_segmento((Segmento)list_cursor_get(&c)));
+    }
+    for (int i = 0; i < 100; i++) {
+        double x = aleatorio(0, 1000), y = aleatorio(800, 1000);
+        list_insert_back(com_longe, criar_segmento(9000 + i, 9000 + i, x, y, x + 30, y + 10, "black"));
+    }
+    for (int k = 0; k < 2; k++) {
+        const LimitesVisao *lim = (k == 0) ? &so_raio : &cone;
+        PoligonoVisibilidade a = visibilidade_calcular_limitada(centro, perto, lim, arena);
+        PoligonoVisibilidade b = visibilidade_calcular_limitada(centro, com_longe, lim, arena);
+        assert(a != NULL && b != NULL);
+        // Far walls are culled before the sweep: same polygon
+        assert_poligonos_iguais(a, b);
+        assert_dentro_dos_limites(a, ox, oy, raio, lim->angulo_min, lim->angulo_max);
+        visibilidade_destruir(a);
+        visibilidade_destruir(b);
+    }
+
+    // No limits: same polygon as the full query
+    LimitesVisao nenhum = { 0, 0, 0 };
+    PoligonoVisibilidade cheio = visibilidade_calcular(centro, perto);
+    PoligonoVisibilidade igual = visibilidade_calcular_limitada(centro, perto, &nenhum, arena);
+    assert_poligonos_iguais(cheio, igual);
+    visibilidade_destruir(cheio);
+    visibilidade_destruir(igual);
+
+    destruir_cenario(perto);
+    destruir_cenario(com_longe);
+    destruir_ponto(centro);
+    arena_destruir(arena);
+    printf("Limited visibility passes.\n");
+}
+
+void test_metodos_ordenacao() {
+    printf("Testing sort method selection...\n");
+    srand(29);
+    LinkedList barreiras = criar_cenario(150);
+    // Small scenes use the mergesort band, larger ones timsort
+    ConfigOrdenacao cfg = { 2, { { 200, ALG_MERGESORT, 4 }, { -1, ALG_TIMSORT, 0 } } };
+    visibilidade_set_config_ordenacao(&cfg);
+    char metodos[] = { 'm', 'i', 'a' };
+    for (int consulta = 0; consulta < 4; consulta++) {
+        Ponto centro = criar_ponto(aleatorio(100, 900), aleatorio(100, 900));
+        visibilidade_set_sort_method('q');
+        PoligonoVisibilidade ref = visibilidade_calcular(centro, barreiras);
+        for (int m = 0; m < 3; m++) {
+            visibilidade_set_sort_method(metodos[m]);
+            visibilidade_set_limiar_insercao(consulta + 1);
+            PoligonoVisibilidade outro = visibilidade_calcular(centro, barreiras);
+            assert_poligonos_iguais(ref, outro);
+            visibilidade_destruir(outro);
+        }
+        visibilidade_destruir(ref);
+        destruir_ponto(centro);
+    }
+    visibilidade_set_sort_method('q');
+    visibilidade_set_limiar_insercao(10);
+    visibilidade_set_config_ordenacao(NULL);
+    destruir_cenario(barreiras);
+    printf("Sort method selection passes.\n");
+}
+
+void test_medidor_ordenacao() {
+    printf("Testing sort calibration probe...\n");
+    // Every candidate the calibration tries runs through the sweep's own sort path
+    AlgoritmoOrdenacao algs[] = { ALG_QSORT, ALG_MERGESORT, ALG_TIMSORT };
+    for (int a = 0; a < 3; a++) {
+        assert(visibilidade_medir_ordenacao(algs[a], 8, 1, 1) >= 0);
+        assert(visibilidade_medir_ordenacao(algs[a], 8, 2048, 3) >= 0);
+    }
+    ConfigOrdenacao cfg;
+    assert(calibracao_executar(&cfg, NULL, 256, visibilidade_medir_ordenacao) == 1);
+    assert(cfg.num_faixas >= 1 && cfg.faixas[cfg.num_faixas - 1].max_n < 0);
+    printf("Sort calibration probe passes.\n");
+}
+
+int main() {
+    test_setores_igual_serial();
+    test_arena_reutilizada();
+    test_timsort_semeado();
+    test_metodos_ordenacao();
+    test_medidor_ordenacao();
+    test_visibilidade_cinetica();
+    test_visibilidade_limitada();
+    test_lote_igual_escalar();
+    test_pontos_no_poligono_igual_escalar();
+    printf("ALL TESTS PASSED for Visibilidade.\n");
+    return 0;
+}